@@ -27,11 +27,17 @@ THE SOFTWARE.
 
 #include "CCAutoPolygon.h"
 #include "poly2tri/poly2tri.h"
+#include "base/CCAsyncTaskPool.h"
 #include "base/CCDirector.h"
+#include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
 #include "clipper/clipper.hpp"
+#include "xxhash.h"
 #include <algorithm>
+#include <mutex>
+#include <thread>
 #include <math.h>
+#include <stdint.h>
 
 USING_NS_CC;
 
@@ -134,16 +140,31 @@ AutoPolygon::AutoPolygon(const std::string &filename)
 ,_filename("")
 ,_width(0)
 ,_height(0)
-,_scaleFactor(0)
+,_scaleFactor(Director::getInstance()->getContentScaleFactor())
 {
     _filename = filename;
     _image = new Image();
     _image->initWithImageFile(filename);
+    initWithImage();
+}
+
+AutoPolygon::AutoPolygon(const std::string& filename, Image* image, float scaleFactor)
+:_image(image)
+,_data(nullptr)
+,_filename(filename)
+,_width(0)
+,_height(0)
+,_scaleFactor(scaleFactor)
+{
+    initWithImage();
+}
+
+void AutoPolygon::initWithImage()
+{
     CCASSERT(_image->getRenderFormat()==Texture2D::PixelFormat::RGBA8888, "unsupported format, currently only supports rgba8888");
     _data = _image->getData();
     _width = _image->getWidth();
     _height = _image->getHeight();
-    _scaleFactor = Director::getInstance()->getContentScaleFactor();
 }
 
 AutoPolygon::~AutoPolygon()
@@ -662,7 +683,212 @@ PolygonInfo AutoPolygon::generateTriangles(const Rect& rect, const float& epsilo
 }
 PolygonInfo AutoPolygon::generatePolygon(const std::string& filename, const Rect& rect, const float epsilon, const float threshold)
 {
-    AutoPolygon ap(filename);
+    std::string cacheDirectory = getCacheDirectory();
+    if (cacheDirectory.empty())
+    {
+        AutoPolygon ap(filename);
+        auto ret = ap.generateTriangles(rect, epsilon, threshold);
+        return ret;
+    }
+    return generatePolygon(filename, FileUtils::getInstance()->fullPathForFilename(filename), rect, epsilon, threshold, cacheDirectory,
+                           Director::getInstance()->getContentScaleFactor());
+}
+
+// the polygon cache, files named after the hash of their key
+static std::mutex s_cacheMutex;
+static std::string s_cacheDirectory;
+
+static const char POLYGON_CACHE_MAGIC[4] = { 'C', 'C', 'A', 'P' };
+static const uint32_t POLYGON_CACHE_VERSION = 1;
+
+struct PolygonCacheKey
+{
+    uint32_t imageSize;
+    uint32_t imageHash[2];
+    float rect[4];
+    float epsilon;
+    float threshold;
+    float scaleFactor;
+};
+
+struct PolygonCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    PolygonCacheKey key;
+    float rect[4];
+    uint32_t vertCount;
+    uint32_t indexCount;
+};
+
+static bool loadCachedPolygon(const std::string& path, const PolygonCacheKey& key, PolygonInfo& info)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path))
+    {
+        return false;
+    }
+
+    Data data = fileUtils->getDataFromFile(path);
+    PolygonCacheHeader header;
+    if (data.getSize() < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, data.getBytes(), sizeof(header));
+    size_t size = sizeof(header) + header.vertCount * sizeof(V3F_C4B_T2F) + header.indexCount * sizeof(unsigned short);
+    if (memcmp(header.magic, POLYGON_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != POLYGON_CACHE_VERSION
+        || memcmp(&header.key, &key, sizeof(key)) != 0 || data.getSize() != size)
+    {
+        return false;
+    }
+
+    auto bytes = data.getBytes() + sizeof(header);
+    TrianglesCommand::Triangles triangles;
+    triangles.verts = new V3F_C4B_T2F[header.vertCount];
+    triangles.indices = new unsigned short[header.indexCount];
+    triangles.vertCount = header.vertCount;
+    triangles.indexCount = header.indexCount;
+    memcpy(triangles.verts, bytes, header.vertCount * sizeof(V3F_C4B_T2F));
+    memcpy(triangles.indices, bytes + header.vertCount * sizeof(V3F_C4B_T2F), header.indexCount * sizeof(unsigned short));
+
+    info.triangles = triangles;
+    info.rect = Rect(header.rect[0], header.rect[1], header.rect[2], header.rect[3]);
+    return true;
+}
+
+static void saveCachedPolygon(const std::string& path, const PolygonCacheKey& key, const PolygonInfo& info)
+{
+    PolygonCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, POLYGON_CACHE_MAGIC, sizeof(header.magic));
+    header.version = POLYGON_CACHE_VERSION;
+    header.key = key;
+    header.rect[0] = info.rect.origin.x;
+    header.rect[1] = info.rect.origin.y;
+    header.rect[2] = info.rect.size.width;
+    header.rect[3] = info.rect.size.height;
+    header.vertCount = (uint32_t)info.triangles.vertCount;
+    header.indexCount = (uint32_t)info.triangles.indexCount;
+
+    size_t vertsSize = header.vertCount * sizeof(V3F_C4B_T2F);
+    size_t indicesSize = header.indexCount * sizeof(unsigned short);
+    size_t size = sizeof(header) + vertsSize + indicesSize;
+    auto bytes = (unsigned char*)malloc(size);
+    if (bytes == nullptr)
+    {
+        return;
+    }
+    memcpy(bytes, &header, sizeof(header));
+    if (vertsSize)
+        memcpy(bytes + sizeof(header), info.triangles.verts, vertsSize);
+    if (indicesSize)
+        memcpy(bytes + sizeof(header) + vertsSize, info.triangles.indices, indicesSize);
+
+    Data data;
+    data.fastSet(bytes, size);
+
+    // written aside and renamed, a polygon generated by two threads at once is never read half written
+    auto fileUtils = FileUtils::getInstance();
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%x.tmp", (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::string tempPath = path + suffix;
+    if (!fileUtils->writeDataToFile(data, tempPath) || !fileUtils->renameFile(tempPath, path))
+    {
+        log("AUTOPOLYGON: cannot save %s", path.c_str());
+        fileUtils->removeFile(tempPath);
+    }
+}
+
+PolygonInfo AutoPolygon::generatePolygon(const std::string& filename, const std::string& fullPath, const Rect& rect, const float epsilon, const float threshold, const std::string& cacheDirectory, float scaleFactor)
+{
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (data.isNull())
+    {
+        log("AUTOPOLYGON: cannot read %s", filename.c_str());
+        return PolygonInfo();
+    }
+
+    PolygonCacheKey key;
+    memset(&key, 0, sizeof(key));
+    std::string cachePath;
+    if (!cacheDirectory.empty())
+    {
+        key.imageSize = (uint32_t)data.getSize();
+        key.imageHash[0] = XXH32(data.getBytes(), data.getSize(), 0);
+        key.imageHash[1] = XXH32(data.getBytes(), data.getSize(), key.imageHash[0]);
+        key.rect[0] = rect.origin.x;
+        key.rect[1] = rect.origin.y;
+        key.rect[2] = rect.size.width;
+        key.rect[3] = rect.size.height;
+        key.epsilon = epsilon;
+        key.threshold = threshold;
+        key.scaleFactor = scaleFactor;
+
+        char name[32];
+        snprintf(name, sizeof(name), "%08x%08x.poly", XXH32(&key, sizeof(key), 0), XXH32(&key, sizeof(key), 1));
+        cachePath = cacheDirectory + name;
+
+        PolygonInfo info;
+        if (loadCachedPolygon(cachePath, key, info))
+        {
+            info.filename = filename;
+            return info;
+        }
+    }
+
+    auto image = new (std::nothrow) Image();
+    if (image == nullptr || !image->initWithImageData(data.getBytes(), data.getSize()))
+    {
+        log("AUTOPOLYGON: cannot decode %s", filename.c_str());
+        CC_SAFE_DELETE(image);
+        return PolygonInfo();
+    }
+
+    AutoPolygon ap(filename, image, scaleFactor);
     auto ret = ap.generateTriangles(rect, epsilon, threshold);
+    if (!cachePath.empty())
+    {
+        saveCachedPolygon(cachePath, key, ret);
+    }
     return ret;
 }
+
+void AutoPolygon::generatePolygonAsync(const std::string& filename, const std::function<void(const PolygonInfo&)>& callback, const Rect& rect, const float epsilon, const float threshold)
+{
+    // the full path cache of FileUtils and the Director are not thread safe
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    std::string cacheDirectory = getCacheDirectory();
+    float scaleFactor = Director::getInstance()->getContentScaleFactor();
+
+    auto info = new PolygonInfo();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [callback](void* param) {
+        auto result = (PolygonInfo*)param;
+        callback(*result);
+        delete result;
+    }, info, [=]() {
+        *info = generatePolygon(filename, fullPath, rect, epsilon, threshold, cacheDirectory, scaleFactor);
+    });
+}
+
+void AutoPolygon::setCacheDirectory(const std::string& directory)
+{
+    std::string path = directory;
+    if (!path.empty() && path.back() != '/')
+    {
+        path += '/';
+    }
+    if (!path.empty() && !FileUtils::getInstance()->isDirectoryExist(path))
+    {
+        FileUtils::getInstance()->createDirectory(path);
+    }
+
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    s_cacheDirectory = path;
+}
+
+std::string AutoPolygon::getCacheDirectory()
+{
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    return s_cacheDirectory;
+}
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #ifndef COCOS_2D_CCAUTOPOLYGON_H__
 #define COCOS_2D_CCAUTOPOLYGON_H__
 
+#include <functional>
 #include <string>
 #include <vector>
 #include "platform/CCImage.h"
@@ -238,7 +239,39 @@ public:
      * @endcode
      */
     static PolygonInfo generatePolygon(const std::string& filename, const Rect& rect = Rect::ZERO, const float epsilon = 2.0, const float threshold = 0.05);
+
+    /**
+     * generate the polygon of an image like generatePolygon, on a worker thread of AsyncTaskPool
+     * @param   filename     A path to image file, e.g., "scene1/monster.png".
+     * @param   callback    called in the main thread with the result, which is empty if the image can't be read
+     * @param   rect    texture rect, use Rect::ZERO for the size of the texture, default is Rect::ZERO
+     * @param   epsilon the value used to reduce and expand, default to 2.0
+     * @param   threshold   the value where bigger than the threshold will be counted as opaque, used in trace
+     * @code
+     * AutoPolygon::generatePolygonAsync("grossini.png", [this](const PolygonInfo& info) {
+     *     addChild(Sprite::create(info));
+     * });
+     * @endcode
+     */
+    static void generatePolygonAsync(const std::string& filename, const std::function<void(const PolygonInfo&)>& callback, const Rect& rect = Rect::ZERO, const float epsilon = 2.0, const float threshold = 0.05);
+
+    /**
+     * set the directory where generatePolygon and generatePolygonAsync save the polygons they generate
+     * a saved polygon is loaded instead of generated again when the content of the image, the parameters
+     * and the content scale factor are the same, across launches of the application
+     * the cache is disabled when the directory is empty, which is the default
+     * @param   directory   a full path, e.g., FileUtils::getInstance()->getWritablePath() + "polygons/"
+     */
+    static void setCacheDirectory(const std::string& directory);
+    static std::string getCacheDirectory();
+
 protected:
+    // takes ownership of image, scaleFactor is the content scale factor of the Director, which may be read on another thread
+    AutoPolygon(const std::string& filename, Image* image, float scaleFactor);
+    void initWithImage();
+
+    static PolygonInfo generatePolygon(const std::string& filename, const std::string& fullPath, const Rect& rect, const float epsilon, const float threshold, const std::string& cacheDirectory, float scaleFactor);
+
     Vec2 findFirstNoneTransparentPixel(const Rect& rect, const float& threshold);
     std::vector<cocos2d::Vec2> marchSquare(const Rect& rect, const Vec2& first, const float& threshold);
     unsigned int getSquareValue(const unsigned int& x, const unsigned int& y, const Rect& rect, const float& threshold);
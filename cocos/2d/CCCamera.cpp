@@ -27,6 +27,7 @@
 #include "2d/CCCamera.h"
 #include "2d/CCCameraBackgroundBrush.h"
 #include "base/CCDirector.h"
+#include "base/CCRefPtr.h"
 #include "platform/CCGLView.h"
 #include "2d/CCScene.h"
 #include "renderer/CCRenderer.h"
@@ -453,6 +454,39 @@ void Camera::applyViewport()
     
 }
 
+std::function<void()> Camera::recordApply()
+{
+    RefPtr<experimental::FrameBuffer> fbo(_fbo);
+    experimental::Viewport viewport = getDefaultViewport();
+    if (_fbo)
+    {
+        viewport = experimental::Viewport(_viewport._left * _fbo->getWidth(), _viewport._bottom * _fbo->getHeight(),
+                                          _viewport._width * _fbo->getWidth(), _viewport._height * _fbo->getHeight());
+    }
+    std::function<void()> background;
+    if (_clearBrush)
+    {
+        background = _clearBrush->recordBackground(this);
+    }
+
+    return [fbo, viewport, background]() {
+        if (fbo)
+        {
+            fbo->applyFBO();
+        }
+        else
+        {
+            experimental::FrameBuffer::applyDefaultFBO();
+        }
+        glViewport(viewport._left, viewport._bottom, viewport._width, viewport._height);
+        //clear background with max depth
+        if (background)
+        {
+            background();
+        }
+    };
+}
+
 int Camera::getRenderOrder() const
 {
     int result(0);
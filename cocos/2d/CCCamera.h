@@ -290,6 +290,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initOrthographic(float zoomX, float zoomY, float nearPlane, float farPlane);
     void applyFrameBufferObject();
     void applyViewport();
+    /** Returns a function doing what apply() and clearBackground() would do now, for the render thread
+     when the rendering is pipelined. It holds the FBO, the viewport and the background brush as they are now. */
+    std::function<void()> recordApply();
 protected:
 
     Scene* _scene; //Scene camera belongs to
@@ -27,12 +27,14 @@
 #include "base/ccMacros.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
+#include "base/CCRefPtr.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
+#include "renderer/CCRenderThread.h"
 #include "renderer/CCTextureCube.h"
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -55,6 +57,15 @@ CameraBackgroundBrush::~CameraBackgroundBrush()
     CC_SAFE_RELEASE(_glProgramState);
 }
 
+std::function<void()> CameraBackgroundBrush::recordBackground(Camera* camera)
+{
+    RefPtr<CameraBackgroundBrush> brush(this);
+    RefPtr<Camera> cameraRef(camera);
+    return [brush, cameraRef]() {
+        brush->drawBackground(cameraRef.get());
+    };
+}
+
 CameraBackgroundBrush* CameraBackgroundBrush::createNoneBrush()
 {
     auto ret = new (std::nothrow) CameraBackgroundBrush();
@@ -122,45 +133,61 @@ bool CameraBackgroundDepthBrush::init()
 }
 
 void CameraBackgroundDepthBrush::drawBackground(Camera* camera)
+{
+    drawQuad(_quad, _depth, _clearColor);
+}
+
+std::function<void()> CameraBackgroundDepthBrush::recordBackground(Camera* camera)
+{
+    RefPtr<CameraBackgroundDepthBrush> brush(this);
+    auto quad = _quad;
+    auto depth = _depth;
+    auto clearColor = _clearColor;
+    return [brush, quad, depth, clearColor]() {
+        brush->drawQuad(quad, depth, clearColor);
+    };
+}
+
+void CameraBackgroundDepthBrush::drawQuad(const V3F_C4B_T2F_Quad& quad, float depth, GLboolean clearColor)
 {
     GLboolean oldDepthTest;
     GLint oldDepthFunc;
     GLboolean oldDepthMask;
     {
-        glColorMask(_clearColor, _clearColor, _clearColor, _clearColor);
+        glColorMask(clearColor, clearColor, clearColor, clearColor);
         glStencilMask(0);
         
-        oldDepthTest = glIsEnabled(GL_DEPTH_TEST);
+        oldDepthTest = GL::isEnabled(GL_DEPTH_TEST);
         glGetIntegerv(GL_DEPTH_FUNC, &oldDepthFunc);
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &oldDepthMask);
+        oldDepthMask = GL::getDepthMask();
         
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_ALWAYS);
+        GL::depthMask(GL_TRUE);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthFunc(GL_ALWAYS);
     }
     
     //draw
     
-    _glProgramState->setUniformFloat("depth", _depth);
+    _glProgramState->setUniformFloat("depth", depth);
     _glProgramState->apply(Mat4::IDENTITY);
     GLshort indices[6] = {0, 1, 2, 3, 2, 1};
     
     {
         GL::bindVAO(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
         
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
         
         // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), &_quad.tl.vertices);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), &quad.tl.vertices);
         
         // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), &_quad.tl.colors);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), &quad.tl.colors);
         
         // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), &_quad.tl.texCoords);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), &quad.tl.texCoords);
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices);
     }
     
@@ -168,13 +195,13 @@ void CameraBackgroundDepthBrush::drawBackground(Camera* camera)
     {
         if(GL_FALSE == oldDepthTest)
         {
-            glDisable(GL_DEPTH_TEST);
+            GL::disable(GL_DEPTH_TEST);
         }
-        glDepthFunc(oldDepthFunc);
+        GL::depthFunc(oldDepthFunc);
         
         if(GL_FALSE == oldDepthMask)
         {
-            glDepthMask(GL_FALSE);
+            GL::depthMask(GL_FALSE);
         }
         
         /* IMPORTANT: We only need to update the states that are not restored.
@@ -246,10 +273,11 @@ CameraBackgroundSkyBoxBrush::CameraBackgroundSkyBoxBrush()
 
 CameraBackgroundSkyBoxBrush::~CameraBackgroundSkyBoxBrush()
 {
+    ScopedGLContext context;
     CC_SAFE_RELEASE(_texture);
     
-    glDeleteBuffers(1, &_vertexBuffer);
-    glDeleteBuffers(1, &_indexBuffer);
+    GL::deleteBuffers(1, &_vertexBuffer);
+    GL::deleteBuffers(1, &_indexBuffer);
     
     _vertexBuffer = 0;
     _indexBuffer = 0;
@@ -297,30 +325,51 @@ CameraBackgroundSkyBoxBrush* CameraBackgroundSkyBoxBrush::create()
 void CameraBackgroundSkyBoxBrush::drawBackground(Camera* camera)
 {
     Mat4 cameraModelMat = camera->getNodeToWorldTransform();
+    cameraModelMat.m[12] = cameraModelMat.m[13] = cameraModelMat.m[14] = 0;
+    drawSkybox(cameraModelMat, _texture);
+}
+
+std::function<void()> CameraBackgroundSkyBoxBrush::recordBackground(Camera* camera)
+{
+    RefPtr<CameraBackgroundSkyBoxBrush> brush(this);
+    RefPtr<TextureCube> texture(_texture);
+    Mat4 cameraModelMat = camera->getNodeToWorldTransform();
+    cameraModelMat.m[12] = cameraModelMat.m[13] = cameraModelMat.m[14] = 0;
+    return [brush, texture, cameraModelMat]() {
+        brush->drawSkybox(cameraModelMat, texture.get());
+    };
+}
+
+void CameraBackgroundSkyBoxBrush::drawSkybox(const Mat4& cameraRotation, TextureCube* texture)
+{
+    // set when drawing, the brush may be drawn by the render thread while the texture is changed
+    if (texture)
+    {
+        _glProgramState->setUniformTexture("u_Env", texture);
+    }
     
     _glProgramState->apply(Mat4::IDENTITY);
     
     Vec4 color(1.f, 1.f, 1.f, 1.f);
     _glProgramState->setUniformVec4("u_color", color);
-    cameraModelMat.m[12] = cameraModelMat.m[13] = cameraModelMat.m[14] = 0;
-    _glProgramState->setUniformMat4("u_cameraRot", cameraModelMat);
+    _glProgramState->setUniformMat4("u_cameraRot", cameraRotation);
     
-    glEnable(GL_DEPTH_TEST);
+    GL::enable(GL_DEPTH_TEST);
     RenderState::StateBlock::_defaultState->setDepthTest(true);
     
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RenderState::StateBlock::_defaultState->setDepthWrite(true);
     
-    glDepthFunc(GL_ALWAYS);
+    GL::depthFunc(GL_ALWAYS);
     RenderState::StateBlock::_defaultState->setDepthFunction(RenderState::DEPTH_ALWAYS);
     
-    glEnable(GL_CULL_FACE);
+    GL::enable(GL_CULL_FACE);
     RenderState::StateBlock::_defaultState->setCullFace(true);
     
-    glCullFace(GL_BACK);
+    GL::cullFace(GL_BACK);
     RenderState::StateBlock::_defaultState->setCullFaceSide(RenderState::CULL_FACE_SIDE_BACK);
     
-    glDisable(GL_BLEND);
+    GL::disable(GL_BLEND);
     RenderState::StateBlock::_defaultState->setBlend(false);
     
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -331,10 +380,10 @@ void CameraBackgroundSkyBoxBrush::drawBackground(Camera* camera)
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION);
         
-        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3), nullptr);
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
     }
     
     glDrawElements(GL_TRIANGLES, (GLsizei)36, GL_UNSIGNED_BYTE, nullptr);
@@ -345,8 +394,8 @@ void CameraBackgroundSkyBoxBrush::drawBackground(Camera* camera)
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
     
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, 8);
@@ -368,10 +417,11 @@ bool CameraBackgroundSkyBoxBrush::init()
 
 void CameraBackgroundSkyBoxBrush::initBuffer()
 {
+    ScopedGLContext context;
     if (_vertexBuffer)
-        glDeleteBuffers(1, &_vertexBuffer);
+        GL::deleteBuffers(1, &_vertexBuffer);
     if (_indexBuffer)
-        glDeleteBuffers(1, &_indexBuffer);
+        GL::deleteBuffers(1, &_indexBuffer);
     
     if (Configuration::getInstance()->supportsShareableVAO() && _vao)
     {
@@ -394,7 +444,7 @@ void CameraBackgroundSkyBoxBrush::initBuffer()
     };
     
     glGenBuffers(1, &_vertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vexBuf), vexBuf, GL_STATIC_DRAW);
     
     // init index buffer object
@@ -407,7 +457,7 @@ void CameraBackgroundSkyBoxBrush::initBuffer()
     };
     
     glGenBuffers(1, &_indexBuffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(idxBuf), idxBuf, GL_STATIC_DRAW);
     
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -424,7 +474,6 @@ void CameraBackgroundSkyBoxBrush::setTexture(TextureCube*  texture)
     CC_SAFE_RETAIN(texture);
     CC_SAFE_RELEASE(_texture);
     _texture = texture;
-    _glProgramState->setUniformTexture("u_Env", _texture);
 }
 
 NS_CC_END
@@ -104,6 +104,15 @@ public:
      */
     virtual void drawBackground(Camera* camera) {}
     
+    /**
+     * Records the background as it would be drawn now, for the render thread when the rendering is pipelined.
+     * The default function calls drawBackground() when it is run, with the values the brush and the camera have then.
+     * @param camera The camera the background is drawn for.
+     * @return A function drawing it later, holding the brush and a copy of the values it draws. Empty if there is nothing to draw.
+     * @since v3.9
+     */
+    virtual std::function<void()> recordBackground(Camera* camera);
+    
 CC_CONSTRUCTOR_ACCESS:
     CameraBackgroundBrush();
     virtual ~CameraBackgroundBrush();
@@ -138,6 +147,8 @@ public:
      */
     virtual void drawBackground(Camera* camera) override;
     
+    virtual std::function<void()> recordBackground(Camera* camera) override;
+    
     /**
      * Set depth
      * @param depth Depth used to clear depth buffer
@@ -151,6 +162,8 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool init() override;
     
 protected:
+    void drawQuad(const V3F_C4B_T2F_Quad& quad, float depth, GLboolean clearColor);
+    
     float _depth;
     
     GLboolean _clearColor;
@@ -237,6 +250,8 @@ public:
      */
     virtual void drawBackground(Camera* camera) override;
     
+    virtual std::function<void()> recordBackground(Camera* camera) override;
+    
 CC_CONSTRUCTOR_ACCESS:
     CameraBackgroundSkyBoxBrush();
     virtual ~CameraBackgroundSkyBoxBrush();
@@ -248,6 +263,7 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     void initBuffer();
+    void drawSkybox(const Mat4& cameraRotation, TextureCube* texture);
     
     GLuint      _vao;
     GLuint      _vertexBuffer;
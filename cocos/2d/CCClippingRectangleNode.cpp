@@ -40,7 +40,7 @@ void ClippingRectangleNode::setClippingRegion(const Rect &clippingRegion)
 void ClippingRectangleNode::onBeforeVisitScissor()
 {
     if (_clippingEnabled) {
-        glEnable(GL_SCISSOR_TEST);
+        GL::enable(GL_SCISSOR_TEST);
 
         GLView* glView = Director::getInstance()->getOpenGLView();
         glView->setScissorInPoints(_clippingRegion.origin.x,
@@ -54,7 +54,7 @@ void ClippingRectangleNode::onAfterVisitScissor()
 {
     if (_clippingEnabled)
     {
-        glDisable(GL_SCISSOR_TEST);
+        GL::disable(GL_SCISSOR_TEST);
     }
 }
 
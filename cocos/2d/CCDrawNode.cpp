@@ -25,6 +25,7 @@
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderThread.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCGLProgramCache.h"
@@ -132,6 +133,7 @@ DrawNode::DrawNode()
 
 DrawNode::~DrawNode()
 {
+    ScopedGLContext context;
     free(_buffer);
     _buffer = nullptr;
     free(_bufferGLPoint);
@@ -139,9 +141,9 @@ DrawNode::~DrawNode()
     free(_bufferGLLine);
     _bufferGLLine = nullptr;
     
-    glDeleteBuffers(1, &_vbo);
-    glDeleteBuffers(1, &_vboGLLine);
-    glDeleteBuffers(1, &_vboGLPoint);
+    GL::deleteBuffers(1, &_vbo);
+    GL::deleteBuffers(1, &_vboGLLine);
+    GL::deleteBuffers(1, &_vboGLPoint);
     _vbo = 0;
     _vboGLPoint = 0;
     _vboGLLine = 0;
@@ -206,6 +208,7 @@ void DrawNode::ensureCapacityGLLine(int count)
 
 bool DrawNode::init()
 {
+    ScopedGLContext context;
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 
     setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR));
@@ -219,7 +222,7 @@ bool DrawNode::init()
         glGenVertexArrays(1, &_vao);
         GL::bindVAO(_vao);
         glGenBuffers(1, &_vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
         // vertex
         glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -234,7 +237,7 @@ bool DrawNode::init()
         glGenVertexArrays(1, &_vaoGLLine);
         GL::bindVAO(_vaoGLLine);
         glGenBuffers(1, &_vboGLLine);
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
         // vertex
         glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -249,7 +252,7 @@ bool DrawNode::init()
         glGenVertexArrays(1, &_vaoGLPoint);
         GL::bindVAO(_vaoGLPoint);
         glGenBuffers(1, &_vboGLPoint);
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
         // vertex
         glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -262,24 +265,24 @@ bool DrawNode::init()
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
         
         GL::bindVAO(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
         
     }
     else
     {
         glGenBuffers(1, &_vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
         
         glGenBuffers(1, &_vboGLLine);
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
         
         glGenBuffers(1, &_vboGLPoint);
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     }
     
     CHECK_GL_ERROR_DEBUG();
@@ -335,7 +338,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t flags)
 
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
         
         _dirty = false;
@@ -348,7 +351,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t flags)
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         // vertex
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
         // color
@@ -358,7 +361,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t flags)
     }
 
     glDrawArrays(GL_TRIANGLES, 0, _bufferCount);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -379,7 +382,7 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t flags)
 
     if (_dirtyGLLine)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
         _dirtyGLLine = false;
     }
@@ -389,7 +392,7 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t flags)
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
         // vertex
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
@@ -406,7 +409,7 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t flags)
         GL::bindVAO(0);
     }
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCountGLLine);
     CHECK_GL_ERROR_DEBUG();
@@ -422,7 +425,7 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t flags)
 
     if (_dirtyGLPoint)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
         
         _dirtyGLPoint = false;
@@ -434,7 +437,7 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t flags)
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
         GL::enableVertexAttribs( GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
@@ -448,7 +451,7 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t flags)
         GL::bindVAO(0);
     }
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCountGLPoint);
     CHECK_GL_ERROR_DEBUG();
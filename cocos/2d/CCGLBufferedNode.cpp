@@ -24,6 +24,8 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCGLBufferedNode.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCRenderThread.h"
 
 GLBufferedNode::GLBufferedNode()
 {
@@ -38,59 +40,62 @@ GLBufferedNode::GLBufferedNode()
 
 GLBufferedNode::~GLBufferedNode()
 {
+    cocos2d::ScopedGLContext context;
     for(int i = 0; i < BUFFER_SLOTS; i++)
     {
         if(_bufferSize[i])
         {
-            glDeleteBuffers(1, &(_bufferObject[i]));
+            cocos2d::GL::deleteBuffers(1, &(_bufferObject[i]));
         }
         if(_indexBufferSize[i])
         {
-            glDeleteBuffers(1, &(_indexBufferObject[i]));
+            cocos2d::GL::deleteBuffers(1, &(_indexBufferObject[i]));
         }
     }
 }
 
 void GLBufferedNode::setGLBufferData(void *buf, GLuint bufSize, int slot)
 {
+    cocos2d::ScopedGLContext context;
     // WebGL doesn't support client-side arrays, so generate a buffer and load the data first.
     if(_bufferSize[slot] < bufSize)
     {
         if(_bufferObject[slot])
         {
-            glDeleteBuffers(1, &(_bufferObject[slot]));
+            cocos2d::GL::deleteBuffers(1, &(_bufferObject[slot]));
         }
         glGenBuffers(1, &(_bufferObject[slot]));
         _bufferSize[slot] = bufSize;
 
-        glBindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
         glBufferData(GL_ARRAY_BUFFER, bufSize, buf, GL_DYNAMIC_DRAW);
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
         glBufferSubData(GL_ARRAY_BUFFER, 0, bufSize, buf);
     }
 }
 
 void GLBufferedNode::setGLIndexData(void *buf, GLuint bufSize, int slot)
 {
+    cocos2d::ScopedGLContext context;
     // WebGL doesn't support client-side arrays, so generate a buffer and load the data first.
     if(_indexBufferSize[slot] < bufSize)
     {
         if(_indexBufferObject[slot])
         {
-            glDeleteBuffers(1, &(_indexBufferObject[slot]));
+            cocos2d::GL::deleteBuffers(1, &(_indexBufferObject[slot]));
         }
         glGenBuffers(1, &(_indexBufferObject[slot]));
         _indexBufferSize[slot] = bufSize;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufSize, buf, GL_DYNAMIC_DRAW);
     }
     else
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, bufSize, buf);
     }
 }
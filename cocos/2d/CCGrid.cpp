@@ -384,16 +384,16 @@ void Grid3D::beforeBlit()
 {
     if(_needDepthTestForBlit)
     {
-        _oldDepthTestValue = glIsEnabled(GL_DEPTH_TEST) != GL_FALSE;
+        _oldDepthTestValue = GL::isEnabled(GL_DEPTH_TEST);
         GLboolean depthWriteMask;
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWriteMask);
+        depthWriteMask = GL::getDepthMask();
 		_oldDepthWriteValue = depthWriteMask != GL_FALSE;
         CHECK_GL_ERROR_DEBUG();
 
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
 
-        glDepthMask(true);
+        GL::depthMask(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(true);
     }
 }
@@ -403,12 +403,12 @@ void Grid3D::afterBlit()
     if(_needDepthTestForBlit)
     {
         if(_oldDepthTestValue)
-            glEnable(GL_DEPTH_TEST);
+            GL::enable(GL_DEPTH_TEST);
         else
-            glDisable(GL_DEPTH_TEST);
+            GL::disable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(_oldDepthTestValue);
 
-        glDepthMask(_oldDepthWriteValue);
+        GL::depthMask(_oldDepthWriteValue);
         RenderState::StateBlock::_defaultState->setDepthWrite(_oldDepthWriteValue);
     }
 }
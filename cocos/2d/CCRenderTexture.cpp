@@ -33,12 +33,20 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCScheduler.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderThread.h"
 #include "2d/CCCamera.h"
 #include "renderer/CCTextureCache.h"
 
 NS_CC_BEGIN
 
+// frames between the read of the pixels into a pixel buffer object and its mapping, so that the GPU is done with it
+static const int READBACK_FRAME_DELAY = 2;
+// pixel buffer objects of a render texture, the reads back beyond them wait for the GPU
+static const size_t MAX_READBACK_BUFFERS = 4;
+
 // implementation RenderTexture
 RenderTexture::RenderTexture()
 : _keepMatrix(false)
@@ -73,6 +81,7 @@ RenderTexture::RenderTexture()
 
 RenderTexture::~RenderTexture()
 {
+    ScopedGLContext context;
     CC_SAFE_RELEASE(_sprite);
     CC_SAFE_RELEASE(_textureCopy);
     
@@ -81,6 +90,10 @@ RenderTexture::~RenderTexture()
     {
         glDeleteRenderbuffers(1, &_depthRenderBufffer);
     }
+    if (!_readbackBuffers.empty())
+    {
+        glDeleteBuffers((GLsizei)_readbackBuffers.size(), _readbackBuffers.data());
+    }
     CC_SAFE_DELETE(_UITextureImage);
 }
 
@@ -181,6 +194,7 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
 
 bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat format, GLuint depthStencilFormat)
 {
+    ScopedGLContext context;
     CCASSERT(format != Texture2D::PixelFormat::A8, "only RGB and RGBA formats are valid for a render texture");
 
     bool ret = false;
@@ -460,6 +474,306 @@ void RenderTexture::onSaveToFile(const std::string& filename, bool isRGBA)
     CC_SAFE_DELETE(image);
 }
 
+void RenderTexture::readPixels(GLvoid* pixels)
+{
+    const Size& s = _texture->getContentSizeInPixels();
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+
+    // TODO: move this to configration, so we don't check it every time
+    /*  Certain Qualcomm Andreno gpu's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
+     */
+    if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
+    {
+        // -- bind a temporary texture so we can clear the render buffer without losing our texture
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
+        CHECK_GL_ERROR_DEBUG();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, (GLsizei)s.width, (GLsizei)s.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+}
+
+void RenderTexture::newImageAsync(const std::function<void (RenderTexture*, Image*)>& callback, bool flipImage)
+{
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+
+    if (nullptr == _texture)
+    {
+        if (callback)
+        {
+            callback(this, nullptr);
+        }
+        return;
+    }
+
+    addAsyncReadback(flipImage, "", true, callback, nullptr);
+}
+
+bool RenderTexture::saveToFileAsync(const std::string& fileName, Image::Format format, bool isRGBA, std::function<void (RenderTexture*, const std::string&)> callback)
+{
+    CCASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
+             "the image can only be saved as JPG or PNG format");
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+    if (isRGBA && format == Image::Format::JPG) CCLOG("RGBA is not supported for JPG format");
+
+    if (nullptr == _texture)
+    {
+        return false;
+    }
+
+    std::string fullpath = FileUtils::getInstance()->getWritablePath() + fileName;
+    addAsyncReadback(true, fullpath, isRGBA, nullptr, callback);
+    return true;
+}
+
+void RenderTexture::addAsyncReadback(bool flipImage, const std::string& fileName, bool isRGBA,
+                                     const std::function<void (RenderTexture*, Image*)>& imageCallback,
+                                     const std::function<void (RenderTexture*, const std::string&)>& fileCallback)
+{
+    AsyncReadback* readback;
+    {
+        std::lock_guard<std::mutex> lock(_readbackMutex);
+        _asyncReadbacks.emplace_back();
+        readback = &_asyncReadbacks.back();
+        readback->state = AsyncReadback::State::QUEUED;
+        readback->frames = 0;
+        readback->buffer = -1;
+        readback->pixels = nullptr;
+        readback->flipImage = flipImage;
+        readback->fileName = fileName;
+        readback->isRGBA = isRGBA;
+        readback->imageCallback = imageCallback;
+        readback->fileCallback = fileCallback;
+    }
+
+    // released once the read back is finished
+    retain();
+
+    readback->command.init(_globalZOrder);
+    readback->command.func = CC_CALLBACK_0(RenderTexture::onReadPixelsAsync, this, readback);
+    Director::getInstance()->getRenderer()->addCommand(&readback->command);
+
+    // not scheduled with the node as target, the read backs go on while it is paused
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (!scheduler->isScheduled("asyncReadbacks", &_asyncReadbacks))
+    {
+        scheduler->schedule(CC_CALLBACK_1(RenderTexture::updateAsyncReadbacks, this), &_asyncReadbacks, 0, false, "asyncReadbacks");
+    }
+}
+
+void RenderTexture::onReadPixelsAsync(AsyncReadback* readback)
+{
+    const Size& s = _texture->getContentSizeInPixels();
+    int buffer = -1;
+    GLubyte* pixels = nullptr;
+
+#ifdef GL_PIXEL_PACK_BUFFER
+    if (Configuration::getInstance()->supportsPixelBufferObject())
+    {
+        for (size_t i = 0; i < _readbackBuffers.size() && buffer < 0; ++i)
+        {
+            if (!_readbackBufferUsed[i])
+            {
+                buffer = (int)i;
+            }
+        }
+
+        if (buffer < 0 && _readbackBuffers.size() < MAX_READBACK_BUFFERS)
+        {
+            GLuint name = 0;
+            glGenBuffers(1, &name);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, name);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)s.width * (GLsizeiptr)s.height * 4, nullptr, GL_STREAM_READ);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            _readbackBuffers.push_back(name);
+            _readbackBufferUsed.push_back(false);
+            buffer = (int)_readbackBuffers.size() - 1;
+        }
+    }
+
+    if (buffer >= 0)
+    {
+        _readbackBufferUsed[buffer] = true;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, _readbackBuffers[buffer]);
+        readPixels(nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+#endif
+
+    if (buffer < 0)
+    {
+        // every buffer is busy or there is none, the pixels are read at once
+        pixels = new (std::nothrow) GLubyte[(size_t)s.width * (size_t)s.height * 4];
+        if (pixels)
+        {
+            readPixels(pixels);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_readbackMutex);
+    readback->buffer = buffer;
+    readback->pixels = pixels;
+    readback->frames = 0;
+    readback->state = AsyncReadback::State::READING;
+    if (buffer < 0)
+    {
+        encodeAsyncReadback(readback);
+    }
+}
+
+void RenderTexture::onUpdateAsyncReadbacks()
+{
+    std::lock_guard<std::mutex> lock(_readbackMutex);
+    for (auto& readback : _asyncReadbacks)
+    {
+        if (readback.state == AsyncReadback::State::READING && ++readback.frames >= READBACK_FRAME_DELAY)
+        {
+#ifdef GL_PIXEL_PACK_BUFFER
+            // kept mapped while the worker thread reads it
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, _readbackBuffers[readback.buffer]);
+            readback.pixels = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+            encodeAsyncReadback(&readback);
+        }
+        else if (readback.state == AsyncReadback::State::ENCODED)
+        {
+#ifdef GL_PIXEL_PACK_BUFFER
+            if (readback.buffer >= 0)
+            {
+                if (readback.pixels)
+                {
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, _readbackBuffers[readback.buffer]);
+                    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                }
+                _readbackBufferUsed[readback.buffer] = false;
+            }
+#endif
+            readback.state = AsyncReadback::State::FINISHED;
+        }
+    }
+}
+
+void RenderTexture::encodeAsyncReadback(AsyncReadback* readback)
+{
+    readback->state = AsyncReadback::State::ENCODING;
+
+    const Size& s = _texture->getContentSizeInPixels();
+    int width = (int)s.width;
+    int height = (int)s.height;
+    GLubyte* pixels = readback->pixels;
+    bool ownsPixels = readback->buffer < 0;
+    bool flipImage = readback->flipImage;
+    std::string fileName = readback->fileName;
+    bool isRGBA = readback->isRGBA;
+    auto result = std::make_shared<Image*>(nullptr);
+
+    auto task = [=]() {
+        if (!pixels)
+        {
+            return;
+        }
+
+        Image* image = new (std::nothrow) Image();
+        if (image && image->initWithRawData(pixels, width * height * 4, width, height, 8))
+        {
+            if (flipImage)
+            {
+                // swaps the rows in place, the image owns a copy of the pixels
+                size_t rowSize = width * 4;
+                std::vector<unsigned char> row(rowSize);
+                unsigned char* data = image->getData();
+                for (int i = 0; i < height / 2; ++i)
+                {
+                    unsigned char* top = data + i * rowSize;
+                    unsigned char* bottom = data + (height - i - 1) * rowSize;
+                    memcpy(row.data(), top, rowSize);
+                    memcpy(top, bottom, rowSize);
+                    memcpy(bottom, row.data(), rowSize);
+                }
+            }
+            if (!fileName.empty())
+            {
+                image->saveToFile(fileName, !isRGBA);
+            }
+            *result = image;
+        }
+        else
+        {
+            CC_SAFE_RELEASE(image);
+        }
+
+        if (ownsPixels)
+        {
+            delete[] pixels;
+        }
+    };
+
+    auto done = [this, readback, result](void*) {
+        Image* image = *result;
+        if (readback->imageCallback)
+        {
+            readback->imageCallback(this, image);
+        }
+        if (readback->fileCallback)
+        {
+            readback->fileCallback(this, readback->fileName);
+        }
+        CC_SAFE_RELEASE(image);
+
+        std::lock_guard<std::mutex> lock(_readbackMutex);
+        readback->state = AsyncReadback::State::ENCODED;
+    };
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, done, nullptr, task);
+}
+
+void RenderTexture::updateAsyncReadbacks(float dt)
+{
+    int finished = 0;
+    bool pending;
+    {
+        std::lock_guard<std::mutex> lock(_readbackMutex);
+        for (auto iter = _asyncReadbacks.begin(); iter != _asyncReadbacks.end();)
+        {
+            if (iter->state == AsyncReadback::State::FINISHED)
+            {
+                iter = _asyncReadbacks.erase(iter);
+                ++finished;
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+        pending = !_asyncReadbacks.empty();
+    }
+
+    if (pending)
+    {
+        // maps the buffers read long enough ago and unmaps the ones whose image is delivered, on the thread of the renderer
+        _updateReadbacksCommand.init(_globalZOrder);
+        _updateReadbacksCommand.func = CC_CALLBACK_0(RenderTexture::onUpdateAsyncReadbacks, this);
+        Director::getInstance()->getRenderer()->addCommand(&_updateReadbacksCommand);
+    }
+    else
+    {
+        Director::getInstance()->getScheduler()->unschedule("asyncReadbacks", &_asyncReadbacks);
+    }
+
+    // last, the render texture may be deleted
+    for (int i = 0; i < finished; ++i)
+    {
+        release();
+    }
+}
+
 /* get buffer as Image */
 Image* RenderTexture::newImage(bool fliimage)
 {
@@ -493,23 +807,7 @@ Image* RenderTexture::newImage(bool fliimage)
             break;
         }
 
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
-
-        // TODO: move this to configration, so we don't check it every time
-        /*  Certain Qualcomm Andreno gpu's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
-         */
-        if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
-        {
-            // -- bind a temporary texture so we can clear the render buffer without losing our texture
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
-            CHECK_GL_ERROR_DEBUG();
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
-        }
-        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-        glReadPixels(0,0,savedBufferWidth, savedBufferHeight,GL_RGBA,GL_UNSIGNED_BYTE, tempData);
-        glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+        readPixels(tempData);
 
         if ( fliimage ) // -- flip is only required when saving image to file
         {
@@ -26,6 +26,9 @@ THE SOFTWARE.
 #ifndef __CCRENDER_TEXTURE_H__
 #define __CCRENDER_TEXTURE_H__
 
+#include <list>
+#include <mutex>
+
 #include "2d/CCNode.h"
 #include "2d/CCSprite.h"
 #include "platform/CCImage.h"
@@ -176,6 +179,31 @@ public:
      * @return Returns true if the operation is successful.
      */
     bool saveToFile(const std::string& filename, Image::Format format, bool isRGBA = true, std::function<void (RenderTexture*, const std::string&)> callback = nullptr);
+
+    /** Creates a new Image with the texture's data, without stalling the main thread.
+     * The pixels are read back by the renderer into a pixel buffer object, mapped a couple of frames later,
+     * and the image is made on a worker thread. Without pixel buffer object the pixels are read at once,
+     * only the image is made on the worker thread.
+     * The render texture is retained until the image is delivered.
+     *
+     * @param callback Called on the main thread with the image, nullptr if it failed.
+     * The image is released after the callback, retain it to keep it.
+     * @param flipImage Whether or not to flip image.
+     * @since v3.9
+     */
+    void newImageAsync(const std::function<void (RenderTexture*, Image*)>& callback, bool flipImage = true);
+
+    /** Saves the texture into a file like saveToFile(), reading the pixels back like newImageAsync() and
+     * encoding the file on a worker thread. Several saves can be pending at once.
+     *
+     * @param filename The file name.
+     * @param format The image format.
+     * @param isRGBA The file is RGBA or not.
+     * @param callback Called on the main thread when the file is saved.
+     * @return Returns true if the operation is successful.
+     * @since v3.9
+     */
+    bool saveToFileAsync(const std::string& filename, Image::Format format, bool isRGBA = true, std::function<void (RenderTexture*, const std::string&)> callback = nullptr);
     
     /** Listen "come to background" message, and save render texture.
      * It only has effect on Android.
@@ -368,6 +396,49 @@ protected:
     void onClearDepth();
 
     void onSaveToFile(const std::string& fileName, bool isRGBA = true);
+
+    // binds the frame buffer and reads the pixels, into the bound pixel pack buffer if any
+    void readPixels(GLvoid* pixels);
+
+    // a read back of newImageAsync() or saveToFileAsync()
+    struct AsyncReadback
+    {
+        enum class State
+        {
+            QUEUED,     // the read command isn't executed yet
+            READING,    // the pixels are on their way to the buffer
+            ENCODING,   // the worker thread makes the image from the pixels
+            ENCODED,    // the image is delivered, the buffer can be reused
+            FINISHED,   // the buffer is released
+        };
+
+        CustomCommand command;
+        State state;
+        int frames;                 // frames waited since the read
+        int buffer;                 // index in _readbackBuffers, -1 when read without pixel buffer object
+        GLubyte* pixels;            // the mapped buffer, or the pixels read at once
+        bool flipImage;
+        std::string fileName;       // the image is saved there if not empty
+        bool isRGBA;
+        std::function<void (RenderTexture*, Image*)> imageCallback;
+        std::function<void (RenderTexture*, const std::string&)> fileCallback;
+    };
+
+    void addAsyncReadback(bool flipImage, const std::string& fileName, bool isRGBA,
+                          const std::function<void (RenderTexture*, Image*)>& imageCallback,
+                          const std::function<void (RenderTexture*, const std::string&)>& fileCallback);
+    void onReadPixelsAsync(AsyncReadback* readback);
+    void onUpdateAsyncReadbacks();
+    void updateAsyncReadbacks(float dt);
+    void encodeAsyncReadback(AsyncReadback* readback);
+
+    // the read backs, with their states, are shared by the main thread, the renderer and the worker threads
+    std::mutex _readbackMutex;
+    std::list<AsyncReadback> _asyncReadbacks;
+    CustomCommand _updateReadbacksCommand;
+    // pixel buffer objects, only used by the renderer
+    std::vector<GLuint> _readbackBuffers;
+    std::vector<bool> _readbackBufferUsed;
     
     Mat4 _oldTransMatrix, _oldProjMatrix;
     Mat4 _transformMatrix, _projectionMatrix;
@@ -194,9 +194,17 @@ void Scene::render(Renderer* renderer)
         
         director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
         director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, Camera::_visitingCamera->getViewProjectionMatrix());
-        camera->apply();
-        //clear background with max depth
-        camera->clearBackground();
+        if (renderer->isRecording())
+        {
+            // on the render thread, with the FBO, viewport and background of the camera as they are now
+            renderer->addCallback(camera->recordApply());
+        }
+        else
+        {
+            camera->apply();
+            //clear background with max depth
+            camera->clearBackground();
+        }
         //visit the scene
         visit(renderer, transform, 0);
 #if CC_USE_NAVMESH
@@ -223,7 +231,7 @@ void Scene::render(Renderer* renderer)
 #endif
 
     Camera::_visitingCamera = nullptr;
-    experimental::FrameBuffer::applyDefaultFBO();
+    renderer->addCallback(&experimental::FrameBuffer::applyDefaultFBO);
 }
 
 void Scene::removeAllChildren()
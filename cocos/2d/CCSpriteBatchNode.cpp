@@ -32,6 +32,15 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCQuadCommand.h"
+#include "base/ccUtils.h"
+#include "2d/CCCamera.h"
+#include "2d/CCScene.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "deprecated/CCString.h" // For StringUtils::format
 
@@ -113,6 +122,7 @@ bool SpriteBatchNode::initWithFile(const std::string& fileImage, ssize_t capacit
 
 SpriteBatchNode::SpriteBatchNode()
 : _textureAtlas(nullptr)
+, _denseParallel(true)
 {
 }
 
@@ -359,9 +369,23 @@ void SpriteBatchNode::reorderBatch(bool reorder)
 
 void SpriteBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    if (!_densePositions.empty())
+    {
+        updateDenseQuads(transform);
+    }
+    else
+    {
+        // the last dense sprites were removed since the quads were written
+        for (auto atlas : _denseAtlases)
+        {
+            atlas->removeAllQuads();
+        }
+    }
+
     // Optimization: Fast Dispatch
     if( _textureAtlas->getTotalQuads() == 0 )
     {
+        addDenseBatchCommands(renderer, transform, flags);
         return;
     }
 
@@ -379,6 +403,8 @@ void SpriteBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t f
 
     _batchCommand.init(_globalZOrder, getGLProgram(), _blendFunc, _textureAtlas, transform, flags);
     renderer->addCommand(&_batchCommand);
+
+    addDenseBatchCommands(renderer, transform, flags);
 }
 
 void SpriteBatchNode::increaseAtlasCapacity()
@@ -611,6 +637,19 @@ void SpriteBatchNode::setTexture(Texture2D *texture)
 {
     _textureAtlas->setTexture(texture);
     updateBlendFunc();
+
+    for (auto atlas : _denseAtlases)
+    {
+        atlas->setTexture(texture);
+    }
+    for (ssize_t i = 0; i < (ssize_t)_denseFrames.size(); ++i)
+    {
+        updateDenseFrame(i);
+    }
+    for (size_t i = 0; i < _denseColors.size(); ++i)
+    {
+        _denseQuadColors[i] = getDenseQuadColor(_denseColors[i]);
+    }
 }
 
 
@@ -692,6 +731,418 @@ SpriteBatchNode * SpriteBatchNode::addSpriteWithoutQuad(Sprite*child, int z, int
     return this;
 }
 
+// MARK: dense sprites
+
+// dense sprites whose quads are written by one call, and at most one thread
+static const ssize_t DENSE_CHUNK_SIZE = 1024;
+// the quads 16 bit indices address, a multiple of DENSE_CHUNK_SIZE so that a chunk is written into one atlas
+static const ssize_t DENSE_ATLAS_CAPACITY = 65536 / 4;
+
+int SpriteBatchNode::addDenseFrame(SpriteFrame* spriteFrame)
+{
+    CCASSERT(spriteFrame, "Invalid sprite frame");
+
+    _denseFrames.pushBack(spriteFrame);
+    _denseFrameData.push_back(DenseFrame());
+    updateDenseFrame(_denseFrames.size() - 1);
+    return (int)_denseFrames.size() - 1;
+}
+
+int SpriteBatchNode::addDenseFrame(const Rect& rect)
+{
+    return addDenseFrame(SpriteFrame::createWithTexture(_textureAtlas->getTexture(), rect));
+}
+
+void SpriteBatchNode::updateDenseFrame(ssize_t index)
+{
+    // the same quad as Sprite::setSpriteFrame() with an anchor point at the center
+    SpriteFrame* spriteFrame = _denseFrames.at(index);
+    DenseFrame& frame = _denseFrameData[index];
+    const Rect& rect = spriteFrame->getRect();
+    const Vec2& offset = spriteFrame->getOffset();
+
+    float x1 = offset.x - rect.size.width / 2;
+    float y1 = offset.y - rect.size.height / 2;
+    float x2 = x1 + rect.size.width;
+    float y2 = y1 + rect.size.height;
+    float x[4] = { x1, x2, x1, x2 };
+    float y[4] = { y1, y1, y2, y2 };
+    memcpy(frame.x, x, sizeof(x));
+    memcpy(frame.y, y, sizeof(y));
+
+    // the same texture coordinates as Sprite::setTextureCoords() without flip
+    Texture2D* tex = _textureAtlas->getTexture();
+    Rect pixels = CC_RECT_POINTS_TO_PIXELS(rect);
+    float atlasWidth = (float)tex->getPixelsWide();
+    float atlasHeight = (float)tex->getPixelsHigh();
+    if (atlasWidth == 0 || atlasHeight == 0)
+    {
+        memset(frame.texCoords, 0, sizeof(frame.texCoords));
+        return;
+    }
+
+    float left, right, top, bottom;
+    if (spriteFrame->isRotated())
+    {
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+        left    = (2*pixels.origin.x+1)/(2*atlasWidth);
+        right   = left+(pixels.size.height*2-2)/(2*atlasWidth);
+        top     = (2*pixels.origin.y+1)/(2*atlasHeight);
+        bottom  = top+(pixels.size.width*2-2)/(2*atlasHeight);
+#else
+        left    = pixels.origin.x/atlasWidth;
+        right   = (pixels.origin.x+pixels.size.height) / atlasWidth;
+        top     = pixels.origin.y/atlasHeight;
+        bottom  = (pixels.origin.y+pixels.size.width) / atlasHeight;
+#endif // CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+
+        frame.texCoords[0] = Tex2F(left, top);
+        frame.texCoords[1] = Tex2F(left, bottom);
+        frame.texCoords[2] = Tex2F(right, top);
+        frame.texCoords[3] = Tex2F(right, bottom);
+    }
+    else
+    {
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+        left    = (2*pixels.origin.x+1)/(2*atlasWidth);
+        right   = left + (pixels.size.width*2-2)/(2*atlasWidth);
+        top     = (2*pixels.origin.y+1)/(2*atlasHeight);
+        bottom  = top + (pixels.size.height*2-2)/(2*atlasHeight);
+#else
+        left    = pixels.origin.x/atlasWidth;
+        right   = (pixels.origin.x + pixels.size.width) / atlasWidth;
+        top     = pixels.origin.y/atlasHeight;
+        bottom  = (pixels.origin.y + pixels.size.height) / atlasHeight;
+#endif // ! CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+
+        frame.texCoords[0] = Tex2F(left, bottom);
+        frame.texCoords[1] = Tex2F(right, bottom);
+        frame.texCoords[2] = Tex2F(left, top);
+        frame.texCoords[3] = Tex2F(right, top);
+    }
+}
+
+Color4B SpriteBatchNode::getDenseQuadColor(const Color4B& color) const
+{
+    // the same color as Sprite::updateColor(), whose opacityModifyRGB follows the texture
+    Color4B color4(color);
+    if (_textureAtlas->getTexture()->hasPremultipliedAlpha())
+    {
+        color4.r *= color.a/255.0f;
+        color4.g *= color.a/255.0f;
+        color4.b *= color.a/255.0f;
+    }
+    return color4;
+}
+
+ssize_t SpriteBatchNode::addDenseSprite(int frame, const Vec2& position)
+{
+    CCASSERT(frame >= 0 && frame < (int)_denseFrames.size(), "Invalid frame index");
+
+    _densePositions.push_back(position);
+    _denseRotations.push_back(0.0f);
+    _denseRotationVectors.push_back(Vec2(1.0f, 0.0f));
+    _denseScales.push_back(Vec2::ONE);
+    _denseColors.push_back(Color4B::WHITE);
+    _denseQuadColors.push_back(getDenseQuadColor(Color4B::WHITE));
+    _denseSpriteFrames.push_back(frame);
+    return _densePositions.size() - 1;
+}
+
+void SpriteBatchNode::removeDenseSprite(ssize_t index)
+{
+    CCASSERT(index >= 0 && index < (ssize_t)_densePositions.size(), "Invalid dense sprite index");
+
+    ssize_t last = _densePositions.size() - 1;
+    _densePositions[index] = _densePositions[last];
+    _denseRotations[index] = _denseRotations[last];
+    _denseRotationVectors[index] = _denseRotationVectors[last];
+    _denseScales[index] = _denseScales[last];
+    _denseColors[index] = _denseColors[last];
+    _denseQuadColors[index] = _denseQuadColors[last];
+    _denseSpriteFrames[index] = _denseSpriteFrames[last];
+
+    _densePositions.pop_back();
+    _denseRotations.pop_back();
+    _denseRotationVectors.pop_back();
+    _denseScales.pop_back();
+    _denseColors.pop_back();
+    _denseQuadColors.pop_back();
+    _denseSpriteFrames.pop_back();
+}
+
+void SpriteBatchNode::removeAllDenseSprites()
+{
+    _densePositions.clear();
+    _denseRotations.clear();
+    _denseRotationVectors.clear();
+    _denseScales.clear();
+    _denseColors.clear();
+    _denseQuadColors.clear();
+    _denseSpriteFrames.clear();
+
+    for (auto atlas : _denseAtlases)
+    {
+        atlas->removeAllQuads();
+    }
+}
+
+void SpriteBatchNode::setDenseSpriteRotation(ssize_t index, float rotation)
+{
+    // the same angle as Node::getNodeToParentTransform()
+    float radians = -CC_DEGREES_TO_RADIANS(rotation);
+    _denseRotations[index] = rotation;
+    _denseRotationVectors[index].set(cosf(radians), sinf(radians));
+}
+
+void SpriteBatchNode::setDenseSpriteColor(ssize_t index, const Color4B& color)
+{
+    _denseColors[index] = color;
+    _denseQuadColors[index] = getDenseQuadColor(color);
+}
+
+void SpriteBatchNode::setDenseSpriteFrame(ssize_t index, int frame)
+{
+    CCASSERT(frame >= 0 && frame < (int)_denseFrames.size(), "Invalid frame index");
+    _denseSpriteFrames[index] = frame;
+}
+
+Sprite* SpriteBatchNode::createSpriteFromDenseSprite(ssize_t index) const
+{
+    CCASSERT(index >= 0 && index < (ssize_t)_densePositions.size(), "Invalid dense sprite index");
+
+    Sprite* sprite = Sprite::createWithSpriteFrame(_denseFrames.at(_denseSpriteFrames[index]));
+    sprite->setPosition(_densePositions[index]);
+    sprite->setRotation(_denseRotations[index]);
+    sprite->setScale(_denseScales[index].x, _denseScales[index].y);
+    const Color4B& color = _denseColors[index];
+    sprite->setColor(Color3B(color.r, color.g, color.b));
+    sprite->setOpacity(color.a);
+    return sprite;
+}
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+static inline bool anyLane(uint32x4_t mask)
+{
+    uint32x2_t half = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+    return (vget_lane_u32(half, 0) | vget_lane_u32(half, 1)) != 0;
+}
+#endif
+
+ssize_t SpriteBatchNode::writeDenseQuads(ssize_t begin, ssize_t end, const float* cullRect, V3F_C4B_T2F_Quad* quads) const
+{
+    const Vec2* positions = _densePositions.data();
+    const Vec2* rotations = _denseRotationVectors.data();
+    const Vec2* scales = _denseScales.data();
+    const Color4B* colors = _denseQuadColors.data();
+    const int* frames = _denseSpriteFrames.data();
+    const DenseFrame* frameData = _denseFrameData.data();
+
+    // the four corners of a sprite are computed at once:
+    // x' = x * cos * scaleX - y * sin * scaleY + positionX
+    // y' = x * sin * scaleX + y * cos * scaleY + positionY
+#if defined(__SSE2__)
+    __m128 cullLeft, cullBottom, cullRight, cullTop;
+    if (cullRect)
+    {
+        cullLeft = _mm_set1_ps(cullRect[0]);
+        cullBottom = _mm_set1_ps(cullRect[1]);
+        cullRight = _mm_set1_ps(cullRect[2]);
+        cullTop = _mm_set1_ps(cullRect[3]);
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    float32x4_t cullLeft, cullBottom, cullRight, cullTop;
+    if (cullRect)
+    {
+        cullLeft = vdupq_n_f32(cullRect[0]);
+        cullBottom = vdupq_n_f32(cullRect[1]);
+        cullRight = vdupq_n_f32(cullRect[2]);
+        cullTop = vdupq_n_f32(cullRect[3]);
+    }
+#endif
+
+    ssize_t count = 0;
+    for (ssize_t i = begin; i < end; ++i)
+    {
+        const DenseFrame& frame = frameData[frames[i]];
+        float a = rotations[i].x * scales[i].x;
+        float b = rotations[i].y * scales[i].x;
+        float c = -rotations[i].y * scales[i].y;
+        float d = rotations[i].x * scales[i].y;
+        float x[4], y[4];
+
+#if defined(__SSE2__)
+        __m128 frameX = _mm_loadu_ps(frame.x);
+        __m128 frameY = _mm_loadu_ps(frame.y);
+        __m128 cornersX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(frameX, _mm_set1_ps(a)), _mm_mul_ps(frameY, _mm_set1_ps(c))), _mm_set1_ps(positions[i].x));
+        __m128 cornersY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(frameX, _mm_set1_ps(b)), _mm_mul_ps(frameY, _mm_set1_ps(d))), _mm_set1_ps(positions[i].y));
+        // overlaps if a corner is on the right of the left side, another one on the left of the right side, ...
+        if (cullRect && !(_mm_movemask_ps(_mm_cmpge_ps(cornersX, cullLeft))
+                          && _mm_movemask_ps(_mm_cmple_ps(cornersX, cullRight))
+                          && _mm_movemask_ps(_mm_cmpge_ps(cornersY, cullBottom))
+                          && _mm_movemask_ps(_mm_cmple_ps(cornersY, cullTop))))
+        {
+            continue;
+        }
+        _mm_storeu_ps(x, cornersX);
+        _mm_storeu_ps(y, cornersY);
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        float32x4_t frameX = vld1q_f32(frame.x);
+        float32x4_t frameY = vld1q_f32(frame.y);
+        float32x4_t cornersX = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(positions[i].x), frameX, a), frameY, c);
+        float32x4_t cornersY = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(positions[i].y), frameX, b), frameY, d);
+        if (cullRect && !(anyLane(vcgeq_f32(cornersX, cullLeft))
+                          && anyLane(vcleq_f32(cornersX, cullRight))
+                          && anyLane(vcgeq_f32(cornersY, cullBottom))
+                          && anyLane(vcleq_f32(cornersY, cullTop))))
+        {
+            continue;
+        }
+        vst1q_f32(x, cornersX);
+        vst1q_f32(y, cornersY);
+#else
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            x[corner] = frame.x[corner] * a + frame.y[corner] * c + positions[i].x;
+            y[corner] = frame.x[corner] * b + frame.y[corner] * d + positions[i].y;
+        }
+        if (cullRect)
+        {
+            float minX = std::min(std::min(x[0], x[1]), std::min(x[2], x[3]));
+            float maxX = std::max(std::max(x[0], x[1]), std::max(x[2], x[3]));
+            float minY = std::min(std::min(y[0], y[1]), std::min(y[2], y[3]));
+            float maxY = std::max(std::max(y[0], y[1]), std::max(y[2], y[3]));
+            if (maxX < cullRect[0] || minX > cullRect[2] || maxY < cullRect[1] || minY > cullRect[3])
+            {
+                continue;
+            }
+        }
+#endif
+
+        V3F_C4B_T2F_Quad& quad = quads[count++];
+        quad.bl.vertices.set(x[0], y[0], 0.0f);
+        quad.br.vertices.set(x[1], y[1], 0.0f);
+        quad.tl.vertices.set(x[2], y[2], 0.0f);
+        quad.tr.vertices.set(x[3], y[3], 0.0f);
+        quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = colors[i];
+        quad.bl.texCoords = frame.texCoords[0];
+        quad.br.texCoords = frame.texCoords[1];
+        quad.tl.texCoords = frame.texCoords[2];
+        quad.tr.texCoords = frame.texCoords[3];
+    }
+    return count;
+}
+
+void SpriteBatchNode::updateDenseQuads(const Mat4& transform)
+{
+    ssize_t spriteCount = _densePositions.size();
+    ssize_t atlasCount = (spriteCount + DENSE_ATLAS_CAPACITY - 1) / DENSE_ATLAS_CAPACITY;
+    for (ssize_t i = 0; i < (ssize_t)_denseAtlases.size() || i < atlasCount; ++i)
+    {
+        ssize_t capacity = std::min(std::max(spriteCount - i * DENSE_ATLAS_CAPACITY, (ssize_t)0), DENSE_ATLAS_CAPACITY);
+        if (i == (ssize_t)_denseAtlases.size())
+        {
+            auto atlas = new (std::nothrow) TextureAtlas();
+            atlas->initWithTexture(_textureAtlas->getTexture(), std::max(capacity, (ssize_t)DEFAULT_CAPACITY));
+            _denseAtlases.pushBack(atlas);
+            atlas->release();
+            _denseBatchCommands.push_back(BatchCommand());
+        }
+        else if (_denseAtlases.at(i)->getCapacity() < capacity)
+        {
+            _denseAtlases.at(i)->resizeCapacity(std::min(std::max(capacity, _denseAtlases.at(i)->getCapacity() * 4 / 3), DENSE_ATLAS_CAPACITY));
+        }
+        // the atlases past atlasCount stay empty
+        _denseAtlases.at(i)->removeAllQuads();
+    }
+
+    // like Renderer::checkVisibility(), the culling is only valid for the default camera:
+    // the visible rect is brought into the space of the batch node
+    float cullRect[4];
+    bool culling = false;
+    auto scene = Director::getInstance()->getRunningScene();
+    if (scene && scene->getDefaultCamera() == Camera::getVisitingCamera())
+    {
+        auto director = Director::getInstance();
+        Rect visibleRect(director->getVisibleOrigin(), director->getVisibleSize());
+        Mat4 inverse = transform.getInversed();
+        Vec3 corners[4] = {
+            Vec3(visibleRect.getMinX(), visibleRect.getMinY(), 0.0f),
+            Vec3(visibleRect.getMaxX(), visibleRect.getMinY(), 0.0f),
+            Vec3(visibleRect.getMinX(), visibleRect.getMaxY(), 0.0f),
+            Vec3(visibleRect.getMaxX(), visibleRect.getMaxY(), 0.0f),
+        };
+        for (int i = 0; i < 4; ++i)
+        {
+            inverse.transformPoint(&corners[i]);
+        }
+        cullRect[0] = std::min(std::min(corners[0].x, corners[1].x), std::min(corners[2].x, corners[3].x));
+        cullRect[1] = std::min(std::min(corners[0].y, corners[1].y), std::min(corners[2].y, corners[3].y));
+        cullRect[2] = std::max(std::max(corners[0].x, corners[1].x), std::max(corners[2].x, corners[3].x));
+        cullRect[3] = std::max(std::max(corners[0].y, corners[1].y), std::max(corners[2].y, corners[3].y));
+        culling = true;
+    }
+
+    if (_denseParallel && spriteCount > DENSE_CHUNK_SIZE && utils::getParallelThreadCount() > 1)
+    {
+        // every chunk writes its quads from its first sprite, then the chunks of an atlas are packed together
+        ssize_t chunkCount = (spriteCount + DENSE_CHUNK_SIZE - 1) / DENSE_CHUNK_SIZE;
+        _denseChunkCounts.resize(chunkCount);
+        utils::parallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+            for (size_t chunk = first; chunk < last; ++chunk)
+            {
+                ssize_t begin = chunk * DENSE_CHUNK_SIZE;
+                ssize_t end = std::min(begin + DENSE_CHUNK_SIZE, spriteCount);
+                ssize_t atlas = begin / DENSE_ATLAS_CAPACITY;
+                V3F_C4B_T2F_Quad* quads = _denseAtlases.at(atlas)->getQuads() + (begin - atlas * DENSE_ATLAS_CAPACITY);
+                _denseChunkCounts[chunk] = writeDenseQuads(begin, end, culling ? cullRect : nullptr, quads);
+            }
+        });
+
+        for (ssize_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            ssize_t begin = chunk * DENSE_CHUNK_SIZE;
+            TextureAtlas* atlas = _denseAtlases.at(begin / DENSE_ATLAS_CAPACITY);
+            V3F_C4B_T2F_Quad* quads = atlas->getQuads();
+            ssize_t offset = begin % DENSE_ATLAS_CAPACITY;
+            ssize_t quadCount = atlas->getTotalQuads();
+            if (offset != quadCount)
+            {
+                memmove(quads + quadCount, quads + offset, _denseChunkCounts[chunk] * sizeof(V3F_C4B_T2F_Quad));
+            }
+            atlas->increaseTotalQuadsWith(_denseChunkCounts[chunk]);
+        }
+    }
+    else
+    {
+        for (ssize_t i = 0; i < atlasCount; ++i)
+        {
+            ssize_t begin = i * DENSE_ATLAS_CAPACITY;
+            ssize_t end = std::min(begin + DENSE_ATLAS_CAPACITY, spriteCount);
+            TextureAtlas* atlas = _denseAtlases.at(i);
+            atlas->increaseTotalQuadsWith(writeDenseQuads(begin, end, culling ? cullRect : nullptr, atlas->getQuads()));
+        }
+    }
+
+    for (ssize_t i = 0; i < atlasCount; ++i)
+    {
+        _denseAtlases.at(i)->setDirty(true);
+    }
+}
+
+void SpriteBatchNode::addDenseBatchCommands(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    for (ssize_t i = 0; i < (ssize_t)_denseAtlases.size(); ++i)
+    {
+        TextureAtlas* atlas = _denseAtlases.at(i);
+        if (atlas->getTotalQuads() > 0)
+        {
+            _denseBatchCommands[i].init(_globalZOrder, getGLProgram(), _blendFunc, atlas, transform, flags);
+            renderer->addCommand(&_denseBatchCommands[i]);
+        }
+    }
+}
+
 std::string SpriteBatchNode::getDescription() const
 {
     return StringUtils::format("<SpriteBatchNode | tag = %d>", _tag);
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <vector>
 
 #include "2d/CCNode.h"
+#include "2d/CCSpriteFrame.h"
 #include "base/CCProtocols.h"
 #include "renderer/CCTextureAtlas.h"
 #include "renderer/CCBatchCommand.h"
@@ -221,6 +222,111 @@ public:
      * It add the sprite to the children and descendants array, but it doesn't update add it to the texture atlas
      */
     SpriteBatchNode * addSpriteWithoutQuad(Sprite *child, int z, int aTag);
+
+    /** @name Dense sprites
+     * Dense sprites are lightweight sprites without node: their position, rotation, scale, color and frame are
+     * stored in arrays by the batch node, and their quads are written by a vectorised loop, split between
+     * worker threads for the big counts. The quads outside of the screen are skipped when the scene is seen by
+     * its default camera.
+     * They are drawn over the Sprite children, in the order they were added, with the texture and blend function
+     * of the batch node. Sprite children and dense sprites can be mixed in the same batch node, and
+     * createSpriteFromDenseSprite() gives a Sprite to a dense sprite which needs actions or children.
+     * A dense sprite is anchored at its center, and has no skew, flip or visibility: use a scale of 0 or
+     * a transparent color to hide it, negative scales to flip it.
+     * @{
+     */
+
+    /** Adds a frame that dense sprites can use.
+     *
+     * @param spriteFrame A sprite frame of the texture of the batch node.
+     * @return The index of the frame.
+     * @since v3.9
+     */
+    int addDenseFrame(SpriteFrame* spriteFrame);
+    /** Adds a frame that dense sprites can use.
+     *
+     * @param rect A rect of the texture of the batch node, in points.
+     * @return The index of the frame.
+     * @since v3.9
+     */
+    int addDenseFrame(const Rect& rect);
+    /** @since v3.9 */
+    ssize_t getDenseFrameCount() const { return _denseFrames.size(); }
+
+    /** Adds a dense sprite, not rotated nor scaled, and white.
+     *
+     * @param frame The index of a frame returned by addDenseFrame().
+     * @param position The position of its center, in the coordinate system of the batch node.
+     * @return The index of the dense sprite.
+     * @since v3.9
+     */
+    ssize_t addDenseSprite(int frame, const Vec2& position);
+    /** Removes a dense sprite. The last dense sprite takes its index, so that the arrays stay dense.
+     * @since v3.9
+     */
+    void removeDenseSprite(ssize_t index);
+    /** @since v3.9 */
+    void removeAllDenseSprites();
+    /** @since v3.9 */
+    ssize_t getDenseSpriteCount() const { return _densePositions.size(); }
+
+    /** @since v3.9 */
+    void setDenseSpritePosition(ssize_t index, const Vec2& position) { _densePositions[index] = position; }
+    /** @since v3.9 */
+    const Vec2& getDenseSpritePosition(ssize_t index) const { return _densePositions[index]; }
+    /** The positions of all the dense sprites, to move them without a call per sprite.
+     * The pointer is valid until a dense sprite is added or removed.
+     * @since v3.9
+     */
+    Vec2* getDenseSpritePositions() { return _densePositions.data(); }
+    /** Sets the rotation in degrees, clockwise as Node::setRotation().
+     * @since v3.9
+     */
+    void setDenseSpriteRotation(ssize_t index, float rotation);
+    /** @since v3.9 */
+    float getDenseSpriteRotation(ssize_t index) const { return _denseRotations[index]; }
+    /** @since v3.9 */
+    void setDenseSpriteScale(ssize_t index, float scaleX, float scaleY) { _denseScales[index].set(scaleX, scaleY); }
+    /** @since v3.9 */
+    const Vec2& getDenseSpriteScale(ssize_t index) const { return _denseScales[index]; }
+    /** Sets the color and the opacity.
+     * @since v3.9
+     */
+    void setDenseSpriteColor(ssize_t index, const Color4B& color);
+    /** @since v3.9 */
+    const Color4B& getDenseSpriteColor(ssize_t index) const { return _denseColors[index]; }
+    /** @since v3.9 */
+    void setDenseSpriteFrame(ssize_t index, int frame);
+    /** @since v3.9 */
+    int getDenseSpriteFrame(ssize_t index) const { return _denseSpriteFrames[index]; }
+
+    /** Creates a Sprite which looks like a dense sprite, with its frame, position, rotation, scale and color.
+     * The Sprite isn't added anywhere, and the dense sprite isn't removed.
+     *
+     * @return An autorelease Sprite.
+     * @since v3.9
+     */
+    Sprite* createSpriteFromDenseSprite(ssize_t index) const;
+
+    /** Whether the quads of the dense sprites are written on several threads when there are enough of them.
+     * Enabled by default.
+     * @since v3.9
+     */
+    void setDenseSpritesParallel(bool parallel) { _denseParallel = parallel; }
+    /** @since v3.9 */
+    bool isDenseSpritesParallel() const { return _denseParallel; }
+
+    /** The number of atlases holding the quads of the dense sprites which were drawn by the last frame.
+     * An atlas holds the quads of 16384 dense sprites at most, the most its 16 bit indices address.
+     * @since v3.9
+     */
+    ssize_t getDenseTextureAtlasCount() const { return _denseAtlases.size(); }
+    /** An atlas holding the quads of the dense sprites which were drawn by the last frame, the dense sprites [index * 16384, (index + 1) * 16384).
+     * nullptr if there is no such atlas.
+     * @since v3.9
+     */
+    TextureAtlas* getDenseTextureAtlas(ssize_t index = 0) const { return index < (ssize_t)_denseAtlases.size() ? _denseAtlases.at(index) : nullptr; }
+    /** @} */
     
 CC_CONSTRUCTOR_ACCESS:
     /**
@@ -265,6 +371,39 @@ protected:
     // There is not need to retain/release these objects, since they are already retained by _children
     // So, using std::vector<Sprite*> is slightly faster than using cocos2d::Array for this particular case
     std::vector<Sprite*> _descendants;
+
+    // the corners around the center of the sprite and their texture coordinates: bl, br, tl, tr
+    struct DenseFrame
+    {
+        float x[4];
+        float y[4];
+        Tex2F texCoords[4];
+    };
+
+    void updateDenseFrame(ssize_t index);
+    Color4B getDenseQuadColor(const Color4B& color) const;
+    // writes the quads of the dense sprites [begin, end) which overlap cullRect (left, bottom, right, top) if any, returns their number
+    ssize_t writeDenseQuads(ssize_t begin, ssize_t end, const float* cullRect, V3F_C4B_T2F_Quad* quads) const;
+    void updateDenseQuads(const Mat4& transform);
+    void addDenseBatchCommands(Renderer* renderer, const Mat4& transform, uint32_t flags);
+
+    Vector<SpriteFrame*> _denseFrames;
+    std::vector<DenseFrame> _denseFrameData;
+
+    // one entry per dense sprite, the rotations are also kept as cos and sin of the angle of Node
+    std::vector<Vec2> _densePositions;
+    std::vector<float> _denseRotations;
+    std::vector<Vec2> _denseRotationVectors;
+    std::vector<Vec2> _denseScales;
+    std::vector<Color4B> _denseColors;
+    std::vector<Color4B> _denseQuadColors;
+    std::vector<int> _denseSpriteFrames;
+
+    // one atlas and one command per DENSE_ATLAS_CAPACITY dense sprites
+    Vector<TextureAtlas*> _denseAtlases;
+    std::vector<BatchCommand> _denseBatchCommands;
+    bool _denseParallel;
+    std::vector<ssize_t> _denseChunkCounts;
 };
 
 // end of sprite_nodes group
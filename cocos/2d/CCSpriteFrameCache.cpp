@@ -104,9 +104,8 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     // check the format
     CCASSERT(format >=0 && format <= 3, "format is not supported for SpriteFrameCache addSpriteFramesWithDictionary:textureFilename:");
 
-    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
-    auto image = new Image();
-    image->initWithImageFile(textureFileName);
+    // only read for the sheets having 9-patch frames
+    Image* image = nullptr;
     NinePatchImageParser parser;
     for (auto iter = framesDict.begin(); iter != framesDict.end(); ++iter)
     {
@@ -199,6 +198,11 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
         bool flag = NinePatchImageParser::isNinePatchImage(spriteFrameName);
         if(flag)
         {
+            if (image == nullptr)
+            {
+                image = new Image();
+                image->initWithImageFile(Director::getInstance()->getTextureCache()->getTextureFilePath(texture));
+            }
             parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
             texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
         }
@@ -210,6 +214,12 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
+    if (SpriteFrameIndex::isIndexFile(plist))
+    {
+        addSpriteFramesWithIndexFile(plist, texture);
+        return;
+    }
+
     if (_loadedFileNames->find(plist) != _loadedFileNames->end())
     {
         return; // We already added it
@@ -255,6 +265,12 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
         return;
     }
 
+    if (SpriteFrameIndex::isIndexFile(plist))
+    {
+        addSpriteFramesWithIndexFile(plist, nullptr);
+        return;
+    }
+
     if (_loadedFileNames->find(plist) == _loadedFileNames->end())
     {
         
@@ -307,7 +323,7 @@ bool SpriteFrameCache::isSpriteFramesWithFileLoaded(const std::string& plist) co
 {
     bool result = false;
 
-    if (_loadedFileNames->find(plist) != _loadedFileNames->end())
+    if (_loadedFileNames->find(plist) != _loadedFileNames->end() || getSpriteFrameIndex(plist))
     {
         result = true;
     }
@@ -325,6 +341,7 @@ void SpriteFrameCache::removeSpriteFrames()
     _spriteFrames.clear();
     _spriteFramesAliases.clear();
     _loadedFileNames->clear();
+    _spriteFrameIndexes.clear();
 }
 
 void SpriteFrameCache::removeUnusedSpriteFrames()
@@ -373,12 +390,29 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
         _spriteFrames.erase(name);
     }
 
+    // not created again by the indexes
+    for (auto index : _spriteFrameIndexes)
+    {
+        int frame = index->findFrame(name);
+        if (frame >= 0)
+        {
+            _spriteFrames.erase(index->getFrameName(frame));
+            index->removeFrame(frame);
+        }
+    }
+
     // FIXME:. Since we don't know the .plist file that originated the frame, we must remove all .plist from the cache
     _loadedFileNames->clear();
 }
 
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
+    if (SpriteFrameIndex::isIndexFile(plist))
+    {
+        removeSpriteFramesFromIndexFile(plist);
+        return;
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
@@ -438,6 +472,19 @@ void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
     }
 
     _spriteFrames.erase(keysToRemove);
+
+    std::vector<SpriteFrameIndex*> indexesToRemove;
+    for (auto index : _spriteFrameIndexes)
+    {
+        if (index->getTexture() == texture)
+        {
+            indexesToRemove.push_back(index);
+        }
+    }
+    for (auto index : indexesToRemove)
+    {
+        _spriteFrameIndexes.eraseObject(index);
+    }
 }
 
 SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
@@ -455,8 +502,101 @@ SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
                 CCLOG("cocos2d: SpriteFrameCache: Frame '%s' not found", name.c_str());
             }
         }
+        else
+        {
+            // the frames of the indexes are created on demand
+            for (auto index : _spriteFrameIndexes)
+            {
+                int indexFrame = index->findFrame(name);
+                if (indexFrame < 0)
+                {
+                    continue;
+                }
+
+                // name may be an alias of a frame created already
+                std::string frameName = index->getFrameName(indexFrame);
+                frame = _spriteFrames.at(frameName);
+                if (!frame)
+                {
+                    frame = index->createSpriteFrame(indexFrame);
+                    _spriteFrames.insert(frameName, frame);
+                }
+                break;
+            }
+        }
     }
     return frame;
 }
 
+void SpriteFrameCache::addSpriteFramesWithIndexFile(const std::string& filename, Texture2D* texture)
+{
+    if (getSpriteFrameIndex(filename))
+    {
+        return; // We already added it
+    }
+
+    auto index = SpriteFrameIndex::createWithFile(filename);
+    if (index == nullptr)
+    {
+        return;
+    }
+
+    if (texture == nullptr)
+    {
+        std::string texturePath = index->getTextureFileName();
+        if (!texturePath.empty())
+        {
+            // build texture path relative to index file
+            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, filename);
+        }
+        else
+        {
+            // build texture path by replacing file extension
+            texturePath = filename.substr(0, filename.find_last_of(".")).append(".png");
+            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+        }
+
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        if (texture == nullptr)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            return;
+        }
+    }
+
+    index->setTexture(texture);
+    _spriteFrameIndexes.pushBack(index);
+}
+
+void SpriteFrameCache::removeSpriteFramesFromIndexFile(const std::string& filename)
+{
+    auto index = getSpriteFrameIndex(filename);
+    if (index == nullptr)
+    {
+        return;
+    }
+
+    // only the created frames can be in the cache, nothing to parse
+    std::vector<std::string> keysToRemove;
+    for (int frame : index->getCreatedFrames())
+    {
+        keysToRemove.push_back(index->getFrameName(frame));
+    }
+    _spriteFrames.erase(keysToRemove);
+
+    _spriteFrameIndexes.eraseObject(index);
+}
+
+SpriteFrameIndex* SpriteFrameCache::getSpriteFrameIndex(const std::string& filename) const
+{
+    for (auto index : _spriteFrameIndexes)
+    {
+        if (index->getFileName() == filename)
+        {
+            return index;
+        }
+    }
+    return nullptr;
+}
+
 NS_CC_END
@@ -37,9 +37,11 @@ THE SOFTWARE.
 #include <set>
 #include <string>
 #include "2d/CCSpriteFrame.h"
+#include "2d/CCSpriteFrameIndex.h"
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
+#include "base/CCVector.h"
 
 NS_CC_BEGIN
 
@@ -54,6 +56,10 @@ class Texture2D;
 /** @class SpriteFrameCache
  * @brief Singleton that handles the loading of the sprite frames.
  It saves in a cache the sprite frames.
+
+ The files whose name ends with SpriteFrameIndex::FILE_EXTENSION are loaded as binary indexes
+ instead of plists, see SpriteFrameIndex::convertPlist(). Their frames are only created when
+ getSpriteFrameByName() asks for them, and their loading or removal does not parse anything.
  @since v0.9
  @js cc.spriteFrameCache
  */
@@ -94,7 +100,7 @@ public:
      */
     bool init();
 
-    /** Adds multiple Sprite Frames from a plist file.
+    /** Adds multiple Sprite Frames from a plist file, or a sprite frame index.
      * A texture will be loaded automatically. The texture name will composed by replacing the .plist suffix with .png.
      * If you want to use another texture, you should use the addSpriteFramesWithFile(const std::string& plist, const std::string& textureFileName) method.
      * @js addSpriteFrames
@@ -160,6 +166,7 @@ public:
     /** Removes unused sprite frames.
      * Sprite Frames that have a retain count of 1 will be deleted.
      * It is convenient to call this method after when starting a new Scene.
+     * The frames of the sprite frame indexes are created again if they are asked for.
 	 * @js NA
      */
     void removeUnusedSpriteFrames();
@@ -223,10 +230,17 @@ protected:
     */
     void removeSpriteFramesFromDictionary(ValueMap& dictionary);
 
+    /** Adds the index file, the texture being the one named in the index if texture is nullptr. */
+    void addSpriteFramesWithIndexFile(const std::string& filename, Texture2D* texture);
+    void removeSpriteFramesFromIndexFile(const std::string& filename);
+    SpriteFrameIndex* getSpriteFrameIndex(const std::string& filename) const;
+
 
     Map<std::string, SpriteFrame*> _spriteFrames;
     ValueMap _spriteFramesAliases;
     std::set<std::string>*  _loadedFileNames;
+    // in loading order, the first one having a frame creates it
+    Vector<SpriteFrameIndex*> _spriteFrameIndexes;
 };
 
 // end of _2d group
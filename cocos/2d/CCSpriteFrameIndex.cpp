@@ -0,0 +1,635 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCSpriteFrameIndex.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <unordered_set>
+
+#include "2d/CCSpriteFrame.h"
+#include "base/CCDirector.h"
+#include "base/CCNS.h"
+#include "base/CCNinePatchImageParser.h"
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+
+#if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT
+#define CC_SPRITE_FRAME_INDEX_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+/*
+ File layout, little endian, every section 4 bytes aligned:
+
+ Header
+ FrameEntry[frameCount], sorted by name
+ AliasEntry[aliasCount]
+ uint32_t buckets[bucketCount], open addressing with linear probing, 0 for an empty bucket,
+     id + 1 otherwise, ids from frameCount on being aliases
+ char strings[stringsSize], every string is followed by a '\0'
+ */
+
+struct SpriteFrameIndex::Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t aliasCount;
+    uint32_t bucketCount;
+    uint32_t textureName;
+    uint32_t textureNameLength;
+    uint32_t stringsSize;
+};
+
+struct SpriteFrameIndex::FrameEntry
+{
+    uint32_t name;
+    uint32_t nameLength;
+    uint32_t hash;
+    uint32_t flags;
+    // as given to SpriteFrame::createWithTexture()
+    float rect[4];
+    float offset[2];
+    float originalSize[2];
+    // in points, valid with FRAME_NINE_PATCH
+    float capInsets[4];
+};
+
+struct SpriteFrameIndex::AliasEntry
+{
+    uint32_t name;
+    uint32_t nameLength;
+    uint32_t hash;
+    uint32_t frame;
+};
+
+namespace
+{
+    const char INDEX_MAGIC[4] = { 'C', 'C', 'S', 'F' };
+    const uint32_t INDEX_VERSION = 1;
+
+    enum FrameFlags
+    {
+        FRAME_ROTATED = 1 << 0,
+        FRAME_NINE_PATCH = 1 << 1,
+    };
+
+    enum FrameState
+    {
+        FRAME_STATE_NONE,
+        FRAME_STATE_CREATED,
+        FRAME_STATE_REMOVED,
+    };
+
+    // FNV-1a, the value is stored in the files so it must not change
+    uint32_t hashName(const char* name, size_t length)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= (unsigned char)name[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    std::string defaultTextureFileName(const std::string& filename)
+    {
+        // replace the extension by .png
+        std::string texturePath = filename;
+        size_t startPos = texturePath.find_last_of(".");
+        if (startPos != std::string::npos)
+            texturePath.erase(startPos);
+        return texturePath.append(".png");
+    }
+}
+
+const char* SpriteFrameIndex::FILE_EXTENSION = ".ccsf";
+
+bool SpriteFrameIndex::isIndexFile(const std::string& filename)
+{
+    size_t length = strlen(FILE_EXTENSION);
+    return filename.size() > length && filename.compare(filename.size() - length, length, FILE_EXTENSION) == 0;
+}
+
+bool SpriteFrameIndex::convertPlist(const std::string& plist, const std::string& indexFile)
+{
+    auto fileUtils = FileUtils::getInstance();
+    ValueMap dict = fileUtils->getValueMapFromFile(fileUtils->fullPathForFilename(plist));
+    if (dict.find("frames") == dict.end())
+    {
+        CCLOG("cocos2d: SpriteFrameIndex: no frames in %s", plist.c_str());
+        return false;
+    }
+
+    int format = 0;
+    std::string textureFileName;
+    if (dict.find("metadata") != dict.end())
+    {
+        ValueMap& metadataDict = dict["metadata"].asValueMap();
+        format = metadataDict["format"].asInt();
+        textureFileName = metadataDict["textureFileName"].asString();
+    }
+    if (format < 0 || format > 3)
+    {
+        CCLOG("cocos2d: SpriteFrameIndex: format %d of %s is not supported", format, plist.c_str());
+        return false;
+    }
+
+    ValueMap& framesDict = dict["frames"].asValueMap();
+    std::vector<std::string> names;
+    names.reserve(framesDict.size());
+    for (const auto& iter : framesDict)
+        names.push_back(iter.first);
+    std::sort(names.begin(), names.end());
+
+    std::string strings;
+    auto addString = [&strings](const std::string& str) {
+        uint32_t offset = (uint32_t)strings.size();
+        strings.append(str);
+        strings.push_back('\0');
+        return offset;
+    };
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.textureName = addString(textureFileName);
+    header.textureNameLength = (uint32_t)textureFileName.size();
+
+    std::vector<FrameEntry> frames(names.size());
+    std::vector<std::pair<std::string, uint32_t>> aliasNames;
+    Image* image = nullptr;
+    bool imageLoaded = false;
+    NinePatchImageParser parser;
+
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        const std::string& name = names[i];
+        ValueMap& frameDict = framesDict[name].asValueMap();
+        FrameEntry& entry = frames[i];
+        memset(&entry, 0, sizeof(entry));
+        entry.name = addString(name);
+        entry.nameLength = (uint32_t)name.size();
+        entry.hash = hashName(name.data(), name.size());
+
+        Rect rect;
+        Vec2 offset;
+        Size originalSize;
+        bool rotated = false;
+
+        if (format == 0)
+        {
+            rect = Rect(frameDict["x"].asFloat(), frameDict["y"].asFloat(), frameDict["width"].asFloat(), frameDict["height"].asFloat());
+            offset = Vec2(frameDict["offsetX"].asFloat(), frameDict["offsetY"].asFloat());
+            int ow = frameDict["originalWidth"].asInt();
+            int oh = frameDict["originalHeight"].asInt();
+            if (!ow || !oh)
+            {
+                CCLOGWARN("cocos2d: WARNING: originalWidth/Height not found on the SpriteFrame. AnchorPoint won't work as expected. Regenrate the .plist");
+            }
+            originalSize = Size((float)abs(ow), (float)abs(oh));
+        }
+        else if (format == 1 || format == 2)
+        {
+            rect = RectFromString(frameDict["frame"].asString());
+            if (format == 2)
+            {
+                rotated = frameDict["rotated"].asBool();
+            }
+            offset = PointFromString(frameDict["offset"].asString());
+            originalSize = SizeFromString(frameDict["sourceSize"].asString());
+        }
+        else
+        {
+            Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
+            Rect textureRect = RectFromString(frameDict["textureRect"].asString());
+            rect = Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height);
+            rotated = frameDict["textureRotated"].asBool();
+            offset = PointFromString(frameDict["spriteOffset"].asString());
+            originalSize = SizeFromString(frameDict["spriteSourceSize"].asString());
+
+            for (const auto& value : frameDict["aliases"].asValueVector())
+            {
+                aliasNames.push_back(std::make_pair(value.asString(), (uint32_t)i));
+            }
+        }
+
+        entry.rect[0] = rect.origin.x;
+        entry.rect[1] = rect.origin.y;
+        entry.rect[2] = rect.size.width;
+        entry.rect[3] = rect.size.height;
+        entry.offset[0] = offset.x;
+        entry.offset[1] = offset.y;
+        entry.originalSize[0] = originalSize.width;
+        entry.originalSize[1] = originalSize.height;
+        if (rotated)
+        {
+            entry.flags |= FRAME_ROTATED;
+        }
+
+        if (NinePatchImageParser::isNinePatchImage(name))
+        {
+            // the texture is only read for the sheets having 9-patch frames
+            if (!imageLoaded)
+            {
+                imageLoaded = true;
+                std::string texturePath = textureFileName.empty() ? defaultTextureFileName(plist) : fileUtils->fullPathFromRelativeFile(textureFileName, plist);
+                image = new (std::nothrow) Image();
+                if (image && !image->initWithImageFile(texturePath))
+                {
+                    CCLOG("cocos2d: SpriteFrameIndex: can't read %s, the 9-patch frames have no cap insets", texturePath.c_str());
+                    CC_SAFE_DELETE(image);
+                }
+            }
+            if (image)
+            {
+                parser.setSpriteFrameInfo(image, CC_RECT_POINTS_TO_PIXELS(rect), rotated);
+                Rect capInsets = parser.parseCapInset();
+                entry.flags |= FRAME_NINE_PATCH;
+                entry.capInsets[0] = capInsets.origin.x;
+                entry.capInsets[1] = capInsets.origin.y;
+                entry.capInsets[2] = capInsets.size.width;
+                entry.capInsets[3] = capInsets.size.height;
+            }
+        }
+    }
+    CC_SAFE_DELETE(image);
+
+    // aliases clashing with a frame or another alias are dropped, as the plist loader would shadow them
+    std::unordered_set<std::string> usedNames(names.begin(), names.end());
+    std::vector<AliasEntry> aliases;
+    for (const auto& alias : aliasNames)
+    {
+        if (!usedNames.insert(alias.first).second)
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", alias.first.c_str());
+            continue;
+        }
+
+        AliasEntry entry;
+        entry.name = addString(alias.first);
+        entry.nameLength = (uint32_t)alias.first.size();
+        entry.hash = hashName(alias.first.data(), alias.first.size());
+        entry.frame = alias.second;
+        aliases.push_back(entry);
+    }
+
+    // open addressing, at most half full
+    uint32_t entryCount = (uint32_t)(frames.size() + aliases.size());
+    uint32_t bucketCount = 2;
+    while (bucketCount < entryCount * 2)
+        bucketCount *= 2;
+    std::vector<uint32_t> buckets(bucketCount, 0);
+
+    uint32_t mask = bucketCount - 1;
+    auto insert = [&buckets, mask](uint32_t hash, uint32_t id) {
+        uint32_t bucket = hash & mask;
+        while (buckets[bucket] != 0)
+            bucket = (bucket + 1) & mask;
+        buckets[bucket] = id + 1;
+    };
+    for (uint32_t i = 0; i < frames.size(); ++i)
+    {
+        insert(frames[i].hash, i);
+    }
+    for (uint32_t i = 0; i < aliases.size(); ++i)
+    {
+        insert(aliases[i].hash, (uint32_t)frames.size() + i);
+    }
+
+    while (strings.size() % 4)
+        strings.push_back('\0');
+
+    header.frameCount = (uint32_t)frames.size();
+    header.aliasCount = (uint32_t)aliases.size();
+    header.bucketCount = bucketCount;
+    header.stringsSize = (uint32_t)strings.size();
+
+    size_t size = sizeof(Header) + frames.size() * sizeof(FrameEntry) + aliases.size() * sizeof(AliasEntry)
+        + buckets.size() * sizeof(uint32_t) + strings.size();
+    unsigned char* bytes = (unsigned char*)malloc(size);
+    if (bytes == nullptr)
+    {
+        return false;
+    }
+
+    unsigned char* ptr = bytes;
+    auto write = [&ptr](const void* data, size_t length) {
+        if (length)
+            memcpy(ptr, data, length);
+        ptr += length;
+    };
+    write(&header, sizeof(header));
+    write(frames.data(), frames.size() * sizeof(FrameEntry));
+    write(aliases.data(), aliases.size() * sizeof(AliasEntry));
+    write(buckets.data(), buckets.size() * sizeof(uint32_t));
+    write(strings.data(), strings.size());
+
+    Data data;
+    data.fastSet(bytes, size);
+    if (!fileUtils->writeDataToFile(data, indexFile))
+    {
+        CCLOG("cocos2d: SpriteFrameIndex: can't write %s", indexFile.c_str());
+        return false;
+    }
+    return true;
+}
+
+SpriteFrameIndex* SpriteFrameIndex::createWithFile(const std::string& filename)
+{
+    auto ret = new (std::nothrow) SpriteFrameIndex();
+    if (ret && ret->initWithFile(filename))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+SpriteFrameIndex::SpriteFrameIndex()
+: _texture(nullptr)
+, _bytes(nullptr)
+, _size(0)
+, _mapping(nullptr)
+{
+}
+
+SpriteFrameIndex::~SpriteFrameIndex()
+{
+    CC_SAFE_RELEASE(_texture);
+    unmapFile();
+}
+
+bool SpriteFrameIndex::initWithFile(const std::string& filename)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    if (fullPath.empty() || !mapFile(fullPath))
+    {
+        CCLOG("cocos2d: SpriteFrameIndex: can't read %s", filename.c_str());
+        return false;
+    }
+    if (!validate())
+    {
+        CCLOG("cocos2d: SpriteFrameIndex: %s is not a valid sprite frame index", filename.c_str());
+        unmapFile();
+        return false;
+    }
+
+    _fileName = filename;
+    _frameStates.assign(getHeader()->frameCount, FRAME_STATE_NONE);
+    return true;
+}
+
+bool SpriteFrameIndex::mapFile(const std::string& fullPath)
+{
+#if CC_SPRITE_FRAME_INDEX_MMAP
+    // files packed in the apk, or not on the file system, can't be mapped
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                _mapping = mapping;
+                _bytes = (const unsigned char*)mapping;
+                _size = (size_t)st.st_size;
+            }
+        }
+        close(fd);
+        if (_mapping)
+        {
+            return true;
+        }
+    }
+#endif
+
+    _data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (_data.isNull())
+    {
+        return false;
+    }
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+    return true;
+}
+
+void SpriteFrameIndex::unmapFile()
+{
+#if CC_SPRITE_FRAME_INDEX_MMAP
+    if (_mapping)
+    {
+        munmap(_mapping, _size);
+    }
+#endif
+    _mapping = nullptr;
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+bool SpriteFrameIndex::validate() const
+{
+    if (_size < sizeof(Header))
+        return false;
+
+    auto header = getHeader();
+    if (memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0 || header->version != INDEX_VERSION)
+        return false;
+
+    // a power of two with an empty bucket at least, so that probing ends
+    uint64_t entryCount = (uint64_t)header->frameCount + header->aliasCount;
+    if (header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0 || header->bucketCount <= entryCount)
+        return false;
+
+    uint64_t size = sizeof(Header) + (uint64_t)header->frameCount * sizeof(FrameEntry) + (uint64_t)header->aliasCount * sizeof(AliasEntry)
+        + (uint64_t)header->bucketCount * sizeof(uint32_t) + header->stringsSize;
+    if (size != _size)
+        return false;
+
+    auto isString = [header](uint32_t offset, uint32_t length) {
+        return (uint64_t)offset + length < header->stringsSize;
+    };
+    if (!isString(header->textureName, header->textureNameLength))
+        return false;
+
+    auto frames = getFrames();
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        if (!isString(frames[i].name, frames[i].nameLength))
+            return false;
+    }
+
+    auto aliases = getAliases();
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        if (!isString(aliases[i].name, aliases[i].nameLength) || aliases[i].frame >= header->frameCount)
+            return false;
+    }
+
+    auto buckets = getBuckets();
+    for (uint32_t i = 0; i < header->bucketCount; ++i)
+    {
+        if (buckets[i] > entryCount)
+            return false;
+    }
+    return true;
+}
+
+const SpriteFrameIndex::Header* SpriteFrameIndex::getHeader() const
+{
+    return (const Header*)_bytes;
+}
+
+const SpriteFrameIndex::FrameEntry* SpriteFrameIndex::getFrames() const
+{
+    return (const FrameEntry*)(_bytes + sizeof(Header));
+}
+
+const SpriteFrameIndex::AliasEntry* SpriteFrameIndex::getAliases() const
+{
+    return (const AliasEntry*)(getFrames() + getHeader()->frameCount);
+}
+
+const unsigned int* SpriteFrameIndex::getBuckets() const
+{
+    return (const unsigned int*)(getAliases() + getHeader()->aliasCount);
+}
+
+const char* SpriteFrameIndex::getStrings() const
+{
+    return (const char*)(getBuckets() + getHeader()->bucketCount);
+}
+
+std::string SpriteFrameIndex::getTextureFileName() const
+{
+    auto header = getHeader();
+    return std::string(getStrings() + header->textureName, header->textureNameLength);
+}
+
+void SpriteFrameIndex::setTexture(Texture2D* texture)
+{
+    CC_SAFE_RETAIN(texture);
+    CC_SAFE_RELEASE(_texture);
+    _texture = texture;
+}
+
+int SpriteFrameIndex::getFrameCount() const
+{
+    return (int)getHeader()->frameCount;
+}
+
+std::string SpriteFrameIndex::getFrameName(int frame) const
+{
+    CCASSERT(frame >= 0 && frame < getFrameCount(), "Invalid frame");
+    const FrameEntry& entry = getFrames()[frame];
+    return std::string(getStrings() + entry.name, entry.nameLength);
+}
+
+int SpriteFrameIndex::findFrame(const std::string& name) const
+{
+    auto header = getHeader();
+    auto frames = getFrames();
+    auto aliases = getAliases();
+    auto buckets = getBuckets();
+    auto strings = getStrings();
+
+    uint32_t hash = hashName(name.data(), name.size());
+    uint32_t mask = header->bucketCount - 1;
+    for (uint32_t i = hash & mask; buckets[i] != 0; i = (i + 1) & mask)
+    {
+        uint32_t id = buckets[i] - 1;
+        uint32_t frame = id;
+        uint32_t offset, length;
+        if (id < header->frameCount)
+        {
+            if (frames[id].hash != hash)
+                continue;
+            offset = frames[id].name;
+            length = frames[id].nameLength;
+        }
+        else
+        {
+            const AliasEntry& alias = aliases[id - header->frameCount];
+            if (alias.hash != hash)
+                continue;
+            offset = alias.name;
+            length = alias.nameLength;
+            frame = alias.frame;
+        }
+
+        if (length == name.size() && memcmp(strings + offset, name.data(), length) == 0)
+        {
+            return _frameStates[frame] == FRAME_STATE_REMOVED ? -1 : (int)frame;
+        }
+    }
+    return -1;
+}
+
+SpriteFrame* SpriteFrameIndex::createSpriteFrame(int frame)
+{
+    CCASSERT(frame >= 0 && frame < getFrameCount(), "Invalid frame");
+    CCASSERT(_texture, "The texture of the index is not set");
+
+    const FrameEntry& entry = getFrames()[frame];
+    auto spriteFrame = SpriteFrame::createWithTexture(_texture,
+                                                      Rect(entry.rect[0], entry.rect[1], entry.rect[2], entry.rect[3]),
+                                                      (entry.flags & FRAME_ROTATED) != 0,
+                                                      Vec2(entry.offset[0], entry.offset[1]),
+                                                      Size(entry.originalSize[0], entry.originalSize[1]));
+    if (spriteFrame && (entry.flags & FRAME_NINE_PATCH))
+    {
+        _texture->addSpriteFrameCapInset(spriteFrame, Rect(entry.capInsets[0], entry.capInsets[1], entry.capInsets[2], entry.capInsets[3]));
+    }
+
+    if (_frameStates[frame] == FRAME_STATE_NONE)
+    {
+        _frameStates[frame] = FRAME_STATE_CREATED;
+        _createdFrames.push_back(frame);
+    }
+    return spriteFrame;
+}
+
+void SpriteFrameIndex::removeFrame(int frame)
+{
+    CCASSERT(frame >= 0 && frame < getFrameCount(), "Invalid frame");
+    _frameStates[frame] = FRAME_STATE_REMOVED;
+}
+
+NS_CC_END
@@ -0,0 +1,144 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_SPRITE_FRAME_INDEX_H__
+#define __CC_SPRITE_FRAME_INDEX_H__
+
+#include <string>
+#include <vector>
+
+#include "base/CCRef.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+class SpriteFrame;
+class Texture2D;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class SpriteFrameIndex
+ * @brief The frames of a sprite sheet in a binary file, created from its .plist by convertPlist().
+
+ The file is mapped in memory when the platform allows it, and is read at once otherwise. Nothing is
+ parsed when it is loaded: the frames are looked up in a hash table stored in the file, and a SpriteFrame
+ is only created when it is requested. The cap insets of the 9-patch frames are computed by the conversion.
+
+ SpriteFrameCache loads the files ending with SpriteFrameIndex::FILE_EXTENSION this way, it is the only
+ user of this class in general.
+ @since v3.9
+ */
+class CC_DLL SpriteFrameIndex : public Ref
+{
+public:
+    /** Extension of the index files, ".ccsf". */
+    static const char* FILE_EXTENSION;
+
+    /** Whether or not a file name ends with FILE_EXTENSION. */
+    static bool isIndexFile(const std::string& filename);
+
+    /** Writes the index of the sprite frames of a .plist.
+     * The plist formats supported by SpriteFrameCache are all supported. The texture file name of the
+     * metadata, if any, is stored as is and resolved relatively to the index file.
+     *
+     * @param plist The .plist file name.
+     * @param indexFile The full path of the index file to write.
+     * @return True if the index file is written.
+     */
+    static bool convertPlist(const std::string& plist, const std::string& indexFile);
+
+    /** Loads an index file, returns nullptr if the file can't be read or is not a valid index. */
+    static SpriteFrameIndex* createWithFile(const std::string& filename);
+
+    /** The file name the index was created with. */
+    const std::string& getFileName() const { return _fileName; }
+
+    /** The texture file name stored in the index, empty if the plist had none. */
+    std::string getTextureFileName() const;
+
+    /** The texture of the frames, set by SpriteFrameCache. It is retained. */
+    Texture2D* getTexture() const { return _texture; }
+    void setTexture(Texture2D* texture);
+
+    /** Number of frames, aliases excluded. */
+    int getFrameCount() const;
+    std::string getFrameName(int frame) const;
+
+    /** Returns the frame named name, or one of whose aliases is name, -1 if not found or removed. */
+    int findFrame(const std::string& name) const;
+
+    /** Creates the sprite frame of a frame with the texture of the index, and registers its cap
+     * insets if it is a 9-patch frame. The frame is then part of getCreatedFrames().
+     */
+    SpriteFrame* createSpriteFrame(int frame);
+
+    /** Frames created by createSpriteFrame(), in creation order. */
+    const std::vector<int>& getCreatedFrames() const { return _createdFrames; }
+
+    /** Makes findFrame() ignore a frame. */
+    void removeFrame(int frame);
+
+CC_CONSTRUCTOR_ACCESS:
+    SpriteFrameIndex();
+    virtual ~SpriteFrameIndex();
+
+    bool initWithFile(const std::string& filename);
+
+protected:
+    struct Header;
+    struct FrameEntry;
+    struct AliasEntry;
+
+    bool mapFile(const std::string& fullPath);
+    void unmapFile();
+    bool validate() const;
+
+    const Header* getHeader() const;
+    const FrameEntry* getFrames() const;
+    const AliasEntry* getAliases() const;
+    const unsigned int* getBuckets() const;
+    const char* getStrings() const;
+
+    std::string _fileName;
+    Texture2D* _texture;
+
+    // either mapped, or read in _data
+    const unsigned char* _bytes;
+    size_t _size;
+    void* _mapping;
+    Data _data;
+
+    std::vector<unsigned char> _frameStates;
+    std::vector<int> _createdFrames;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_SPRITE_FRAME_INDEX_H__
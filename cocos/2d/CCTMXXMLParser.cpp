@@ -30,15 +30,154 @@ THE SOFTWARE.
 #include <unordered_map>
 #include <sstream>
 #include "2d/CCTMXTiledMap.h"
-#include "base/ZipUtils.h"
-#include "base/base64.h"
 #include "base/CCDirector.h"
 #include "platform/CCFileUtils.h"
+#include "base/ccUtils.h"
+
+#include <zlib.h>
 
 using namespace std;
 
 NS_CC_BEGIN
 
+// the base64 tile data is decoded by chunks, straight into the tiles of the layer
+static const size_t TILE_DATA_CHUNK_SIZE = 16 * 1024;
+
+namespace {
+
+struct Base64Table
+{
+    signed char values[256];
+
+    Base64Table()
+    {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        memset(values, -1, sizeof(values));
+        for (int i = 0; i < 64; ++i)
+            values[(unsigned char)alphabet[i]] = (signed char)i;
+    }
+};
+
+const Base64Table s_base64Table;
+
+// decodes the base64 text by parts, the characters out of the alphabet are skipped like base64Decode() does
+class Base64Reader
+{
+public:
+    Base64Reader(const std::string& text)
+    : _text(text)
+    , _pos(0)
+    , _bits(0)
+    , _charCount(0)
+    , _ended(false)
+    {
+    }
+
+    bool isEnded() const { return _ended || _pos >= _text.size(); }
+
+    // decodes up to size bytes, size must be at least 3, returns the number of bytes written
+    size_t read(unsigned char* out, size_t size)
+    {
+        size_t written = 0;
+        size_t length = _text.size();
+        while (_pos < length && written + 3 <= size)
+        {
+            unsigned char c = (unsigned char)_text[_pos++];
+            if (c == '=')
+            {
+                if (_charCount == 2)
+                {
+                    out[written++] = (unsigned char)(_bits >> 4);
+                }
+                else if (_charCount == 3)
+                {
+                    out[written++] = (unsigned char)(_bits >> 10);
+                    out[written++] = (unsigned char)((_bits >> 2) & 0xff);
+                }
+                _ended = true;
+                break;
+            }
+
+            int value = s_base64Table.values[c];
+            if (value < 0)
+                continue;
+
+            _bits = (_bits << 6) | (unsigned int)value;
+            if (++_charCount == 4)
+            {
+                out[written++] = (unsigned char)(_bits >> 16);
+                out[written++] = (unsigned char)((_bits >> 8) & 0xff);
+                out[written++] = (unsigned char)(_bits & 0xff);
+                _bits = 0;
+                _charCount = 0;
+            }
+        }
+        return written;
+    }
+
+private:
+    const std::string& _text;
+    size_t _pos;
+    unsigned int _bits;
+    int _charCount;
+    bool _ended;
+};
+
+// base64 -> tiles
+bool decodeTiles(const std::string& text, unsigned char* tiles, size_t size)
+{
+    Base64Reader reader(text);
+    size_t written = 0;
+    unsigned char tail[3];
+    while (!reader.isEnded() && written + 3 <= size)
+        written += reader.read(tiles + written, size - written);
+
+    // the last bytes of a buffer whose size isn't a multiple of 3
+    while (!reader.isEnded() && written < size)
+    {
+        size_t count = std::min(reader.read(tail, sizeof(tail)), size - written);
+        memcpy(tiles + written, tail, count);
+        written += count;
+    }
+    return written == size;
+}
+
+// base64 -> zlib or gzip -> tiles
+bool inflateTiles(const std::string& text, unsigned char* tiles, size_t size)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // 15 + 32: zlib or gzip header, detected by zlib
+    if (inflateInit2(&stream, 15 + 32) != Z_OK)
+        return false;
+
+    unsigned char chunk[TILE_DATA_CHUNK_SIZE];
+    Base64Reader reader(text);
+    stream.next_out = tiles;
+    stream.avail_out = static_cast<unsigned int>(size);
+
+    int err = Z_OK;
+    while (err == Z_OK)
+    {
+        if (stream.avail_in == 0)
+        {
+            if (reader.isEnded())
+                break;
+            stream.next_in = chunk;
+            stream.avail_in = static_cast<unsigned int>(reader.read(chunk, sizeof(chunk)));
+        }
+        err = inflate(&stream, Z_NO_FLUSH);
+        if (err == Z_BUF_ERROR && stream.avail_out > 0 && stream.avail_in == 0)
+            err = Z_OK;
+    }
+    inflateEnd(&stream);
+
+    // the tiles are filled either way, a data size which doesn't match the layer is only reported
+    return err == Z_STREAM_END && stream.avail_out == 0;
+}
+
+} // namespace
+
 // implementation TMXLayerInfo
 TMXLayerInfo::TMXLayerInfo()
 : _name("")
@@ -191,7 +330,9 @@ bool TMXMapInfo::parseXMLString(const std::string& xmlString)
 
     parser.setDelegator(this);
 
-    return parser.parse(xmlString.c_str(), len);
+    bool ret = parser.parse(xmlString.c_str(), len);
+    decodeLayerTiles();
+    return ret;
 }
 
 bool TMXMapInfo::parseXMLFile(const std::string& xmlFilename)
@@ -205,7 +346,39 @@ bool TMXMapInfo::parseXMLFile(const std::string& xmlFilename)
     
     parser.setDelegator(this);
 
-    return parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
+    bool ret = parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
+    decodeLayerTiles();
+    return ret;
+}
+
+void TMXMapInfo::decodeLayerTiles()
+{
+    if (_layerTileData.empty())
+        return;
+
+    // every layer is decoded into its own tiles, on its own thread
+    utils::parallelFor(_layerTileData.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto& data = _layerTileData[i];
+            Size layerSize = data.layer->_layerSize;
+            size_t size = (size_t)(layerSize.width * layerSize.height) * sizeof(uint32_t);
+            // zeroed, as empty tiles, in case the data is short
+            unsigned char* tiles = (unsigned char*)calloc(size, 1);
+            if (tiles)
+                data.decoded = data.compressed ? inflateTiles(data.text, tiles, size) : decodeTiles(data.text, tiles, size);
+
+            data.layer->_tiles = reinterpret_cast<uint32_t*>(tiles);
+            std::string().swap(data.text);
+        }
+    });
+
+    for (const auto& data : _layerTileData)
+    {
+        if (!data.decoded)
+            CCLOG("cocos2d: TiledMap: decode data error in layer %s", data.layer->_name.c_str());
+    }
+    _layerTileData.clear();
 }
 
 // the XML parser calls here with all the elements
@@ -628,45 +801,15 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
         if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBase64)
         {
             tmxMapInfo->setStoringCharacters(false);
-            
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            
-            std::string currentString = tmxMapInfo->getCurrentString();
-            unsigned char *buffer;
-            auto len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
-            if (!buffer)
-            {
-                CCLOG("cocos2d: TiledMap: decode data error");
-                return;
-            }
-            
-            if (tmxMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib))
-            {
-                unsigned char *deflated = nullptr;
-                Size s = layer->_layerSize;
-                // int sizeHint = s.width * s.height * sizeof(uint32_t);
-                ssize_t sizeHint = s.width * s.height * sizeof(unsigned int);
-                
-                ssize_t CC_UNUSED inflatedLen = ZipUtils::inflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-                CCASSERT(inflatedLen == sizeHint, "inflatedLen should be equal to sizeHint!");
-                
-                free(buffer);
-                buffer = nullptr;
-                
-                if (!deflated)
-                {
-                    CCLOG("cocos2d: TiledMap: inflate data error");
-                    return;
-                }
-                
-                layer->_tiles = reinterpret_cast<uint32_t*>(deflated);
-            }
-            else
-            {
-                layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
-            }
-            
-            tmxMapInfo->setCurrentString("");
+
+            // decoded by decodeLayerTiles() once the whole file is parsed, with the other layers
+            LayerTileData data;
+            data.layer = tmxMapInfo->getLayers().back();
+            data.compressed = (tmxMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib)) != 0;
+            data.decoded = false;
+            _layerTileData.push_back(std::move(data));
+            _layerTileData.back().text.swap(_currentString);
+            _currentString.clear();
         }
         else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribNone)
         {
@@ -703,13 +846,10 @@ void TMXMapInfo::textHandler(void *ctx, const char *ch, int len)
 {
     CC_UNUSED_PARAM(ctx);
     TMXMapInfo *tmxMapInfo = this;
-    std::string text(ch, 0, len);
 
     if (tmxMapInfo->isStoringCharacters())
     {
-        std::string currentString = tmxMapInfo->getCurrentString();
-        currentString += text;
-        tmxMapInfo->setCurrentString(currentString.c_str());
+        _currentString.append(ch, len);
     }
 }
 
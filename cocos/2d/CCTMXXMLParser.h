@@ -282,6 +282,16 @@ public:
 
 protected:
     void internalInit(const std::string& tmxFileName, const std::string& resourcePath);
+    /** Decodes the base64 tile data of the layers read by the last parse, straight into their tiles, one layer by thread. */
+    void decodeLayerTiles();
+
+    struct LayerTileData
+    {
+        TMXLayerInfo* layer;
+        std::string text;
+        bool compressed;
+        bool decoded;
+    };
 
     /// map orientation
     int    _orientation;
@@ -314,6 +324,8 @@ protected:
     std::string _resources;
     //! current string
     std::string _currentString;
+    //! base64 tile data of the layers, waiting for decodeLayerTiles()
+    std::vector<LayerTileData> _layerTileData;
     //! tile properties
     ValueMapIntKey _tileProperties;
     int _currentFirstGID;
@@ -36,6 +36,7 @@ USING_NS_CC;
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderState.h"
+#include "renderer/CCRenderThread.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "2d/CCCamera.h"
@@ -476,6 +477,7 @@ void Terrain::setIsEnableFrustumCull(bool bool_value)
 
 Terrain::~Terrain()
 {
+    ScopedGLContext context;
     CC_SAFE_RELEASE(_stateBlock);
     CC_SAFE_RELEASE(_alphaMap);
     CC_SAFE_RELEASE(_lightMap);
@@ -501,12 +503,12 @@ Terrain::~Terrain()
 
     for(size_t i =0;i<_chunkLodIndicesSet.size();i++)
     {
-        glDeleteBuffers(1,&(_chunkLodIndicesSet[i]._chunkIndices._indices));
+        GL::deleteBuffers(1,&(_chunkLodIndicesSet[i]._chunkIndices._indices));
     }
 
     for(size_t i =0;i<_chunkLodIndicesSkirtSet.size();i++)
     {
-        glDeleteBuffers(1,&(_chunkLodIndicesSkirtSet[i]._chunkIndices._indices));
+        GL::deleteBuffers(1,&(_chunkLodIndicesSkirtSet[i]._chunkIndices._indices));
     }
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -749,8 +751,9 @@ Terrain::ChunkIndices Terrain::insertIndicesLOD(int neighborLod[4], int selfLod,
     memcpy(lodIndices._relativeLod,neighborLod,sizeof(int [4]));
     lodIndices._relativeLod[4] = selfLod;
     lodIndices._chunkIndices._size = size;
+    ScopedGLContext context;
     glGenBuffers(1,&(lodIndices._chunkIndices._indices));
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lodIndices._chunkIndices._indices);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, lodIndices._chunkIndices._indices);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,sizeof(GLushort)*size,indices,GL_STATIC_DRAW);
     this->_chunkLodIndicesSet.push_back(lodIndices);
     return lodIndices._chunkIndices;
@@ -784,8 +787,9 @@ Terrain::ChunkIndices Terrain::insertIndicesLODSkirt(int selfLod, GLushort * ind
     ChunkLODIndicesSkirt skirtIndices;
     skirtIndices._selfLod = selfLod;
     skirtIndices._chunkIndices._size = size;
+    ScopedGLContext context;
     glGenBuffers(1,&(skirtIndices._chunkIndices._indices));
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skirtIndices._chunkIndices._indices);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, skirtIndices._chunkIndices._indices);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,sizeof(GLushort)*size,indices,GL_STATIC_DRAW);
     this->_chunkLodIndicesSkirtSet.push_back(skirtIndices);
     return skirtIndices._chunkIndices;
@@ -814,6 +818,7 @@ void Terrain::onEnter()
 
 void Terrain::cacheUniformAttribLocation()
 {
+    ScopedGLContext context;
 
     _positionLocation = glGetAttribLocation(this->getGLProgram()->getProgram(),"a_position");
     _texcordLocation = glGetAttribLocation(this->getGLProgram()->getProgram(),"a_texCoord");
@@ -926,13 +931,14 @@ void Terrain::Chunk::finish()
 {
     //genearate two VBO ,the first for vertices, we just setup datas once ,won't changed at all
     //the second vbo for the indices, because we use level of detail technique to each chunk, so we will modified frequently 
+    ScopedGLContext context;
     glGenBuffers(1,&_vbo);
 
     //only set for vertices vbo
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(TerrainVertexData)*_originalVertices.size(), &_originalVertices[0], GL_STREAM_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER,0);
+    GL::bindBuffer(GL_ARRAY_BUFFER,0);
 
     calculateSlope();
 
@@ -949,7 +955,7 @@ void Terrain::Chunk::finish()
 
 void Terrain::Chunk::bindAndDraw()
 {
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     if(_terrain->_isCameraViewChanged || _oldLod <0)
     {
         switch (_terrain->_crackFixedType)
@@ -966,7 +972,7 @@ void Terrain::Chunk::bindAndDraw()
             break;
         }
     }
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,_chunkIndices._indices);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER,_chunkIndices._indices);
     unsigned long offset = 0;
     //position
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertexData), (GLvoid *)offset);
@@ -1385,7 +1391,8 @@ void Terrain::Chunk::updateVerticesForLOD()
 
 Terrain::Chunk::~Chunk()
 {
-    glDeleteBuffers(1,&_vbo);
+    ScopedGLContext context;
+    GL::deleteBuffers(1,&_vbo);
 }
 
 void Terrain::Chunk::updateIndicesLODSkirt()
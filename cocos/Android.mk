@@ -78,6 +78,7 @@ cocos2d.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
+2d/CCSpriteFrameIndex.cpp \
 2d/CCTMXLayer.cpp \
 2d/CCTMXObjectGroup.cpp \
 2d/CCTMXTiledMap.cpp \
@@ -92,6 +93,7 @@ cocos2d.cpp \
 3d/CCFrustum.cpp \
 3d/CCPlane.cpp \
 platform/CCFileUtils.cpp \
+platform/CCFilePackage.cpp \
 platform/CCGLView.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
@@ -179,6 +181,7 @@ renderer/CCQuadCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderState.cpp \
 renderer/CCRenderer.cpp \
+renderer/CCRenderThread.cpp \
 renderer/CCTechnique.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
@@ -228,6 +231,7 @@ physics3d/CCPhysics3DConstraint.cpp \
 #navmesh/CCNavMeshAgent.cpp \
 #navmesh/CCNavMeshDebugDraw.cpp \
 #navmesh/CCNavMeshObstacle.cpp \
+#navmesh/CCNavMeshPathService.cpp \
 #navmesh/CCNavMeshUtils.cpp \
 
 
@@ -0,0 +1,297 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "AudioDecoder.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <mutex>
+
+#include "fmod.hpp"
+#include "fmod_errors.h"
+#include "platform/CCFileUtils.h"
+
+namespace CocosDenshion {
+
+static const size_t DECODE_ALL_FRAMES = 16384;
+
+// the 8 bits PCM are unsigned
+static void convertPcm8(const uint8_t* in, int16_t* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        out[i] = (int16_t)((in[i] - 128) << 8);
+}
+
+static void convertPcmFloat(const float* in, int16_t* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        float value = in[i] * 32767.0f;
+        out[i] = (int16_t)(value > 32767.0f ? 32767.0f : (value < -32768.0f ? -32768.0f : value));
+    }
+}
+
+class WavDecoder : public AudioDecoder
+{
+public:
+    WavDecoder() : _file(nullptr), _bytesPerSample(0), _dataOffset(0), _frame(0) {}
+
+    ~WavDecoder()
+    {
+        if (_file)
+            fclose(_file);
+    }
+
+    bool open(const std::string& fullPath)
+    {
+        _file = fopen(cocos2d::FileUtils::getInstance()->getSuitableFOpen(fullPath).c_str(), "rb");
+        if (!_file)
+            return false;
+
+        unsigned char header[12];
+        if (fread(header, 1, 12, _file) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+            return false;
+
+        // the chunks are walked until the data, the format must come before it
+        bool hasFormat = false;
+        unsigned char chunk[8];
+        while (fread(chunk, 1, 8, _file) == 8)
+        {
+            uint32_t size = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | ((uint32_t)chunk[7] << 24);
+            if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+            {
+                unsigned char format[16];
+                if (fread(format, 1, 16, _file) != 16)
+                    return false;
+                int audioFormat = format[0] | (format[1] << 8);
+                _channels = format[2] | (format[3] << 8);
+                _sampleRate = format[4] | (format[5] << 8) | (format[6] << 16) | (format[7] << 24);
+                _bytesPerSample = (format[14] | (format[15] << 8)) / 8;
+                // WAVE_FORMAT_PCM or WAVE_FORMAT_EXTENSIBLE
+                if ((audioFormat != 1 && audioFormat != 0xFFFE) || (_bytesPerSample != 1 && _bytesPerSample != 2) || _channels <= 0)
+                    return false;
+                hasFormat = true;
+                fseek(_file, size - 16 + (size & 1), SEEK_CUR);
+            }
+            else if (memcmp(chunk, "data", 4) == 0)
+            {
+                if (!hasFormat)
+                    return false;
+                _dataOffset = ftell(_file);
+                _frameCount = size / (_bytesPerSample * _channels);
+                return true;
+            }
+            else
+            {
+                fseek(_file, size + (size & 1), SEEK_CUR);
+            }
+        }
+        return false;
+    }
+
+    size_t read(int16_t* samples, size_t frames) override
+    {
+        frames = std::min(frames, _frameCount - _frame);
+        size_t count = frames * _channels;
+        size_t read;
+        if (_bytesPerSample == 2)
+        {
+            read = fread(samples, sizeof(int16_t), count, _file);
+        }
+        else
+        {
+            // converted in place, from the end
+            uint8_t* bytes = (uint8_t*)samples + count;
+            read = fread(bytes, 1, count, _file);
+            convertPcm8(bytes, samples, read);
+        }
+        frames = read / _channels;
+        _frame += frames;
+        return frames;
+    }
+
+    bool seek(size_t frame) override
+    {
+        _frame = std::min(frame, _frameCount);
+        return fseek(_file, _dataOffset + (long)(_frame * _bytesPerSample * _channels), SEEK_SET) == 0;
+    }
+
+private:
+    FILE* _file;
+    int _bytesPerSample;
+    long _dataOffset;
+    size_t _frame;
+};
+
+// the sounds are only opened by this system, they are never played
+static FMOD::System* getDecodeSystem()
+{
+    static std::mutex s_mutex;
+    static FMOD::System* s_system = nullptr;
+    static bool s_initialized = false;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_initialized)
+    {
+        s_initialized = true;
+        if (FMOD::System_Create(&s_system) != FMOD_OK)
+            return s_system = nullptr;
+        if (s_system->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT) != FMOD_OK || s_system->init(1, FMOD_INIT_NORMAL, 0) != FMOD_OK)
+        {
+            s_system->release();
+            s_system = nullptr;
+        }
+    }
+    return s_system;
+}
+
+class FmodDecoder : public AudioDecoder
+{
+public:
+    FmodDecoder() : _sound(nullptr), _format(FMOD_SOUND_FORMAT_NONE) {}
+
+    ~FmodDecoder()
+    {
+        if (_sound)
+            _sound->release();
+    }
+
+    bool open(const std::string& fullPath)
+    {
+        FMOD::System* system = getDecodeSystem();
+        if (!system)
+            return false;
+
+        FMOD_RESULT result = system->createSound(fullPath.c_str(), FMOD_OPENONLY | FMOD_ACCURATETIME, 0, &_sound);
+        if (result != FMOD_OK)
+        {
+            printf("AudioDecoder: can't open %s: %s\n", fullPath.c_str(), FMOD_ErrorString(result));
+            _sound = nullptr;
+            return false;
+        }
+
+        int bits = 0;
+        float frequency = 0;
+        unsigned int length = 0;
+        if (_sound->getFormat(nullptr, &_format, &_channels, &bits) != FMOD_OK
+            || _sound->getDefaults(&frequency, nullptr, nullptr, nullptr) != FMOD_OK
+            || _channels <= 0)
+            return false;
+        if (_format != FMOD_SOUND_FORMAT_PCM16 && _format != FMOD_SOUND_FORMAT_PCM8 && _format != FMOD_SOUND_FORMAT_PCMFLOAT)
+            return false;
+
+        _sampleRate = (int)frequency;
+        if (_sound->getLength(&length, FMOD_TIMEUNIT_PCM) == FMOD_OK)
+            _frameCount = length;
+        return true;
+    }
+
+    size_t read(int16_t* samples, size_t frames) override
+    {
+        size_t count = frames * _channels;
+        unsigned int read = 0;
+        FMOD_RESULT result;
+        switch (_format)
+        {
+            case FMOD_SOUND_FORMAT_PCM16:
+                result = _sound->readData(samples, (unsigned int)(count * sizeof(int16_t)), &read);
+                read /= sizeof(int16_t);
+                break;
+            case FMOD_SOUND_FORMAT_PCM8:
+            {
+                uint8_t* bytes = (uint8_t*)samples + count;
+                result = _sound->readData(bytes, (unsigned int)count, &read);
+                convertPcm8(bytes, samples, read);
+                break;
+            }
+            default:
+            {
+                _floats.resize(count);
+                result = _sound->readData(_floats.data(), (unsigned int)(count * sizeof(float)), &read);
+                read /= sizeof(float);
+                convertPcmFloat(_floats.data(), samples, read);
+                break;
+            }
+        }
+        if (result != FMOD_OK && result != FMOD_ERR_FILE_EOF)
+            return 0;
+        return read / _channels;
+    }
+
+    bool seek(size_t frame) override
+    {
+        return _sound->seekData((unsigned int)frame) == FMOD_OK;
+    }
+
+private:
+    FMOD::Sound* _sound;
+    FMOD_SOUND_FORMAT _format;
+    std::vector<float> _floats;
+};
+
+AudioDecoder* AudioDecoder::open(const std::string& fullPath)
+{
+    // the wav files of other formats go to FMOD
+    WavDecoder* wav = new (std::nothrow) WavDecoder();
+    if (wav && wav->open(fullPath))
+        return wav;
+    delete wav;
+
+    FmodDecoder* decoder = new (std::nothrow) FmodDecoder();
+    if (decoder && decoder->open(fullPath))
+        return decoder;
+    delete decoder;
+    return nullptr;
+}
+
+bool AudioDecoder::decodeAll(const std::string& fullPath, AudioPcm& pcm)
+{
+    AudioDecoder* decoder = open(fullPath);
+    if (!decoder)
+        return false;
+
+    pcm.channels = decoder->getChannels();
+    pcm.sampleRate = decoder->getSampleRate();
+    pcm.samples.clear();
+
+    size_t frames = 0;
+    size_t chunkFrames = decoder->getFrameCount() > 0 ? decoder->getFrameCount() : DECODE_ALL_FRAMES;
+    while (true)
+    {
+        pcm.samples.resize((frames + chunkFrames) * pcm.channels);
+        size_t read = decoder->read(pcm.samples.data() + frames * pcm.channels, chunkFrames);
+        frames += read;
+        if (read == 0)
+            break;
+        chunkFrames = DECODE_ALL_FRAMES;
+    }
+    pcm.samples.resize(frames * pcm.channels);
+    pcm.samples.shrink_to_fit();
+
+    delete decoder;
+    return frames > 0;
+}
+
+} // namespace CocosDenshion
@@ -0,0 +1,87 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __AUDIO_DECODER_H_
+#define __AUDIO_DECODER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace CocosDenshion {
+
+/** Decoded clip, as interleaved 16 bits samples. */
+struct AudioPcm
+{
+    int channels;
+    int sampleRate;
+    std::vector<int16_t> samples;
+
+    AudioPcm() : channels(0), sampleRate(0) {}
+
+    size_t getFrameCount() const { return channels > 0 ? samples.size() / channels : 0; }
+    size_t getByteSize() const { return samples.size() * sizeof(int16_t); }
+};
+
+/** @brief AudioDecoder: decodes an audio file to 16 bits samples, by chunks of any size.
+
+ It isn't tied to the mixer playing the samples: the wav files of 8 or 16 bits PCM are read directly,
+ and the other formats are decoded by the codecs of FMOD, on an FMOD system without output.
+ A decoder is used by one thread at a time.
+ @since v3.9
+ */
+class AudioDecoder
+{
+public:
+    /** Opens the file at a full path, returns nullptr if it can't be decoded. The caller deletes it. */
+    static AudioDecoder* open(const std::string& fullPath);
+
+    /** Decodes the whole file at once. */
+    static bool decodeAll(const std::string& fullPath, AudioPcm& pcm);
+
+    virtual ~AudioDecoder() {}
+
+    int getChannels() const { return _channels; }
+    int getSampleRate() const { return _sampleRate; }
+
+    /** Number of frames of the file, 0 if the codec can't tell it. */
+    size_t getFrameCount() const { return _frameCount; }
+
+    /** Decodes up to frames frames into samples, returns the number of frames decoded, 0 at the end of the file. */
+    virtual size_t read(int16_t* samples, size_t frames) = 0;
+
+    /** Moves to a frame, the next read() decodes from there. */
+    virtual bool seek(size_t frame) = 0;
+
+protected:
+    AudioDecoder() : _channels(0), _sampleRate(0), _frameCount(0) {}
+
+    int _channels;
+    int _sampleRate;
+    size_t _frameCount;
+};
+
+} // namespace CocosDenshion
+
+#endif // __AUDIO_DECODER_H_
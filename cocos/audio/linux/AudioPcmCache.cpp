@@ -0,0 +1,138 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "AudioPcmCache.h"
+
+namespace CocosDenshion {
+
+static const size_t DEFAULT_BUDGET = 16 * 1024 * 1024;
+static const size_t DEFAULT_MAX_CLIP_SIZE = 2 * 1024 * 1024;
+
+AudioPcmCache* AudioPcmCache::getInstance()
+{
+    static AudioPcmCache s_cache;
+    return &s_cache;
+}
+
+AudioPcmCache::AudioPcmCache()
+: _budget(DEFAULT_BUDGET)
+, _maxClipSize(DEFAULT_MAX_CLIP_SIZE)
+, _size(0)
+, _hits(0)
+, _misses(0)
+{
+}
+
+std::shared_ptr<const AudioPcm> AudioPcmCache::get(const std::string& fullPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _clipMap.find(fullPath);
+        if (iter != _clipMap.end())
+        {
+            ++_hits;
+            _clips.splice(_clips.begin(), _clips, iter->second);
+            return iter->second->second;
+        }
+        ++_misses;
+    }
+
+    // decoded without the lock, another thread may decode the same clip meanwhile
+    auto pcm = std::make_shared<AudioPcm>();
+    if (!AudioDecoder::decodeAll(fullPath, *pcm))
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (pcm->getByteSize() > _maxClipSize || _clipMap.find(fullPath) != _clipMap.end())
+        return pcm;
+
+    _clips.push_front(std::make_pair(fullPath, pcm));
+    _clipMap[fullPath] = _clips.begin();
+    _size += pcm->getByteSize();
+    trim();
+    return pcm;
+}
+
+void AudioPcmCache::remove(const std::string& fullPath)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _clipMap.find(fullPath);
+    if (iter == _clipMap.end())
+        return;
+
+    _size -= iter->second->second->getByteSize();
+    _clips.erase(iter->second);
+    _clipMap.erase(iter);
+}
+
+void AudioPcmCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _clips.clear();
+    _clipMap.clear();
+    _size = 0;
+}
+
+void AudioPcmCache::setBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _budget = bytes;
+    trim();
+}
+
+size_t AudioPcmCache::getBudget() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _budget;
+}
+
+void AudioPcmCache::setMaxClipSize(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxClipSize = bytes;
+}
+
+size_t AudioPcmCache::getMaxClipSize() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxClipSize;
+}
+
+size_t AudioPcmCache::getSize() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+void AudioPcmCache::trim()
+{
+    while (_size > _budget && !_clips.empty())
+    {
+        _size -= _clips.back().second->getByteSize();
+        _clipMap.erase(_clips.back().first);
+        _clips.pop_back();
+    }
+}
+
+} // namespace CocosDenshion
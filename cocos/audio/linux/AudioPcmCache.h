@@ -0,0 +1,91 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __AUDIO_PCM_CACHE_H_
+#define __AUDIO_PCM_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "AudioDecoder.h"
+
+namespace CocosDenshion {
+
+/** @brief AudioPcmCache: keeps the decoded short clips, so that they are decoded once however often they are played.
+
+ The least recently used clips are dropped when the cache goes over its budget. A clip bigger than
+ the maximum clip size isn't kept, it should be streamed with AudioStream instead.
+ The clips handed out stay valid when they are dropped, until they are released.
+ @since v3.9
+ */
+class AudioPcmCache
+{
+public:
+    static AudioPcmCache* getInstance();
+
+    AudioPcmCache();
+
+    /** Returns the decoded clip of a full path, decoding it if it isn't cached. nullptr if it can't be decoded. */
+    std::shared_ptr<const AudioPcm> get(const std::string& fullPath);
+
+    void remove(const std::string& fullPath);
+    void clear();
+
+    /** Bytes of decoded samples kept at most, 16MB by default. */
+    void setBudget(size_t bytes);
+    size_t getBudget() const;
+
+    /** Bytes of decoded samples of a clip kept at most, 2MB by default. */
+    void setMaxClipSize(size_t bytes);
+    size_t getMaxClipSize() const;
+
+    /** Bytes of decoded samples kept. */
+    size_t getSize() const;
+
+    /** Number of clips found in the cache and decoded, since the creation. */
+    unsigned int getHits() const { return _hits; }
+    unsigned int getMisses() const { return _misses; }
+
+protected:
+    typedef std::list<std::pair<std::string, std::shared_ptr<const AudioPcm>>> ClipList;
+
+    void trim();
+
+    mutable std::mutex _mutex;
+    ClipList _clips;
+    std::unordered_map<std::string, ClipList::iterator> _clipMap;
+    size_t _budget;
+    size_t _maxClipSize;
+    size_t _size;
+    std::atomic<unsigned int> _hits;
+    std::atomic<unsigned int> _misses;
+};
+
+} // namespace CocosDenshion
+
+#endif // __AUDIO_PCM_CACHE_H_
@@ -0,0 +1,247 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "AudioStream.h"
+
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+
+namespace CocosDenshion {
+
+// decodes the chunks of all the streams on one thread, a chunk of each stream in turn
+class AudioStreamDecoder
+{
+public:
+    static AudioStreamDecoder* getInstance()
+    {
+        // never deleted, the thread may outlive the static objects at exit
+        static AudioStreamDecoder* s_instance = new AudioStreamDecoder();
+        return s_instance;
+    }
+
+    void add(AudioStream* stream)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _streams.push_back(stream);
+        _wakeUp = true;
+        _condition.notify_one();
+    }
+
+    // once it returns, the stream isn't decoded anymore
+    void remove(AudioStream* stream)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _streams.erase(std::remove(_streams.begin(), _streams.end(), stream), _streams.end());
+        std::lock_guard<std::mutex> streamLock(stream->_decodeMutex);
+    }
+
+    void wakeUp()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _wakeUp = true;
+        _condition.notify_one();
+    }
+
+private:
+    AudioStreamDecoder()
+    : _wakeUp(false)
+    {
+        std::thread(&AudioStreamDecoder::loop, this).detach();
+    }
+
+    void loop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            bool decoded = false;
+            for (size_t i = 0; i < _streams.size(); ++i)
+            {
+                AudioStream* stream = _streams[i];
+                std::unique_lock<std::mutex> streamLock(stream->_decodeMutex);
+                if (!stream->needsChunk())
+                    continue;
+
+                // the stream can't be removed while its chunk is decoded, the others can
+                lock.unlock();
+                stream->decodeChunk();
+                streamLock.unlock();
+                lock.lock();
+                decoded = true;
+            }
+
+            if (!decoded)
+            {
+                _condition.wait(lock, [this]{ return _wakeUp; });
+                _wakeUp = false;
+            }
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<AudioStream*> _streams;
+    bool _wakeUp;
+};
+
+AudioStream* AudioStream::create(const std::string& fullPath, bool loop/* = false*/)
+{
+    AudioDecoder* decoder = AudioDecoder::open(fullPath);
+    if (!decoder)
+        return nullptr;
+
+    AudioStream* stream = new (std::nothrow) AudioStream(decoder, loop);
+    if (!stream)
+    {
+        delete decoder;
+        return nullptr;
+    }
+    stream->decodeChunk();
+    AudioStreamDecoder::getInstance()->add(stream);
+    return stream;
+}
+
+AudioStream::AudioStream(AudioDecoder* decoder, bool loop)
+: _decoder(decoder)
+, _loop(loop)
+, _frameCount(decoder->getFrameCount())
+, _decodedChunks(0)
+, _readChunks(0)
+, _decodeEnded(false)
+, _readOffset(0)
+, _readFrame(0)
+, _underruns(0)
+{
+    for (unsigned int i = 0; i < CHUNK_COUNT; ++i)
+    {
+        _chunks[i].resize(CHUNK_FRAMES * decoder->getChannels());
+        _chunkFrames[i] = 0;
+    }
+}
+
+AudioStream::~AudioStream()
+{
+    AudioStreamDecoder::getInstance()->remove(this);
+    delete _decoder;
+}
+
+bool AudioStream::needsChunk() const
+{
+    return !_decodeEnded && _decodedChunks - _readChunks < CHUNK_COUNT;
+}
+
+void AudioStream::decodeChunk()
+{
+    unsigned int index = _decodedChunks % CHUNK_COUNT;
+    int channels = _decoder->getChannels();
+    int16_t* samples = _chunks[index].data();
+
+    size_t frames = 0;
+    bool rewound = false;
+    while (frames < CHUNK_FRAMES)
+    {
+        size_t read = _decoder->read(samples + frames * channels, CHUNK_FRAMES - frames);
+        if (read > 0)
+        {
+            frames += read;
+            rewound = false;
+        }
+        // an empty clip doesn't loop
+        else if (_loop && !rewound && _decoder->seek(0))
+        {
+            rewound = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // the chunk is published before the end, so that the reader never sees the end first
+    _chunkFrames[index] = frames;
+    if (frames > 0)
+        _decodedChunks.fetch_add(1, std::memory_order_release);
+    if (frames < CHUNK_FRAMES)
+        _decodeEnded = true;
+}
+
+size_t AudioStream::read(int16_t* samples, size_t frames)
+{
+    int channels = _decoder->getChannels();
+    size_t done = 0;
+    bool consumed = false;
+    while (done < frames)
+    {
+        unsigned int readChunks = _readChunks.load(std::memory_order_relaxed);
+        if (readChunks == _decodedChunks.load(std::memory_order_acquire))
+            break;
+
+        unsigned int index = readChunks % CHUNK_COUNT;
+        size_t count = std::min(_chunkFrames[index] - _readOffset, frames - done);
+        memcpy(samples + done * channels, _chunks[index].data() + _readOffset * channels, count * channels * sizeof(int16_t));
+        done += count;
+        _readOffset += count;
+
+        if (_readOffset == _chunkFrames[index])
+        {
+            _readOffset = 0;
+            _readChunks.store(readChunks + 1, std::memory_order_release);
+            consumed = true;
+        }
+    }
+
+    _readFrame += done;
+    if (_frameCount > 0)
+        _readFrame %= _frameCount;
+
+    if (consumed)
+        AudioStreamDecoder::getInstance()->wakeUp();
+    if (done < frames && !isEnded())
+        ++_underruns;
+    return done;
+}
+
+void AudioStream::seek(size_t frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(_decodeMutex);
+        _decoder->seek(frame);
+        _decodedChunks = 0;
+        _readChunks = 0;
+        _readOffset = 0;
+        _decodeEnded = false;
+    }
+    _readFrame = frame;
+    // not woken up with the lock of the stream, the decoding thread takes it after its own
+    AudioStreamDecoder::getInstance()->wakeUp();
+}
+
+bool AudioStream::isEnded() const
+{
+    return _decodeEnded && _readChunks == _decodedChunks;
+}
+
+} // namespace CocosDenshion
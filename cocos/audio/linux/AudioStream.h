@@ -0,0 +1,108 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __AUDIO_STREAM_H_
+#define __AUDIO_STREAM_H_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AudioDecoder.h"
+
+namespace CocosDenshion {
+
+/** @brief AudioStream: plays a long clip without decoding it whole.
+
+ The clip is decoded by chunks of CHUNK_FRAMES frames on a background thread shared by all the streams,
+ which keeps CHUNK_COUNT chunks ahead of the reader, so a stream holds a fixed amount of memory
+ whatever the length of the clip. The first chunk is decoded by create(), so that the stream can be read at once.
+ read() never waits for the decoder: it returns what is decoded, and counts an underrun when it is short.
+ A stream is read by one thread at a time.
+ @since v3.9
+ */
+class AudioStream
+{
+public:
+    static const size_t CHUNK_FRAMES = 8192;
+    static const unsigned int CHUNK_COUNT = 4;
+
+    /** Opens the file at a full path, returns nullptr if it can't be decoded. The caller deletes it. */
+    static AudioStream* create(const std::string& fullPath, bool loop = false);
+
+    /** Waits for the decoding of its chunk, if the background thread is on it. */
+    ~AudioStream();
+
+    int getChannels() const { return _decoder->getChannels(); }
+    int getSampleRate() const { return _decoder->getSampleRate(); }
+
+    /** Number of frames of the clip, 0 if the codec can't tell it. */
+    size_t getFrameCount() const { return _frameCount; }
+
+    /** Copies up to frames decoded frames into samples, returns the number of frames copied, 0 at the end of the clip. */
+    size_t read(int16_t* samples, size_t frames);
+
+    /** Restarts the decoding from a frame, the decoded chunks are dropped. */
+    void seek(size_t frame);
+
+    /** Frame of the clip the next read() starts from, back to 0 when a looping stream wraps around. */
+    size_t getPosition() const { return _readFrame; }
+
+    /** Whether every frame of the clip is read, never for a looping stream. */
+    bool isEnded() const;
+
+    /** Number of read() calls which got fewer frames than asked before the end of the clip. */
+    unsigned int getUnderruns() const { return _underruns; }
+
+protected:
+    friend class AudioStreamDecoder;
+
+    AudioStream(AudioDecoder* decoder, bool loop);
+
+    // called by the decoding thread with _decodeMutex locked
+    bool needsChunk() const;
+    void decodeChunk();
+
+    AudioDecoder* _decoder;
+    bool _loop;
+    size_t _frameCount;
+
+    std::vector<int16_t> _chunks[CHUNK_COUNT];
+    size_t _chunkFrames[CHUNK_COUNT];
+
+    // chunks decoded and read since the last seek, the decoder writes the first and the reader the second
+    std::atomic<unsigned int> _decodedChunks;
+    std::atomic<unsigned int> _readChunks;
+    std::atomic<bool> _decodeEnded;
+    size_t _readOffset;
+    size_t _readFrame;
+
+    std::mutex _decodeMutex;
+    std::atomic<unsigned int> _underruns;
+};
+
+} // namespace CocosDenshion
+
+#endif // __AUDIO_STREAM_H_
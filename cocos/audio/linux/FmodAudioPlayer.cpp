@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "stdlib.h"
 #include "assert.h"
 #include "string.h"
+#include "AudioPcmCache.h"
 
 #define szMusicSuffix "|"
 
@@ -53,8 +54,43 @@ bool ERRCHECK(FMOD_RESULT result) {
 	return false;
 }
 
+// frames asked by FMOD at once to the music stream
+static const unsigned int MUSIC_DECODE_FRAMES = 4096;
+
+static FMOD_RESULT F_CALLBACK readMusicStream(FMOD_SOUND* sound, void* data,
+		unsigned int datalen) {
+	void* userdata = NULL;
+	((FMOD::Sound*) sound)->getUserData(&userdata);
+	AudioStream* stream = (AudioStream*) userdata;
+	if (stream == NULL) {
+		memset(data, 0, datalen);
+		return FMOD_OK;
+	}
+
+	int channels = stream->getChannels();
+	size_t read = stream->read((int16_t*) data,
+			datalen / (channels * sizeof(int16_t)));
+	//the decoder is late or the music ended, the rest is silence
+	size_t readBytes = read * channels * sizeof(int16_t);
+	memset((char*) data + readBytes, 0, datalen - readBytes);
+	return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALLBACK seekMusicStream(FMOD_SOUND* sound, int subsound,
+		unsigned int position, FMOD_TIMEUNIT postype) {
+	void* userdata = NULL;
+	((FMOD::Sound*) sound)->getUserData(&userdata);
+	AudioStream* stream = (AudioStream*) userdata;
+	//FMOD also sets the position back to 0 when the sound loops, the stream has wrapped around already
+	if (stream != NULL && postype == FMOD_TIMEUNIT_PCM
+			&& position != stream->getPosition()) {
+		stream->seek(position);
+	}
+	return FMOD_OK;
+}
+
 FmodAudioPlayer::FmodAudioPlayer() :
-		pMusic(0), pBGMChannel(0), iSoundChannelCount(0) {
+		pMusic(0), pMusicStream(0), pBGMChannel(0), iSoundChannelCount(0) {
 	init();
 }
 
@@ -85,6 +121,7 @@ void FmodAudioPlayer::init() {
 	ERRCHECKWITHEXIT(result);
 
 	mapEffectSound.clear();
+	mapEffectPcm.clear();
 
 }
 
@@ -98,9 +135,8 @@ void FmodAudioPlayer::close() {
 	}
 
 	if (pMusic != NULL) {
-		result = pMusic->release();
+		result = releaseMusic();
 		ERRCHECKWITHEXIT(result);
-		pMusic = 0;
 	}
 
 	result = pChannelGroup->release();
@@ -124,7 +160,7 @@ FmodAudioPlayer::~FmodAudioPlayer() {
 	}
 
 	if (pMusic != NULL) {
-		result = pMusic->release();
+		result = releaseMusic();
 		ERRCHECKWITHEXIT(result);
 	}
 
@@ -138,21 +174,66 @@ FmodAudioPlayer::~FmodAudioPlayer() {
 }
 
 // BGM
+FMOD_RESULT FmodAudioPlayer::createMusic(const char* pszFilePath) {
+	//the music is decoded by chunks while it plays, instead of whole when it is loaded.
+	//the stream loops, so that the start of the clip is decoded before the end is played
+	pMusicStream = AudioStream::create(pszFilePath, true);
+	if (pMusicStream && pMusicStream->getFrameCount() > 0) {
+		FMOD_CREATESOUNDEXINFO exinfo;
+		memset(&exinfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+		exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+		exinfo.numchannels = pMusicStream->getChannels();
+		exinfo.defaultfrequency = pMusicStream->getSampleRate();
+		exinfo.format = FMOD_SOUND_FORMAT_PCM16;
+		exinfo.length = pMusicStream->getFrameCount() * exinfo.numchannels
+				* sizeof(int16_t);
+		exinfo.decodebuffersize = MUSIC_DECODE_FRAMES;
+		exinfo.pcmreadcallback = readMusicStream;
+		exinfo.pcmsetposcallback = seekMusicStream;
+		exinfo.userdata = pMusicStream;
+
+		FMOD_RESULT result = pSystem->createSound(0,
+				FMOD_LOOP_NORMAL | FMOD_OPENUSER | FMOD_CREATESTREAM, &exinfo,
+				&pMusic);
+		if (result == FMOD_OK) {
+			return result;
+		}
+		pMusic = 0;
+	}
+
+	//the format is unknown to the decoders, FMOD streams it itself
+	delete pMusicStream;
+	pMusicStream = 0;
+	return pSystem->createSound(pszFilePath,
+			FMOD_LOOP_NORMAL | FMOD_CREATESTREAM, 0, &pMusic);
+}
+
+FMOD_RESULT FmodAudioPlayer::releaseMusic() {
+	//the stream is read by FMOD until its sound is released
+	FMOD_RESULT result = pMusic->release();
+	pMusic = 0;
+	delete pMusicStream;
+	pMusicStream = 0;
+	return result;
+}
+
 void FmodAudioPlayer::preloadBackgroundMusic(const char* pszFilePath) {
 	FMOD_RESULT result;
 	pSystem->update();
 	string sNewMusicPath = string(pszFilePath) + szMusicSuffix;
-	if (pMusic && sNewMusicPath != sMusicPath) {
+	if (pMusic) {
+		if (sNewMusicPath == sMusicPath) {
+			return;
+		}
 		//release old
-		result = pMusic->release();
+		result = releaseMusic();
 		ERRCHECKWITHEXIT(result);
+	}
 
+	result = createMusic(pszFilePath);
+	if (!ERRCHECK(result)) {
 		sMusicPath = sNewMusicPath;
-
 	}
-
-	result = pSystem->createSound(pszFilePath, FMOD_LOOP_NORMAL, 0, &pMusic);
-	ERRCHECK(result);
 }
 
 void FmodAudioPlayer::playBackgroundMusic(const char* pszFilePath, bool bLoop) {
@@ -160,8 +241,7 @@ void FmodAudioPlayer::playBackgroundMusic(const char* pszFilePath, bool bLoop) {
 	if (pMusic == NULL) {
 		//did not load it
 		//load the new music
-		FMOD_RESULT result = pSystem->createSound(pszFilePath, FMOD_LOOP_NORMAL,
-				0, &pMusic);
+		FMOD_RESULT result = createMusic(pszFilePath);
 		if (!ERRCHECK(result)) {
 			sMusicPath = string(pszFilePath) + szMusicSuffix;
 		}
@@ -175,10 +255,9 @@ void FmodAudioPlayer::playBackgroundMusic(const char* pszFilePath, bool bLoop) {
 
 		if (sNewMusicPath != sMusicPath) {
 
-			pMusic->release();
+			releaseMusic();
 			//load the new music
-			FMOD_RESULT result = pSystem->createSound(pszFilePath,
-					FMOD_LOOP_NORMAL, 0, &pMusic);
+			FMOD_RESULT result = createMusic(pszFilePath);
 
 			if (!ERRCHECK(result)) {
 				sMusicPath = sNewMusicPath;
@@ -205,10 +284,9 @@ void FmodAudioPlayer::stopBackgroundMusic(bool bReleaseData) {
 	if (bReleaseData) {
 		result = pBGMChannel->stop();
 		ERRCHECKWITHEXIT(result);
-		result = pMusic->release();
+		result = releaseMusic();
 		ERRCHECKWITHEXIT(result);
 		pBGMChannel = 0;
-		pMusic = 0;
 	} else {
 		result = pBGMChannel->stop();
 		ERRCHECKWITHEXIT(result);
@@ -315,6 +393,9 @@ unsigned int FmodAudioPlayer::playEffect(const char* pszFilePath, bool bLoop,
 			//no load it yet
 			preloadEffect(pszFilePath);
 			l_it = mapEffectSound.find(string(pszFilePath));
+			if (l_it == mapEffectSound.end()) {
+				break;
+			}
 		}
 		pSound = l_it->second;
 		if (pSound==NULL){
@@ -442,9 +523,34 @@ void FmodAudioPlayer::stopAllEffects() {
 
 void FmodAudioPlayer::preloadEffect(const char* pszFilePath) {
 	FMOD::Sound* pLoadSound;
+	FMOD_RESULT result;
 
 	pSystem->update();
-	FMOD_RESULT result = pSystem->createSound(pszFilePath, FMOD_LOOP_NORMAL, 0,
+	if (mapEffectSound.find(string(pszFilePath)) != mapEffectSound.end()) {
+		return;
+	}
+
+	//the samples decoded once by the cache are played in place by FMOD
+	std::shared_ptr<const AudioPcm> pcm = AudioPcmCache::getInstance()->get(pszFilePath);
+	if (pcm) {
+		FMOD_CREATESOUNDEXINFO exinfo;
+		memset(&exinfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+		exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+		exinfo.length = pcm->getByteSize();
+		exinfo.numchannels = pcm->channels;
+		exinfo.defaultfrequency = pcm->sampleRate;
+		exinfo.format = FMOD_SOUND_FORMAT_PCM16;
+		result = pSystem->createSound((const char*) pcm->samples.data(),
+				FMOD_LOOP_NORMAL | FMOD_OPENMEMORY_POINT | FMOD_OPENRAW
+						| FMOD_CREATESAMPLE, &exinfo, &pLoadSound);
+		if (!ERRCHECK(result)) {
+			mapEffectSound[string(pszFilePath)] = pLoadSound;
+			mapEffectPcm[string(pszFilePath)] = pcm;
+			return;
+		}
+	}
+
+	result = pSystem->createSound(pszFilePath, FMOD_LOOP_NORMAL, 0,
 			&pLoadSound);
 	if (ERRCHECK(result)){
 		printf("sound effect in %s could not be preload", pszFilePath);
@@ -468,8 +574,9 @@ void FmodAudioPlayer::unloadEffect(const char* pszFilePath) {
 	//release the sound;
 	pSound->release();
 
-	//delete from the map
+	//delete from the map, the samples stay in the cache while it has room for them
 	mapEffectSound.erase(string(pszFilePath));
+	mapEffectPcm.erase(string(pszFilePath));
 }
 
 //~for sound effects
@@ -31,6 +31,9 @@ THE SOFTWARE.
 #include "AudioPlayer.h"
 #include "string"
 #include <map>
+#include <memory>
+#include "AudioDecoder.h"
+#include "AudioStream.h"
 
 
 using namespace std;
@@ -171,11 +174,15 @@ public:
 private:
 
 	void init();
+	FMOD_RESULT createMusic(const char* pszFilePath);
+	FMOD_RESULT releaseMusic();
 	map<string, FMOD::Sound*> mapEffectSound;
+	map<string, std::shared_ptr<const AudioPcm> > mapEffectPcm;
 	map<unsigned int, FMOD::Channel*> mapEffectSoundChannel;
 
 	FMOD::System* 	pSystem;
 	FMOD::Sound* 	pMusic;   //BGM
+	AudioStream* 	pMusicStream;
 	FMOD::Channel* 	pBGMChannel;
 
 	FMOD::ChannelGroup* pChannelGroup;
@@ -0,0 +1,145 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "NullAudioSink.h"
+
+#include <algorithm>
+
+namespace CocosDenshion {
+
+NullAudioSink::NullAudioSink(int channels/* = 2*/)
+: _channels(std::max(channels, 1))
+, _renderedFrames(0)
+, _nextSoundId(0)
+{
+}
+
+NullAudioSink::~NullAudioSink()
+{
+    stopAll();
+}
+
+int NullAudioSink::play(const std::shared_ptr<const AudioPcm>& pcm, bool loop/* = false*/)
+{
+    if (!pcm || pcm->channels <= 0)
+        return -1;
+
+    Sound sound = { _nextSoundId++, pcm, nullptr, 0, loop };
+    _sounds.push_back(sound);
+    return sound.id;
+}
+
+int NullAudioSink::play(AudioStream* stream)
+{
+    if (!stream)
+        return -1;
+
+    Sound sound = { _nextSoundId++, nullptr, stream, 0, false };
+    _sounds.push_back(sound);
+    return sound.id;
+}
+
+void NullAudioSink::stop(int soundId)
+{
+    auto iter = std::find_if(_sounds.begin(), _sounds.end(), [soundId](const Sound& sound) { return sound.id == soundId; });
+    if (iter == _sounds.end())
+        return;
+
+    delete iter->stream;
+    _sounds.erase(iter);
+}
+
+void NullAudioSink::stopAll()
+{
+    for (auto& sound : _sounds)
+        delete sound.stream;
+    _sounds.clear();
+}
+
+size_t NullAudioSink::render(size_t frames)
+{
+    _mix.assign(frames * _channels, 0);
+    for (size_t i = 0; i < _sounds.size();)
+    {
+        if (mix(_sounds[i], frames))
+        {
+            ++i;
+        }
+        else
+        {
+            delete _sounds[i].stream;
+            _sounds.erase(_sounds.begin() + i);
+        }
+    }
+    _renderedFrames += frames;
+    return _sounds.size();
+}
+
+bool NullAudioSink::mix(Sound& sound, size_t frames)
+{
+    if (sound.stream)
+    {
+        AudioStream* stream = sound.stream;
+        _streamBuffer.resize(frames * stream->getChannels());
+        size_t read = stream->read(_streamBuffer.data(), frames);
+        mixSamples(_streamBuffer.data(), stream->getChannels(), read, 0);
+        return !stream->isEnded();
+    }
+
+    const AudioPcm& pcm = *sound.pcm;
+    size_t clipFrames = pcm.getFrameCount();
+    size_t done = 0;
+    while (done < frames && sound.frame < clipFrames)
+    {
+        size_t count = std::min(frames - done, clipFrames - sound.frame);
+        mixSamples(pcm.samples.data() + sound.frame * pcm.channels, pcm.channels, count, done);
+        done += count;
+        sound.frame += count;
+        if (sound.loop && sound.frame == clipFrames)
+            sound.frame = 0;
+    }
+    return sound.frame < clipFrames;
+}
+
+void NullAudioSink::mixSamples(const int16_t* samples, int channels, size_t frames, size_t offset)
+{
+    int32_t* out = _mix.data() + offset * _channels;
+    if (channels == _channels)
+    {
+        for (size_t i = 0, count = frames * channels; i < count; ++i)
+            out[i] += samples[i];
+        return;
+    }
+
+    // the missing channels repeat the last one of the sound, the extra ones are dropped
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (int channel = 0; channel < _channels; ++channel)
+            out[channel] += samples[std::min(channel, channels - 1)];
+        out += _channels;
+        samples += channels;
+    }
+}
+
+} // namespace CocosDenshion
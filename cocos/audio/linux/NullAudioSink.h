@@ -0,0 +1,91 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __NULL_AUDIO_SINK_H_
+#define __NULL_AUDIO_SINK_H_
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "AudioDecoder.h"
+#include "AudioStream.h"
+
+namespace CocosDenshion {
+
+/** @brief NullAudioSink: mixes the clips and the streams as an output would, without any device.
+
+ render() mixes as many frames as asked at once instead of following a clock, so the time it takes
+ measures the decode layer alone. The sounds are mixed to the channels of the sink without resampling.
+ @since v3.9
+ */
+class NullAudioSink
+{
+public:
+    explicit NullAudioSink(int channels = 2);
+    ~NullAudioSink();
+
+    /** Plays a decoded clip, usually from AudioPcmCache. Returns the id of the sound. */
+    int play(const std::shared_ptr<const AudioPcm>& pcm, bool loop = false);
+
+    /** Plays a stream, the sink deletes it when it ends or is stopped. Returns the id of the sound. */
+    int play(AudioStream* stream);
+
+    void stop(int soundId);
+    void stopAll();
+
+    /** Mixes frames frames of all the playing sounds, the ended sounds are removed. Returns the number of sounds still playing. */
+    size_t render(size_t frames);
+
+    size_t getPlayingCount() const { return _sounds.size(); }
+
+    /** Frames mixed by render(), and the last ones. */
+    uint64_t getRenderedFrames() const { return _renderedFrames; }
+    const std::vector<int32_t>& getMix() const { return _mix; }
+
+protected:
+    struct Sound
+    {
+        int id;
+        std::shared_ptr<const AudioPcm> pcm;
+        AudioStream* stream;
+        size_t frame;
+        bool loop;
+    };
+
+    // mixes frames frames of samples, returns false once the sound ended
+    bool mix(Sound& sound, size_t frames);
+    void mixSamples(const int16_t* samples, int channels, size_t frames, size_t offset);
+
+    int _channels;
+    std::vector<Sound> _sounds;
+    std::vector<int32_t> _mix;
+    std::vector<int16_t> _streamBuffer;
+    uint64_t _renderedFrames;
+    int _nextSoundId;
+};
+
+} // namespace CocosDenshion
+
+#endif // __NULL_AUDIO_SINK_H_
@@ -145,6 +145,13 @@ public:
      * @since v2.0.0
      */
 	bool supportsShareableVAO() const;
+
+    /** Whether or not pixel buffer objects are supported, to read the pixels back without waiting for the GPU.
+     *
+     * @return Is true if supports pixel buffer objects.
+     * @since v3.9
+     */
+    bool supportsPixelBufferObject() const;
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -232,6 +239,7 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsPixelBufferObject;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -77,6 +77,7 @@ void Data::move(Data& other)
 {
     _bytes = other._bytes;
     _size = other._size;
+    _owner = std::move(other._owner);
     
     other._bytes = nullptr;
     other._size = 0;
@@ -113,11 +114,23 @@ void Data::fastSet(unsigned char* bytes, const ssize_t size)
 {
     _bytes = bytes;
     _size = size;
+    _owner.reset();
+}
+
+void Data::fastSet(unsigned char* bytes, const ssize_t size, const std::shared_ptr<void>& owner)
+{
+    clear();
+    _bytes = bytes;
+    _size = size;
+    _owner = owner;
 }
 
 void Data::clear()
 {
-    free(_bytes);
+    if (_owner)
+        _owner.reset();
+    else
+        free(_bytes);
     _bytes = nullptr;
     _size = 0;
 }
@@ -29,6 +29,7 @@
 #include "platform/CCPlatformMacros.h"
 #include <stdint.h> // for ssize_t on android
 #include <string>   // for ssize_t on linux
+#include <memory>
 #include "platform/CCStdC.h" // for ssize_t on window
 
 /**
@@ -107,6 +108,14 @@ public:
      *  @see Data::copy
      */
     void fastSet(unsigned char* bytes, const ssize_t size);
+
+    /** Fast set a buffer owned by another object, such as a slice of a mapped file.
+     *  @param bytes The buffer pointer, it isn't freed by Data and may be read only.
+     *  @param owner Keeps the buffer valid, it is released when Data is cleared.
+     *  @see Data::fastSet
+     *  @since v3.9
+     */
+    void fastSet(unsigned char* bytes, const ssize_t size, const std::shared_ptr<void>& owner);
     
     /** 
      * Clears data, free buffer and reset data size.
@@ -126,6 +135,8 @@ private:
 private:
     unsigned char* _bytes;
     ssize_t _size;
+    // set when _bytes belongs to it rather than to Data
+    std::shared_ptr<void> _owner;
 };
 
 
@@ -48,6 +48,7 @@ THE SOFTWARE.
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
+#include "renderer/CCRenderThread.h"
 #include "renderer/CCFrameBuffer.h"
 #include "2d/CCCamera.h"
 #include "base/CCUserDefault.h"
@@ -128,6 +129,11 @@ bool Director::init(void)
     _totalFrames = 0;
     _lastUpdate = new struct timeval;
     _secondsPerFrame = 1.0f;
+    _fixedDeltaTime = 0.0f;
+
+    // pipelined rendering
+    _pipelinedRendering = false;
+    _renderThread = nullptr;
 
     // paused ?
     _paused = false;
@@ -191,6 +197,7 @@ Director::~Director(void)
     delete _eventAfterVisit;
     delete _eventProjectionChanged;
 
+    stopRenderThread();
     delete _renderer;
 
     delete _console;
@@ -255,6 +262,19 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    if (_pipelinedRendering != (_renderThread != nullptr))
+    {
+        if (_pipelinedRendering)
+            startRenderThread();
+        else
+            stopRenderThread();
+    }
+
+    if (_renderThread)
+    {
+        _renderThread->beginFrame();
+    }
+
     // calculate "global" dt
     calculateDeltaTime();
     
@@ -270,8 +290,12 @@ void Director::drawScene()
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
-    _renderer->clear();
-    experimental::FrameBuffer::clearAllFBOs();
+    // on the render thread when the rendering is pipelined
+    _renderer->addCallback([this]() {
+        _renderer->clear();
+        experimental::FrameBuffer::clearAllFBOs();
+        _renderer->clearDrawStats();
+    });
     /* to avoid flickr, nextScene MUST be here: after tick and before draw.
      * FIXME: Which bug is this one. It seems that it can't be reproduced with v0.9
      */
@@ -287,9 +311,6 @@ void Director::drawScene()
 #if (CC_USE_PHYSICS || (CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION) || CC_USE_NAVMESH)
         _runningScene->stepPhysicsAndNavigation(_deltaTime);
 #endif
-        //clear draw stats
-        _renderer->clearDrawStats();
-        
         //render the scene
         _runningScene->render(_renderer);
         
@@ -315,7 +336,12 @@ void Director::drawScene()
     _totalFrames++;
 
     // swap buffers
-    if (_openGLView)
+    if (_renderThread)
+    {
+        // drawn and swapped on the render thread
+        _renderThread->submitFrame();
+    }
+    else if (_openGLView)
     {
         _openGLView->swapBuffers();
     }
@@ -343,6 +369,10 @@ void Director::calculateDeltaTime()
         _deltaTime = 0;
         _nextDeltaTimeZero = false;
     }
+    else if (_fixedDeltaTime > 0)
+    {
+        _deltaTime = _fixedDeltaTime;
+    }
     else
     {
         _deltaTime = (now.tv_sec - _lastUpdate->tv_sec) + (now.tv_usec - _lastUpdate->tv_usec) / 1000000.0f;
@@ -369,6 +399,9 @@ void Director::setOpenGLView(GLView *openGLView)
 
     if (_openGLView != openGLView)
     {
+        // the render thread draws into the current view
+        stopRenderThread();
+
         // Configuration. Gather GPU info
         Configuration *conf = Configuration::getInstance();
         conf->gatherGPUInfo();
@@ -426,6 +459,7 @@ void Director::setViewport()
 {
     if (_openGLView)
     {
+        ScopedGLContext context;
         _openGLView->setViewPortInPoints(0, 0, _winSizeInPoints.width, _winSizeInPoints.height);
     }
 }
@@ -435,6 +469,45 @@ void Director::setNextDeltaTimeZero(bool nextDeltaTimeZero)
     _nextDeltaTimeZero = nextDeltaTimeZero;
 }
 
+void Director::setFixedDeltaTime(float fixedDeltaTime)
+{
+    _fixedDeltaTime = MAX(0, fixedDeltaTime);
+}
+
+void Director::setPipelinedRendering(bool pipelined)
+{
+    // applied by drawScene(), between two frames
+    _pipelinedRendering = pipelined;
+}
+
+void Director::startRenderThread()
+{
+    // the render thread makes the context current when it needs it
+    if (_openGLView == nullptr || !_openGLView->makeContextCurrent(false))
+    {
+        CCLOG("cocos2d: pipelined rendering is not supported by this GLView");
+        _pipelinedRendering = false;
+        return;
+    }
+
+    for (auto& stack : _renderThreadMatrixStacks)
+    {
+        while (!stack.empty())
+        {
+            stack.pop();
+        }
+        stack.push(Mat4::IDENTITY);
+    }
+
+    _renderThread = new (std::nothrow) RenderThread(_renderer, _openGLView);
+}
+
+void Director::stopRenderThread()
+{
+    // the destructor waits for the submitted frames and gives the context back to this thread
+    CC_SAFE_DELETE(_renderThread);
+}
+
 //
 // FIXME TODO
 // Matrix code MUST NOT be part of the Director
@@ -468,123 +541,61 @@ void Director::resetMatrixStack()
     initMatrixStack();
 }
 
-void Director::popMatrix(MATRIX_STACK_TYPE type)
+std::stack<Mat4>& Director::getMatrixStack(MATRIX_STACK_TYPE type)
 {
+    // the render thread draws a frame while the main thread visits the next one
+    if (_renderThread && _renderThread->isCurrentThread())
+    {
+        CCASSERT(type <= MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE, "unknow matrix stack type");
+        return _renderThreadMatrixStacks[static_cast<int>(type)];
+    }
+
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.pop();
+        return _modelViewMatrixStack;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
-        _projectionMatrixStack.pop();
+        return _projectionMatrixStack;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
     {
-        _textureMatrixStack.pop();
-    }
-    else
-    {
-        CCASSERT(false, "unknow matrix stack type");
+        return _textureMatrixStack;
     }
+
+    CCASSERT(false, "unknow matrix stack type, will return modelview matrix instead");
+    return _modelViewMatrixStack;
+}
+
+void Director::popMatrix(MATRIX_STACK_TYPE type)
+{
+    getMatrixStack(type).pop();
 }
 
 void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 {
-    if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
-    {
-        _modelViewMatrixStack.top() = Mat4::IDENTITY;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
-    {
-        _projectionMatrixStack.top() = Mat4::IDENTITY;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
-    {
-        _textureMatrixStack.top() = Mat4::IDENTITY;
-    }
-    else
-    {
-        CCASSERT(false, "unknow matrix stack type");
-    }
+    getMatrixStack(type).top() = Mat4::IDENTITY;
 }
 
 void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
-    if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
-    {
-        _modelViewMatrixStack.top() = mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
-    {
-        _projectionMatrixStack.top() = mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
-    {
-        _textureMatrixStack.top() = mat;
-    }
-    else
-    {
-        CCASSERT(false, "unknow matrix stack type");
-    }
+    getMatrixStack(type).top() = mat;
 }
 
 void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
-    if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
-    {
-        _modelViewMatrixStack.top() *= mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
-    {
-        _projectionMatrixStack.top() *= mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
-    {
-        _textureMatrixStack.top() *= mat;
-    }
-    else
-    {
-        CCASSERT(false, "unknow matrix stack type");
-    }
+    getMatrixStack(type).top() *= mat;
 }
 
 void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
-    if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
-    {
-        _modelViewMatrixStack.push(_modelViewMatrixStack.top());
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
-    {
-        _projectionMatrixStack.push(_projectionMatrixStack.top());
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE)
-    {
-        _textureMatrixStack.push(_textureMatrixStack.top());
-    }
-    else
-    {
-        CCASSERT(false, "unknow matrix stack type");
-    }
+    auto& stack = getMatrixStack(type);
+    stack.push(stack.top());
 }
 
 const Mat4& Director::getMatrix(MATRIX_STACK_TYPE type)
 {
-    if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
-    {
-        return _modelViewMatrixStack.top();
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
-    {
-        return _projectionMatrixStack.top();
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE)
-    {
-        return _textureMatrixStack.top();
-    }
-
-    CCASSERT(false, "unknow matrix stack type, will return modelview matrix instead");
-    return  _modelViewMatrixStack.top();
+    return getMatrixStack(type).top();
 }
 
 void Director::setProjection(Projection projection)
@@ -667,6 +678,7 @@ float Director::getZEye(void) const
 
 void Director::setAlphaBlending(bool on)
 {
+    ScopedGLContext context;
     if (on)
     {
         GL::blendFunc(CC_BLEND_SRC, CC_BLEND_DST);
@@ -681,6 +693,7 @@ void Director::setAlphaBlending(bool on)
 
 void Director::setDepthTest(bool on)
 {
+    ScopedGLContext context;
     _renderer->setDepthTest(on);
 }
 
@@ -916,6 +929,9 @@ void Director::restart()
 
 void Director::reset()
 {    
+    // the objects released below delete their GL objects on this thread
+    stopRenderThread();
+
     if (_runningScene)
     {
         _runningScene->onExit();
@@ -58,6 +58,7 @@ class EventCustom;
 class EventListenerCustom;
 class TextureCache;
 class Renderer;
+class RenderThread;
 class Camera;
 
 class Console;
@@ -191,6 +192,30 @@ public:
      */
     void setNextDeltaTimeZero(bool nextDeltaTimeZero);
 
+    /** Gets the fixed delta time, 0 when the delta time is measured. */
+    float getFixedDeltaTime() const { return _fixedDeltaTime; }
+    /**
+     * Uses the same delta time for every frame instead of the measured wall-clock time.
+     * Useful for deterministic benchmarks and replays. Pass 0 to go back to the measured delta time.
+     */
+    void setFixedDeltaTime(float fixedDeltaTime);
+
+    /**
+     * Enables or disables the pipelined rendering, from the next frame on.
+     * A render thread then draws frame N and swaps the buffers while the main thread updates and visits frame N+1.
+     * Triangles and quads commands are copied with their vertices when they are added to the renderer. A frame with
+     * other commands reads the state of their nodes when it is drawn, so the main thread waits until it is drawn.
+     * The GL context belongs to the render thread: textures, programs and buffers created or deleted by the main thread
+     * wait for the frame being drawn, other GL calls on the main thread must be made within a ScopedGLContext.
+     * EVENT_AFTER_DRAW is dispatched once the frame is recorded, before it is drawn.
+     * Needs a GLView able to move its context across threads, see GLView::makeContextCurrent().
+     */
+    void setPipelinedRendering(bool pipelined);
+    /** Whether or not the rendering is pipelined. */
+    bool isPipelinedRendering() const { return _pipelinedRendering; }
+    /** Gets the render thread, which holds the frame latency and throughput counters. nullptr when the rendering is not pipelined. */
+    RenderThread* getRenderThread() const { return _renderThread; }
+
     /** Whether or not the Director is paused. */
     inline bool isPaused() { return _paused; }
 
@@ -519,11 +544,18 @@ protected:
     void destroyTextureCache();
 
     void initMatrixStack();
+    std::stack<Mat4>& getMatrixStack(MATRIX_STACK_TYPE type);
+
+    void startRenderThread();
+    void stopRenderThread();
 
     std::stack<Mat4> _modelViewMatrixStack;
     std::stack<Mat4> _projectionMatrixStack;
     std::stack<Mat4> _textureMatrixStack;
 
+    /* matrix stacks used by the render thread */
+    std::stack<Mat4> _renderThreadMatrixStacks[3];
+
     /** Scheduler associated with this director
      @since v2.0
      */
@@ -589,6 +621,9 @@ protected:
 
     /* whether or not the next delta time will be zero */
     bool _nextDeltaTimeZero;
+
+    /* delta time used for every frame if greater than 0 */
+    float _fixedDeltaTime;
     
     /* projection used */
     Projection _projection;
@@ -604,6 +639,10 @@ protected:
 
     /* Renderer for the Director */
     Renderer *_renderer;
+
+    /* pipelined rendering requested, applied at the beginning of a frame */
+    bool _pipelinedRendering;
+    RenderThread *_renderThread;
     
     /* Default FrameBufferObject*/
     experimental::FrameBuffer* _defaultFBO;
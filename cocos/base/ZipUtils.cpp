@@ -40,6 +40,7 @@
 #include "base/ccMacros.h"
 #include "platform/CCFileUtils.h"
 #include <map>
+#include <memory>
 
 // FIXME: Other platforms should use upstream minizip like mingw-w64  
 #ifdef MINIZIP_FROM_SYSTEM
@@ -371,6 +372,8 @@ bool ZipUtils::isGZipBuffer(const unsigned char *buffer, ssize_t len)
 int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
 {
     struct CCZHeader *header = (struct CCZHeader*) buffer;
+    // the decrypted copy of an encrypted buffer, which may be read only or shared by other readers
+    std::unique_ptr<unsigned char, void(*)(void*)> decrypted(nullptr, free);
 
     // verify header
     if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!' )
@@ -410,8 +413,18 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
             return -1;
         }
 
-        // decrypt
-        unsigned int* ints = (unsigned int*)(buffer+12);
+        // decrypt a copy
+        decrypted.reset((unsigned char*)malloc(bufferLen));
+        if (!decrypted)
+        {
+            CCLOG("cocos2d: CCZ: Failed to allocate memory for decryption");
+            return -1;
+        }
+        memcpy(decrypted.get(), buffer, bufferLen);
+        buffer = decrypted.get();
+        header = (struct CCZHeader*) buffer;
+
+        unsigned int* ints = (unsigned int*)(decrypted.get()+12);
         ssize_t enclen = (bufferLen-12)/4;
 
         decodeEncodedPvr(ints, enclen);
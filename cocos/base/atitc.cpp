@@ -23,6 +23,10 @@
  ****************************************************************************/
 
 #include "atitc.h"
+#include "base/ccUtils.h"
+
+// smallest number of block rows decoded by a task of parallelFor
+static const size_t DECODE_ROWS_CHUNK = 4;
 
 //Decode ATITC encode block to 4x4 RGB32 pixels
 static void atitc_decode_block(uint8_t **blockData,
@@ -156,40 +160,45 @@ void atitc_decode(uint8_t *encodeData,             //in_data
                  const int pixelsHeight,
                  ATITCDecodeFlag decodeFlag)
 {
-    uint32_t *decodeBlockData = (uint32_t *)decodeData;
-    
-    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 3 * pixelsWidth)   //stride = 3*width
-    {
-        for (int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)            //skip 4 pixels
+    // the block rows are independent, every task finds where its rows start in both buffers
+    const int blocksPerRow = pixelsWidth / 4;
+    const size_t blockSize = ATITCDecodeFlag::ATC_RGB == decodeFlag ? 8 : 16;
+    cocos2d::utils::parallelFor(pixelsHeight / 4, DECODE_ROWS_CHUNK, [=](size_t begin, size_t end) {
+        uint8_t *blockData = encodeData + begin * blocksPerRow * blockSize;
+        uint32_t *decodeBlockData = (uint32_t *)decodeData + begin * 4 * pixelsWidth;
+        for (size_t block_y = begin; block_y < end; ++block_y, decodeBlockData += 3 * pixelsWidth)   //stride = 3*width
         {
-            uint64_t blockAlpha = 0;
-            
-            switch (decodeFlag)
+            for (int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)            //skip 4 pixels
             {
-                case ATITCDecodeFlag::ATC_RGB:
-                {
-                    atitc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 0, 0LL, ATITCDecodeFlag::ATC_RGB);
-                }
-                    break;
-                case ATITCDecodeFlag::ATC_EXPLICIT_ALPHA:
-                {
-                    memcpy((void *)&blockAlpha, encodeData, 8);
-                    encodeData += 8;
-                    atitc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
-                }
-                    break;
-                case ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA:
+                uint64_t blockAlpha = 0;
+            
+                switch (decodeFlag)
                 {
-                    memcpy((void *)&blockAlpha, encodeData, 8);
-                    encodeData += 8;
-                    atitc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
-                }
-                    break;
-                default:
-                    break;
-            }//switch
-        }//for block_x
-    }//for block_y
+                    case ATITCDecodeFlag::ATC_RGB:
+                    {
+                        atitc_decode_block(&blockData, decodeBlockData, pixelsWidth, 0, 0LL, ATITCDecodeFlag::ATC_RGB);
+                    }
+                        break;
+                    case ATITCDecodeFlag::ATC_EXPLICIT_ALPHA:
+                    {
+                        memcpy((void *)&blockAlpha, blockData, 8);
+                        blockData += 8;
+                        atitc_decode_block(&blockData, decodeBlockData, pixelsWidth, 1, blockAlpha, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
+                    }
+                        break;
+                    case ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA:
+                    {
+                        memcpy((void *)&blockAlpha, blockData, 8);
+                        blockData += 8;
+                        atitc_decode_block(&blockData, decodeBlockData, pixelsWidth, 1, blockAlpha, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
+                    }
+                        break;
+                    default:
+                        break;
+                }//switch
+            }//for block_x
+        }//for block_y
+    });
 }
 
 
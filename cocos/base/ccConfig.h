@@ -52,6 +52,9 @@ THE SOFTWARE.
  *  - ccGLUseProgram() instead of glUseProgram().
  *  - GL::deleteProgram() instead of glDeleteProgram().
  *  - GL::blendFunc() instead of glBlendFunc().
+ *  - GL::enable() and GL::disable() instead of glEnable() and glDisable().
+ *  - GL::depthMask(), GL::depthFunc(), GL::cullFace() and GL::frontFace() instead of the GL ones.
+ *  - GL::bindBuffer() and GL::deleteBuffers() instead of glBindBuffer() and glDeleteBuffers().
 
  * If this functionality is disabled, then ccGLUseProgram(), GL::deleteProgram(), GL::blendFunc() will call the GL ones, without using the cache.
 
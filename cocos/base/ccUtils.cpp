@@ -26,6 +26,12 @@ THE SOFTWARE.
 #include "base/ccUtils.h"
 
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #include "base/CCDirector.h"
 #include "base/CCAsyncTaskPool.h"
@@ -48,6 +54,113 @@ int ccNextPOT(int x)
     return x + 1;
 }
 
+namespace
+{
+/**
+* Threads of utils::parallelFor(). They are never stopped: the pool is leaked on purpose,
+* so that no thread is joined while the process exits.
+*/
+class ParallelForPool
+{
+public:
+    struct Job
+    {
+        const std::function<void(size_t, size_t)>* func;
+        size_t count;
+        size_t chunkSize;
+        size_t chunkCount;
+        std::atomic<size_t> nextChunk;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t helpersDone;
+    };
+
+    static ParallelForPool* getInstance()
+    {
+        static ParallelForPool* s_pool = new ParallelForPool();
+        return s_pool;
+    }
+
+    int getWorkerCount() const { return (int)_workers.size(); }
+
+    void run(Job& job, size_t helperCount)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (size_t i = 0; i < helperCount; ++i)
+                _jobs.push_back(&job);
+        }
+        if (helperCount == 1)
+            _condition.notify_one();
+        else
+            _condition.notify_all();
+
+        runChunks(job);
+
+        // the helpers which didn't take the job yet won't find it anymore
+        size_t helpersTaken = helperCount;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto end = std::remove(_jobs.begin(), _jobs.end(), &job);
+            helpersTaken -= _jobs.end() - end;
+            _jobs.erase(end, _jobs.end());
+        }
+
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.condition.wait(lock, [&]{ return job.helpersDone == helpersTaken; });
+    }
+
+private:
+    ParallelForPool()
+    {
+        // the calling thread runs chunks as well
+        int count = (int)std::thread::hardware_concurrency() - 1;
+        count = std::min(count, 7);
+        for (int i = 0; i < count; ++i)
+        {
+            _workers.push_back(std::thread(&ParallelForPool::workerLoop, this));
+            _workers.back().detach();
+        }
+    }
+
+    static void runChunks(Job& job)
+    {
+        size_t chunk;
+        while ((chunk = job.nextChunk++) < job.chunkCount)
+        {
+            size_t begin = chunk * job.chunkSize;
+            (*job.func)(begin, std::min(begin + job.chunkSize, job.count));
+        }
+    }
+
+    void workerLoop()
+    {
+        while (true)
+        {
+            Job* job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this]{ return !_jobs.empty(); });
+                job = _jobs.front();
+                _jobs.pop_front();
+            }
+
+            runChunks(*job);
+
+            std::lock_guard<std::mutex> lock(job->mutex);
+            ++job->helpersDone;
+            job->condition.notify_one();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<Job*> _jobs;
+};
+}
+
 namespace utils
 {
 /**
@@ -263,7 +376,40 @@ Rect getCascadeBoundingBox(Node *node)
     
     return cbb;
 }
-    
+
+void parallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& func)
+{
+    if (count == 0)
+        return;
+
+    auto pool = ParallelForPool::getInstance();
+    minChunk = std::max(minChunk, (size_t)1);
+    if (count <= minChunk || pool->getWorkerCount() == 0)
+    {
+        func(0, count);
+        return;
+    }
+
+    // a few chunks per thread, so that a slow thread is made up for by the others
+    size_t threadCount = pool->getWorkerCount() + 1;
+    size_t chunkCount = std::min((count + minChunk - 1) / minChunk, threadCount * 4);
+
+    ParallelForPool::Job job;
+    job.func = &func;
+    job.count = count;
+    job.chunkSize = (count + chunkCount - 1) / chunkCount;
+    job.chunkCount = (count + job.chunkSize - 1) / job.chunkSize;
+    job.nextChunk = 0;
+    job.helpersDone = 0;
+
+    pool->run(job, std::min(job.chunkCount - 1, threadCount - 1));
+}
+
+int getParallelThreadCount()
+{
+    return ParallelForPool::getInstance()->getWorkerCount() + 1;
+}
+
 }
 
 NS_CC_END
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #ifndef __SUPPORT_CC_UTILS_H__
 #define __SUPPORT_CC_UTILS_H__
 
+#include <functional>
 #include <vector>
 #include <string>
 #include "2d/CCNode.h"
@@ -100,6 +101,25 @@ namespace utils
      * @return Returns unionof bounding box of a node and its children.
      */
     Rect CC_DLL getCascadeBoundingBox(Node *node);
+
+    /**
+     * Calls func(begin, end) on consecutive ranges covering [0, count), on the calling thread and on the
+     * threads of a pool shared by the engine, and returns once every range is done.
+     * The ranges never overlap and hold at least minChunk items, so a count up to minChunk runs on the calling thread only.
+     * func is called concurrently, it must not touch anything shared with the other ranges.
+     *
+     * @param count The number of items.
+     * @param minChunk The smallest number of items worth sending to another thread.
+     * @param func The function called for every range.
+     * @since v3.9
+     */
+    void CC_DLL parallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& func);
+
+    /**
+     * Number of threads which may run the ranges of parallelFor(), the calling thread included.
+     * @since v3.9
+     */
+    int CC_DLL getParallelThreadCount();
 }
 
 NS_CC_END
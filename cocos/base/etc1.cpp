@@ -16,6 +16,16 @@
 
 #include <string.h>
 
+#include "base/ccUtils.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ETC1_DECODE_VECTOR 1
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ETC1_DECODE_VECTOR 1
+#endif
+
 /* From http://www.khronos.org/registry/gles/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
 
  The number of bits that represent a 4x4 texel block is 64 bits if
@@ -194,33 +204,39 @@ void decode_subblock(etc1_byte* pOut, int r, int g, int b, const int* table,
     }
 }
 
-// Input is an ETC1 compressed version of the data.
-// Output is a 4 x 4 square of 3-byte pixels in form R, G, B
-
-void etc1_decode_block(const etc1_byte* pIn, etc1_byte* pOut) {
-    etc1_uint32 high = (pIn[0] << 24) | (pIn[1] << 16) | (pIn[2] << 8) | pIn[3];
-    etc1_uint32 low = (pIn[4] << 24) | (pIn[5] << 16) | (pIn[6] << 8) | pIn[7];
-    int r1, r2, g1, g2, b1, b2;
+static
+void decode_base_colors(etc1_uint32 high, int* r1, int* g1, int* b1,
+        int* r2, int* g2, int* b2) {
     if (high & 2) {
         // differential
         int rBase = high >> 27;
         int gBase = high >> 19;
         int bBase = high >> 11;
-        r1 = convert5To8(rBase);
-        r2 = convertDiff(rBase, high >> 24);
-        g1 = convert5To8(gBase);
-        g2 = convertDiff(gBase, high >> 16);
-        b1 = convert5To8(bBase);
-        b2 = convertDiff(bBase, high >> 8);
+        *r1 = convert5To8(rBase);
+        *r2 = convertDiff(rBase, high >> 24);
+        *g1 = convert5To8(gBase);
+        *g2 = convertDiff(gBase, high >> 16);
+        *b1 = convert5To8(bBase);
+        *b2 = convertDiff(bBase, high >> 8);
     } else {
         // not differential
-        r1 = convert4To8(high >> 28);
-        r2 = convert4To8(high >> 24);
-        g1 = convert4To8(high >> 20);
-        g2 = convert4To8(high >> 16);
-        b1 = convert4To8(high >> 12);
-        b2 = convert4To8(high >> 8);
+        *r1 = convert4To8(high >> 28);
+        *r2 = convert4To8(high >> 24);
+        *g1 = convert4To8(high >> 20);
+        *g2 = convert4To8(high >> 16);
+        *b1 = convert4To8(high >> 12);
+        *b2 = convert4To8(high >> 8);
     }
+}
+
+// Input is an ETC1 compressed version of the data.
+// Output is a 4 x 4 square of 3-byte pixels in form R, G, B
+
+void etc1_decode_block(const etc1_byte* pIn, etc1_byte* pOut) {
+    etc1_uint32 high = (pIn[0] << 24) | (pIn[1] << 16) | (pIn[2] << 8) | pIn[3];
+    etc1_uint32 low = (pIn[4] << 24) | (pIn[5] << 16) | (pIn[6] << 8) | pIn[7];
+    int r1, r2, g1, g2, b1, b2;
+    decode_base_colors(high, &r1, &g1, &b1, &r2, &g2, &b2);
     int tableIndexA = 7 & (high >> 5);
     int tableIndexB = 7 & (high >> 2);
     const int* tableA = kModifierTable + tableIndexA * 4;
@@ -230,6 +246,84 @@ void etc1_decode_block(const etc1_byte* pIn, etc1_byte* pOut) {
     decode_subblock(pOut, r2, g2, b2, tableB, low, true, flipped);
 }
 
+#if ETC1_DECODE_VECTOR
+
+// The 16 pixels of a block in row order, 8 per vector: the bit of pixel (x, y) in both
+// halves of the low word is y + 4 * x.
+static const short kPixelBits[16] = {
+    1 << 0, 1 << 4, 1 << 8, (short) (1 << 12), 1 << 1, 1 << 5, 1 << 9, (short) (1 << 13),
+    1 << 2, 1 << 6, 1 << 10, (short) (1 << 14), 1 << 3, 1 << 7, 1 << 11, (short) (1 << 15) };
+
+// Pixels of the second subblock, the right half when not flipped, the bottom half when flipped.
+static const short kSecondSubblock[2][16] = {
+    { 0, 0, -1, -1, 0, 0, -1, -1, 0, 0, -1, -1, 0, 0, -1, -1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, -1, -1, -1, -1, -1 } };
+
+// Same output as etc1_decode_block(), the 16 pixels computed at once.
+
+static
+void decode_block_vector(const etc1_byte* pIn, etc1_byte* pOut) {
+    etc1_uint32 high = (pIn[0] << 24) | (pIn[1] << 16) | (pIn[2] << 8) | pIn[3];
+    etc1_uint32 low = (pIn[4] << 24) | (pIn[5] << 16) | (pIn[6] << 8) | pIn[7];
+    int r1, r2, g1, g2, b1, b2;
+    decode_base_colors(high, &r1, &g1, &b1, &r2, &g2, &b2);
+    const int* tableA = kModifierTable + (7 & (high >> 5)) * 4;
+    const int* tableB = kModifierTable + (7 & (high >> 2)) * 4;
+    const short* second = kSecondSubblock[high & 1];
+
+    // the modifiers are { a, b, -a, -b }: the lsb picks b, the msb negates
+    etc1_byte r[16], g[16], b[16];
+#if defined(__SSE2__)
+    const __m128i lsbWord = _mm_set1_epi16((short) (low & 0xffff));
+    const __m128i msbWord = _mm_set1_epi16((short) (low >> 16));
+    __m128i red[2], green[2], blue[2];
+    for (int half = 0; half < 2; half++) {
+        __m128i bits = _mm_loadu_si128((const __m128i*) (kPixelBits + 8 * half));
+        __m128i mask = _mm_loadu_si128((const __m128i*) (second + 8 * half));
+        __m128i lsb = _mm_cmpeq_epi16(_mm_and_si128(lsbWord, bits), bits);
+        __m128i msb = _mm_cmpeq_epi16(_mm_and_si128(msbWord, bits), bits);
+#define ETC1_SELECT(m, x, y) _mm_or_si128(_mm_and_si128((m), (x)), _mm_andnot_si128((m), (y)))
+        __m128i small = ETC1_SELECT(mask, _mm_set1_epi16((short) tableB[0]), _mm_set1_epi16((short) tableA[0]));
+        __m128i large = ETC1_SELECT(mask, _mm_set1_epi16((short) tableB[1]), _mm_set1_epi16((short) tableA[1]));
+        __m128i delta = ETC1_SELECT(lsb, large, small);
+        delta = _mm_sub_epi16(_mm_xor_si128(delta, msb), msb);
+        red[half] = _mm_add_epi16(ETC1_SELECT(mask, _mm_set1_epi16((short) r2), _mm_set1_epi16((short) r1)), delta);
+        green[half] = _mm_add_epi16(ETC1_SELECT(mask, _mm_set1_epi16((short) g2), _mm_set1_epi16((short) g1)), delta);
+        blue[half] = _mm_add_epi16(ETC1_SELECT(mask, _mm_set1_epi16((short) b2), _mm_set1_epi16((short) b1)), delta);
+#undef ETC1_SELECT
+    }
+    // packing with unsigned saturation is the clamp
+    _mm_storeu_si128((__m128i*) r, _mm_packus_epi16(red[0], red[1]));
+    _mm_storeu_si128((__m128i*) g, _mm_packus_epi16(green[0], green[1]));
+    _mm_storeu_si128((__m128i*) b, _mm_packus_epi16(blue[0], blue[1]));
+#else
+    const int16x8_t lsbWord = vdupq_n_s16((short) (low & 0xffff));
+    const int16x8_t msbWord = vdupq_n_s16((short) (low >> 16));
+    for (int half = 0; half < 2; half++) {
+        int16x8_t bits = vld1q_s16(kPixelBits + 8 * half);
+        uint16x8_t mask = vreinterpretq_u16_s16(vld1q_s16(second + 8 * half));
+        uint16x8_t lsb = vtstq_s16(lsbWord, bits);
+        int16x8_t msb = vreinterpretq_s16_u16(vtstq_s16(msbWord, bits));
+        int16x8_t small = vbslq_s16(mask, vdupq_n_s16((short) tableB[0]), vdupq_n_s16((short) tableA[0]));
+        int16x8_t large = vbslq_s16(mask, vdupq_n_s16((short) tableB[1]), vdupq_n_s16((short) tableA[1]));
+        int16x8_t delta = vbslq_s16(lsb, large, small);
+        delta = vsubq_s16(veorq_s16(delta, msb), msb);
+        // narrowing with unsigned saturation is the clamp
+        vst1_u8(r + 8 * half, vqmovun_s16(vaddq_s16(vbslq_s16(mask, vdupq_n_s16((short) r2), vdupq_n_s16((short) r1)), delta)));
+        vst1_u8(g + 8 * half, vqmovun_s16(vaddq_s16(vbslq_s16(mask, vdupq_n_s16((short) g2), vdupq_n_s16((short) g1)), delta)));
+        vst1_u8(b + 8 * half, vqmovun_s16(vaddq_s16(vbslq_s16(mask, vdupq_n_s16((short) b2), vdupq_n_s16((short) b1)), delta)));
+    }
+#endif
+    for (int i = 0; i < 16; i++) {
+        *pOut++ = r[i];
+        *pOut++ = g[i];
+        *pOut++ = b[i];
+    }
+}
+
+#endif // ETC1_DECODE_VECTOR
+
+
 typedef struct {
     etc1_uint32 high;
     etc1_uint32 low;
@@ -558,25 +652,20 @@ int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 heigh
     return 0;
 }
 
-// Decode an entire image.
-// pIn - pointer to encoded data.
-// pOut - pointer to the image data. Will be written such that the Red component of
-//       pixel (x,y) is at pIn + pixelSize * x + stride * y + redOffset. Must be
-//        large enough to store entire image.
-
+// Smallest number of block rows decoded by a task of parallelFor.
+static const size_t kDecodeRowsChunk = 4;
 
-int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
+static
+void decode_block_rows(const etc1_byte* pIn, etc1_byte* pOut,
         etc1_uint32 width, etc1_uint32 height,
-        etc1_uint32 pixelSize, etc1_uint32 stride) {
-    if (pixelSize < 2 || pixelSize > 3) {
-        return -1;
-    }
+        etc1_uint32 pixelSize, etc1_uint32 stride,
+        etc1_uint32 firstRow, etc1_uint32 lastRow) {
     etc1_byte block[ETC1_DECODED_BLOCK_SIZE];
 
     etc1_uint32 encodedWidth = (width + 3) & ~3;
-    etc1_uint32 encodedHeight = (height + 3) & ~3;
+    pIn += firstRow * (encodedWidth / 4) * ETC1_ENCODED_BLOCK_SIZE;
 
-    for (etc1_uint32 y = 0; y < encodedHeight; y += 4) {
+    for (etc1_uint32 y = firstRow * 4; y < lastRow * 4; y += 4) {
         etc1_uint32 yEnd = height - y;
         if (yEnd > 4) {
             yEnd = 4;
@@ -586,7 +675,11 @@ int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
             if (xEnd > 4) {
                 xEnd = 4;
             }
+#if ETC1_DECODE_VECTOR
+            decode_block_vector(pIn, block);
+#else
             etc1_decode_block(pIn, block);
+#endif
             pIn += ETC1_ENCODED_BLOCK_SIZE;
             for (etc1_uint32 cy = 0; cy < yEnd; cy++) {
                 const etc1_byte* q = block + (cy * 4) * 3;
@@ -606,6 +699,28 @@ int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
             }
         }
     }
+}
+
+// Decode an entire image.
+// pIn - pointer to encoded data.
+// pOut - pointer to the image data. Will be written such that the Red component of
+//       pixel (x,y) is at pIn + pixelSize * x + stride * y + redOffset. Must be
+//        large enough to store entire image.
+
+
+int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
+        etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride) {
+    if (pixelSize < 2 || pixelSize > 3) {
+        return -1;
+    }
+
+    // The rows of blocks are decoded on several threads, they never share an output line.
+    etc1_uint32 encodedHeight = (height + 3) & ~3;
+    cocos2d::utils::parallelFor(encodedHeight / 4, kDecodeRowsChunk, [=](size_t begin, size_t end) {
+        decode_block_rows(pIn, pOut, width, height, pixelSize, stride,
+                (etc1_uint32) begin, (etc1_uint32) end);
+    });
     return 0;
 }
 
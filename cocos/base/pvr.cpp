@@ -19,6 +19,7 @@
 #include <assert.h>
 #include <cstdint>
 #include "pvr.h"
+#include "base/ccUtils.h"
 
 #define PVRT_MIN(a,b)            (((a) < (b)) ? (a) : (b))
 #define PVRT_MAX(a,b)            (((a) > (b)) ? (a) : (b))
@@ -551,20 +552,26 @@ static U32 TwiddleUV(U32 YSize, U32 XSize, U32 YPos, U32 XPos)
 }
 
 /*!***********************************************************************
- @Function		Decompress
+ @Function		DecompressRows
  @Input			pCompressedData The PVRTC texture data to decompress
  @Input			Do2BitMode Signifies whether the data is PVRTC2 or PVRTC4
  @Input			XDim X dimension of the texture
  @Input			YDim Y dimension of the texture
  @Input			AssumeImageTiles Assume the texture data tiles
+ @Input			FirstRow First row of pixels to decompress
+ @Input			LastRow Row of pixels after the last one to decompress
  @Modified		pResultImage The decompressed texture data
- @Description	Decompresses PVRTC to RGBA 8888
+ @Description	Decompresses rows of PVRTC to RGBA 8888. Every pixel only
+ depends on the compressed data, so that the rows may be
+ decompressed by several calls at once.
  *************************************************************************/
-static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
+static void PVRDecompressRows(AMTC_BLOCK_STRUCT *pCompressedData,
                        const bool Do2bitMode,
                        const int XDim,
                        const int YDim,
                        const int AssumeImageTiles,
+                       const int FirstRow,
+                       const int LastRow,
                        unsigned char* pResultImage)
 {
 	int x, y;
@@ -614,7 +621,7 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
      
      Note that this is a hideously inefficient way to do this!
      */
-	for(y = 0; y < YDim; y++)
+	for(y = FirstRow; y < LastRow; y++)
 	{
 		for(x = 0; x < XDim; x++)
 		{
@@ -708,6 +715,32 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
 	}
 }
 
+/*!***********************************************************************
+ @Function		Decompress
+ @Input			pCompressedData The PVRTC texture data to decompress
+ @Input			Do2BitMode Signifies whether the data is PVRTC2 or PVRTC4
+ @Input			XDim X dimension of the texture
+ @Input			YDim Y dimension of the texture
+ @Input			AssumeImageTiles Assume the texture data tiles
+ @Modified		pResultImage The decompressed texture data
+ @Description	Decompresses PVRTC to RGBA 8888, the rows of pixels are
+ shared by the threads of parallelFor
+ *************************************************************************/
+static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
+                       const bool Do2bitMode,
+                       const int XDim,
+                       const int YDim,
+                       const int AssumeImageTiles,
+                       unsigned char* pResultImage)
+{
+	// 16 rows are 4 rows of blocks, the smallest part worth another thread
+	cocos2d::utils::parallelFor(YDim, 16, [=](size_t Begin, size_t End)
+	{
+		PVRDecompressRows(pCompressedData, Do2bitMode, XDim, YDim, AssumeImageTiles,
+						  (int)Begin, (int)End, pResultImage);
+	});
+}
+
 /*****************************************************************************
  End of file (pvr.cpp)
  *****************************************************************************/
\ No newline at end of file
@@ -23,6 +23,10 @@
  ****************************************************************************/
 
 #include "s3tc.h"
+#include "base/ccUtils.h"
+
+// smallest number of block rows decoded by a task of parallelFor
+static const size_t DECODE_ROWS_CHUNK = 4;
 
 //Decode S3TC encode block to 4x4 RGB32 pixels
 static void s3tc_decode_block(uint8_t **blockData,
@@ -144,39 +148,45 @@ void s3tc_decode(uint8_t *encodeData,             //in_data
                  const int pixelsHeight,
                  S3TCDecodeFlag decodeFlag)
 {
-    uint32_t *decodeBlockData = (uint32_t *)decodeData;
-    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 3 * pixelsWidth)   //stride = 3*width
-    {
-        for(int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)            //skip 4 pixels
+    // the block rows are independent, every task finds where its rows start in both buffers
+    const int blocksPerRow = pixelsWidth / 4;
+    const size_t blockSize = S3TCDecodeFlag::DXT1 == decodeFlag ? 8 : 16;
+    cocos2d::utils::parallelFor(pixelsHeight / 4, DECODE_ROWS_CHUNK, [=](size_t begin, size_t end) {
+        uint8_t *blockData = encodeData + begin * blocksPerRow * blockSize;
+        uint32_t *decodeBlockData = (uint32_t *)decodeData + begin * 4 * pixelsWidth;
+        for (size_t block_y = begin; block_y < end; ++block_y, decodeBlockData += 3 * pixelsWidth)   //stride = 3*width
         {
-            uint64_t blockAlpha = 0;
-            
-            switch (decodeFlag)
+            for(int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)            //skip 4 pixels
             {
-                case S3TCDecodeFlag::DXT1:
-                {
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 0, 0LL, S3TCDecodeFlag::DXT1);
-                }
-                    break;
-                case S3TCDecodeFlag::DXT3:
-                {
-                    memcpy((void *)&blockAlpha, encodeData, 8);
-                    encodeData += 8;
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT3);
-                }
-                    break;
-                case S3TCDecodeFlag::DXT5:
+                uint64_t blockAlpha = 0;
+            
+                switch (decodeFlag)
                 {
-                    memcpy((void *)&blockAlpha, encodeData, 8);
-                    encodeData += 8;
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT5);
-                }
-                    break;
-                default:
-                    break;
-            }//switch
-        }//for block_x
-    }//for block_y
+                    case S3TCDecodeFlag::DXT1:
+                    {
+                        s3tc_decode_block(&blockData, decodeBlockData, pixelsWidth, 0, 0LL, S3TCDecodeFlag::DXT1);
+                    }
+                        break;
+                    case S3TCDecodeFlag::DXT3:
+                    {
+                        memcpy((void *)&blockAlpha, blockData, 8);
+                        blockData += 8;
+                        s3tc_decode_block(&blockData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT3);
+                    }
+                        break;
+                    case S3TCDecodeFlag::DXT5:
+                    {
+                        memcpy((void *)&blockAlpha, blockData, 8);
+                        blockData += 8;
+                        s3tc_decode_block(&blockData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT5);
+                    }
+                        break;
+                    default:
+                        break;
+                }//switch
+            }//for block_x
+        }//for block_y
+    });
 }
 
 
@@ -162,6 +162,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCRenderState.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderThread.h"
 #include "renderer/CCTechnique.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCube.h"
@@ -192,6 +193,7 @@ THE SOFTWARE.
 #include "platform/CCCommon.h"
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCFilePackage.h"
 #include "platform/CCImage.h"
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
@@ -261,6 +263,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCSpriteFrameIndex.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
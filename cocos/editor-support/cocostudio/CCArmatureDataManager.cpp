@@ -114,7 +114,9 @@ void ArmatureDataManager::removeArmatureFileInfo(const std::string& configFilePa
             SpriteFrameCacheHelper::getInstance()->removeSpriteFrameFromFile(str);
         }
 
+        _relativeDataMutex.lock();
         _relativeDatas.erase(configFilePath);
+        _relativeDataMutex.unlock();
         DataReaderHelper::getInstance()->removeConfigFile(configFilePath);
     }
 }
@@ -252,6 +254,7 @@ const cocos2d::Map<std::string, TextureData*>& ArmatureDataManager::getTextureDa
 
 void CCArmatureDataManager::addRelativeData(const std::string& configFilePath)
 {
+    std::lock_guard<std::mutex> lock(_relativeDataMutex);
     if (_relativeDatas.find(configFilePath) == _relativeDatas.end())
     {
         _relativeDatas[configFilePath] = RelativeData();
@@ -260,6 +263,8 @@ void CCArmatureDataManager::addRelativeData(const std::string& configFilePath)
 
 RelativeData *CCArmatureDataManager::getRelativeData(const std::string&  configFilePath)
 {
+    // the datas are nodes, they stay where they are while other ones are added
+    std::lock_guard<std::mutex> lock(_relativeDataMutex);
     return &_relativeDatas[configFilePath];
 }
 
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "cocostudio/CCDatas.h"
 #include "cocostudio/CocosStudioExport.h"
 
+#include <mutex>
+
 namespace cocostudio {
 
 struct RelativeData
@@ -200,6 +202,8 @@ private:
     bool _autoLoadSpriteFile;
 
     std::unordered_map<std::string, RelativeData> _relativeDatas;
+    // the loading threads of DataReaderHelper look the files up while the main thread adds other ones
+    std::mutex _relativeDataMutex;
 };
 
 
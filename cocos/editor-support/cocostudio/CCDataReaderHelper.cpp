@@ -38,6 +38,8 @@ THE SOFTWARE.
 
 #include "cocostudio/CocoLoader.h"
 
+#include <algorithm>
+
 
 using namespace cocos2d;
 
@@ -155,31 +157,19 @@ DataReaderHelper *DataReaderHelper::_dataReaderHelper = nullptr;
 //! Async load
 void DataReaderHelper::loadData()
 {
-    AsyncStruct *pAsyncStruct = nullptr;
-
     while (true)
     {
-        std::queue<AsyncStruct *> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock(); // get async struct from queue
-        if (pQueue->empty())
+        AsyncStruct *pAsyncStruct = nullptr;
         {
-            _asyncStructQueueMutex.unlock();
+            std::unique_lock<std::mutex> lock(_asyncStructQueueMutex);
+            _sleepCondition.wait(lock, [this]{ return need_quit || !_asyncStructQueue.empty(); });
             if (need_quit)
             {
                 break;
             }
-            else
-            {
-				std::unique_lock<std::mutex> lk(_sleepMutex);
-				_sleepCondition.wait(lk);
-                continue;
-            }
-        }
-        else
-        {
-            pAsyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
+
+            pAsyncStruct = _asyncStructQueue.front();
+            _asyncStructQueue.pop_front();
         }
 
         // generate data info
@@ -203,17 +193,9 @@ void DataReaderHelper::loadData()
 
         // put the image info into the queue
         _dataInfoMutex.lock();
-        _dataQueue->push(pDataInfo);
+        _dataQueue.push(pDataInfo);
         _dataInfoMutex.unlock();
     }
-
-    if( _asyncStructQueue != nullptr )
-    {
-        delete _asyncStructQueue;
-        _asyncStructQueue = nullptr;
-        delete _dataQueue;
-        _dataQueue = nullptr;
-    }
 }
 
 
@@ -246,24 +228,42 @@ void DataReaderHelper::purge()
 
 
 DataReaderHelper::DataReaderHelper()
-	: _loadingThread(nullptr)
+	: _loadingThreadCount(0)
 	, _asyncRefCount(0)
 	, _asyncRefTotalCount(0)
 	, need_quit(false)
-	, _asyncStructQueue(nullptr)
-	, _dataQueue(nullptr)
 {
-
+    _loadingThreadCount = std::min(std::max((int)std::thread::hardware_concurrency() - 1, 1), 4);
 }
 
 DataReaderHelper::~DataReaderHelper()
 {
-    need_quit = true;
+    {
+        std::lock_guard<std::mutex> lock(_asyncStructQueueMutex);
+        need_quit = true;
+    }
+	_sleepCondition.notify_all();
+	for (auto& thread : _loadingThreads)
+	{
+	    thread.join();
+	}
 
-	_sleepCondition.notify_one();
-	if (_loadingThread) _loadingThread->join();
+    // the files being loaded are dropped without calling their selector
+    while (!_dataQueue.empty())
+    {
+        delete _dataQueue.front();
+        _dataQueue.pop();
+    }
+    for (auto asyncStruct : _pendingAsyncStructs)
+    {
+        CC_SAFE_RELEASE(asyncStruct->target);
+        delete asyncStruct;
+    }
+    if (_asyncRefCount > 0)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(DataReaderHelper::addDataAsyncCallBack), this);
+    }
 
-	CC_SAFE_DELETE(_loadingThread);
 	_dataReaderHelper = nullptr;
 }
 
@@ -331,6 +331,11 @@ void DataReaderHelper::addDataFromFile(const std::string& filePath)
 }
 
 void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const std::string& plistPath, const std::string& filePath, Ref *target, SEL_SCHEDULE selector)
+{
+    addDataFromFileAsync(imagePath, plistPath, filePath, target, selector, 0);
+}
+
+void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const std::string& plistPath, const std::string& filePath, Ref *target, SEL_SCHEDULE selector, int priority)
 {
     /*
     * Check if file is already added to ArmatureDataManager, if then return.
@@ -370,15 +375,13 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
 
 
     // lazy init
-    if (_asyncStructQueue == nullptr)
+    if (_loadingThreads.empty())
     {
-        _asyncStructQueue = new std::queue<AsyncStruct *>();
-        _dataQueue = new std::queue<DataInfo *>();
-
-		// create a new thread to load images
-		_loadingThread = new std::thread(&DataReaderHelper::loadData, this);
-
-        need_quit = false;
+        int count = std::max(_loadingThreadCount, 1);
+        for (int i = 0; i < count; ++i)
+        {
+            _loadingThreads.push_back(std::thread(&DataReaderHelper::loadData, this));
+        }
     }
 
     if (0 == _asyncRefCount)
@@ -401,6 +404,7 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     data->target = target;
     data->selector = selector;
     data->autoLoadSpriteFile = ArmatureDataManager::getInstance()->isAutoLoadSpriteFile();
+    data->priority = priority;
 
     data->imagePath = imagePath;
     data->plistPath = plistPath;
@@ -443,31 +447,94 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     }
 
 
-    // add async struct into queue
+    _pendingAsyncStructs.push_back(data);
+
+    // add async struct into queue, after the ones of the same priority
     _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
+    auto iter = std::find_if(_asyncStructQueue.begin(), _asyncStructQueue.end(), [priority](AsyncStruct *queued) { return queued->priority < priority; });
+    _asyncStructQueue.insert(iter, data);
     _asyncStructQueueMutex.unlock();
 
     _sleepCondition.notify_one();
 }
 
-void DataReaderHelper::addDataAsyncCallBack(float dt)
+void DataReaderHelper::cancelDataFromFileAsync(const std::string& filePath)
 {
-    // the data is generated in loading thread
-    std::queue<DataInfo *> *dataQueue = _dataQueue;
+    auto iter = std::find_if(_pendingAsyncStructs.begin(), _pendingAsyncStructs.end(), [&filePath](AsyncStruct *pending) { return pending->filename == filePath; });
+    if (iter != _pendingAsyncStructs.end())
+    {
+        dropAsyncStruct(*iter);
+    }
+}
 
-    _dataInfoMutex.lock();
-    if (dataQueue->empty())
+void DataReaderHelper::cancelDataAsyncForTarget(Ref *target)
+{
+    std::vector<AsyncStruct *> cancelled;
+    for (auto pending : _pendingAsyncStructs)
     {
-        _dataInfoMutex.unlock();
+        if (target && pending->target == target)
+        {
+            cancelled.push_back(pending);
+        }
     }
-    else
+
+    for (auto asyncStruct : cancelled)
+    {
+        dropAsyncStruct(asyncStruct);
+    }
+}
+
+void DataReaderHelper::dropAsyncStruct(AsyncStruct *asyncStruct)
+{
+    bool queued = false;
+    _asyncStructQueueMutex.lock();
+    auto iter = std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct);
+    if (iter != _asyncStructQueue.end())
+    {
+        _asyncStructQueue.erase(iter);
+        queued = true;
+    }
+    _asyncStructQueueMutex.unlock();
+
+    CC_SAFE_RELEASE_NULL(asyncStruct->target);
+    asyncStruct->selector = nullptr;
+
+    // being decoded, addDataAsyncCallBack() will only forget it
+    if (!queued)
     {
-        DataInfo *pDataInfo = dataQueue->front();
-        dataQueue->pop();
+        return;
+    }
+
+    removeConfigFile(asyncStruct->filename);
+    _pendingAsyncStructs.erase(std::find(_pendingAsyncStructs.begin(), _pendingAsyncStructs.end(), asyncStruct));
+    delete asyncStruct;
+
+    --_asyncRefCount;
+    --_asyncRefTotalCount;
+    if (0 == _asyncRefCount)
+    {
+        _asyncRefTotalCount = 0;
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(DataReaderHelper::addDataAsyncCallBack), this);
+    }
+}
+
+void DataReaderHelper::addDataAsyncCallBack(float dt)
+{
+    // the data is generated in loading threads, the ones ready are all handled, but the sprite frames of a single file per frame
+    while (true)
+    {
+        _dataInfoMutex.lock();
+        if (_dataQueue.empty())
+        {
+            _dataInfoMutex.unlock();
+            break;
+        }
+        DataInfo *pDataInfo = _dataQueue.front();
+        _dataQueue.pop();
         _dataInfoMutex.unlock();
 
         AsyncStruct *pAsyncStruct = pDataInfo->asyncStruct;
+        bool addedSpriteFrames = false;
 
 
         if (pAsyncStruct->imagePath != "" && pAsyncStruct->plistPath != "")
@@ -475,6 +542,7 @@ void DataReaderHelper::addDataAsyncCallBack(float dt)
             _getFileMutex.lock();
             ArmatureDataManager::getInstance()->addSpriteFrameFromFile(pAsyncStruct->plistPath.c_str(), pAsyncStruct->imagePath.c_str(), pDataInfo->filename.c_str());
             _getFileMutex.unlock();
+            addedSpriteFrames = true;
         }
 
         while (!pDataInfo->configFileQueue.empty())
@@ -484,19 +552,21 @@ void DataReaderHelper::addDataAsyncCallBack(float dt)
             ArmatureDataManager::getInstance()->addSpriteFrameFromFile((pAsyncStruct->baseFilePath + configPath + ".plist").c_str(), (pAsyncStruct->baseFilePath + configPath + ".png").c_str(),pDataInfo->filename.c_str());
             _getFileMutex.unlock();
             pDataInfo->configFileQueue.pop();
+            addedSpriteFrames = true;
         }
 
 
         Ref* target = pAsyncStruct->target;
         SEL_SCHEDULE selector = pAsyncStruct->selector;
 
+        _pendingAsyncStructs.erase(std::find(_pendingAsyncStructs.begin(), _pendingAsyncStructs.end(), pAsyncStruct));
         --_asyncRefCount;
 
         if (target && selector)
         {
             (target->*selector)((_asyncRefTotalCount - _asyncRefCount) / (float)_asyncRefTotalCount);
-            target->release();
         }
+        CC_SAFE_RELEASE(target);
 
 
         delete pAsyncStruct;
@@ -506,6 +576,12 @@ void DataReaderHelper::addDataAsyncCallBack(float dt)
         {
             _asyncRefTotalCount = 0;
             Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(DataReaderHelper::addDataAsyncCallBack), this);
+            break;
+        }
+
+        if (addedSpriteFrames)
+        {
+            break;
         }
     }
 }
@@ -542,72 +618,75 @@ void DataReaderHelper::addDataFromCache(const std::string& pFileContent, DataInf
 
 
     /*
-    * Begin decode armature data from xml
+    * Begin decode armature data from xml, the armatures and then the animations are decoded in parallel
     */
+    std::vector<tinyxml2::XMLElement *> armatureXMLs;
     tinyxml2::XMLElement *armaturesXML = root->FirstChildElement(ARMATURES);
-    tinyxml2::XMLElement *armatureXML = armaturesXML->FirstChildElement(ARMATURE);
-    while(armatureXML)
+    for (tinyxml2::XMLElement *armatureXML = armaturesXML->FirstChildElement(ARMATURE); armatureXML; armatureXML = armatureXML->NextSiblingElement(ARMATURE))
     {
-        ArmatureData *armatureData = DataReaderHelper::decodeArmature(armatureXML, dataInfo);
+        armatureXMLs.push_back(armatureXML);
+    }
 
-        if (dataInfo->asyncStruct)
+    std::vector<ArmatureData *> armatureDatas(armatureXMLs.size());
+    utils::parallelFor(armatureXMLs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            _dataReaderHelper->_addDataMutex.lock();
+            armatureDatas[i] = DataReaderHelper::decodeArmature(armatureXMLs[i], dataInfo);
         }
-        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
-        armatureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
-
-        armatureXML = armatureXML->NextSiblingElement(ARMATURE);
-    }
+    });
+    addDecodedDatas(armatureDatas, &ArmatureDataManager::addArmatureData, dataInfo);
 
 
     /*
     * Begin decode animation data from xml
     */
+    std::vector<tinyxml2::XMLElement *> animationXMLs;
     tinyxml2::XMLElement *animationsXML = root->FirstChildElement(ANIMATIONS);
-    tinyxml2::XMLElement *animationXML = animationsXML->FirstChildElement(ANIMATION);
-    while(animationXML)
+    for (tinyxml2::XMLElement *animationXML = animationsXML->FirstChildElement(ANIMATION); animationXML; animationXML = animationXML->NextSiblingElement(ANIMATION))
     {
-        AnimationData *animationData = DataReaderHelper::decodeAnimation(animationXML, dataInfo);
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
-        animationData->release();
-        if (dataInfo->asyncStruct)
+        animationXMLs.push_back(animationXML);
+    }
+
+    std::vector<AnimationData *> animationDatas(animationXMLs.size());
+    utils::parallelFor(animationXMLs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            animationDatas[i] = DataReaderHelper::decodeAnimation(animationXMLs[i], dataInfo);
         }
-        animationXML = animationXML->NextSiblingElement(ANIMATION);
-    }
+    });
+    addDecodedDatas(animationDatas, &ArmatureDataManager::addAnimationData, dataInfo);
 
 
     /*
     * Begin decode texture data from xml
     */
+    std::vector<TextureData *> textureDatas;
     tinyxml2::XMLElement *texturesXML = root->FirstChildElement(TEXTURE_ATLAS);
     tinyxml2::XMLElement *textureXML = texturesXML->FirstChildElement(SUB_TEXTURE);
     while(textureXML)
     {
-        TextureData *textureData = DataReaderHelper::decodeTexture(textureXML, dataInfo);
-
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
-        textureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        textureDatas.push_back(DataReaderHelper::decodeTexture(textureXML, dataInfo));
         textureXML = textureXML->NextSiblingElement(SUB_TEXTURE);
     }
+    addDecodedDatas(textureDatas, &ArmatureDataManager::addTextureData, dataInfo);
+}
+
+template <typename T>
+void DataReaderHelper::addDecodedDatas(std::vector<T *> &datas, void (ArmatureDataManager::*add)(const std::string&, T *, const std::string&), DataInfo *dataInfo)
+{
+    // the loading threads and the main thread add to ArmatureDataManager at once
+    std::unique_lock<std::mutex> lock;
+    if (_dataReaderHelper)
+    {
+        lock = std::unique_lock<std::mutex>(_dataReaderHelper->_addDataMutex);
+    }
+
+    for (auto data : datas)
+    {
+        (ArmatureDataManager::getInstance()->*add)(data->name, data, dataInfo->filename);
+        data->release();
+    }
+    datas.clear();
 }
 
 ArmatureData *DataReaderHelper::decodeArmature(tinyxml2::XMLElement *armatureXML, DataInfo *dataInfo)
@@ -728,7 +807,16 @@ AnimationData *DataReaderHelper::decodeAnimation(tinyxml2::XMLElement *animation
 
     const char	*name = animationXML->Attribute(A_NAME);
 
-    ArmatureData *armatureData = ArmatureDataManager::getInstance()->getArmatureData(name);
+    ArmatureData *armatureData = nullptr;
+    if (_dataReaderHelper)
+    {
+        std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+        armatureData = ArmatureDataManager::getInstance()->getArmatureData(name);
+    }
+    else
+    {
+        armatureData = ArmatureDataManager::getInstance()->getArmatureData(name);
+    }
 
     aniData->name = name;
 
@@ -1246,62 +1334,45 @@ void DataReaderHelper::addDataFromJsonCache(const std::string& fileContent, Data
 	
 	dataInfo->contentScale = DICTOOL->getFloatValue_json(json, CONTENT_SCALE, 1.0f);
 	
-    // Decode armatures
+    // Decode armatures, then animations, in parallel
 	int length = DICTOOL->getArrayCount_json(json, ARMATURE_DATA);
-	for (int i = 0; i < length; i++)
-    {
-		const rapidjson::Value &armatureDic = DICTOOL->getSubDictionary_json(json, ARMATURE_DATA, i); 
-        ArmatureData *armatureData = decodeArmature(armatureDic, dataInfo);
-
-        if (dataInfo->asyncStruct)
+    std::vector<ArmatureData *> armatureDatas(length);
+    utils::parallelFor(length, 1, [&](size_t begin, size_t end) {
+        // decodeArmature() writes the version
+        DataInfo chunkDataInfo = *dataInfo;
+        for (size_t i = begin; i < end; ++i)
         {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
-        armatureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
+            const rapidjson::Value &armatureDic = DICTOOL->getSubDictionary_json(json, ARMATURE_DATA, (int)i);
+            armatureDatas[i] = decodeArmature(armatureDic, &chunkDataInfo);
         }
+    });
+    if (!armatureDatas.empty())
+    {
+        dataInfo->cocoStudioVersion = armatureDatas.back()->dataVersion;
     }
+    addDecodedDatas(armatureDatas, &ArmatureDataManager::addArmatureData, dataInfo);
 
     // Decode animations
 	length = DICTOOL->getArrayCount_json(json, ANIMATION_DATA); //json[ANIMATION_DATA].IsNull() ? 0 : json[ANIMATION_DATA].Size();
-    for (int i = 0; i < length; i++)
-    {
-		const rapidjson::Value &animationDic = DICTOOL->getSubDictionary_json(json, ANIMATION_DATA, i);
-        AnimationData *animationData = decodeAnimation(animationDic, dataInfo);
-
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
-        animationData->release();
-        if (dataInfo->asyncStruct)
+    std::vector<AnimationData *> animationDatas(length);
+    utils::parallelFor(length, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            const rapidjson::Value &animationDic = DICTOOL->getSubDictionary_json(json, ANIMATION_DATA, (int)i);
+            animationDatas[i] = decodeAnimation(animationDic, dataInfo);
         }
-    }
+    });
+    addDecodedDatas(animationDatas, &ArmatureDataManager::addAnimationData, dataInfo);
 
     // Decode textures
     length = DICTOOL->getArrayCount_json(json, TEXTURE_DATA); 
+    std::vector<TextureData *> textureDatas;
     for (int i = 0; i < length; i++)
     {
         const rapidjson::Value &textureDic =  DICTOOL->getSubDictionary_json(json, TEXTURE_DATA, i);
-        TextureData *textureData = decodeTexture(textureDic);
-
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
-        textureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        textureDatas.push_back(decodeTexture(textureDic));
     }
+    addDecodedDatas(textureDatas, &ArmatureDataManager::addTextureData, dataInfo);
 
     // Auto load sprite file
     bool autoLoad = dataInfo->asyncStruct == nullptr ? ArmatureDataManager::getInstance()->isAutoLoadSpriteFile() : dataInfo->asyncStruct->autoLoadSpriteFile;
@@ -1778,60 +1849,44 @@ void DataReaderHelper::decodeNode(BaseData *node, const rapidjson::Value& json,
                     {
                         pDataArray = tpChildArray[i].GetChildArray(&tCocoLoader);
                         length = tpChildArray[i].GetChildNum();
-                        ArmatureData * armatureData;
-                        for (int ii = 0; ii < length; ++ii)
-                        {
-                            armatureData = decodeArmature(&tCocoLoader, &pDataArray[ii], dataInfo);
-                            if (dataInfo->asyncStruct)
+                        std::vector<ArmatureData *> armatureDatas(length);
+                        utils::parallelFor(length, 1, [&](size_t begin, size_t end) {
+                            // decodeArmature() writes the version
+                            DataInfo chunkDataInfo = *dataInfo;
+                            for (size_t ii = begin; ii < end; ++ii)
                             {
-                                _dataReaderHelper->_addDataMutex.lock();
-                            }
-                            ArmatureDataManager::getInstance()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
-                            armatureData->release();
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.unlock();
+                                armatureDatas[ii] = decodeArmature(&tCocoLoader, &pDataArray[ii], &chunkDataInfo);
                             }
+                        });
+                        if (!armatureDatas.empty())
+                        {
+                            dataInfo->cocoStudioVersion = armatureDatas.back()->dataVersion;
                         }
+                        addDecodedDatas(armatureDatas, &ArmatureDataManager::addArmatureData, dataInfo);
                     }
                     else if ( 0 == key.compare(ANIMATION_DATA))
                     {
                         pDataArray = tpChildArray[i].GetChildArray(&tCocoLoader);
                         length = tpChildArray[i].GetChildNum();
-                        AnimationData *animationData;
-                        for (int ii = 0; ii < length; ++ii)
-                        {
-                            animationData = decodeAnimation(&tCocoLoader, &pDataArray[ii], dataInfo);
-                            if (dataInfo->asyncStruct)
+                        std::vector<AnimationData *> animationDatas(length);
+                        utils::parallelFor(length, 1, [&](size_t begin, size_t end) {
+                            for (size_t ii = begin; ii < end; ++ii)
                             {
-                                _dataReaderHelper->_addDataMutex.lock();
+                                animationDatas[ii] = decodeAnimation(&tCocoLoader, &pDataArray[ii], dataInfo);
                             }
-                            ArmatureDataManager::getInstance()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
-                            animationData->release();
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.unlock();
-                            }
-                        }
+                        });
+                        addDecodedDatas(animationDatas, &ArmatureDataManager::addAnimationData, dataInfo);
                     }
                     else if (key.compare(TEXTURE_DATA) == 0)
                     {
                         pDataArray = tpChildArray[i].GetChildArray(&tCocoLoader);
                         length = tpChildArray[i].GetChildNum();
+                        std::vector<TextureData *> textureDatas;
                         for (int ii = 0; ii < length; ++ii)
                         {
-                            TextureData *textureData = decodeTexture(&tCocoLoader, &pDataArray[ii]);
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.lock();
-                            }
-                            ArmatureDataManager::getInstance()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
-                            textureData->release();
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.unlock();
-                            }
+                            textureDatas.push_back(decodeTexture(&tCocoLoader, &pDataArray[ii]));
                         }
+                        addDecodedDatas(textureDatas, &ArmatureDataManager::addTextureData, dataInfo);
                     }
                 }
                 // Auto losprite file
@@ -35,7 +35,9 @@ THE SOFTWARE.
 #include "DictionaryHelper.h"
 
 #include <string>
+#include <deque>
 #include <queue>
+#include <vector>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
@@ -72,6 +74,7 @@ protected:
         cocos2d::Ref       *target;
         cocos2d::SEL_SCHEDULE   selector;
         bool           autoLoadSpriteFile;
+        int            priority;
 
         std::string    imagePath;
         std::string    plistPath;
@@ -117,6 +120,33 @@ public:
     void addDataFromFile(const std::string& filePath);
     void addDataFromFileAsync(const std::string& imagePath, const std::string& plistPath, const std::string& filePath, cocos2d::Ref *target, cocos2d::SEL_SCHEDULE selector);
 
+    /**
+     * Same as above, the files of a higher priority are decoded first, the files of a same priority in the order they are added.
+     * Several files are decoded at once, see setLoadingThreadCount().
+     * @since v3.9
+     */
+    void addDataFromFileAsync(const std::string& imagePath, const std::string& plistPath, const std::string& filePath, cocos2d::Ref *target, cocos2d::SEL_SCHEDULE selector, int priority);
+
+    /**
+     * Drops the file if it isn't decoded yet. Otherwise the file is still added, but its selector won't be called.
+     * @since v3.9
+     */
+    void cancelDataFromFileAsync(const std::string& filePath);
+
+    /**
+     * Cancels every file whose selector would be called on target, as cancelDataFromFileAsync() does.
+     * @since v3.9
+     */
+    void cancelDataAsyncForTarget(cocos2d::Ref *target);
+
+    /**
+     * Number of files decoded at once, one less than the hardware threads between 1 and 4 by default.
+     * Used when the loading threads are started, by the first asynchronous load.
+     * @since v3.9
+     */
+    void setLoadingThreadCount(int count) { _loadingThreadCount = count; }
+    int getLoadingThreadCount() const { return _loadingThreadCount; }
+
     void addDataAsyncCallBack(float dt);
 
     void removeConfigFile(const std::string& configFile);
@@ -197,14 +227,18 @@ public:
 protected:
     void loadData();
 
+    // adds the datas decoded in parallel in the order of the file, and releases them
+    template <typename T>
+    static void addDecodedDatas(std::vector<T *> &datas, void (ArmatureDataManager::*add)(const std::string&, T *, const std::string&), DataInfo *dataInfo);
 
+    void dropAsyncStruct(AsyncStruct *asyncStruct);
 
 
+    // wakes the loading threads, with _asyncStructQueueMutex
     std::condition_variable        _sleepCondition;
 
-    std::thread     *_loadingThread;
-
-    std::mutex      _sleepMutex;
+    std::vector<std::thread> _loadingThreads;
+    int _loadingThreadCount;
 
     std::mutex      _asyncStructQueueMutex;
     std::mutex      _dataInfoMutex;
@@ -219,8 +253,12 @@ protected:
 
     bool need_quit;
 
-    std::queue<AsyncStruct *> *_asyncStructQueue;
-    std::queue<DataInfo *>   *_dataQueue;
+    // sorted by decreasing priority
+    std::deque<AsyncStruct *> _asyncStructQueue;
+    std::queue<DataInfo *>   _dataQueue;
+
+    // main thread only, the files whose data info isn't handled by addDataAsyncCallBack() yet
+    std::vector<AsyncStruct *> _pendingAsyncStructs;
 
     static std::vector<std::string> _configFileList;
 
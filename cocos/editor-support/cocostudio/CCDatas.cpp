@@ -26,10 +26,111 @@ THE SOFTWARE.
 #include "cocostudio/CCUtilMath.h"
 #include "cocostudio/CCTransformHelp.h"
 
+#include <mutex>
+
 using namespace cocos2d;
 
 namespace cocostudio {
 
+namespace
+{
+/**
+* Blocks of one size, carved from pages and kept in a free list once released. The pages are never given back,
+* and the pools are leaked on purpose, since a data may still be released while the process exits.
+*/
+class DataBlockPool
+{
+public:
+    explicit DataBlockPool(size_t size)
+        : _size(size)
+        , _blockSize((size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+        , _freeList(nullptr)
+    {
+    }
+
+    void *allocate(size_t size)
+    {
+        // a derived class, which inherits the operators
+        if (size != _size)
+            return ::operator new(size);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_freeList)
+        {
+            char *page = (char *)::operator new(_blockSize * BLOCKS_PER_PAGE);
+            for (size_t i = BLOCKS_PER_PAGE; i-- > 0;)
+            {
+                Block *block = (Block *)(page + i * _blockSize);
+                block->next = _freeList;
+                _freeList = block;
+            }
+        }
+
+        Block *block = _freeList;
+        _freeList = block->next;
+        return block;
+    }
+
+    void deallocate(void *object, size_t size)
+    {
+        if (!object)
+            return;
+        if (size != _size)
+        {
+            ::operator delete(object);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        Block *block = (Block *)object;
+        block->next = _freeList;
+        _freeList = block;
+    }
+
+private:
+    struct Block
+    {
+        Block *next;
+    };
+
+    static const size_t ALIGNMENT = 16;
+    static const size_t BLOCKS_PER_PAGE = 256;
+
+    size_t _size;
+    size_t _blockSize;
+    Block *_freeList;
+    std::mutex _mutex;
+};
+
+template <typename T>
+DataBlockPool &getDataBlockPool()
+{
+    static DataBlockPool *s_pool = new DataBlockPool(sizeof(T));
+    return *s_pool;
+}
+}
+
+#define CC_DATA_POOL_OPERATORS(varType)\
+void *varType::operator new(size_t size)\
+{\
+    return getDataBlockPool<varType>().allocate(size);\
+}\
+void *varType::operator new(size_t size, const std::nothrow_t &nothrow) throw()\
+{\
+    try\
+    {\
+        return getDataBlockPool<varType>().allocate(size);\
+    }\
+    catch (...)\
+    {\
+        return nullptr;\
+    }\
+}\
+void varType::operator delete(void *object, size_t size)\
+{\
+    getDataBlockPool<varType>().deallocate(object, size);\
+}
+
 
 BaseData::BaseData()
     : x(0.0f)
@@ -196,6 +297,8 @@ ParticleDisplayData::ParticleDisplayData(void)
 
 
 
+CC_DATA_POOL_OPERATORS(BoneData)
+
 BoneData::BoneData(void)
     : name("")
     , parentName("")
@@ -246,6 +349,8 @@ BoneData *ArmatureData::getBoneData(const std::string& boneName)
     return static_cast<BoneData*>(boneDataDic.at(boneName));
 }
 
+CC_DATA_POOL_OPERATORS(FrameData)
+
 FrameData::FrameData(void)
     : frameID(0)
     , duration(1)
@@ -295,6 +400,8 @@ void FrameData::copy(const BaseData *baseData)
     }
 }
 
+CC_DATA_POOL_OPERATORS(MovementBoneData)
+
 MovementBoneData::MovementBoneData()
     : delay(0.0f)
     , scale(1.0f)
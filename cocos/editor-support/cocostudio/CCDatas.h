@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include "2d/CCTweenFunction.h"
 #include "cocostudio/CocosStudioExport.h"
 
+#include <new>
+
 
 #define CC_CREATE_NO_PARAM_NO_INIT(varType)\
 public: \
@@ -62,6 +64,16 @@ public: \
     return nullptr;\
 }
 
+/**
+ * The datas a file holds by thousands are allocated from a pool per class, which the loading threads share.
+ * The derived classes of a pooled class are allocated as usual.
+ */
+#define CC_USE_DATA_POOL(varType)\
+public: \
+    static void *operator new(size_t size);\
+    static void *operator new(size_t size, const std::nothrow_t &nothrow) throw();\
+    static void operator delete(void *object, size_t size);
+
 namespace cocostudio {
 
 /**
@@ -239,6 +251,7 @@ class CC_STUDIO_DLL BoneData : public BaseData
 {
 public:
     CC_CREATE_NO_PARAM(BoneData)
+    CC_USE_DATA_POOL(BoneData)
 public:
     /**
      * @js ctor
@@ -319,6 +332,7 @@ class CC_STUDIO_DLL FrameData : public BaseData
 {
 public:
     CC_CREATE_NO_PARAM_NO_INIT(FrameData)
+    CC_USE_DATA_POOL(FrameData)
 public:
     /**
      * @js ctor
@@ -366,6 +380,7 @@ class CC_STUDIO_DLL MovementBoneData : public cocos2d::Ref
 {
 public:
     CC_CREATE_NO_PARAM(MovementBoneData)
+    CC_USE_DATA_POOL(MovementBoneData)
 public:
     /**
      * @js ctor
@@ -101,6 +101,10 @@ NavMesh::NavMesh()
     , _navMeshQuery(nullptr)
     , _crowed(nullptr)
     , _tileCache(nullptr)
+    , _tileCacheDirty(false)
+    , _pathService(nullptr)
+    , _pathWorkerCount(0)
+    , _pathCacheSize(-1)
     , _allocator(nullptr)
     , _compressor(nullptr)
     , _meshProcess(nullptr)
@@ -112,6 +116,8 @@ NavMesh::NavMesh()
 
 NavMesh::~NavMesh()
 {
+    // the workers use the nav mesh
+    CC_SAFE_DELETE(_pathService);
     dtFreeTileCache(_tileCache);
     dtFreeCrowd(_crowed);
     dtFreeNavMesh(_navMesh);
@@ -396,6 +402,7 @@ void NavMesh::removeNavMeshObstacle(NavMeshObstacle *obstacle)
     auto iter = std::find(_obstacleList.begin(), _obstacleList.end(), obstacle);
     if (iter != _obstacleList.end()){
         obstacle->removeFrom(_tileCache);
+        _tileCacheDirty = true;
         obstacle->release();
         _obstacleList[iter - _obstacleList.begin()] = nullptr;
     }
@@ -406,6 +413,7 @@ void NavMesh::addNavMeshObstacle(NavMeshObstacle *obstacle)
     auto iter = std::find(_obstacleList.begin(), _obstacleList.end(), nullptr);
     if (iter != _obstacleList.end()){
         obstacle->addTo(_tileCache);
+        _tileCacheDirty = true;
         obstacle->retain();
         _obstacleList[iter - _obstacleList.begin()] = obstacle;
     }
@@ -460,15 +468,32 @@ void NavMesh::update(float dt)
     }
 
     for (auto iter : _obstacleList){
-        if (iter)
+        if (iter){
             iter->preUpdate(dt);
+            // also set by syncToObstacle() calls made since the last update
+            if (iter->_tileCacheChanged){
+                iter->_tileCacheChanged = false;
+                _tileCacheDirty = true;
+            }
+        }
     }
 
     if (_crowed)
         _crowed->update(dt, nullptr);
 
-    if (_tileCache)
+    // the tile cache has nothing to rebuild until an obstacle changes, the path workers aren't stopped for nothing
+    if (_tileCache && _tileCacheDirty)
+    {
+        // rebuilding the tiles changes the polygons the path workers read
+        if (_pathService)
+            _pathService->lockNavMesh();
         _tileCache->update(dt, _navMesh);
+        if (_pathService)
+            _pathService->unlockNavMesh();
+
+        // one tile is rebuilt per update
+        _tileCacheDirty = hasPendingObstacles();
+    }
 
     for (auto iter : _agentList){
         if (iter)
@@ -479,12 +504,24 @@ void NavMesh::update(float dt)
         if (iter)
             iter->postUpdate(dt);
     }
+
+    if (_pathService)
+        _pathService->deliver();
+}
+
+bool NavMesh::hasPendingObstacles() const
+{
+    for (int i = 0; i < _tileCache->getObstacleCount(); ++i){
+        auto state = _tileCache->getObstacle(i)->state;
+        if (state == DT_OBSTACLE_PROCESSING || state == DT_OBSTACLE_REMOVING)
+            return true;
+    }
+    return false;
 }
 
 void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<Vec3> &pathPoints)
 {
     static const int MAX_POLYS = 256;
-    static const int MAX_SMOOTH = 2048;
     float ext[3];
     ext[0] = 2; ext[1] = 4; ext[2] = 2;
     dtQueryFilter filter;
@@ -495,140 +532,43 @@ void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<
     _navMeshQuery->findNearestPoly(&end.x, ext, &filter, &endRef, 0);
     _navMeshQuery->findPath(startRef, endRef, &start.x, &end.x, &filter, polys, &npolys, MAX_POLYS);
 
-    if (npolys)
-    {
-        //// Iterate over the path to find smooth path on the detail mesh surface.
-        //dtPolyRef polys[MAX_POLYS];
-        //memcpy(polys, polys, sizeof(dtPolyRef)*npolys);
-        //int npolys = npolys;
-
-        float iterPos[3], targetPos[3];
-        _navMeshQuery->closestPointOnPoly(startRef, &start.x, iterPos, 0);
-        _navMeshQuery->closestPointOnPoly(polys[npolys - 1], &end.x, targetPos, 0);
-
-        static const float STEP_SIZE = 0.5f;
-        static const float SLOP = 0.01f;
+    findSmoothPath(_navMesh, _navMeshQuery, &filter, &start.x, &end.x, polys, npolys, MAX_POLYS, pathPoints);
+}
 
-        int nsmoothPath = 0;
-        //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], iterPos);
-        //m_nsmoothPath++;
+unsigned int NavMesh::findPathAsync(const Vec3 &start, const Vec3 &end, const std::function<void(const std::vector<Vec3>&)> &callback)
+{
+    if (!_pathService)
+    {
+        _pathService = new (std::nothrow) NavMeshPathService(_navMesh, _pathWorkerCount);
+        if (_pathCacheSize >= 0)
+            _pathService->setCacheSize(_pathCacheSize);
+    }
+    return _pathService->request(start, end, callback);
+}
 
-        pathPoints.push_back(Vec3(iterPos[0], iterPos[1], iterPos[2]));
-        nsmoothPath++;
+void NavMesh::cancelPathRequest(unsigned int requestId)
+{
+    if (_pathService)
+        _pathService->cancel(requestId);
+}
 
-        // Move towards target a small advancement at a time until target reached or
-        // when ran out of memory to store the path.
-        while (npolys && nsmoothPath < MAX_SMOOTH)
-        {
-            // Find location to steer towards.
-            float steerPos[3];
-            unsigned char steerPosFlag;
-            dtPolyRef steerPosRef;
-
-            if (!getSteerTarget(_navMeshQuery, iterPos, targetPos, SLOP,
-                polys, npolys, steerPos, steerPosFlag, steerPosRef))
-                break;
-
-            bool endOfPath = (steerPosFlag & DT_STRAIGHTPATH_END) ? true : false;
-            bool offMeshConnection = (steerPosFlag & DT_STRAIGHTPATH_OFFMESH_CONNECTION) ? true : false;
-
-            // Find movement delta.
-            float delta[3], len;
-            dtVsub(delta, steerPos, iterPos);
-            len = dtMathSqrtf(dtVdot(delta, delta));
-            // If the steer target is end of path or off-mesh link, do not move past the location.
-            if ((endOfPath || offMeshConnection) && len < STEP_SIZE)
-                len = 1;
-            else
-                len = STEP_SIZE / len;
-            float moveTgt[3];
-            dtVmad(moveTgt, iterPos, delta, len);
-
-            // Move
-            float result[3];
-            dtPolyRef visited[16];
-            int nvisited = 0;
-            _navMeshQuery->moveAlongSurface(polys[0], iterPos, moveTgt, &filter,
-                result, visited, &nvisited, 16);
-
-            npolys = fixupCorridor(polys, npolys, MAX_POLYS, visited, nvisited);
-            npolys = fixupShortcuts(polys, npolys, _navMeshQuery);
-
-            float h = 0;
-            _navMeshQuery->getPolyHeight(polys[0], result, &h);
-            result[1] = h;
-            dtVcopy(iterPos, result);
-
-            // Handle end of path and off-mesh links when close enough.
-            if (endOfPath && inRange(iterPos, steerPos, SLOP, 1.0f))
-            {
-                // Reached end of path.
-                dtVcopy(iterPos, targetPos);
-                if (nsmoothPath < MAX_SMOOTH)
-                {
-                    //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], iterPos);
-                    //m_nsmoothPath++;
-                    pathPoints.push_back(Vec3(iterPos[0], iterPos[1], iterPos[2]));
-                    nsmoothPath++;
-                }
-                break;
-            }
-            else if (offMeshConnection && inRange(iterPos, steerPos, SLOP, 1.0f))
-            {
-                // Reached off-mesh connection.
-                float startPos[3], endPos[3];
-
-                // Advance the path up to and over the off-mesh connection.
-                dtPolyRef prevRef = 0, polyRef = polys[0];
-                int npos = 0;
-                while (npos < npolys && polyRef != steerPosRef)
-                {
-                    prevRef = polyRef;
-                    polyRef = polys[npos];
-                    npos++;
-                }
-                for (int i = npos; i < npolys; ++i)
-                    polys[i - npos] = polys[i];
-                npolys -= npos;
-
-                // Handle the connection.
-                dtStatus status = _navMesh->getOffMeshConnectionPolyEndPoints(prevRef, polyRef, startPos, endPos);
-                if (dtStatusSucceed(status))
-                {
-                    if (nsmoothPath < MAX_SMOOTH)
-                    {
-                        //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], startPos);
-                        //m_nsmoothPath++;
-                        pathPoints.push_back(Vec3(startPos[0], startPos[1], startPos[2]));
-                        nsmoothPath++;
-                        // Hack to make the dotted path not visible during off-mesh connection.
-                        if (nsmoothPath & 1)
-                        {
-                            //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], startPos);
-                            //m_nsmoothPath++;
-                            pathPoints.push_back(Vec3(startPos[0], startPos[1], startPos[2]));
-                            nsmoothPath++;
-                        }
-                    }
-                    // Move position at the other side of the off-mesh link.
-                    dtVcopy(iterPos, endPos);
-                    float eh = 0.0f;
-                    _navMeshQuery->getPolyHeight(polys[0], iterPos, &eh);
-                    iterPos[1] = eh;
-                }
-            }
+void NavMesh::setPathWorkerCount(int count)
+{
+    CCASSERT(!_pathService, "the path workers are already started");
+    _pathWorkerCount = count;
+}
 
-            // Store results.
-            if (nsmoothPath < MAX_SMOOTH)
-            {
-                //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], iterPos);
-                //m_nsmoothPath++;
+void NavMesh::setPathCacheSize(int size)
+{
+    _pathCacheSize = size;
+    if (_pathService)
+        _pathService->setCacheSize(size);
+}
 
-                pathPoints.push_back(Vec3(iterPos[0], iterPos[1], iterPos[2]));
-                nsmoothPath++;
-            }
-        }
-    }
+void NavMesh::clearPathCache()
+{
+    if (_pathService)
+        _pathService->clearCache();
 }
 
 NS_CC_END
@@ -40,6 +40,7 @@
 #include "navmesh/CCNavMeshAgent.h"
 #include "navmesh/CCNavMeshDebugDraw.h"
 #include "navmesh/CCNavMeshObstacle.h"
+#include "navmesh/CCNavMeshPathService.h"
 #include "navmesh/CCNavMeshUtils.h"
 
 
@@ -96,6 +97,28 @@ public:
     */
     void findPath(const Vec3 &start, const Vec3 &end, std::vector<Vec3> &pathPoints);
 
+    /**
+    find a path on navmesh on a worker thread, the result is delivered by update()
+
+    @param start The start search position in world coordinate system.
+    @param end The end search position in world coordinate system.
+    @param callback Called on the thread of update() with the key points of path, empty if none is found.
+    @return The id of the request, for cancelPathRequest().
+    */
+    unsigned int findPathAsync(const Vec3 &start, const Vec3 &end, const std::function<void(const std::vector<Vec3>&)> &callback);
+
+    /** The callback of an asynchronous path request won't be called. */
+    void cancelPathRequest(unsigned int requestId);
+
+    /** Number of threads finding the asynchronous paths, must be set before the first request. 0 uses the default. */
+    void setPathWorkerCount(int count);
+
+    /** Number of polygon corridors of recent asynchronous requests kept to answer the same ones, 0 disables it. */
+    void setPathCacheSize(int size);
+
+    /** Forget the polygon corridors of the recent asynchronous requests. */
+    void clearPathCache();
+
 CC_CONSTRUCTOR_ACCESS:
     NavMesh();
     virtual ~NavMesh();
@@ -110,6 +133,7 @@ protected:
     void drawAgents();
     void drawObstacles();
     void drawOffMeshConnections();
+    bool hasPendingObstacles() const;
 
 protected:
 
@@ -117,6 +141,11 @@ protected:
     dtNavMeshQuery *_navMeshQuery;
     dtCrowd *_crowed;
     dtTileCache *_tileCache;
+    // obstacles were added, removed or moved, and the tiles they touch may not be rebuilt yet
+    bool _tileCacheDirty;
+    NavMeshPathService *_pathService;
+    int _pathWorkerCount;
+    int _pathCacheSize;
     LinearAllocator *_allocator;
     FastLZCompressor *_compressor;
     MeshProcess *_meshProcess;
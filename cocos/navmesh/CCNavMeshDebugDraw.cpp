@@ -28,6 +28,7 @@
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
+#include "renderer/CCRenderThread.h"
 #include "base/CCDirector.h"
 #include "base/ccMacros.h"
 
@@ -50,6 +51,7 @@ NavMeshDebugDraw::NavMeshDebugDraw()
     _customCmd.set3D(true);
     _customCmd.setTransparent(true);
     _program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR);
+    ScopedGLContext context;
     glGenBuffers(1, &_vbo);
 }
 
@@ -82,7 +84,8 @@ NavMeshDebugDraw::~NavMeshDebugDraw()
     for (auto iter : _primitiveList){
         delete iter;
     }
-    glDeleteBuffers(1, &_vbo);
+    ScopedGLContext context;
+    GL::deleteBuffers(1, &_vbo);
 }
 
 void NavMeshDebugDraw::depthMask(bool state)
@@ -139,7 +142,7 @@ void NavMeshDebugDraw::drawImplement(const cocos2d::Mat4& transform, uint32_t fl
     _program->use();
     _program->setUniformsForBuiltins(transform);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_COLOR);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4F), (GLvoid *)offsetof(V3F_C4F, position));
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(V3F_C4F), (GLvoid *)offsetof(V3F_C4F, color));
@@ -159,7 +162,7 @@ void NavMeshDebugDraw::drawImplement(const cocos2d::Mat4& transform, uint32_t fl
         glDrawArrays(iter->type, iter->start, iter->end - iter->start);
         CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, iter->end - iter->start);
     }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void NavMeshDebugDraw::draw(Renderer* renderer)
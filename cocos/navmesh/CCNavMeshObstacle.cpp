@@ -56,6 +56,7 @@ NavMeshObstacle::NavMeshObstacle()
 , _tileCache(nullptr)
 , _obstacleID(-1)
 , _syncFlag(NODE_AND_NODE)
+, _tileCacheChanged(false)
 {
 
 }
@@ -156,6 +157,7 @@ void NavMeshObstacle::syncToObstacle()
                 || obstacle->height != _height){
                 _tileCache->removeObstacle(_obstacleID);
                 _tileCache->addObstacle(&mat.m[12], _radius, _height, &_obstacleID);
+                _tileCacheChanged = true;
             }
         }
     }
@@ -112,6 +112,8 @@ private:
     NavMeshObstacleSyncFlag _syncFlag;
     dtObstacleRef _obstacleID;
     dtTileCache *_tileCache;
+    // the obstacle was moved or resized in the tile cache since NavMesh::update() last looked
+    bool _tileCacheChanged;
 };
 
 /** @} */
@@ -0,0 +1,359 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "navmesh/CCNavMeshPathService.h"
+#if CC_USE_NAVMESH
+
+#include <algorithm>
+
+#include "navmesh/CCNavMeshUtils.h"
+
+NS_CC_BEGIN
+
+// same as NavMesh::findPath
+static const int MAX_POLYS = 256;
+static const int MAX_NODES = 2048;
+static const float EXTENTS[3] = { 2, 4, 2 };
+
+// requests taken by a worker at once, and A* iterations between two chances given to a writer
+static const size_t BATCH_SIZE = 16;
+static const int MAX_ITERATIONS_PER_SLICE = 64;
+// searches of a path whose corridor lost polygons to a tile rebuild while it was smoothed
+static const int MAX_SMOOTH_ATTEMPTS = 3;
+static const int DEFAULT_CACHE_SIZE = 64;
+
+int NavMeshPathService::getDefaultWorkerCount()
+{
+    int count = (int)std::thread::hardware_concurrency() - 1;
+    return std::min(std::max(count, 1), 4);
+}
+
+NavMeshPathService::NavMeshPathService(dtNavMesh *navMesh, int workerCount)
+    : _navMesh(navMesh)
+    , _quit(false)
+    , _readers(0)
+    , _writing(false)
+    , _writerWaiting(false)
+    , _cacheSize(DEFAULT_CACHE_SIZE)
+    , _cacheHits(0)
+    , _cacheMisses(0)
+    , _nextRequestId(0)
+{
+    if (workerCount <= 0)
+        workerCount = getDefaultWorkerCount();
+
+    for (int i = 0; i < workerCount; ++i)
+        _workers.push_back(std::thread(&NavMeshPathService::workerLoop, this));
+}
+
+NavMeshPathService::~NavMeshPathService()
+{
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        _quit = true;
+        _requests.clear();
+    }
+    _requestCondition.notify_all();
+
+    for (auto &worker : _workers)
+        worker.join();
+}
+
+unsigned int NavMeshPathService::request(const Vec3 &start, const Vec3 &end, const PathCallback &callback)
+{
+    // 0 is never used, so that it can mean no request
+    if (++_nextRequestId == 0)
+        ++_nextRequestId;
+    unsigned int id = _nextRequestId;
+    _callbacks[id] = callback;
+
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        _requests.push_back({ id, start, end });
+    }
+    _requestCondition.notify_one();
+    return id;
+}
+
+void NavMeshPathService::cancel(unsigned int requestId)
+{
+    _callbacks.erase(requestId);
+}
+
+void NavMeshPathService::deliver()
+{
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(_resultMutex);
+        results.swap(_results);
+    }
+
+    for (const auto &result : results)
+    {
+        auto iter = _callbacks.find(result.id);
+        if (iter == _callbacks.end())
+            continue;
+
+        // removed first, the callback may request another path
+        PathCallback callback = std::move(iter->second);
+        _callbacks.erase(iter);
+        if (callback)
+            callback(result.pathPoints);
+    }
+}
+
+void NavMeshPathService::lockNavMesh()
+{
+    std::unique_lock<std::mutex> lock(_rwMutex);
+    _writerWaiting = true;
+    _rwCondition.wait(lock, [this]{ return _readers == 0 && !_writing; });
+    _writing = true;
+    _writerWaiting = false;
+}
+
+void NavMeshPathService::unlockNavMesh()
+{
+    {
+        std::lock_guard<std::mutex> lock(_rwMutex);
+        _writing = false;
+    }
+    _rwCondition.notify_all();
+}
+
+void NavMeshPathService::lockRead()
+{
+    std::unique_lock<std::mutex> lock(_rwMutex);
+    _rwCondition.wait(lock, [this]{ return !_writing && !_writerWaiting; });
+    ++_readers;
+}
+
+void NavMeshPathService::unlockRead()
+{
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(_rwMutex);
+        last = --_readers == 0;
+    }
+    if (last)
+        _rwCondition.notify_all();
+}
+
+bool NavMeshPathService::yieldRead()
+{
+    if (!_writerWaiting)
+        return false;
+
+    unlockRead();
+    lockRead();
+    return true;
+}
+
+void NavMeshPathService::setCacheSize(int size)
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cacheSize = std::max(size, 0);
+    while ((int)_cacheList.size() > _cacheSize)
+    {
+        _cacheMap.erase(_cacheList.back().first);
+        _cacheList.pop_back();
+    }
+}
+
+int NavMeshPathService::getCacheSize() const
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    return _cacheSize;
+}
+
+void NavMeshPathService::clearCache()
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cacheList.clear();
+    _cacheMap.clear();
+}
+
+bool NavMeshPathService::getCachedCorridor(const CacheKey &key, dtPolyRef *polys, int &npolys)
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    auto iter = _cacheMap.find(key);
+    if (iter == _cacheMap.end())
+        return false;
+
+    // the tiles of the corridor may have been rebuilt by the tile cache since
+    const auto &corridor = iter->second->second;
+    for (auto ref : corridor)
+    {
+        if (!_navMesh->isValidPolyRef(ref))
+        {
+            _cacheList.erase(iter->second);
+            _cacheMap.erase(iter);
+            return false;
+        }
+    }
+
+    _cacheList.splice(_cacheList.begin(), _cacheList, iter->second);
+    npolys = (int)corridor.size();
+    std::copy(corridor.begin(), corridor.end(), polys);
+    return true;
+}
+
+void NavMeshPathService::addCachedCorridor(const CacheKey &key, const dtPolyRef *polys, int npolys)
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (_cacheSize == 0)
+        return;
+
+    auto iter = _cacheMap.find(key);
+    if (iter != _cacheMap.end())
+    {
+        iter->second->second.assign(polys, polys + npolys);
+        _cacheList.splice(_cacheList.begin(), _cacheList, iter->second);
+        return;
+    }
+
+    _cacheList.push_front(std::make_pair(key, std::vector<dtPolyRef>(polys, polys + npolys)));
+    _cacheMap[key] = _cacheList.begin();
+    if ((int)_cacheList.size() > _cacheSize)
+    {
+        _cacheMap.erase(_cacheList.back().first);
+        _cacheList.pop_back();
+    }
+}
+
+void NavMeshPathService::workerLoop()
+{
+    dtNavMeshQuery *query = dtAllocNavMeshQuery();
+    lockRead();
+    query->init(_navMesh, MAX_NODES);
+    unlockRead();
+
+    std::vector<Request> batch;
+    std::vector<Result> results;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_requestMutex);
+            _requestCondition.wait(lock, [this]{ return _quit || !_requests.empty(); });
+            if (_quit)
+                break;
+
+            size_t count = std::min(_requests.size(), BATCH_SIZE);
+            batch.assign(_requests.begin(), _requests.begin() + count);
+            _requests.erase(_requests.begin(), _requests.begin() + count);
+        }
+
+        results.resize(batch.size());
+        lockRead();
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            if (i > 0)
+                yieldRead();
+            findPath(query, batch[i], results[i]);
+        }
+        unlockRead();
+
+        std::lock_guard<std::mutex> lock(_resultMutex);
+        for (auto &result : results)
+            _results.push_back(std::move(result));
+        results.clear();
+    }
+
+    dtFreeNavMeshQuery(query);
+}
+
+void NavMeshPathService::findPath(dtNavMeshQuery *query, const Request &request, Result &result)
+{
+    result.id = request.id;
+
+    // searched again if the corridor was rebuilt while smoothing, the last time without leaving the nav mesh
+    auto yield = [this]() { return yieldRead(); };
+    for (int attempt = 0; attempt < MAX_SMOOTH_ATTEMPTS; ++attempt)
+    {
+        result.pathPoints.clear();
+
+        dtQueryFilter filter;
+        dtPolyRef startRef = 0, endRef = 0;
+        query->findNearestPoly(&request.start.x, EXTENTS, &filter, &startRef, 0);
+        query->findNearestPoly(&request.end.x, EXTENTS, &filter, &endRef, 0);
+        if (!startRef || !endRef)
+            return;
+
+        dtPolyRef polys[MAX_POLYS];
+        int npolys = 0;
+        if (getCachedCorridor(CacheKey(startRef, endRef), polys, npolys))
+        {
+            ++_cacheHits;
+        }
+        else
+        {
+            ++_cacheMisses;
+            if (!findCorridor(query, filter, startRef, endRef, &request.start.x, &request.end.x, polys, npolys))
+                return;
+            addCachedCorridor(CacheKey(startRef, endRef), polys, npolys);
+        }
+
+        bool lastAttempt = attempt == MAX_SMOOTH_ATTEMPTS - 1;
+        if (findSmoothPath(_navMesh, query, &filter, &request.start.x, &request.end.x, polys, npolys, MAX_POLYS,
+            result.pathPoints, lastAttempt ? nullptr : yield))
+            return;
+    }
+}
+
+bool NavMeshPathService::findCorridor(dtNavMeshQuery *query, const dtQueryFilter &filter, dtPolyRef &startRef, dtPolyRef &endRef,
+    const float *start, const float *end, dtPolyRef *polys, int &npolys)
+{
+    // searched again once if the nav mesh changed while the workers were out of it
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        bool yielded = false;
+        dtStatus status = query->initSlicedFindPath(startRef, endRef, start, end, &filter);
+        while (dtStatusInProgress(status))
+        {
+            status = query->updateSlicedFindPath(MAX_ITERATIONS_PER_SLICE, nullptr);
+            if (yieldRead())
+                yielded = true;
+        }
+
+        npolys = 0;
+        if (dtStatusSucceed(status))
+            status = query->finalizeSlicedFindPath(polys, &npolys, MAX_POLYS);
+
+        bool valid = dtStatusSucceed(status) && npolys > 0;
+        for (int i = 0; valid && yielded && i < npolys; ++i)
+            valid = _navMesh->isValidPolyRef(polys[i]);
+        if (valid)
+            return true;
+        if (!yielded)
+            return false;
+
+        query->findNearestPoly(start, EXTENTS, &filter, &startRef, 0);
+        query->findNearestPoly(end, EXTENTS, &filter, &endRef, 0);
+        if (!startRef || !endRef)
+            return false;
+    }
+    return false;
+}
+
+NS_CC_END
+
+#endif //CC_USE_NAVMESH
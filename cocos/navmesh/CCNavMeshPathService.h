@@ -0,0 +1,176 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCNAV_MESH_PATH_SERVICE_H__
+#define __CCNAV_MESH_PATH_SERVICE_H__
+
+#include "base/ccConfig.h"
+#if CC_USE_NAVMESH
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/Vec3.h"
+#include "recast/Detour/DetourNavMesh.h"
+#include "recast/Detour/DetourNavMeshQuery.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup 3d
+ * @{
+ */
+
+/** @brief NavMeshPathService: finds the paths of a NavMesh on worker threads.
+
+ Every worker owns its dtNavMeshQuery, and takes the pending requests by batches. The corridors are
+ found with the sliced queries of Detour, so that the workers can leave the nav mesh to a writer between
+ two slices, and the corridors of the last start and end polygons are kept in a small LRU cache.
+ The results are delivered by deliver(), on the thread which called it.
+
+ NavMesh creates it when a path is first requested with NavMesh::findPathAsync(), locks it around the
+ tile cache updates, and delivers the results at the end of NavMesh::update().
+ @since v3.9
+ */
+class CC_DLL NavMeshPathService
+{
+public:
+    typedef std::function<void(const std::vector<Vec3>&)> PathCallback;
+
+    /** Default number of workers: one less than the hardware threads, between 1 and 4. */
+    static int getDefaultWorkerCount();
+
+    /** Starts the workers, workerCount <= 0 uses getDefaultWorkerCount(). */
+    NavMeshPathService(dtNavMesh *navMesh, int workerCount = 0);
+
+    /** Stops the workers, the pending requests are dropped without calling their callbacks. */
+    ~NavMeshPathService();
+
+    /**
+    Requests a path, the same as NavMesh::findPath() would find.
+
+    @param start The start search position in world coordinate system.
+    @param end The end search position in world coordinate system.
+    @param callback Called by deliver() with the key points of the path, empty if none is found.
+    @return The id of the request, to cancel it.
+    */
+    unsigned int request(const Vec3 &start, const Vec3 &end, const PathCallback &callback);
+
+    /** The callback of the request won't be called, the path may still be computed. */
+    void cancel(unsigned int requestId);
+
+    /** Calls the callbacks of the paths found since the last call. The callbacks may request other paths. */
+    void deliver();
+
+    /** Number of requests whose callback isn't called yet. */
+    size_t getPendingCount() const { return _callbacks.size(); }
+
+    /** Waits for the workers to leave the nav mesh, and keeps them out until unlockNavMesh(). */
+    void lockNavMesh();
+    void unlockNavMesh();
+
+    /** Number of corridors kept in the cache, 0 disables it. */
+    void setCacheSize(int size);
+    int getCacheSize() const;
+    void clearCache();
+
+    /** Number of requests served from the cache and searched, since the creation. */
+    unsigned int getCacheHits() const { return _cacheHits; }
+    unsigned int getCacheMisses() const { return _cacheMisses; }
+
+protected:
+    struct Request
+    {
+        unsigned int id;
+        Vec3 start;
+        Vec3 end;
+    };
+
+    struct Result
+    {
+        unsigned int id;
+        std::vector<Vec3> pathPoints;
+    };
+
+    typedef std::pair<dtPolyRef, dtPolyRef> CacheKey;
+    typedef std::list<std::pair<CacheKey, std::vector<dtPolyRef>>> CacheList;
+
+    void workerLoop();
+    void findPath(dtNavMeshQuery *query, const Request &request, Result &result);
+    bool findCorridor(dtNavMeshQuery *query, const dtQueryFilter &filter, dtPolyRef &startRef, dtPolyRef &endRef,
+        const float *start, const float *end, dtPolyRef *polys, int &npolys);
+
+    // several workers read the nav mesh at once, the tile cache update writes it alone
+    void lockRead();
+    void unlockRead();
+    bool yieldRead();
+
+    bool getCachedCorridor(const CacheKey &key, dtPolyRef *polys, int &npolys);
+    void addCachedCorridor(const CacheKey &key, const dtPolyRef *polys, int npolys);
+
+    dtNavMesh *_navMesh;
+    std::vector<std::thread> _workers;
+
+    std::mutex _requestMutex;
+    std::condition_variable _requestCondition;
+    std::deque<Request> _requests;
+    bool _quit;
+
+    std::mutex _resultMutex;
+    std::vector<Result> _results;
+
+    std::mutex _rwMutex;
+    std::condition_variable _rwCondition;
+    int _readers;
+    bool _writing;
+    std::atomic<bool> _writerWaiting;
+
+    mutable std::mutex _cacheMutex;
+    CacheList _cacheList;
+    std::map<CacheKey, CacheList::iterator> _cacheMap;
+    int _cacheSize;
+    std::atomic<unsigned int> _cacheHits;
+    std::atomic<unsigned int> _cacheMisses;
+
+    // main thread only
+    std::unordered_map<unsigned int, PathCallback> _callbacks;
+    unsigned int _nextRequestId;
+};
+
+/** @} */
+
+NS_CC_END
+
+#endif //CC_USE_NAVMESH
+
+#endif // __CCNAV_MESH_PATH_SERVICE_H__
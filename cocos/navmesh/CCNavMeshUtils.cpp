@@ -284,6 +284,159 @@ bool inRange(const float* v1, const float* v2, const float r, const float h)
     return (dx*dx + dz*dz) < r*r && fabsf(dy) < h;
 }
 
+bool findSmoothPath(dtNavMesh* navMesh, dtNavMeshQuery* navQuery, const dtQueryFilter* filter,
+    const float* start, const float* end, dtPolyRef* polys, int npolys, const int maxPolys,
+    std::vector<Vec3>& pathPoints, const std::function<bool()>& yield)
+{
+    static const int MAX_SMOOTH = 2048;
+
+    if (npolys)
+    {
+        //// Iterate over the path to find smooth path on the detail mesh surface.
+        //dtPolyRef polys[MAX_POLYS];
+        //memcpy(polys, polys, sizeof(dtPolyRef)*npolys);
+        //int npolys = npolys;
+
+        float iterPos[3], targetPos[3];
+        navQuery->closestPointOnPoly(polys[0], start, iterPos, 0);
+        navQuery->closestPointOnPoly(polys[npolys - 1], end, targetPos, 0);
+
+        static const float STEP_SIZE = 0.5f;
+        static const float SLOP = 0.01f;
+
+        int nsmoothPath = 0;
+        //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], iterPos);
+        //m_nsmoothPath++;
+
+        pathPoints.push_back(Vec3(iterPos[0], iterPos[1], iterPos[2]));
+        nsmoothPath++;
+
+        // Move towards target a small advancement at a time until target reached or
+        // when ran out of memory to store the path.
+        while (npolys && nsmoothPath < MAX_SMOOTH)
+        {
+            // The tiles rebuilt meanwhile may not be the ones of the corridor.
+            if (yield && yield())
+            {
+                for (int i = 0; i < npolys; ++i)
+                {
+                    if (!navMesh->isValidPolyRef(polys[i]))
+                        return false;
+                }
+            }
+
+            // Find location to steer towards.
+            float steerPos[3];
+            unsigned char steerPosFlag;
+            dtPolyRef steerPosRef;
+
+            if (!getSteerTarget(navQuery, iterPos, targetPos, SLOP,
+                polys, npolys, steerPos, steerPosFlag, steerPosRef))
+                break;
+
+            bool endOfPath = (steerPosFlag & DT_STRAIGHTPATH_END) ? true : false;
+            bool offMeshConnection = (steerPosFlag & DT_STRAIGHTPATH_OFFMESH_CONNECTION) ? true : false;
+
+            // Find movement delta.
+            float delta[3], len;
+            dtVsub(delta, steerPos, iterPos);
+            len = dtMathSqrtf(dtVdot(delta, delta));
+            // If the steer target is end of path or off-mesh link, do not move past the location.
+            if ((endOfPath || offMeshConnection) && len < STEP_SIZE)
+                len = 1;
+            else
+                len = STEP_SIZE / len;
+            float moveTgt[3];
+            dtVmad(moveTgt, iterPos, delta, len);
+
+            // Move
+            float result[3];
+            dtPolyRef visited[16];
+            int nvisited = 0;
+            navQuery->moveAlongSurface(polys[0], iterPos, moveTgt, filter,
+                result, visited, &nvisited, 16);
+
+            npolys = fixupCorridor(polys, npolys, maxPolys, visited, nvisited);
+            npolys = fixupShortcuts(polys, npolys, navQuery);
+
+            float h = 0;
+            navQuery->getPolyHeight(polys[0], result, &h);
+            result[1] = h;
+            dtVcopy(iterPos, result);
+
+            // Handle end of path and off-mesh links when close enough.
+            if (endOfPath && inRange(iterPos, steerPos, SLOP, 1.0f))
+            {
+                // Reached end of path.
+                dtVcopy(iterPos, targetPos);
+                if (nsmoothPath < MAX_SMOOTH)
+                {
+                    //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], iterPos);
+                    //m_nsmoothPath++;
+                    pathPoints.push_back(Vec3(iterPos[0], iterPos[1], iterPos[2]));
+                    nsmoothPath++;
+                }
+                break;
+            }
+            else if (offMeshConnection && inRange(iterPos, steerPos, SLOP, 1.0f))
+            {
+                // Reached off-mesh connection.
+                float startPos[3], endPos[3];
+
+                // Advance the path up to and over the off-mesh connection.
+                dtPolyRef prevRef = 0, polyRef = polys[0];
+                int npos = 0;
+                while (npos < npolys && polyRef != steerPosRef)
+                {
+                    prevRef = polyRef;
+                    polyRef = polys[npos];
+                    npos++;
+                }
+                for (int i = npos; i < npolys; ++i)
+                    polys[i - npos] = polys[i];
+                npolys -= npos;
+
+                // Handle the connection.
+                dtStatus status = navMesh->getOffMeshConnectionPolyEndPoints(prevRef, polyRef, startPos, endPos);
+                if (dtStatusSucceed(status))
+                {
+                    if (nsmoothPath < MAX_SMOOTH)
+                    {
+                        //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], startPos);
+                        //m_nsmoothPath++;
+                        pathPoints.push_back(Vec3(startPos[0], startPos[1], startPos[2]));
+                        nsmoothPath++;
+                        // Hack to make the dotted path not visible during off-mesh connection.
+                        if (nsmoothPath & 1)
+                        {
+                            //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], startPos);
+                            //m_nsmoothPath++;
+                            pathPoints.push_back(Vec3(startPos[0], startPos[1], startPos[2]));
+                            nsmoothPath++;
+                        }
+                    }
+                    // Move position at the other side of the off-mesh link.
+                    dtVcopy(iterPos, endPos);
+                    float eh = 0.0f;
+                    navQuery->getPolyHeight(polys[0], iterPos, &eh);
+                    iterPos[1] = eh;
+                }
+            }
+
+            // Store results.
+            if (nsmoothPath < MAX_SMOOTH)
+            {
+                //dtVcopy(&m_smoothPath[m_nsmoothPath * 3], iterPos);
+                //m_nsmoothPath++;
+
+                pathPoints.push_back(Vec3(iterPos[0], iterPos[1], iterPos[2]));
+                nsmoothPath++;
+            }
+        }
+    }
+    return true;
+}
+
 NS_CC_END
 
 #endif //CC_USE_NAVMESH
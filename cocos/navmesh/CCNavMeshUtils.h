@@ -28,6 +28,9 @@
 #include "base/ccConfig.h"
 #if CC_USE_NAVMESH
 
+#include <functional>
+#include <vector>
+
 #include "platform/CCPlatformMacros.h"
 #include "math/CCMath.h"
 
@@ -126,6 +129,14 @@ bool getSteerTarget(dtNavMeshQuery* navQuery, const float* startPos, const float
     const dtPolyRef* path, const int pathSize,
     float* steerPos, unsigned char& steerPosFlag, dtPolyRef& steerPosRef,
     float* outPoints = 0, int* outPointCount = 0);
+
+// Moves along the corridor polys, from start to end on the detail mesh surface,
+// and appends the points of the smoothed path to pathPoints. polys is modified.
+// yield is called before every step, and returns true if the nav mesh may have changed meanwhile:
+// false is returned if the corridor lost some of its polygons, the path is then incomplete.
+bool findSmoothPath(dtNavMesh* navMesh, dtNavMeshQuery* navQuery, const dtQueryFilter* filter,
+    const float* start, const float* end, dtPolyRef* polys, int npolys, const int maxPolys,
+    std::vector<Vec3>& pathPoints, const std::function<bool()>& yield = nullptr);
 /** @} */
 
 NS_CC_END
@@ -34,6 +34,7 @@
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "deprecated/CCString.h"
+#include "xxhash.h"
 
 namespace cocos2d {
 namespace network {
@@ -43,6 +44,8 @@ namespace network {
 #define LOW_SPEED_TIME      5L
 #define MAX_REDIRS          2
 #define DEFAULT_TIMEOUT     5
+#define DEFAULT_MAX_PARALLEL_DOWNLOADS  6
+#define HASH_READ_SIZE      16384
 #define HTTP_CODE_SUPPORT_RESUME    206
 #define MAX_WAIT_MSECS 30*1000 /* Wait max. 30 seconds */
 
@@ -53,7 +56,7 @@ Downloader::Downloader()
 , _onError(nullptr)
 , _onProgress(nullptr)
 , _onSuccess(nullptr)
-, _supportResuming(false)
+, _maxParallelDownloads(DEFAULT_MAX_PARALLEL_DOWNLOADS)
 , _downloaderImpl(nullptr)
 {
     _fileUtils = FileUtils::getInstance();
@@ -77,6 +80,12 @@ void Downloader::setConnectionTimeout(int timeout)
         _connectionTimeout = timeout;
 }
 
+void Downloader::setMaxParallelDownloads(int count)
+{
+    _maxParallelDownloads = std::max(count, 1);
+    _downloaderImpl->setMaxParallelDownloads(_maxParallelDownloads);
+}
+
 void Downloader::notifyError(ErrorCode code, const std::string& msg/* ="" */, const std::string& customId/* ="" */, int curle_code/* = CURLE_OK*/, int curlm_code/* = CURLM_OK*/)
 {
     std::weak_ptr<Downloader> ptr = shared_from_this();
@@ -118,19 +127,22 @@ std::string Downloader::getFileNameFromUrl(const std::string& srcUrl)
     return filename;
 }
 
-void Downloader::prepareDownload(const DownloadUnit& downloadUnit)
+bool Downloader::prepareDownload(const DownloadUnit& downloadUnit, bool restart/* = false*/)
 {
     std::string name = "";
     std::string path = "";
 
-    FILE *localFP = nullptr;
+    // the server sent the whole file again, the bytes already written are dropped
+    if (downloadUnit.fp)
+    {
+        fclose((FILE*)downloadUnit.fp);
+        downloadUnit.fp = nullptr;
+    }
 
     downloadUnit.downloaded = 0;
     downloadUnit.totalToDownload = 0;
+    downloadUnit.resumeOffset = 0;
 
-    Error err;
-    err.customId = downloadUnit.customId;
-    
     // Asserts
     // Find file name and file extension
     unsigned long found = downloadUnit.storagePath.find_last_of("/\\");
@@ -141,37 +153,107 @@ void Downloader::prepareDownload(const DownloadUnit& downloadUnit)
     }
     else
     {
-        err.code = ErrorCode::INVALID_URL;
-        err.message = "Invalid url or filename not exist error: " + downloadUnit.srcUrl;
-        if (this->_onError)
-            this->_onError(err);
-        downloadUnit.fp = nullptr;
-        return;
+        notifyError(ErrorCode::INVALID_URL, "Invalid url or filename not exist error: " + downloadUnit.srcUrl, downloadUnit.customId);
+        return false;
     }
 
     // create possible subdirectories
-    if (!FileUtils::getInstance()->isDirectoryExist(path))
-        FileUtils::getInstance()->createDirectory(path);
-    
-    // Create a file to save file.
+    if (!_fileUtils->isDirectoryExist(path))
+        _fileUtils->createDirectory(path);
+
+    // Create a file to save file, or append to the one left by an interrupted download
+    FILE *localFP = nullptr;
     const std::string outFileName = downloadUnit.storagePath + TEMP_EXT;
-    if (_supportResuming && downloadUnit.resumeDownload && _fileUtils->isFileExist(outFileName))
+    if (!restart && downloadUnit.resumeDownload && _fileUtils->isFileExist(outFileName))
     {
-        localFP = fopen(FileUtils::getInstance()->getSuitableFOpen(outFileName).c_str(), "ab");
+        downloadUnit.resumeOffset = std::max(_fileUtils->getFileSize(outFileName), 0L);
+        localFP = fopen(_fileUtils->getSuitableFOpen(outFileName).c_str(), "ab");
     }
     else
     {
-        localFP = fopen(FileUtils::getInstance()->getSuitableFOpen(outFileName).c_str(), "wb");
+        localFP = fopen(_fileUtils->getSuitableFOpen(outFileName).c_str(), "wb");
     }
     if (!localFP)
     {
-        err.code = ErrorCode::CREATE_FILE;
-        err.message = StringUtils::format("Can not create file %s: errno %d", outFileName.c_str(), errno);
-        if (this->_onError)
-            this->_onError(err);
+        notifyError(ErrorCode::CREATE_FILE, StringUtils::format("Can not create file %s: errno %d", outFileName.c_str(), errno), downloadUnit.customId);
+        return false;
     }
-
     downloadUnit.fp = localFP;
+
+    // the content is hashed as it is written, starting with the bytes kept from the previous download
+    if (!downloadUnit.hash.empty())
+    {
+        if (!downloadUnit._hashState)
+            downloadUnit._hashState = XXH32_createState();
+        XXH32_state_t* state = (XXH32_state_t*)downloadUnit._hashState;
+        XXH32_reset(state, 0);
+
+        if (downloadUnit.resumeOffset > 0)
+        {
+            FILE* keptFP = fopen(_fileUtils->getSuitableFOpen(outFileName).c_str(), "rb");
+            if (!keptFP)
+            {
+                return prepareDownload(downloadUnit, true);
+            }
+            unsigned char buffer[HASH_READ_SIZE];
+            size_t read;
+            while ((read = fread(buffer, 1, sizeof(buffer), keptFP)) > 0)
+                XXH32_update(state, buffer, read);
+            fclose(keptFP);
+        }
+    }
+    return true;
+}
+
+void Downloader::finishDownload(const DownloadUnit& downloadUnit, int curle_code)
+{
+    // first close, then rename. Otherwise sharing_violation_error on windows
+    if (downloadUnit.fp)
+    {
+        fclose((FILE*)downloadUnit.fp);
+        downloadUnit.fp = nullptr;
+    }
+
+    std::string hash;
+    if (downloadUnit._hashState)
+    {
+        XXH32_state_t* state = (XXH32_state_t*)downloadUnit._hashState;
+        hash = StringUtils::format("%08x", XXH32_digest(state));
+        XXH32_freeState(state);
+        downloadUnit._hashState = nullptr;
+    }
+
+    const std::string tempFileName = downloadUnit.storagePath + TEMP_EXT;
+    if (curle_code != CURLE_OK)
+    {
+        // the temporary file is kept to be resumed, unless the server refused the range
+        if (curle_code == CURLE_HTTP_RETURNED_ERROR && downloadUnit.resumeOffset > 0)
+            _fileUtils->removeFile(tempFileName);
+        std::string msg = StringUtils::format("Unable to download file: [curl error]%s", curl_easy_strerror((CURLcode)curle_code));
+        notifyError(ErrorCode::NETWORK, msg, downloadUnit.customId, curle_code);
+    }
+    else if (!downloadUnit.hash.empty() && strcasecmp(hash.c_str(), downloadUnit.hash.c_str()) != 0)
+    {
+        _fileUtils->removeFile(tempFileName);
+        std::string msg = StringUtils::format("Hash mismatch: expected %s, downloaded %s", downloadUnit.hash.c_str(), hash.c_str());
+        notifyError(ErrorCode::HASH_MISMATCH, msg, downloadUnit.customId);
+    }
+    else
+    {
+        _fileUtils->renameFile(tempFileName, downloadUnit.storagePath);
+
+        std::weak_ptr<Downloader> ptr = shared_from_this();
+        std::string srcUrl = downloadUnit.srcUrl;
+        std::string storagePath = downloadUnit.storagePath;
+        std::string customId = downloadUnit.customId;
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+            if (!ptr.expired())
+            {
+                std::shared_ptr<Downloader> downloader = ptr.lock();
+                downloader->reportDownloadFinished(srcUrl, storagePath, customId);
+            }
+        });
+    }
 }
 
 void Downloader::downloadToBufferAsync(const std::string& srcUrl, unsigned char *buffer, long size, const std::string& customId/* = ""*/)
@@ -267,8 +349,12 @@ void Downloader::downloadToFP(const std::string& srcUrl, const std::string& cust
     unit.customId = customId;
     unit.storagePath = storagePath;
     unit.fp = nullptr;
+    unit.resumeDownload = false;
+    unit.resumeOffset = 0;
+    unit._hashState = nullptr;
 
-    prepareDownload(unit);
+    if (!prepareDownload(unit))
+        return;
 
     int res = _downloaderImpl->performDownload(&unit,
                                                std::bind(&Downloader::fileWriteFunc, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4),
@@ -326,35 +412,26 @@ void Downloader::batchDownloadSync(const DownloadUnits& units, const std::string
     
     if (units.size() != 0)
     {
-        _supportResuming = _downloaderImpl->supportsResume(units.cbegin()->second.srcUrl);
+        // static_cast needed since notifyError is overloaded
+        auto errorCallback = std::bind( static_cast<void(Downloader::*)(const std::string&, int, const std::string&)>
+                              (&Downloader::notifyError), this,
+                              std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
 
-        // split units in multiple parts if the size is bigger
-        // than FOPEN_MAX
-        if (units.size() >= FOPEN_MAX)
-        {
-            int count = 0;
-            DownloadUnits group;
-            for (auto it = units.cbegin(); it != units.cend(); ++it, ++count)
-            {
-                if (count == FOPEN_MAX)
-                {
-                    groupBatchDownload(group);
-                    group.clear();
-                    count = 0;
-                }
-                const std::string& key = it->first;
-                const DownloadUnit& unit = it->second;
-                group.emplace(key, unit);
-            }
-            if (group.size() > 0)
-            {
-                groupBatchDownload(group);
-            }
-        }
-        else
+        // the files are opened when their transfer starts, so that only a few are open at once
+        for (const auto& entry: units)
         {
-            groupBatchDownload(units);
+            auto&& unit = entry.second;
+            unit.fp = nullptr;
+            unit.resumeOffset = 0;
+            unit._hashState = nullptr;
         }
+        _downloaderImpl->performBatchDownload(units,
+                                              std::bind(&Downloader::fileWriteFunc, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4),
+                                              std::bind(&Downloader::batchDownloadProgressFunc, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                                              errorCallback,
+                                              std::bind(&Downloader::prepareDownload, this, std::placeholders::_1, std::placeholders::_2),
+                                              std::bind(&Downloader::finishDownload, this, std::placeholders::_1, std::placeholders::_2)
+                                              );
     }
     
     Director::getInstance()->getScheduler()->performFunctionInCocosThread([ptr, batchId]{
@@ -367,48 +444,6 @@ void Downloader::batchDownloadSync(const DownloadUnits& units, const std::string
             }
         }
     });
-    _supportResuming = false;
-}
-
-void Downloader::groupBatchDownload(const DownloadUnits& units)
-{
-    std::weak_ptr<Downloader> ptr = shared_from_this();
-    std::shared_ptr<Downloader> shared = ptr.lock();
-    
-    // static_cast needed since notifyError is overloaded
-    auto errorCallback = std::bind( static_cast<void(Downloader::*)(const std::string&, int, const std::string&)>
-                          (&Downloader::notifyError), this,
-                          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-
-    for (const auto& entry: units)
-    {
-        auto&& unit = entry.second;
-        prepareDownload(unit);
-    }
-    _downloaderImpl->performBatchDownload(units,
-                                          std::bind(&Downloader::fileWriteFunc, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4),
-                                          std::bind(&Downloader::batchDownloadProgressFunc, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-                                          errorCallback
-                                          );
-
-    // Check unfinished files and notify errors, succeed files will be renamed from temporary file name to real name
-    for(const auto& entry: units)
-    {
-        const auto& unit = entry.second;
-
-        // first close, then rename. Otherwise sharing_violation_error on windows
-        if (unit.fp)
-            fclose((FILE*)unit.fp);
-
-        if (unit.downloaded < unit.totalToDownload || unit.totalToDownload == 0)
-        {
-            this->notifyError(ErrorCode::NETWORK, "Unable to download file", unit.customId);
-        }
-        else
-        {
-            _fileUtils->renameFile(unit.storagePath + TEMP_EXT, unit.storagePath);
-        }
-    }
 }
 
 HeaderInfo Downloader::getHeader(const std::string &srcUrl)
@@ -427,6 +462,8 @@ size_t Downloader::fileWriteFunc(void *ptr, size_t size, size_t nmemb, void *use
     
     CC_ASSERT(fp && "Invalid FP");
     size_t written = fwrite(ptr, size, nmemb, fp);
+    if (unit->_hashState)
+        XXH32_update((XXH32_state_t*)unit->_hashState, ptr, written * size);
     return written;
 }
 
@@ -455,15 +492,6 @@ void Downloader::reportDownloadFinished(const std::string& url, const std::strin
         _onSuccess(url, path, customid);
     }
 }
-void Downloader::reportProgressFinished(double totalToDownload, double nowDownloaded, const DownloadUnit* unit)
-{
-    if (_onProgress != nullptr)
-    {
-        _onProgress(totalToDownload, nowDownloaded, unit->srcUrl, unit->customId);
-    }
-    reportDownloadFinished(unit->srcUrl, unit->storagePath, unit->customId);
-}
-
 void Downloader::reportProgressInProgress(double totalToDownload, double nowDownloaded, const DownloadUnit* unit)
 {
     if (_onProgress != nullptr)
@@ -472,12 +500,20 @@ void Downloader::reportProgressInProgress(double totalToDownload, double nowDown
     }
 }
 
-// This is only for batchDownload process, will notify file succeed event in progress function
+// This is only for batchDownload process, the files succeed when their transfer ends, see finishDownload
 int Downloader::batchDownloadProgressFunc(void *userdata, double totalToDownload, double nowDownloaded)
 {
     CC_ASSERT(userdata && "Invalid userdata");
 
     DownloadUnit* ptr = (DownloadUnit*) userdata;
+
+    // a resumed transfer only counts the bytes after the ones kept
+    if (totalToDownload > 0)
+    {
+        totalToDownload += ptr->resumeOffset;
+        nowDownloaded += ptr->resumeOffset;
+    }
+
     if (ptr->totalToDownload == 0)
     {
         ptr->totalToDownload = totalToDownload;
@@ -487,41 +523,20 @@ int Downloader::batchDownloadProgressFunc(void *userdata, double totalToDownload
     {
         ptr->downloaded = nowDownloaded;
 
-        if (nowDownloaded == totalToDownload)
+        if (std::this_thread::get_id() != Director::getInstance()->getCocos2dThreadId())
         {
-            if (std::this_thread::get_id() != Director::getInstance()->getCocos2dThreadId())
-            {
-                std::weak_ptr<Downloader> _this = shared_from_this();
-                DownloadUnit copyUnit = *ptr;
-                Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
-                    if (!_this.expired())
-                    {
-                        this->reportProgressFinished(totalToDownload, nowDownloaded, &copyUnit);
-                    }
-                });
-            }
-            else
-            {
-                reportProgressFinished(totalToDownload, nowDownloaded, ptr);
-            }
+            std::weak_ptr<Downloader> _this = shared_from_this();
+            DownloadUnit copyUnit = *ptr;
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+                if (!_this.expired())
+                {
+                    reportProgressInProgress(totalToDownload, nowDownloaded, &copyUnit);
+                }
+            });
         }
         else
         {
-            if (std::this_thread::get_id() != Director::getInstance()->getCocos2dThreadId())
-            {
-                std::weak_ptr<Downloader> _this = shared_from_this();
-                DownloadUnit copyUnit = *ptr;
-                Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
-                    if (!_this.expired())
-                    {
-                        reportProgressInProgress(totalToDownload, nowDownloaded, &copyUnit);
-                    }
-                });
-            }
-            else
-            {
-                reportProgressInProgress(totalToDownload, nowDownloaded, ptr);
-            }
+            reportProgressInProgress(totalToDownload, nowDownloaded, ptr);
         }
     }
 
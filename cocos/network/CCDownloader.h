@@ -62,7 +62,9 @@ public:
 
         INVALID_STORAGE_PATH,
         
-        PREPARE_HEADER_ERROR
+        PREPARE_HEADER_ERROR,
+
+        HASH_MISMATCH
     };
 
     struct Error
@@ -89,6 +91,13 @@ public:
 
     int getConnectionTimeout();
     void setConnectionTimeout(int timeout);
+
+    /** Number of files of a batch downloaded at once, 6 by default.
+     * The files share the connections, and a file which fails doesn't stop the others.
+     * @since v3.9
+     */
+    int getMaxParallelDownloads() const { return _maxParallelDownloads; }
+    void setMaxParallelDownloads(int count);
     
     void setErrorCallback(const ErrorCallback &callback) { _onError = callback; };
     void setProgressCallback(const ProgressCallback &callback) { _onProgress = callback; };
@@ -119,11 +128,11 @@ public:
 protected:
 
 
-    void prepareDownload(const DownloadUnit& downloadUnit);
+    bool prepareDownload(const DownloadUnit& downloadUnit, bool restart = false);
+    void finishDownload(const DownloadUnit& downloadUnit, int curle_code);
 
     void downloadToBuffer(const std::string& srcUrl, const std::string& customId, unsigned char* buffer, long size);
     void downloadToFP(const std::string& srcUrl, const std::string& customId, const std::string& storagePath);
-    void groupBatchDownload(const DownloadUnits& units);
 
     void notifyError(ErrorCode code, const std::string& msg = "", const std::string& customId = "", int curle_code = 0, int curlm_code = 0);
     void notifyError(const std::string& msg, int curlm_code, const std::string& customId = "");
@@ -136,7 +145,6 @@ protected:
     size_t fileWriteFunc(void *ptr, size_t size, size_t nmemb, void *userdata);
 
     // callback helpers
-    void reportProgressFinished(double totalToDownload, double nowDownloaded, const DownloadUnit* downloadUnit);
     void reportProgressInProgress(double totalToDownload, double nowDownloaded, const DownloadUnit* downloadUnit);
     void reportDownloadFinished(const std::string& url, const std::string&, const std::string& customid);
 
@@ -149,8 +157,8 @@ private:
     SuccessCallback _onSuccess;
 
     int _connectionTimeout;
+    int _maxParallelDownloads;
     FileUtils* _fileUtils;
-    bool _supportResuming;
     DownloaderImpl* _downloaderImpl;
 };
 
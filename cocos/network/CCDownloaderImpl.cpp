@@ -25,6 +25,7 @@
 #include "network/CCDownloaderImpl.h"
 
 #include <curl/curl.h>
+#include <algorithm>
 
 #include "platform/CCFileUtils.h"
 #include "deprecated/CCString.h"
@@ -35,6 +36,7 @@ using namespace cocos2d::network;
 static const long LOW_SPEED_LIMIT = 1;
 static const long LOW_SPEED_TIME = 5;
 static const int DEFAULT_TIMEOUT = 5;
+static const int DEFAULT_MAX_PARALLEL_DOWNLOADS = 6;
 static const int MAX_REDIRS = 2;
 static const int MAX_WAIT_MSECS = 30*1000; /* Wait max. 30 seconds */
 
@@ -68,6 +70,7 @@ DownloaderImpl::DownloaderImpl()
 , _curlHandle(nullptr)
 , _lastErrCode(CURLE_OK)
 , _connectionTimeout(DEFAULT_TIMEOUT)
+, _maxParallelDownloads(DEFAULT_MAX_PARALLEL_DOWNLOADS)
 , _initialized(false)
 {
 }
@@ -125,10 +128,42 @@ int DownloaderImpl::performDownload(DownloadUnit* unit,
     return _lastErrCode;
 }
 
+namespace {
+    // a unit of a batch being downloaded
+    struct BatchTransfer
+    {
+        const DownloadUnit* unit;
+        CURL* curl;
+        const IDownloaderImpl::StartCallback* startCallback;
+        bool responseChecked;
+    };
+}
+
+static size_t _batchWriteFunc(void *ptr, size_t size, size_t nmemb, void* userdata)
+{
+    BatchTransfer* transfer = (BatchTransfer*)userdata;
+    const DownloadUnit* unit = transfer->unit;
+    if (!transfer->responseChecked)
+    {
+        transfer->responseChecked = true;
+        long responseCode = 0;
+        curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &responseCode);
+        // the whole file comes instead of the requested range
+        if (unit->resumeOffset > 0 && responseCode != HTTP_CODE_SUPPORT_RESUME)
+        {
+            if (!(*transfer->startCallback)(*unit, true))
+                return 0;
+        }
+    }
+    return _fileWriteFunc(ptr, size, nmemb, (void*)unit);
+}
+
 int DownloaderImpl::performBatchDownload(const DownloadUnits& units,
                                          const WriterCallback& batchWriterCallback,
                                          const ProgressCallback& batchProgressCallback,
-                                         const ErrorCallback& errorCallback)
+                                         const ErrorCallback& errorCallback,
+                                         const StartCallback& startCallback,
+                                         const FinishCallback& finishCallback)
 {
     CC_ASSERT(_initialized && "must be initialized");
 
@@ -138,80 +173,108 @@ int DownloaderImpl::performBatchDownload(const DownloadUnits& units,
     CURLM* multi_handle = curl_multi_init();
     int still_running = 0;
 
-    bool supportResume = supportsResume(units.cbegin()->second.srcUrl);
-    auto fileUtils = FileUtils::getInstance();
-
     _writerCallback = batchWriterCallback;
     _progressCallback = batchProgressCallback;
 
-    std::vector<CURL*> curls;
-    curls.reserve(units.size());
-
-    for (const auto& unitEntry: units)
-    {
-        const auto& unit = unitEntry.second;
+    // the transfers start as the previous ones end, with their files opened, and reuse their connections
+    std::vector<BatchTransfer*> transfers;
+    auto nextUnit = units.cbegin();
 
+    auto startTransfer = [&](const DownloadUnit& unit) {
         // HACK: Needed for callbacks. "this" + "unit" are needed
         unit._reserved = this;
 
-        if (unit.fp != NULL)
+        // the error is already reported
+        if (!startCallback(unit, false))
+            return;
+
+        BatchTransfer* transfer = new (std::nothrow) BatchTransfer();
+        transfer->unit = &unit;
+        transfer->curl = curl_easy_init();
+        transfer->startCallback = &startCallback;
+        transfer->responseChecked = false;
+
+        CURL* curl = transfer->curl;
+        curl_easy_setopt(curl, CURLOPT_URL, unit.srcUrl.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _batchWriteFunc);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, false);
+        curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, _downloadProgressFunc);
+        curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &unit);
+        curl_easy_setopt(curl, CURLOPT_FAILONERROR, true);
+        if (_connectionTimeout)
+            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, _connectionTimeout);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, true);
+        curl_easy_setopt(curl, CURLOPT_MAXREDIRS, MAX_REDIRS);
+
+        // Resuming download support, with a Range request from the end of the temporary file
+        if (unit.resumeOffset > 0)
         {
-            CURL* curl = curl_easy_init();
-            curl_easy_setopt(curl, CURLOPT_URL, unit.srcUrl.c_str());
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _fileWriteFunc);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &unit);
-            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, false);
-            curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, _downloadProgressFunc);
-            curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &unit);
-            curl_easy_setopt(curl, CURLOPT_FAILONERROR, true);
-            if (_connectionTimeout)
-                curl_easy_setopt(_curlHandle, CURLOPT_CONNECTTIMEOUT, _connectionTimeout);
-            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
-            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, true);
-            curl_easy_setopt(curl, CURLOPT_MAXREDIRS, MAX_REDIRS);
-
-            // Resuming download support
-            if (supportResume && unit.resumeDownload)
-            {
-                // Check already downloaded size for current download unit
-                long size = fileUtils->getFileSize(unit.storagePath + TEMP_EXT);
-                if (size != -1)
-                {
-                    curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, size);
-                }
-            }
+            curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)unit.resumeOffset);
+        }
 
-            CURLMcode code = curl_multi_add_handle(multi_handle, curl);
-            if (code != CURLM_OK)
-            {
-                errorCallback(StringUtils::format("Unable to add curl handler for %s: [curl error]%s", unit.customId.c_str(), curl_multi_strerror(code)),
-                              code,
-                              unit.customId);
-                curl_easy_cleanup(curl);
-            }
-            else
-            {
-                curls.push_back(curl);
-            }
+        CURLMcode code = curl_multi_add_handle(multi_handle, curl);
+        if (code != CURLM_OK)
+        {
+            curl_easy_cleanup(curl);
+            delete transfer;
+            finishCallback(unit, CURLE_FAILED_INIT);
         }
-    }
+        else
+        {
+            transfers.push_back(transfer);
+        }
+    };
 
-    // Query multi perform
-    CURLMcode curlm_code = CURLM_CALL_MULTI_PERFORM;
-    while(CURLM_CALL_MULTI_PERFORM == curlm_code) {
-        curlm_code = curl_multi_perform(multi_handle, &still_running);
-    }
-    if (curlm_code != CURLM_OK) {
-        errorCallback(StringUtils::format("Unable to continue the download process: [curl error]%s", curl_multi_strerror(curlm_code)),
-                      curlm_code,
-                      "");
-    }
-    else
+    bool failed = false;
+    while (!failed)
     {
-        bool failed = false;
-        while (still_running > 0 && !failed)
+        while (nextUnit != units.cend() && (int)transfers.size() < _maxParallelDownloads)
+        {
+            startTransfer(nextUnit->second);
+            ++nextUnit;
+        }
+        if (transfers.empty())
+            break;
+
+        // Query multi perform
+        CURLMcode curlm_code = CURLM_CALL_MULTI_PERFORM;
+        while(CURLM_CALL_MULTI_PERFORM == curlm_code) {
+            curlm_code = curl_multi_perform(multi_handle, &still_running);
+        }
+        if (curlm_code != CURLM_OK) {
+            errorCallback(StringUtils::format("Unable to continue the download process: [curl error]%s", curl_multi_strerror(curlm_code)),
+                          curlm_code,
+                          "");
+            break;
+        }
+
+        // Close the finished transfers, their units are checked by the finish callback
+        CURLMsg* message;
+        int messagesLeft;
+        while ((message = curl_multi_info_read(multi_handle, &messagesLeft)))
+        {
+            if (message->msg != CURLMSG_DONE)
+                continue;
+
+            auto iter = std::find_if(transfers.begin(), transfers.end(), [message](BatchTransfer* transfer) {
+                return transfer->curl == message->easy_handle;
+            });
+            if (iter == transfers.end())
+                continue;
+
+            BatchTransfer* transfer = *iter;
+            transfers.erase(iter);
+            curl_multi_remove_handle(multi_handle, transfer->curl);
+            curl_easy_cleanup(transfer->curl);
+            finishCallback(*transfer->unit, message->data.result);
+            delete transfer;
+        }
+
+        if (still_running > 0)
         {
             // set a suitable timeout to play around with
             struct timeval select_tv;
@@ -229,47 +292,36 @@ int DownloaderImpl::performBatchDownload(const DownloadUnits& units,
             }
 
             int rc;
+            int maxfd = -1;
+            // FIXME: when jenkins migrate to ubuntu, we should remove this hack code
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
             fd_set fdread;
             fd_set fdwrite;
             fd_set fdexcep;
-            int maxfd = -1;
             FD_ZERO(&fdread);
             FD_ZERO(&fdwrite);
             FD_ZERO(&fdexcep);
-            // FIXME: when jenkins migrate to ubuntu, we should remove this hack code
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
             curl_multi_fdset(multi_handle, &fdread, &fdwrite, &fdexcep, &maxfd);
             rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &select_tv);
 #else
             rc = curl_multi_wait(multi_handle,nullptr, 0, MAX_WAIT_MSECS, &maxfd);
 #endif
-
-            switch(rc)
-            {
-                case -1:
-                    failed = true;
-                    break;
-                case 0:
-                default:
-                    curlm_code = CURLM_CALL_MULTI_PERFORM;
-                    while(CURLM_CALL_MULTI_PERFORM == curlm_code) {
-                        curlm_code = curl_multi_perform(multi_handle, &still_running);
-                    }
-                    if (curlm_code != CURLM_OK) {
-                        errorCallback(StringUtils::format("Unable to continue the download process: [curl error]%s", curl_multi_strerror(curlm_code)),
-                                      curlm_code,
-                                      "");
-                    }
-                    break;
-            }
+            failed = rc == -1;
         }
     }
 
-    // Clean up and close files
-    for (auto& curl: curls)
+    // Clean up the transfers left by an error, their files are kept to be resumed
+    for (auto transfer : transfers)
     {
-        curl_multi_remove_handle(multi_handle, curl);
-        curl_easy_cleanup(curl);
+        curl_multi_remove_handle(multi_handle, transfer->curl);
+        curl_easy_cleanup(transfer->curl);
+        finishCallback(*transfer->unit, CURLE_ABORTED_BY_CALLBACK);
+        delete transfer;
+    }
+    for (; nextUnit != units.cend(); ++nextUnit)
+    {
+        nextUnit->second._reserved = this;
+        finishCallback(nextUnit->second, CURLE_ABORTED_BY_CALLBACK);
     }
     curl_multi_cleanup(multi_handle);
 
@@ -336,3 +388,8 @@ void DownloaderImpl::setConnectionTimeout(int connectionTimeout)
 {
     _connectionTimeout = connectionTimeout;
 }
+
+void DownloaderImpl::setMaxParallelDownloads(int count)
+{
+    _maxParallelDownloads = std::max(count, 1);
+}
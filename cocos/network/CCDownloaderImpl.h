@@ -55,11 +55,14 @@ namespace network
         int performBatchDownload(const DownloadUnits& units,
                                  const WriterCallback& writerCallback,
                                  const ProgressCallback& progressCallback,
-                                 const ErrorCallback& errorCallback                                         
+                                 const ErrorCallback& errorCallback,
+                                 const StartCallback& startCallback,
+                                 const FinishCallback& finishCallback
                                  ) override;
         int getHeader(const std::string& url, HeaderInfo* headerInfo) override;
         std::string getStrError() const override;
         void setConnectionTimeout(int timeout) override;
+        void setMaxParallelDownloads(int count) override;
         bool supportsResume(const std::string& url);
 
         //
@@ -69,6 +72,7 @@ namespace network
     private:
 
         int _connectionTimeout;
+        int _maxParallelDownloads;
         WriterCallback _writerCallback;
         ProgressCallback _progressCallback;
 
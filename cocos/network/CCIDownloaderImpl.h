@@ -55,12 +55,17 @@ namespace network
         std::string srcUrl;
         std::string storagePath;
         std::string customId;
+        // xxHash32 of the content as 8 hexadecimal digits, the download fails if it doesn't match. Not checked if empty.
+        std::string hash;
 
         // additional info created by CCDownloader
         mutable void* fp;
         mutable bool resumeDownload;
         mutable double downloaded;
         mutable double totalToDownload;
+        // bytes kept from a previous download, requested again from this offset
+        mutable long resumeOffset;
+        mutable void *_hashState;
         mutable void *_reserved;
     };
 
@@ -72,6 +77,10 @@ namespace network
         typedef std::function<int(void* ptr, ssize_t, ssize_t, void* userdata)> WriterCallback;
         typedef std::function<int(void* userdata, double, double)> ProgressCallback;
         typedef std::function<void(const std::string&, int, const std::string&)> ErrorCallback;
+        // opens the destination of a unit when its transfer starts, restart is true when the server ignored its resume offset
+        typedef std::function<bool(const DownloadUnit& unit, bool restart)> StartCallback;
+        // closes the destination of a unit when its transfer ends, with the curl code of the transfer
+        typedef std::function<void(const DownloadUnit& unit, int curle_code)> FinishCallback;
 
         IDownloaderImpl(){}
         virtual ~IDownloaderImpl(){}
@@ -90,12 +99,15 @@ namespace network
         virtual int performBatchDownload(const DownloadUnits& units,
                                          const WriterCallback& writerCallback,
                                          const ProgressCallback& progressCallback,
-                                         const ErrorCallback& errorCallback
+                                         const ErrorCallback& errorCallback,
+                                         const StartCallback& startCallback,
+                                         const FinishCallback& finishCallback
                                          ) = 0;
 
         virtual int getHeader(const std::string& url, HeaderInfo* headerInfo) = 0;
         virtual std::string getStrError() const = 0;
         virtual void setConnectionTimeout(int timeout) = 0;
+        virtual void setMaxParallelDownloads(int count) = 0;
     };
 }
 
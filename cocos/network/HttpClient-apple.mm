@@ -71,7 +71,15 @@ void HttpClient::networkThread()
         // Create a HttpResponse object, the default setting is http access failed
         HttpResponse *response = new (std::nothrow) HttpResponse(request);
         
-        processResponse(response, _responseMessage);
+        if (request->isCancelled())
+        {
+            // still dispatched, to be released on the cocos thread
+            response->setErrorBuffer("cancelled");
+        }
+        else
+        {
+            processResponse(response, _responseMessage);
+        }
         
         // add response packet into queue
         _responseQueueMutex.lock();
@@ -114,7 +122,11 @@ void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response
             Ref* pTarget = request->getTarget();
             SEL_HttpResponse pSelector = request->getSelector();
             
-            if (callback != nullptr)
+            if (request->isCancelled())
+            {
+                // released without calling back
+            }
+            else if (callback != nullptr)
             {
                 callback(this, response);
             }
@@ -371,6 +383,8 @@ void HttpClient::setSSLVerification(const std::string& caFile)
 HttpClient::HttpClient()
 : _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(6)
+, _maxConnectionsPerHost(0)
 , _isInited(false)
 , _threadCount(0)
 , _requestSentinel(new HttpRequest())
@@ -428,7 +442,7 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
     
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    insertRequest(_requestQueue, request);
     _requestQueueMutex.unlock();
     
     // Notify thread start to work
@@ -471,7 +485,11 @@ void HttpClient::dispatchResponseCallbacks()
         Ref* pTarget = request->getTarget();
         SEL_HttpResponse pSelector = request->getSelector();
 
-        if (callback != nullptr)
+        if (request->isCancelled())
+        {
+            // released without calling back
+        }
+        else if (callback != nullptr)
         {
             callback(this, response);
         }
@@ -588,6 +606,30 @@ int HttpClient::getTimeoutForRead()
     std::lock_guard<std::mutex> lock(_timeoutForReadMutex);
     return _timeoutForRead;
 }
+
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+    _maxConcurrentRequests = std::max(value, 1);
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+    _maxConnectionsPerHost = std::max(value, 0);
+}
+
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+    return _maxConnectionsPerHost;
+}
     
 const std::string& HttpClient::getCookieFilename()
 {
@@ -26,6 +26,7 @@
 
 #include "HttpClient.h"
 #include <queue>
+#include <algorithm>
 #include <errno.h>
 #include <curl/curl.h>
 #include "base/CCDirector.h"
@@ -41,6 +42,11 @@ typedef int int32_t;
 
 static HttpClient* _httpClient = nullptr; // pointer to singleton
 
+// how long the network thread waits for the sockets of the running transfers, before it looks for new requests
+static const int TRANSFER_WAIT_MS = 10;
+// easy handles kept for the next requests, with their buffers
+static const size_t MAX_IDLE_HANDLES = 16;
+
 typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
 
 // Callback function used by libcurl for collect response data
@@ -69,104 +75,6 @@ static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream
     return sizes;
 }
 
-
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread()
-{   
-	increaseThreadCount();
-    
-    while (true) 
-    {
-        HttpRequest *request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-			{
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
-        
-		processResponse(response, _responseMessage);
-        
-
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
-        
-		_schedulerMutex.lock();
-		if (nullptr != _scheduler)
-		{
-			_scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
-		}
-		_schedulerMutex.unlock();
-    }
-    
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-    
-	_responseQueueMutex.lock();
-	_responseQueue.clear();
-	_responseQueueMutex.unlock();
-
-	decreaseThreadCountAndMayDeleteThis();    
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response)
-{
-	increaseThreadCount();
-
-	char responseMessage[RESPONSE_BUFFER_SIZE] = { 0 };
-	processResponse(response, responseMessage);
-	
-	_schedulerMutex.lock();
-	if (nullptr != _scheduler)
-	{
-		_scheduler->performFunctionInCocosThread([this, response, request]{
-			const ccHttpRequestCallback& callback = request->getCallback();
-			Ref* pTarget = request->getTarget();
-			SEL_HttpResponse pSelector = request->getSelector();
-
-			if (callback != nullptr)
-			{
-				callback(this, response);
-			}
-			else if (pTarget && pSelector)
-			{
-				(pTarget->*pSelector)(this, response);
-			}
-			response->release();
-			// do not release in other thread
-			request->release();
-		});
-	}
-	_schedulerMutex.unlock();
-
-	decreaseThreadCountAndMayDeleteThis();
-}
-
 //Configure curl's timeout property
 static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
 {
@@ -179,11 +87,11 @@ static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, HttpClient::getInstance()->getTimeoutForRead());
+    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, client->getTimeoutForRead());
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, HttpClient::getInstance()->getTimeoutForConnect());
+    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, client->getTimeoutForConnect());
     if (code != CURLE_OK) {
         return false;
     }
@@ -207,135 +115,323 @@ static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
     return true;
 }
 
-class CURLRaii
+/**
+ * A request transferred by the multi handle of the network thread.
+ * The easy handle comes back to the idle handles once the transfer is done, its connection stays in the
+ * connection cache of the multi handle for the next requests to the same host.
+ */
+class CURLTransfer
 {
-    /// Instance of CURL
-    CURL *_curl;
-    /// Keeps custom header data
-    curl_slist *_headers;
 public:
-    CURLRaii()
-        : _curl(curl_easy_init())
-        , _headers(nullptr)
+    HttpRequest* request;
+    HttpResponse* response;
+    CURL* curl;
+    /// Keeps custom header data
+    curl_slist* headers;
+    bool cookies;
+    char errorBuffer[CURL_ERROR_SIZE];
+
+    CURLTransfer(HttpRequest* request, CURL* curl)
+        : request(request)
+        , response(new (std::nothrow) HttpResponse(request))
+        , curl(curl)
+        , headers(nullptr)
+        , cookies(false)
     {
+        errorBuffer[0] = '\0';
     }
 
-    ~CURLRaii()
+    ~CURLTransfer()
     {
-        if (_curl)
-            curl_easy_cleanup(_curl);
         /* free the linked list for header data */
-        if (_headers)
-            curl_slist_free_all(_headers);
+        if (headers)
+            curl_slist_free_all(headers);
     }
 
     template <class T>
     bool setOption(CURLoption option, T data)
     {
-        return CURLE_OK == curl_easy_setopt(_curl, option, data);
+        return CURLE_OK == curl_easy_setopt(curl, option, data);
     }
 
     /**
-     * @brief Inits CURL instance for common usage
-     * @param request Null not allowed
-     * @param callback Response write callback
-     * @param stream Response write stream
+     * @brief Sets the options of the request on the easy handle
+     * @param share The DNS cache, TLS sessions and cookies shared by the transfers
      */
-    bool init(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, write_callback headerCallback, void* headerStream, char* errorBuffer)
+    bool init(HttpClient* client, CURLSH* share)
     {
-        if (!_curl)
+        if (!curl || !response)
             return false;
-		if (!configureCURL(client, _curl, errorBuffer))
+        if (!configureCURL(client, curl, errorBuffer))
             return false;
 
         /* get custom header data (if set) */
-        std::vector<std::string> headers=request->getHeaders();
-        if(!headers.empty())
+        std::vector<std::string> requestHeaders = request->getHeaders();
+        if (!requestHeaders.empty())
         {
             /* append custom headers one by one */
-            for (std::vector<std::string>::iterator it = headers.begin(); it != headers.end(); ++it)
-                _headers = curl_slist_append(_headers,it->c_str());
+            for (auto& header : requestHeaders)
+                headers = curl_slist_append(headers, header.c_str());
             /* set custom headers for curl */
-            if (!setOption(CURLOPT_HTTPHEADER, _headers))
+            if (!setOption(CURLOPT_HTTPHEADER, headers))
                 return false;
         }
-		std::string cookieFilename = client->getCookieFilename();
-		if (!cookieFilename.empty()) {
-			if (!setOption(CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
+        std::string cookieFilename = client->getCookieFilename();
+        if (!cookieFilename.empty()) {
+            if (!setOption(CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
                 return false;
             }
-			if (!setOption(CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
+            if (!setOption(CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
                 return false;
             }
+            cookies = true;
         }
 
-        return setOption(CURLOPT_URL, request->getUrl())
-                && setOption(CURLOPT_WRITEFUNCTION, callback)
-                && setOption(CURLOPT_WRITEDATA, stream)
-                && setOption(CURLOPT_HEADERFUNCTION, headerCallback)
-                && setOption(CURLOPT_HEADERDATA, headerStream);
-        
+        bool ok = setOption(CURLOPT_URL, request->getUrl())
+                && setOption(CURLOPT_WRITEFUNCTION, (write_callback)writeData)
+                && setOption(CURLOPT_WRITEDATA, response->getResponseData())
+                && setOption(CURLOPT_HEADERFUNCTION, (write_callback)writeHeaderData)
+                && setOption(CURLOPT_HEADERDATA, response->getResponseHeader())
+                && setOption(CURLOPT_SHARE, share)
+                && setOption(CURLOPT_PRIVATE, this);
+        if (!ok)
+            return false;
+
+        switch (request->getRequestType())
+        {
+        case HttpRequest::Type::GET: // HTTP GET
+            return setOption(CURLOPT_FOLLOWLOCATION, 1L);
+        case HttpRequest::Type::POST: // HTTP POST
+            return setOption(CURLOPT_POST, 1L)
+                && setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+                && setOption(CURLOPT_POSTFIELDSIZE, (long)request->getRequestDataSize());
+        case HttpRequest::Type::PUT:
+            return setOption(CURLOPT_CUSTOMREQUEST, "PUT")
+                && setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+                && setOption(CURLOPT_POSTFIELDSIZE, (long)request->getRequestDataSize());
+        case HttpRequest::Type::DELETE:
+            return setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+                && setOption(CURLOPT_FOLLOWLOCATION, 1L);
+        default:
+            CCLOGERROR("HttpClient: unknown request type, only GET, POST, PUT and DELETE are supported");
+            return false;
+        }
     }
 
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode)
+    /// Writes the result of the transfer to the response
+    void finish(CURLcode result)
     {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
-            return false;
+        long responseCode = -1;
+        bool succeed = false;
+        if (result == CURLE_OK)
+        {
+            CURLcode code = curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+            succeed = code == CURLE_OK && responseCode >= 200 && responseCode < 300;
+            if (code != CURLE_OK)
+                CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
         }
-        // Get some mor data.
-        
-        return true;
+        else if (errorBuffer[0] == '\0')
+        {
+            strncpy(errorBuffer, curl_easy_strerror(result), sizeof(errorBuffer) - 1);
+            errorBuffer[sizeof(errorBuffer) - 1] = '\0';
+        }
+
+        // the cookie jar is written by curl_easy_cleanup(), which the idle handles don't reach
+        if (cookies)
+            curl_easy_setopt(curl, CURLOPT_COOKIELIST, "FLUSH");
+
+        response->setResponseCode(responseCode);
+        response->setSucceed(succeed);
+        if (!succeed)
+            response->setErrorBuffer(errorBuffer);
     }
 };
 
-//Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+// Worker thread, transfers the requests with a curl multi handle
+void HttpClient::networkThread()
+{   
+	increaseThreadCount();
 
-//Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_POST, 1)
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+    CURLM* multi = curl_multi_init();
+    CURLSH* share = curl_share_init();
+    // the transfers all run on this thread, the share handle needs no lock
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
 
-//Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+    std::vector<CURL*> idleHandles;
+    std::vector<CURLTransfer*> transfers;
+    Vector<HttpRequest*> requests;
 
-//Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    auto deliver = [this](HttpResponse* response) {
+        // add response packet into queue
+        _responseQueueMutex.lock();
+        _responseQueue.pushBack(response);
+        _responseQueueMutex.unlock();
+
+		_schedulerMutex.lock();
+		if (nullptr != _scheduler)
+		{
+			_scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+		}
+		_schedulerMutex.unlock();
+    };
+
+    auto releaseTransfer = [&](CURLTransfer* transfer) {
+        curl_multi_remove_handle(multi, transfer->curl);
+        if (idleHandles.size() < MAX_IDLE_HANDLES)
+        {
+            curl_easy_reset(transfer->curl);
+            idleHandles.push_back(transfer->curl);
+        }
+        else
+        {
+            curl_easy_cleanup(transfer->curl);
+        }
+        delete transfer;
+    };
+
+    bool quit = false;
+    while (!quit)
+    {
+        int maxConcurrentRequests;
+        {
+            std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+            maxConcurrentRequests = _maxConcurrentRequests;
+            curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)_maxConnectionsPerHost);
+        }
+
+        // step 1: take the immediate requests, and the queued ones up to the limit
+        {
+            std::unique_lock<std::mutex> lock(_requestQueueMutex);
+            while (transfers.empty() && _requestQueue.empty() && _immediateRequestQueue.empty())
+            {
+                _sleepCondition.wait(lock);
+            }
+
+            // the sentinel is queued last by destroyInstance(), the pending requests are dropped
+            if (!_requestQueue.empty() && _requestQueue.back() == _requestSentinel)
+            {
+                quit = true;
+                break;
+            }
+
+            requests.pushBack(_immediateRequestQueue);
+            _immediateRequestQueue.clear();
+            int running = (int)transfers.size();
+            while (!_requestQueue.empty() && running < maxConcurrentRequests)
+            {
+                requests.pushBack(_requestQueue.at(0));
+                _requestQueue.erase(0);
+                ++running;
+            }
+        }
+
+        // step 2: start the transfers, a cancelled request gets a failed response to be released on the cocos thread
+        for (auto request : requests)
+        {
+            CURL* curl = nullptr;
+            if (!request->isCancelled())
+            {
+                if (idleHandles.empty())
+                {
+                    curl = curl_easy_init();
+                }
+                else
+                {
+                    curl = idleHandles.back();
+                    idleHandles.pop_back();
+                }
+            }
+
+            auto transfer = new (std::nothrow) CURLTransfer(request, curl);
+            if (curl && transfer->init(this, share) && curl_multi_add_handle(multi, curl) == CURLM_OK)
+            {
+                transfers.push_back(transfer);
+                continue;
+            }
+
+            transfer->response->setSucceed(false);
+            transfer->response->setErrorBuffer(request->isCancelled() ? "cancelled" : "cannot start the transfer");
+            deliver(transfer->response);
+            if (curl)
+            {
+                // never added to the multi handle, removing it is harmless
+                releaseTransfer(transfer);
+            }
+            else
+            {
+                delete transfer;
+            }
+        }
+        requests.clear();
+
+        // step 3: transfer, and deliver the finished requests
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        CURLMsg* message;
+        int messagesLeft;
+        while ((message = curl_multi_info_read(multi, &messagesLeft)))
+        {
+            if (message->msg != CURLMSG_DONE)
+                continue;
+
+            CURLTransfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&transfer);
+            transfer->finish(message->data.result);
+            deliver(transfer->response);
+            transfers.erase(std::find(transfers.begin(), transfers.end(), transfer));
+            releaseTransfer(transfer);
+        }
+
+        // step 4: abort the cancelled transfers
+        for (auto iter = transfers.begin(); iter != transfers.end();)
+        {
+            auto transfer = *iter;
+            if (!transfer->request->isCancelled())
+            {
+                ++iter;
+                continue;
+            }
+            transfer->response->setSucceed(false);
+            transfer->response->setErrorBuffer("cancelled");
+            deliver(transfer->response);
+            iter = transfers.erase(iter);
+            releaseTransfer(transfer);
+        }
+
+        // step 5: wait for the sockets, new requests are only looked for between two waits
+        if (!transfers.empty())
+        {
+            curl_multi_wait(multi, nullptr, 0, TRANSFER_WAIT_MS, nullptr);
+        }
+    }
+
+    // cleanup: the running transfers are dropped like the pending requests
+    for (auto transfer : transfers)
+    {
+        transfer->response->release();
+        releaseTransfer(transfer);
+    }
+    for (auto curl : idleHandles)
+    {
+        curl_easy_cleanup(curl);
+    }
+    curl_multi_cleanup(multi);
+    curl_share_cleanup(share);
+    
+    // cleanup: if worker thread received quit signal, clean up un-completed request queue
+    _requestQueueMutex.lock();
+    _requestQueue.clear();
+    _immediateRequestQueue.clear();
+    _requestQueueMutex.unlock();
+    
+	_responseQueueMutex.lock();
+	_responseQueue.clear();
+	_responseQueueMutex.unlock();
+
+	decreaseThreadCountAndMayDeleteThis();    
 }
 
 // HttpClient implementation
@@ -398,6 +494,8 @@ void HttpClient::setSSLVerification(const std::string& caFile)
 HttpClient::HttpClient()
 : _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(6)
+, _maxConnectionsPerHost(0)
 , _isInited(false)
 , _threadCount(0)
 , _requestSentinel(new HttpRequest())
@@ -448,7 +546,7 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
 	_requestQueueMutex.lock();
-	_requestQueue.pushBack(request);
+	insertRequest(_requestQueue, request);
 	_requestQueueMutex.unlock();
 
 	// Notify thread start to work
@@ -457,17 +555,24 @@ void HttpClient::send(HttpRequest* request)
 
 void HttpClient::sendImmediate(HttpRequest* request)
 {
+    if (false == lazyInitThreadSemphore())
+    {
+        return;
+    }
+
     if(!request)
     {
         return;
     }
 
     request->retain();
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    // started by the network thread without waiting for the queued requests
+	_requestQueueMutex.lock();
+	_immediateRequestQueue.pushBack(request);
+	_requestQueueMutex.unlock();
+
+	_sleepCondition.notify_one();
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -492,7 +597,11 @@ void HttpClient::dispatchResponseCallbacks()
         Ref* pTarget = request->getTarget();
         SEL_HttpResponse pSelector = request->getSelector();
 
-        if (callback != nullptr)
+        if (request->isCancelled())
+        {
+            // released without calling back
+        }
+        else if (callback != nullptr)
         {
             callback(this, response);
         }
@@ -507,74 +616,6 @@ void HttpClient::dispatchResponseCallbacks()
     }
 }
 
-// Process Response
-void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
-{
-	auto request = response->getHttpRequest();
-	long responseCode = -1;
-	int retValue = 0;
-
-	// Process the request -> get response packet
-	switch (request->getRequestType())
-	{
-	case HttpRequest::Type::GET: // HTTP GET
-		retValue = processGetTask(this, request,
-			writeData,
-			response->getResponseData(),
-			&responseCode,
-			writeHeaderData,
-			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	case HttpRequest::Type::POST: // HTTP POST
-		retValue = processPostTask(this, request,
-			writeData,
-			response->getResponseData(),
-			&responseCode,
-			writeHeaderData,
-			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	case HttpRequest::Type::PUT:
-		retValue = processPutTask(this, request,
-			writeData,
-			response->getResponseData(),
-			&responseCode,
-			writeHeaderData,
-			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	case HttpRequest::Type::DELETE:
-		retValue = processDeleteTask(this, request,
-			writeData,
-			response->getResponseData(),
-			&responseCode,
-			writeHeaderData,
-			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	default:
-		CCASSERT(true, "CCHttpClient: unknown request type, only GET and POSt are supported");
-		break;
-	}
-
-	// write data to HttpResponse
-	response->setResponseCode(responseCode);
-	if (retValue != 0)
-	{
-		response->setSucceed(false);
-		response->setErrorBuffer(responseMessage);
-	}
-	else
-	{
-		response->setSucceed(true);
-	}
-}
-
 void HttpClient::increaseThreadCount()
 {
 	_threadCountMutex.lock();
@@ -622,6 +663,34 @@ int HttpClient::getTimeoutForRead()
     std::lock_guard<std::mutex> lock(_timeoutForReadMutex);
     return _timeoutForRead;
 }
+
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    {
+        std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+        _maxConcurrentRequests = std::max(value, 1);
+    }
+    // more requests may start now
+    _sleepCondition.notify_one();
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+    _maxConnectionsPerHost = std::max(value, 0);
+}
+
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_connectionLimitsMutex);
+    return _maxConnectionsPerHost;
+}
     
 const std::string& HttpClient::getCookieFilename()
 {
@@ -638,5 +707,3 @@ const std::string& HttpClient::getSSLVerification()
 }
 
 NS_CC_END
-
-
@@ -143,6 +143,42 @@ public:
      * @return int the timeout value for reading.
      */
     int getTimeoutForRead();
+
+    /**
+     * Set the number of requests of send() transferred at once, 6 by default.
+     * The requests of sendImmediate() don't count. Only the libcurl client of the desktop platforms
+     * transfers several requests at once, the other clients send one request after the other.
+     *
+     * @param value the number of concurrent requests, at least 1.
+     * @since v3.9
+     */
+    void setMaxConcurrentRequests(int value);
+
+    /**
+     * Get the number of requests of send() transferred at once.
+     *
+     * @return int the number of concurrent requests.
+     * @since v3.9
+     */
+    int getMaxConcurrentRequests();
+
+    /**
+     * Set the number of connections opened to a same host, 0 by default for no limit.
+     * The libcurl client keeps the connections alive and reuses them, with their TLS sessions, for the next
+     * requests to the host. Ignored by the other clients.
+     *
+     * @param value the number of connections per host, 0 for no limit.
+     * @since v3.9
+     */
+    void setMaxConnectionsPerHost(int value);
+
+    /**
+     * Get the number of connections opened to a same host.
+     *
+     * @return int the number of connections per host, 0 for no limit.
+     * @since v3.9
+     */
+    int getMaxConnectionsPerHost();
     
     HttpCookie* getCookie() const {return _cookie; }
     
@@ -167,6 +203,15 @@ private:
     void processResponse(HttpResponse* response, char* responseMessage);
     void increaseThreadCount();
     void decreaseThreadCountAndMayDeleteThis();
+
+    // the pending requests are kept by decreasing priority, in the order they were sent
+    static void insertRequest(Vector<HttpRequest*>& queue, HttpRequest* request)
+    {
+        ssize_t index = queue.size();
+        while (index > 0 && queue.at(index - 1)->getPriority() < request->getPriority())
+            --index;
+        queue.insert(index, request);
+    }
     
 private:
     bool _isInited;
@@ -176,6 +221,10 @@ private:
     
     int _timeoutForRead;
     std::mutex _timeoutForReadMutex;
+
+    int _maxConcurrentRequests;
+    int _maxConnectionsPerHost;
+    std::mutex _connectionLimitsMutex;
     
     int  _threadCount;
     std::mutex _threadCountMutex;
@@ -184,6 +233,8 @@ private:
     std::mutex _schedulerMutex;
     
     Vector<HttpRequest*>  _requestQueue;
+    // requests of sendImmediate() for the libcurl client, guarded by _requestQueueMutex as well
+    Vector<HttpRequest*>  _immediateRequestQueue;
     std::mutex _requestQueueMutex;
     
     Vector<HttpResponse*> _responseQueue;
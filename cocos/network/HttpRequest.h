@@ -26,6 +26,7 @@
 #ifndef __HTTP_REQUEST_H__
 #define __HTTP_REQUEST_H__
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include "base/CCRef.h"
@@ -93,6 +94,8 @@ public:
         _pSelector = nullptr;
         _pCallback = nullptr;
         _pUserData = nullptr;
+        _priority = 0;
+        _cancelled = false;
     };
     
     /** Destructor. */
@@ -341,6 +344,50 @@ public:
    	{
    		return _headers;
    	}
+
+    /**
+     * Set the priority of the request, 0 by default.
+     * HttpClient::send() queues the requests by decreasing priority, the requests of the same priority are sent in order.
+     *
+     * @param priority the priority of the request.
+     * @since v3.9
+     */
+    inline void setPriority(int priority)
+    {
+        _priority = priority;
+    }
+
+    /**
+     * Get the priority of the request.
+     *
+     * @return int the priority of the request.
+     * @since v3.9
+     */
+    inline int getPriority() const
+    {
+        return _priority;
+    }
+
+    /**
+     * Cancel the request, from any thread. A pending request isn't sent, a running transfer is aborted
+     * when the client supports it, and the callback isn't called.
+     * @since v3.9
+     */
+    inline void cancel()
+    {
+        _cancelled = true;
+    }
+
+    /**
+     * Check whether cancel() was called.
+     *
+     * @return bool true if the request is cancelled.
+     * @since v3.9
+     */
+    inline bool isCancelled() const
+    {
+        return _cancelled;
+    }
     
 protected:
     // properties
@@ -353,6 +400,8 @@ protected:
     ccHttpRequestCallback       _pCallback;      /// C++11 style callbacks
     void*                       _pUserData;      /// You can add your customed data here 
     std::vector<std::string>    _headers;		      /// custom http headers
+    int                         _priority;       /// the pending requests of a higher priority are sent first
+    std::atomic<bool>           _cancelled;      /// set by cancel(), read by the network thread
 };
 
 }
@@ -31,6 +31,9 @@
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 
+#include <atomic>
+#include <algorithm>
+#include <condition_variable>
 #include <thread>
 #include <mutex>
 #include <queue>
@@ -46,53 +49,252 @@ NS_CC_BEGIN
 
 namespace network {
 
+// the pooled frame buffers hold from 2^WS_POOL_MIN_SHIFT to 2^WS_POOL_MAX_SHIFT bytes, bigger ones are freed
+#define WS_POOL_MIN_SHIFT 10
+#define WS_POOL_MAX_SHIFT 16
+#define WS_POOL_BUFFERS_PER_SIZE 32
+
+// the service thread waits from 1ms after some traffic, up to 50ms when the sockets stay idle
+#define WS_SERVICE_MIN_INTERVAL 1
+#define WS_SERVICE_MAX_INTERVAL 50
+
+/**
+ * A frame to send or received, with the padding libwebsocket_write() needs before and after the data.
+ * The buffers are taken from a pool, and go back to it when their last reference is released.
+ */
+class WsFrameBuffer
+{
+public:
+    // Gets a buffer of capacity bytes at least, of size 0.
+    static WsFrameBuffer* create(size_t capacity);
+    // Appends bytes, to a bigger buffer if they don't fit in this one, which is then released.
+    static WsFrameBuffer* append(WsFrameBuffer* buffer, const void* bytes, size_t len);
+
+    void retain() { ++_referenceCount; }
+    void release()
+    {
+        if (--_referenceCount == 0)
+            recycle(this);
+    }
+
+    char* getData() { return _data + LWS_SEND_BUFFER_PRE_PADDING; }
+    size_t getSize() const { return _size; }
+    size_t getCapacity() const { return _capacity; }
+
+private:
+    static void recycle(WsFrameBuffer* buffer);
+
+    std::atomic<int> _referenceCount;
+    size_t _size;
+    size_t _capacity;
+    int _sizeClass;
+    char* _data;
+};
+
+static std::mutex s_framePoolMutex;
+static std::vector<WsFrameBuffer*> s_framePool[WS_POOL_MAX_SHIFT - WS_POOL_MIN_SHIFT + 1];
+
+WsFrameBuffer* WsFrameBuffer::create(size_t capacity)
+{
+    int sizeClass = -1;
+    for (int shift = WS_POOL_MIN_SHIFT; shift <= WS_POOL_MAX_SHIFT; ++shift)
+    {
+        if (capacity <= ((size_t)1 << shift))
+        {
+            sizeClass = shift - WS_POOL_MIN_SHIFT;
+            capacity = (size_t)1 << shift;
+            break;
+        }
+    }
+
+    WsFrameBuffer* buffer = nullptr;
+    if (sizeClass >= 0)
+    {
+        std::lock_guard<std::mutex> lock(s_framePoolMutex);
+        auto& pool = s_framePool[sizeClass];
+        if (!pool.empty())
+        {
+            buffer = pool.back();
+            pool.pop_back();
+        }
+    }
+
+    if (!buffer)
+    {
+        // one more byte for the '\0' ending the text frames
+        char* memory = (char*)malloc(sizeof(WsFrameBuffer) + LWS_SEND_BUFFER_PRE_PADDING + capacity + LWS_SEND_BUFFER_POST_PADDING + 1);
+        buffer = new (memory) WsFrameBuffer();
+        buffer->_capacity = capacity;
+        buffer->_sizeClass = sizeClass;
+        buffer->_data = memory + sizeof(WsFrameBuffer);
+    }
+
+    buffer->_referenceCount = 1;
+    buffer->_size = 0;
+    return buffer;
+}
+
+WsFrameBuffer* WsFrameBuffer::append(WsFrameBuffer* buffer, const void* bytes, size_t len)
+{
+    if (!buffer)
+    {
+        buffer = create(len);
+    }
+    else if (buffer->_size + len > buffer->_capacity)
+    {
+        WsFrameBuffer* bigger = create(std::max(buffer->_size + len, buffer->_capacity * 2));
+        memcpy(bigger->getData(), buffer->getData(), buffer->_size);
+        bigger->_size = buffer->_size;
+        buffer->release();
+        buffer = bigger;
+    }
+
+    memcpy(buffer->getData() + buffer->_size, bytes, len);
+    buffer->_size += len;
+    return buffer;
+}
+
+void WsFrameBuffer::recycle(WsFrameBuffer* buffer)
+{
+    if (buffer->_sizeClass >= 0)
+    {
+        std::lock_guard<std::mutex> lock(s_framePoolMutex);
+        auto& pool = s_framePool[buffer->_sizeClass];
+        if (pool.size() < WS_POOL_BUFFERS_PER_SIZE)
+        {
+            pool.push_back(buffer);
+            return;
+        }
+    }
+
+    buffer->~WsFrameBuffer();
+    free(buffer);
+}
+
 class WsMessage
 {
 public:
-    WsMessage() : what(0), obj(nullptr){}
+    WsMessage(unsigned int what = 0, WsFrameBuffer* buffer = nullptr, bool isBinary = false)
+    : what(what), buffer(buffer), issued(0), isBinary(isBinary) {}
     unsigned int what; // message type
-    void* obj;
+    WsFrameBuffer* buffer;
+    size_t issued; // bytes of the buffer already sent
+    bool isBinary;
 };
 
 /**
- *  @brief Websocket thread helper, it's used for sending message between UI thread and websocket thread.
+ * An unbounded queue, for one thread pushing the messages and one other thread popping them, without lock.
+ * The nodes of the popped messages are reused by the pushing thread.
  */
-class WsThreadHelper : public Ref
+class WsMessageQueue
 {
 public:
-    WsThreadHelper();
-    ~WsThreadHelper();
-        
-    // Creates a new thread
-    bool createThread(const WebSocket& ws);
-    // Quits sub-thread (websocket thread).
-    void quitSubThread();
-    
-    // Schedule callback function
+    WsMessageQueue()
+    {
+        Node* node = new Node();
+        _head = node;
+        _tail = node;
+        _first = node;
+        _headCopy = node;
+    }
+
+    ~WsMessageQueue()
+    {
+        Node* node = _first;
+        while (node)
+        {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    // Producer thread only.
+    void push(const WsMessage& msg)
+    {
+        Node* node = allocNode();
+        node->msg = msg;
+        node->next.store(nullptr, std::memory_order_relaxed);
+        _tail->next.store(node, std::memory_order_release);
+        _tail = node;
+    }
+
+    // Consumer thread only, the next message, nullptr if none. It stays valid until pop().
+    WsMessage* front()
+    {
+        Node* next = _head.load(std::memory_order_relaxed)->next.load(std::memory_order_acquire);
+        return next ? &next->msg : nullptr;
+    }
+
+    // Consumer thread only, front() must not be nullptr.
+    void pop()
+    {
+        Node* head = _head.load(std::memory_order_relaxed);
+        _head.store(head->next.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+private:
+    struct Node
+    {
+        Node() : next(nullptr) {}
+        std::atomic<Node*> next;
+        WsMessage msg;
+    };
+
+    Node* allocNode()
+    {
+        // the nodes before the head are consumed, from the first one
+        if (_first == _headCopy)
+            _headCopy = _head.load(std::memory_order_acquire);
+        if (_first != _headCopy)
+        {
+            Node* node = _first;
+            _first = _first->next.load(std::memory_order_relaxed);
+            return node;
+        }
+        return new Node();
+    }
+
+    // the node before the next message, written by the consumer
+    std::atomic<Node*> _head;
+    // written by the producer
+    Node* _tail;
+    Node* _first;
+    Node* _headCopy;
+};
+
+/**
+ *  @brief Services all the websockets on one thread, and delivers their messages on the UI thread.
+ */
+class WsService : public Ref
+{
+public:
+    static WsService* getInstance();
+
+    // Starts servicing a websocket. UI thread.
+    void add(WebSocket* ws);
+    // Waits for the service thread to leave a closing websocket, no message of it is delivered then. UI thread.
+    void remove(WebSocket* ws);
+    // Services the websockets now, when a message is sent.
+    void wakeUp();
+
+    // Schedule callback function, delivers the messages
     virtual void update(float dt);
-    
-    // Sends message to UI thread. It's needed to be invoked in sub-thread.
-    void sendMessageToUIThread(WsMessage *msg);
-    
-    // Sends message to sub-thread(websocket thread). It's needs to be invoked in UI thread.
-    void sendMessageToSubThread(WsMessage *msg);
-    
-    // Waits the sub-thread (websocket thread) to exit,
-    void joinSubThread();
-    
-    
+
 protected:
-    void wsThreadEntryFunc();
-    
+    WsService();
+    void serviceThreadEntryFunc();
+
 private:
-    std::list<WsMessage*>* _UIWsMessageQueue;
-    std::list<WsMessage*>* _subThreadWsMessageQueue;
-    std::mutex   _UIWsMessageQueueMutex;
-    std::mutex   _subThreadWsMessageQueueMutex;
-    std::thread* _subThreadInstance;
-    WebSocket* _ws;
-    bool _needQuit;
-    friend class WebSocket;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<WebSocket*> _sockets;
+    // closed by the UI thread, whatever the service thread found meanwhile
+    std::vector<WebSocket*> _removing;
+    bool _wakeUp;
+
+    // UI thread only
+    std::vector<WebSocket*> _uiSockets;
 };
 
 // Wrapper for converting websocket callback from static function to member function of WebSocket class.
@@ -114,108 +316,128 @@ public:
     }
 };
 
-// Implementation of WsThreadHelper
-WsThreadHelper::WsThreadHelper()
-: _subThreadInstance(nullptr)
-, _ws(nullptr)
-, _needQuit(false)
+// Implementation of WsService
+WsService* WsService::getInstance()
 {
-    _UIWsMessageQueue = new std::list<WsMessage*>();
-    _subThreadWsMessageQueue = new std::list<WsMessage*>();
-    
-    Director::getInstance()->getScheduler()->scheduleUpdate(this, 0, false);
+    // never deleted, its thread may service websockets until the end
+    static WsService* s_service = nullptr;
+    if (!s_service)
+    {
+        s_service = new (std::nothrow) WsService();
+        std::thread(&WsService::serviceThreadEntryFunc, s_service).detach();
+    }
+    return s_service;
 }
 
-WsThreadHelper::~WsThreadHelper()
+WsService::WsService()
+: _wakeUp(false)
 {
-    Director::getInstance()->getScheduler()->unscheduleAllForTarget(this);
-    joinSubThread();
-    CC_SAFE_DELETE(_subThreadInstance);
-    delete _UIWsMessageQueue;
-    delete _subThreadWsMessageQueue;
 }
 
-bool WsThreadHelper::createThread(const WebSocket& ws)
+void WsService::add(WebSocket* ws)
 {
-    _ws = const_cast<WebSocket*>(&ws);
-    
-    // Creates websocket thread
-    _subThreadInstance = new std::thread(&WsThreadHelper::wsThreadEntryFunc, this);
-    return true;
-}
+    // scheduled again, in case the scheduler was reset since the previous websocket
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, 0, false);
+    _uiSockets.push_back(ws);
 
-void WsThreadHelper::quitSubThread()
-{
-    _needQuit = true;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sockets.push_back(ws);
+    _wakeUp = true;
+    _condition.notify_all();
 }
 
-void WsThreadHelper::wsThreadEntryFunc()
+void WsService::remove(WebSocket* ws)
 {
-    _ws->onSubThreadStarted();
-    
-    while (!_needQuit)
-    {
-        if (_ws->onSubThreadLoop())
-        {
-            break;
-        }
-    }
-    
+    _uiSockets.erase(std::remove(_uiSockets.begin(), _uiSockets.end(), ws), _uiSockets.end());
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _removing.push_back(ws);
+    _wakeUp = true;
+    _condition.notify_all();
+    _condition.wait(lock, [this, ws] { return std::find(_sockets.begin(), _sockets.end(), ws) == _sockets.end(); });
+    _removing.erase(std::find(_removing.begin(), _removing.end(), ws));
 }
 
-void WsThreadHelper::sendMessageToUIThread(WsMessage *msg)
+void WsService::wakeUp()
 {
-    std::lock_guard<std::mutex> lk(_UIWsMessageQueueMutex);
-    _UIWsMessageQueue->push_back(msg);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _wakeUp = true;
+    _condition.notify_all();
 }
 
-void WsThreadHelper::sendMessageToSubThread(WsMessage *msg)
+void WsService::serviceThreadEntryFunc()
 {
-    std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
-    _subThreadWsMessageQueue->push_back(msg);
-}
+    std::vector<WebSocket*> sockets;
+    std::vector<WebSocket*> removing;
+    std::vector<WebSocket*> ended;
+    int interval = WS_SERVICE_MIN_INTERVAL;
 
-void WsThreadHelper::joinSubThread()
-{
-    if (_subThreadInstance->joinable())
+    while (true)
     {
-        _subThreadInstance->join();
-    }
-}
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            for (auto ws : ended)
+            {
+                _sockets.erase(std::find(_sockets.begin(), _sockets.end(), ws));
+            }
+            if (!ended.empty())
+            {
+                // remove() may be waiting for them
+                _condition.notify_all();
+                ended.clear();
+            }
 
-void WsThreadHelper::update(float dt)
-{
-    /* Avoid locking if, in most cases, the queue is empty. This could be a little faster.
-    size() is not thread-safe, it might return a strange value, but it should be OK in our scenario.
-    */
-    if (0 == _UIWsMessageQueue->size()) 
-        return;	
+            if (_sockets.empty())
+            {
+                _condition.wait(lock, [this] { return !_sockets.empty(); });
+            }
+            else if (!_wakeUp)
+            {
+                _condition.wait_for(lock, std::chrono::milliseconds(interval), [this] { return _wakeUp; });
+            }
+            _wakeUp = false;
 
-    // Returns quickly if no message
-    _UIWsMessageQueueMutex.lock();
+            // the websockets stay alive until they are out of _sockets
+            sockets = _sockets;
+            removing = _removing;
+        }
 
-    if (0 == _UIWsMessageQueue->size())
-    {
-        _UIWsMessageQueueMutex.unlock();
-        return;
-    }
-    
-    // Gets message
-    // Process all messages in the queue, in case it's piling up faster than being processed
-    std::list<WsMessage*> messages;
-    while (!_UIWsMessageQueue->empty()) {
-        messages.push_back(_UIWsMessageQueue->front());
-        _UIWsMessageQueue->pop_front();
+        bool hadTraffic = false;
+        for (auto ws : sockets)
+        {
+            if (std::find(removing.begin(), removing.end(), ws) != removing.end() || ws->onSubThreadLoop())
+            {
+                ws->onSubThreadEnded();
+                ended.push_back(ws);
+            }
+            hadTraffic = hadTraffic || ws->_hadTraffic;
+            ws->_hadTraffic = false;
+        }
+
+        interval = hadTraffic ? WS_SERVICE_MIN_INTERVAL : std::min(interval * 2, WS_SERVICE_MAX_INTERVAL);
     }
+}
 
-    _UIWsMessageQueueMutex.unlock();
-    
-    for (auto msg : messages) {
-        if (_ws)
+void WsService::update(float dt)
+{
+    // the delegates may close or delete any websocket
+    std::vector<WebSocket*> sockets = _uiSockets;
+    for (auto ws : sockets)
+    {
+        while (std::find(_uiSockets.begin(), _uiSockets.end(), ws) != _uiSockets.end())
         {
-            _ws->onUIThreadReceiveMessage(msg);
+            WsMessage* front = ws->_receiveQueue->front();
+            if (!front)
+                break;
+
+            WsMessage msg = *front;
+            ws->_receiveQueue->pop();
+            ws->onUIThreadReceiveMessage(msg);
+            if (msg.buffer)
+            {
+                msg.buffer->release();
+            }
         }
-        CC_SAFE_DELETE(msg);
     }
 }
 
@@ -232,9 +454,10 @@ WebSocket::WebSocket()
 : _readyState(State::CONNECTING)
 , _port(80)
 , _pendingFrameDataLen(0)
-, _currentDataLen(0)
-, _currentData(nullptr)
-, _wsHelper(nullptr)
+, _currentFrame(nullptr)
+, _sendQueue(new WsMessageQueue())
+, _receiveQueue(new WsMessageQueue())
+, _hadTraffic(false)
 , _wsInstance(nullptr)
 , _wsContext(nullptr)
 , _delegate(nullptr)
@@ -246,7 +469,24 @@ WebSocket::WebSocket()
 WebSocket::~WebSocket()
 {
     close();
-    CC_SAFE_RELEASE_NULL(_wsHelper);
+
+    // the service thread left this websocket, the queues can be drained from here
+    for (auto queue : { _sendQueue, _receiveQueue })
+    {
+        while (WsMessage* msg = queue->front())
+        {
+            if (msg->buffer)
+            {
+                msg->buffer->release();
+            }
+            queue->pop();
+        }
+        delete queue;
+    }
+    if (_currentFrame)
+    {
+        _currentFrame->release();
+    }
     
     for (int i = 0; _wsProtocols[i].callback != nullptr; ++i)
     {
@@ -330,9 +570,9 @@ bool WebSocket::init(const Delegate& delegate,
         _wsProtocols[0].callback = WebSocketCallbackWrapper::onSocketCallback;
     }
     
-    // WebSocket thread needs to be invoked at the end of this method.
-    _wsHelper = new (std::nothrow) WsThreadHelper();
-    ret = _wsHelper->createThread(*this);
+    // The websocket needs to be serviced at the end of this method.
+    WsService::getInstance()->add(this);
+    ret = true;
     
     return ret;
 }
@@ -342,14 +582,9 @@ void WebSocket::send(const std::string& message)
     if (_readyState == State::OPEN)
     {
         // In main thread
-        WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_STRING;
-        Data* data = new (std::nothrow) Data();
-        data->bytes = new char[message.length()+1];
-        strcpy(data->bytes, message.c_str());
-        data->len = static_cast<ssize_t>(message.length());
-        msg->obj = data;
-        _wsHelper->sendMessageToSubThread(msg);
+        WsFrameBuffer* buffer = WsFrameBuffer::append(nullptr, message.data(), message.length());
+        _sendQueue->push(WsMessage(WS_MSG_TO_SUBTRHEAD_SENDING_STRING, buffer));
+        WsService::getInstance()->wakeUp();
     }
 }
 
@@ -360,29 +595,24 @@ void WebSocket::send(const unsigned char* binaryMsg, unsigned int len)
     if (_readyState == State::OPEN)
     {
         // In main thread
-        WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_BINARY;
-        Data* data = new (std::nothrow) Data();
-        data->bytes = new char[len];
-        memcpy((void*)data->bytes, (void*)binaryMsg, len);
-        data->len = len;
-        msg->obj = data;
-        _wsHelper->sendMessageToSubThread(msg);
+        WsFrameBuffer* buffer = WsFrameBuffer::append(nullptr, binaryMsg, len);
+        _sendQueue->push(WsMessage(WS_MSG_TO_SUBTRHEAD_SENDING_BINARY, buffer, true));
+        WsService::getInstance()->wakeUp();
     }
 }
 
 void WebSocket::close()
 {
-    Director::getInstance()->getScheduler()->unscheduleAllForTarget(_wsHelper);
-    
     if (_readyState == State::CLOSING || _readyState == State::CLOSED)
     {
+        // no message is delivered after close()
+        WsService::getInstance()->remove(this);
         return;
     }
     
     _readyState = State::CLOSED;
 
-    _wsHelper->joinSubThread();
+    WsService::getInstance()->remove(this);
     
     // onClose callback needs to be invoked at the end of this method
     // since websocket instance may be deleted in 'onClose'.
@@ -396,22 +626,28 @@ WebSocket::State WebSocket::getReadyState()
 
 int WebSocket::onSubThreadLoop()
 {
+    if (!_wsContext && _readyState == State::CONNECTING)
+    {
+        onSubThreadStarted();
+    }
+
     if (_readyState == State::CLOSED || _readyState == State::CLOSING)
     {
-        libwebsocket_context_destroy(_wsContext);
-        // return 1 to exit the loop.
+        // return 1 to stop servicing this websocket.
         return 1;
     }
     
-    if (_wsContext && _readyState != State::CLOSED && _readyState != State::CLOSING)
+    if (_wsContext)
     {
+        // the writable callback sends the queued messages
+        if (_readyState == State::OPEN && _sendQueue->front())
+        {
+            libwebsocket_callback_on_writable(_wsContext, _wsInstance);
+        }
         libwebsocket_service(_wsContext, 0);
     }
-    
-    // Sleep 50 ms
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
-    // return 0 to continue the loop.
+    // return 0 to continue servicing this websocket.
     return 0;
 }
 
@@ -454,20 +690,25 @@ void WebSocket::onSubThreadStarted()
                                              name.c_str(), -1);
                                              
         if(nullptr == _wsInstance) {
-            WsMessage* msg = new (std::nothrow) WsMessage();
-            msg->what = WS_MSG_TO_UITHREAD_ERROR;
             _readyState = State::CLOSING;
-            _wsHelper->sendMessageToUIThread(msg);
+            _receiveQueue->push(WsMessage(WS_MSG_TO_UITHREAD_ERROR));
         }
-
 	}
+    else
+    {
+        _readyState = State::CLOSING;
+        _receiveQueue->push(WsMessage(WS_MSG_TO_UITHREAD_ERROR));
+    }
 }
 
 void WebSocket::onSubThreadEnded()
 {
-
+    if (_wsContext)
+    {
+        libwebsocket_context_destroy(_wsContext);
+        _wsContext = nullptr;
+    }
 }
-
 int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
                      struct libwebsocket *wsi,
                      int reason,
@@ -483,124 +724,96 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
         case LWS_CALLBACK_PROTOCOL_DESTROY:
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
             {
-                WsMessage* msg = nullptr;
                 if (reason == LWS_CALLBACK_CLIENT_CONNECTION_ERROR
                     || (reason == LWS_CALLBACK_PROTOCOL_DESTROY && _readyState == State::CONNECTING)
                     || (reason == LWS_CALLBACK_DEL_POLL_FD && _readyState == State::CONNECTING)
                     )
                 {
-                    msg = new (std::nothrow) WsMessage();
-                    msg->what = WS_MSG_TO_UITHREAD_ERROR;
                     _readyState = State::CLOSING;
+                    _receiveQueue->push(WsMessage(WS_MSG_TO_UITHREAD_ERROR));
                 }
                 else if (reason == LWS_CALLBACK_PROTOCOL_DESTROY && _readyState == State::CLOSING)
                 {
-                    msg = new (std::nothrow) WsMessage();
-                    msg->what = WS_MSG_TO_UITHREAD_CLOSE;
-                }
-
-                if (msg)
-                {
-                    _wsHelper->sendMessageToUIThread(msg);
+                    _receiveQueue->push(WsMessage(WS_MSG_TO_UITHREAD_CLOSE));
                 }
             }
             break;
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
             {
-                WsMessage* msg = new (std::nothrow) WsMessage();
-                msg->what = WS_MSG_TO_UITHREAD_OPEN;
                 _readyState = State::OPEN;
-                
-                /*
-                 * start the ball rolling,
-                 * LWS_CALLBACK_CLIENT_WRITEABLE will come next service
-                 */
-                libwebsocket_callback_on_writable(ctx, wsi);
-                _wsHelper->sendMessageToUIThread(msg);
+                _hadTraffic = true;
+                _receiveQueue->push(WsMessage(WS_MSG_TO_UITHREAD_OPEN));
             }
             break;
             
         case LWS_CALLBACK_CLIENT_WRITEABLE:
             {
-
-                std::lock_guard<std::mutex> lk(_wsHelper->_subThreadWsMessageQueueMutex);
-                                               
-                std::list<WsMessage*>::iterator iter = _wsHelper->_subThreadWsMessageQueue->begin();
-                
-                int bytesWrite = 0;
-                for (; iter != _wsHelper->_subThreadWsMessageQueue->end();)
+                // the frames are written from their buffers, without copy
+                WsMessage* subThreadMsg;
+                while ((subThreadMsg = _sendQueue->front()) != nullptr)
                 {
-                    WsMessage* subThreadMsg = *iter;
-                    
-                    if ( WS_MSG_TO_SUBTRHEAD_SENDING_STRING == subThreadMsg->what
-                      || WS_MSG_TO_SUBTRHEAD_SENDING_BINARY == subThreadMsg->what)
-                    {
-                        Data* data = (Data*)subThreadMsg->obj;
-
-                        const size_t c_bufferSize = WS_WRITE_BUFFER_SIZE;
-
-                        size_t remaining = data->len - data->issued;
-                        size_t n = std::min(remaining, c_bufferSize );
-                        //fixme: the log is not thread safe
-//                        CCLOG("[websocket:send] total: %d, sent: %d, remaining: %d, buffer size: %d", static_cast<int>(data->len), static_cast<int>(data->issued), static_cast<int>(remaining), static_cast<int>(n));
-
-                        unsigned char* buf = new unsigned char[LWS_SEND_BUFFER_PRE_PADDING + n + LWS_SEND_BUFFER_POST_PADDING];
-
-                        memcpy((char*)&buf[LWS_SEND_BUFFER_PRE_PADDING], data->bytes + data->issued, n);
-                        
-                        int writeProtocol;
-                        
-                        if (data->issued == 0) {
-							if (WS_MSG_TO_SUBTRHEAD_SENDING_STRING == subThreadMsg->what)
-							{
-								writeProtocol = LWS_WRITE_TEXT;
-							}
-							else
-							{
-								writeProtocol = LWS_WRITE_BINARY;
-							}
-
-							// If we have more than 1 fragment
-							if (data->len > c_bufferSize)
-								writeProtocol |= LWS_WRITE_NO_FIN;
-                        } else {
-                        	// we are in the middle of fragments
-                        	writeProtocol = LWS_WRITE_CONTINUATION;
-                        	// and if not in the last fragment
-                        	if (remaining != n)
-                        		writeProtocol |= LWS_WRITE_NO_FIN;
-                        }
+                    WsFrameBuffer* buffer = subThreadMsg->buffer;
+                    const size_t c_bufferSize = WS_WRITE_BUFFER_SIZE;
 
-                        bytesWrite = libwebsocket_write(wsi,  &buf[LWS_SEND_BUFFER_PRE_PADDING], n, (libwebsocket_write_protocol)writeProtocol);
-                        //fixme: the log is not thread safe
-//                        CCLOG("[websocket:send] bytesWrite => %d", bytesWrite);
+                    size_t remaining = buffer->getSize() - subThreadMsg->issued;
+                    size_t n = std::min(remaining, c_bufferSize);
+                    unsigned char* fragment = (unsigned char*)buffer->getData() + subThreadMsg->issued;
 
-                        // Buffer overrun?
-                        if (bytesWrite < 0)
-                        {
-                            break;
-                        }
-                        // Do we have another fragments to send?
-                        else if (remaining != n)
+                    int writeProtocol;
+                    
+                    if (subThreadMsg->issued == 0) {
+                        if (WS_MSG_TO_SUBTRHEAD_SENDING_STRING == subThreadMsg->what)
                         {
-                            data->issued += n;
-                            break;
+                            writeProtocol = LWS_WRITE_TEXT;
                         }
-                        // Safely done!
                         else
                         {
-                            CC_SAFE_DELETE_ARRAY(data->bytes);
-                            CC_SAFE_DELETE(data);
-                            CC_SAFE_DELETE_ARRAY(buf);
-                            _wsHelper->_subThreadWsMessageQueue->erase(iter++);
-                            CC_SAFE_DELETE(subThreadMsg);
+                            writeProtocol = LWS_WRITE_BINARY;
                         }
+
+                        // If we have more than 1 fragment
+                        if (buffer->getSize() > c_bufferSize)
+                            writeProtocol |= LWS_WRITE_NO_FIN;
+                    } else {
+                        // we are in the middle of fragments
+                        writeProtocol = LWS_WRITE_CONTINUATION;
+                        // and if not in the last fragment
+                        if (remaining != n)
+                            writeProtocol |= LWS_WRITE_NO_FIN;
+                    }
+
+                    // the header of a fragment is written over the fragments already sent, but its post padding
+                    // is the start of the next fragment
+                    unsigned char postPadding[LWS_SEND_BUFFER_POST_PADDING];
+                    memcpy(postPadding, fragment + n, LWS_SEND_BUFFER_POST_PADDING);
+                    int bytesWrite = libwebsocket_write(wsi, fragment, n, (libwebsocket_write_protocol)writeProtocol);
+                    memcpy(fragment + n, postPadding, LWS_SEND_BUFFER_POST_PADDING);
+                    _hadTraffic = true;
+
+                    // Buffer overrun?
+                    if (bytesWrite < 0)
+                    {
+                        break;
+                    }
+                    // Do we have another fragments to send?
+                    else if (remaining != n)
+                    {
+                        subThreadMsg->issued += n;
+                        break;
+                    }
+                    // Safely done!
+                    else
+                    {
+                        buffer->release();
+                        _sendQueue->pop();
                     }
                 }
                 
                 /* get notified as soon as we can write again */
-                
-                libwebsocket_callback_on_writable(ctx, wsi);
+                if (_sendQueue->front())
+                {
+                    libwebsocket_callback_on_writable(ctx, wsi);
+                }
             }
             break;
             
@@ -609,14 +822,11 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
                 //fixme: the log is not thread safe
 //                CCLOG("%s", "connection closing..");
 
-                _wsHelper->quitSubThread();
-                
+                // the service stops with the CLOSED state
                 if (_readyState != State::CLOSED)
                 {
-                    WsMessage* msg = new (std::nothrow) WsMessage();
                     _readyState = State::CLOSED;
-                    msg->what = WS_MSG_TO_UITHREAD_CLOSE;
-                    _wsHelper->sendMessageToUIThread(msg);
+                    _receiveQueue->push(WsMessage(WS_MSG_TO_UITHREAD_CLOSE));
                 }
             }
             break;
@@ -625,63 +835,28 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
             {
                 if (in && len > 0)
                 {
-                    // Accumulate the data (increasing the buffer as we go)
-                    if (_currentDataLen == 0)
-                    {
-                        _currentData = new char[len];
-                        memcpy (_currentData, in, len);
-                        _currentDataLen = len;
-                    }
-                    else
-                    {
-                        char *new_data = new char [_currentDataLen + len];
-                        memcpy (new_data, _currentData, _currentDataLen);
-                        memcpy (new_data + _currentDataLen, in, len);
-                        CC_SAFE_DELETE_ARRAY(_currentData);
-                        _currentData = new_data;
-                        _currentDataLen = _currentDataLen + len;
-                    }
-
                     _pendingFrameDataLen = libwebsockets_remaining_packet_payload (wsi);
+                    _hadTraffic = true;
 
-                    if (_pendingFrameDataLen > 0)
+                    // Accumulate the data, in a buffer big enough for the whole frame
+                    if (_currentFrame == nullptr)
                     {
-                        //CCLOG("%ld bytes of pending data to receive, consider increasing the libwebsocket rx_buffer_size value.", _pendingFrameDataLen);
+                        _currentFrame = WsFrameBuffer::create(len + _pendingFrameDataLen);
                     }
-                    
+                    _currentFrame = WsFrameBuffer::append(_currentFrame, in, len);
+
                     // If no more data pending, send it to the client thread
                     if (_pendingFrameDataLen == 0)
                     {
-						WsMessage* msg = new (std::nothrow) WsMessage();
-						msg->what = WS_MSG_TO_UITHREAD_MESSAGE;
-
-						char* bytes = nullptr;
-						Data* data = new (std::nothrow) Data();
-
-						if (lws_frame_is_binary(wsi))
-						{
-
-							bytes = new char[_currentDataLen];
-							data->isBinary = true;
-						}
-						else
-						{
-							bytes = new char[_currentDataLen+1];
-							bytes[_currentDataLen] = '\0';
-							data->isBinary = false;
-						}
-
-						memcpy(bytes, _currentData, _currentDataLen);
-
-						data->bytes = bytes;
-						data->len = _currentDataLen;
-						msg->obj = (void*)data;
-
-						CC_SAFE_DELETE_ARRAY(_currentData);
-						_currentData = nullptr;
-						_currentDataLen = 0;
+                        bool isBinary = lws_frame_is_binary(wsi) != 0;
+                        if (!isBinary)
+                        {
+                            // there is room for it after the capacity
+                            _currentFrame->getData()[_currentFrame->getSize()] = '\0';
+                        }
 
-						_wsHelper->sendMessageToUIThread(msg);
+                        _receiveQueue->push(WsMessage(WS_MSG_TO_UITHREAD_MESSAGE, _currentFrame, isBinary));
+                        _currentFrame = nullptr;
                     }
                 }
             }
@@ -694,9 +869,9 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
 	return 0;
 }
 
-void WebSocket::onUIThreadReceiveMessage(WsMessage* msg)
+void WebSocket::onUIThreadReceiveMessage(const WsMessage& msg)
 {
-    switch (msg->what) {
+    switch (msg.what) {
         case WS_MSG_TO_UITHREAD_OPEN:
             {
                 _delegate->onOpen(this);
@@ -704,16 +879,18 @@ void WebSocket::onUIThreadReceiveMessage(WsMessage* msg)
             break;
         case WS_MSG_TO_UITHREAD_MESSAGE:
             {
-                Data* data = (Data*)msg->obj;
-                _delegate->onMessage(this, *data);
-                CC_SAFE_DELETE_ARRAY(data->bytes);
-                CC_SAFE_DELETE(data);
+                // the buffer is released by the service once the delegate returns
+                Data data;
+                data.bytes = msg.buffer->getData();
+                data.len = static_cast<ssize_t>(msg.buffer->getSize());
+                data.isBinary = msg.isBinary;
+                _delegate->onMessage(this, data);
             }
             break;
         case WS_MSG_TO_UITHREAD_CLOSE:
             {
-                //Waiting for the subThread safety exit
-                _wsHelper->joinSubThread();
+                //Waiting for the service thread to leave this websocket
+                WsService::getInstance()->remove(this);
                 _delegate->onClose(this);
             }
             break;
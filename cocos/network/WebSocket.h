@@ -49,11 +49,15 @@ NS_CC_BEGIN
 
 namespace network {
 
-class WsThreadHelper;
+class WsService;
 class WsMessage;
+class WsMessageQueue;
+class WsFrameBuffer;
 
 /**
  * WebSocket is wrapper of the libwebsockets-protocol, let the develop could call the websocket easily.
+ * All the websockets are serviced by one thread, the events are delivered to the delegates by the scheduler.
+ * The received frames are passed to onMessage() in place, from a pool of buffers.
  */
 class CC_DLL WebSocket
 {
@@ -193,7 +197,7 @@ private:
     virtual void onSubThreadStarted();
     virtual int onSubThreadLoop();
     virtual void onSubThreadEnded();
-    virtual void onUIThreadReceiveMessage(WsMessage* msg);
+    virtual void onUIThreadReceiveMessage(const WsMessage& msg);
 
 
     friend class WebSocketCallbackWrapper;
@@ -209,11 +213,14 @@ private:
     std::string  _path;
 
     ssize_t _pendingFrameDataLen;
-    ssize_t _currentDataLen;
-    char *_currentData;
-
-    friend class WsThreadHelper;
-    WsThreadHelper* _wsHelper;
+    WsFrameBuffer* _currentFrame;
+
+    // single producer single consumer queues, the messages to send are written by the UI thread
+    // and read by the service thread, the received ones the other way round
+    friend class WsService;
+    WsMessageQueue* _sendQueue;
+    WsMessageQueue* _receiveQueue;
+    bool _hadTraffic;
 
     struct libwebsocket*         _wsInstance;
     struct libwebsocket_context* _wsContext;
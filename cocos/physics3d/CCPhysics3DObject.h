@@ -174,7 +174,7 @@ public:
      */
     static Physics3DRigidBody* create(Physics3DRigidBodyDes* info);
     
-    /** Get the pointer of btRigidBody. */
+    /** Get the pointer of btRigidBody. Its user pointer is this object, it must not be changed. */
     btRigidBody* getRigidBody() const { return _btRigidBody; }
     
     /**
@@ -412,7 +412,7 @@ public:
     */
     static Physics3DCollider* create(Physics3DColliderDes *info);
 
-    /** Get the pointer of btGhostObject. 
+    /** Get the pointer of btGhostObject. Its user pointer is this object, it must not be changed.
      *  @return The pointer of btGhostObject.
     */
     btGhostObject* getGhostObject() const { return _btGhostObject; }
@@ -293,24 +293,24 @@ bool Physics3DWorld::sweepShape(Physics3DShape* shape, const cocos2d::Mat4& star
 
 Physics3DObject* Physics3DWorld::getPhysicsObject(const btCollisionObject* btObj)
 {
-    for(auto it : _objects)
-    {
-        if (it->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
-        {
-            if (static_cast<Physics3DRigidBody*>(it)->getRigidBody() == btObj)
-                return it;
-        }
-        else if (it->getObjType() == Physics3DObject::PhysicsObjType::COLLIDER)
-        {
-            if (static_cast<Physics3DCollider*>(it)->getGhostObject() == btObj)
-                return it;
-        }
-    }
-    return nullptr;
+    // set by Physics3DRigidBody and Physics3DCollider
+    return static_cast<Physics3DObject*>(btObj->getUserPointer());
+}
+
+void Physics3DWorld::setContactBatchCallback(const ContactBatchCallbackFunc &func)
+{
+    _contactBatchCallback = func;
+    _collisionCheckingFlag = true;
 }
 
 void Physics3DWorld::collisionChecking()
 {
+    auto& pairs = _contactBatch.pairs;
+    auto& points = _contactBatch.points;
+    pairs.clear();
+    points.clear();
+    bool batching = _contactBatchCallback != nullptr;
+
     int numManifolds = _dispatcher->getNumManifolds();
     for (int i = 0; i < numManifolds; ++i){
         btPersistentManifold * contactManifold = _dispatcher->getManifoldByIndexInternal(i);
@@ -320,35 +320,52 @@ void Physics3DWorld::collisionChecking()
             const btCollisionObject* obB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
             Physics3DObject *poA = getPhysicsObject(obA);
             Physics3DObject *poB = getPhysicsObject(obB);
-            if (poA->needCollisionCallback() || poB->needCollisionCallback()){
-                Physics3DCollisionInfo ci;
-                ci.objA = poA;
-                ci.objB = poB;
-                for (int c = 0; c < numContacts; ++c){
-                    btManifoldPoint& pt = contactManifold->getContactPoint(c);
-                    Physics3DCollisionInfo::CollisionPoint cp = {
-                          convertbtVector3ToVec3(pt.m_localPointA), convertbtVector3ToVec3(pt.m_positionWorldOnA)
-                        , convertbtVector3ToVec3(pt.m_localPointB), convertbtVector3ToVec3(pt.m_positionWorldOnB)
-                        , convertbtVector3ToVec3(pt.m_normalWorldOnB)
-                    };
-                    ci.collisionPointList.push_back(cp);
-                }
+            bool callbackA = poA->needCollisionCallback();
+            bool callbackB = poB->needCollisionCallback();
+            if (!batching && !callbackA && !callbackB)
+                continue;
 
-                if (poA->needCollisionCallback()){
-                    poA->getCollisionCallback()(ci);
+            // the points of the pairs not batched are overwritten by the next pair
+            if (!batching)
+                points.clear();
+            unsigned int firstPoint = (unsigned int)points.size();
+            for (int c = 0; c < numContacts; ++c){
+                btManifoldPoint& pt = contactManifold->getContactPoint(c);
+                Physics3DCollisionInfo::CollisionPoint cp = {
+                      convertbtVector3ToVec3(pt.m_localPointA), convertbtVector3ToVec3(pt.m_positionWorldOnA)
+                    , convertbtVector3ToVec3(pt.m_localPointB), convertbtVector3ToVec3(pt.m_positionWorldOnB)
+                    , convertbtVector3ToVec3(pt.m_normalWorldOnB)
+                };
+                points.push_back(cp);
+            }
+            if (batching){
+                Physics3DContactBatch::ContactPair pair = { poA, poB, firstPoint, (unsigned int)numContacts };
+                pairs.push_back(pair);
+            }
+
+            if (callbackA || callbackB){
+                _collisionInfo.objA = poA;
+                _collisionInfo.objB = poB;
+                _collisionInfo.collisionPointList.assign(points.begin() + firstPoint, points.end());
+
+                if (callbackA){
+                    poA->getCollisionCallback()(_collisionInfo);
                 }
-                if (poB->needCollisionCallback()){
-                    poB->getCollisionCallback()(ci);
+                if (callbackB){
+                    poB->getCollisionCallback()(_collisionInfo);
                 }
             }
         }
     }
+
+    if (batching && !pairs.empty())
+        _contactBatchCallback(_contactBatch);
 }
 
 bool Physics3DWorld::needCollisionChecking()
 {
     if (_collisionCheckingFlag){
-        _needCollisionChecking = false;
+        _needCollisionChecking = _contactBatchCallback != nullptr;
         for(auto it : _objects)
         {
             if (it->getCollisionCallback() != nullptr){
@@ -28,6 +28,10 @@
 #include "math/CCMath.h"
 #include "base/CCRef.h"
 #include "base/ccConfig.h"
+#include "CCPhysics3DObject.h"
+
+#include <functional>
+#include <vector>
 
 #if CC_USE_3D_PHYSICS
 
@@ -69,6 +73,27 @@ struct CC_DLL Physics3DWorldDes
     }
 };
 
+/**
+ * @brief The contacts of all the colliding pairs of a simulation step.
+ *
+ * The points of a pair are points[firstPoint] to points[firstPoint + pointCount - 1]. The batch is reused by
+ * the next step, so it must not be kept by the callback.
+ * @since v3.9
+ */
+struct CC_DLL Physics3DContactBatch
+{
+    struct ContactPair
+    {
+        Physics3DObject *objA;
+        Physics3DObject *objB;
+        unsigned int firstPoint;
+        unsigned int pointCount;
+    };
+
+    std::vector<ContactPair> pairs;
+    std::vector<Physics3DCollisionInfo::CollisionPoint> points;
+};
+
 /**
  * @brief The physics information container, include Physics3DObjects, Physics3DConstraints, collision information and so on.
  */
@@ -83,6 +108,8 @@ public:
         cocos2d::Vec3 hitNormal;
         Physics3DObject* hitObj;
     };
+
+    typedef std::function<void(const Physics3DContactBatch &batch)> ContactBatchCallbackFunc;
     
     /**
      * Creates a Physics3DWorld with Physics3DWorldDes. 
@@ -140,6 +167,15 @@ public:
     
     /** Performs a swept shape cast on all objects in the Physics3DWorld. */
     bool sweepShape(Physics3DShape* shape, const cocos2d::Mat4& startTransform, const cocos2d::Mat4& endTransform, HitResult* result);
+
+    /**
+     * Set the callback receiving the contacts of all the objects after every simulation step, at once.
+     * The collision callbacks of the objects are still called, before it.
+     */
+    void setContactBatchCallback(const ContactBatchCallbackFunc &func);
+
+    /** Get the callback of the contacts of all the objects. */
+    const ContactBatchCallbackFunc& getContactBatchCallback() const { return _contactBatchCallback; }
     
 CC_CONSTRUCTOR_ACCESS:
     
@@ -160,6 +196,10 @@ protected:
     bool _needCollisionChecking;
     bool _collisionCheckingFlag;
     bool _needGhostPairCallbackChecking;
+    ContactBatchCallbackFunc _contactBatchCallback;
+    // reused by every step, so that reporting the contacts doesn't allocate once they have grown
+    Physics3DContactBatch _contactBatch;
+    Physics3DCollisionInfo _collisionInfo;
     
 #if (CC_ENABLE_BULLET_INTEGRATION)
     btDynamicsWorld* _btPhyiscsWorld;
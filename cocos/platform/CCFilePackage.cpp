@@ -0,0 +1,342 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCFilePackage.h"
+
+#include <zlib.h>
+
+#include "base/ccMacros.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <windows.h>
+#elif CC_TARGET_PLATFORM != CC_PLATFORM_WINRT
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+static const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static const uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+static const uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+static const size_t LOCAL_HEADER_SIZE = 30;
+static const size_t CENTRAL_HEADER_SIZE = 46;
+static const size_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+static const size_t MAX_COMMENT_SIZE = 0xffff;
+
+static const int METHOD_STORED = 0;
+static const int METHOD_DEFLATED = 8;
+
+static uint16_t readUInt16(const unsigned char* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readUInt32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+std::shared_ptr<FilePackage> FilePackage::open(const std::string& path)
+{
+    std::shared_ptr<FilePackage> package(new (std::nothrow) FilePackage());
+    if (package && package->init(path))
+        return package;
+    return nullptr;
+}
+
+FilePackage::FilePackage()
+    : _bytes(nullptr)
+    , _size(0)
+    , _file(nullptr)
+    , _mapping(nullptr)
+{
+}
+
+FilePackage::~FilePackage()
+{
+    unmap();
+}
+
+bool FilePackage::init(const std::string& path)
+{
+    _path = path;
+    if (!map())
+    {
+        CCLOG("FilePackage: can't map %s", path.c_str());
+        return false;
+    }
+    if (!readCentralDirectory())
+    {
+        CCLOG("FilePackage: %s isn't a supported zip archive", path.c_str());
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+// read only mappings: the slices given away as Data are shared by every reader of the entry
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+bool FilePackage::map()
+{
+    int length = MultiByteToWideChar(CP_UTF8, 0, _path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, _path.c_str(), -1, &widePath[0], length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    _file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        return false;
+    _size = (size_t)size.QuadPart;
+
+    _mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping)
+        return false;
+    _bytes = (unsigned char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+    return _bytes != nullptr;
+}
+
+void FilePackage::unmap()
+{
+    if (_bytes)
+        UnmapViewOfFile(_bytes);
+    if (_mapping)
+        CloseHandle(_mapping);
+    if (_file)
+        CloseHandle(_file);
+    _bytes = nullptr;
+    _mapping = nullptr;
+    _file = nullptr;
+    _size = 0;
+}
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
+// no file mapping for the store apps, the archive is read whole
+bool FilePackage::map()
+{
+    FILE* fp = fopen(_path.c_str(), "rb");
+    if (!fp)
+        return false;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size > 0)
+    {
+        _bytes = (unsigned char*)malloc(size);
+        if (_bytes && fread(_bytes, 1, size, fp) == (size_t)size)
+            _size = (size_t)size;
+    }
+    fclose(fp);
+    return _size > 0;
+}
+
+void FilePackage::unmap()
+{
+    free(_bytes);
+    _bytes = nullptr;
+    _size = 0;
+}
+#else
+bool FilePackage::map()
+{
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void* bytes = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (bytes != MAP_FAILED)
+        {
+            _bytes = (unsigned char*)bytes;
+            _size = (size_t)info.st_size;
+        }
+    }
+    // the mapping stays valid without the descriptor
+    ::close(fd);
+    return _bytes != nullptr;
+}
+
+void FilePackage::unmap()
+{
+    if (_bytes)
+        munmap(_bytes, _size);
+    _bytes = nullptr;
+    _size = 0;
+}
+#endif
+
+bool FilePackage::readCentralDirectory()
+{
+    if (_size < END_OF_CENTRAL_DIRECTORY_SIZE)
+        return false;
+
+    // the end of central directory record is followed by a comment of up to 64KB
+    const unsigned char* end = nullptr;
+    size_t lowest = _size > END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE ? _size - END_OF_CENTRAL_DIRECTORY_SIZE - MAX_COMMENT_SIZE : 0;
+    for (size_t offset = _size - END_OF_CENTRAL_DIRECTORY_SIZE + 1; offset-- > lowest;)
+    {
+        if (readUInt32(_bytes + offset) == END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+        {
+            end = _bytes + offset;
+            break;
+        }
+    }
+    if (!end)
+        return false;
+
+    size_t count = readUInt16(end + 10);
+    size_t directorySize = readUInt32(end + 12);
+    size_t directoryOffset = readUInt32(end + 16);
+    // zip64 stores 0xffff and 0xffffffff here
+    if (count == 0xffff || directoryOffset == 0xffffffff || directoryOffset + directorySize > (size_t)(end - _bytes))
+        return false;
+
+    _entries.reserve(count);
+    const unsigned char* header = _bytes + directoryOffset;
+    const unsigned char* directoryEnd = header + directorySize;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (header + CENTRAL_HEADER_SIZE > directoryEnd || readUInt32(header) != CENTRAL_HEADER_SIGNATURE)
+            return false;
+
+        uint16_t flags = readUInt16(header + 8);
+        Entry entry;
+        entry.method = readUInt16(header + 10);
+        entry.compressedSize = readUInt32(header + 20);
+        entry.uncompressedSize = readUInt32(header + 24);
+        size_t nameLength = readUInt16(header + 28);
+        size_t extraLength = readUInt16(header + 30);
+        size_t commentLength = readUInt16(header + 32);
+        entry.localHeaderOffset = readUInt32(header + 42);
+
+        const unsigned char* name = header + CENTRAL_HEADER_SIZE;
+        header = name + nameLength + extraLength + commentLength;
+        if (header > directoryEnd)
+            return false;
+
+        // directories, encrypted entries and compressions zlib can't inflate are left out
+        bool directory = nameLength > 0 && name[nameLength - 1] == '/';
+        bool supported = (flags & 1) == 0 && (entry.method == METHOD_STORED || entry.method == METHOD_DEFLATED);
+        if (directory || !supported || entry.localHeaderOffset + LOCAL_HEADER_SIZE > _size)
+            continue;
+
+        _entries[std::string((const char*)name, nameLength)] = entry;
+    }
+    return true;
+}
+
+const unsigned char* FilePackage::getEntryBytes(const Entry& entry) const
+{
+    // the local header has its own name and extra field lengths
+    const unsigned char* header = _bytes + entry.localHeaderOffset;
+    if (readUInt32(header) != LOCAL_HEADER_SIGNATURE)
+        return nullptr;
+
+    size_t offset = entry.localHeaderOffset + LOCAL_HEADER_SIZE + readUInt16(header + 26) + readUInt16(header + 28);
+    if (offset + entry.compressedSize > _size)
+        return nullptr;
+    return _bytes + offset;
+}
+
+ssize_t FilePackage::getEntrySize(const std::string& name) const
+{
+    auto iter = _entries.find(name);
+    return iter != _entries.end() ? (ssize_t)iter->second.uncompressedSize : -1;
+}
+
+bool FilePackage::isEntryStored(const std::string& name) const
+{
+    auto iter = _entries.find(name);
+    return iter != _entries.end() && iter->second.method == METHOD_STORED;
+}
+
+Data FilePackage::getData(const std::string& name, bool nullTerminated)
+{
+    Data ret;
+    auto iter = _entries.find(name);
+    if (iter == _entries.end())
+        return ret;
+
+    const Entry& entry = iter->second;
+    const unsigned char* bytes = getEntryBytes(entry);
+    if (!bytes)
+    {
+        CCLOG("FilePackage: %s is corrupted in %s", name.c_str(), _path.c_str());
+        return ret;
+    }
+
+    if (entry.method == METHOD_STORED && !nullTerminated)
+    {
+        ret.fastSet(const_cast<unsigned char*>(bytes), entry.uncompressedSize, shared_from_this());
+        return ret;
+    }
+
+    unsigned char* buffer = (unsigned char*)malloc(entry.uncompressedSize + (nullTerminated ? 1 : 0));
+    if (!buffer)
+        return ret;
+
+    bool succeeded = true;
+    if (entry.method == METHOD_STORED)
+    {
+        memcpy(buffer, bytes, entry.uncompressedSize);
+    }
+    else
+    {
+        // raw deflate, without the zlib header
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        succeeded = inflateInit2(&stream, -MAX_WBITS) == Z_OK;
+        if (succeeded)
+        {
+            stream.next_in = const_cast<Bytef*>(bytes);
+            stream.avail_in = (uInt)entry.compressedSize;
+            stream.next_out = buffer;
+            stream.avail_out = (uInt)entry.uncompressedSize;
+            int result = inflate(&stream, Z_FINISH);
+            succeeded = (result == Z_STREAM_END || (result == Z_BUF_ERROR && stream.avail_out == 0)) && stream.total_out == entry.uncompressedSize;
+            inflateEnd(&stream);
+        }
+    }
+
+    if (!succeeded)
+    {
+        CCLOG("FilePackage: can't inflate %s in %s", name.c_str(), _path.c_str());
+        free(buffer);
+        return ret;
+    }
+
+    if (nullTerminated)
+        buffer[entry.uncompressedSize] = '\0';
+    ret.fastSet(buffer, entry.uncompressedSize);
+    return ret;
+}
+
+NS_CC_END
@@ -0,0 +1,119 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_FILE_PACKAGE_H__
+#define __CC_FILE_PACKAGE_H__
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @brief FilePackage: a zip archive opened once, whose entries are found by a hash of their names.
+
+ The archive is mapped in memory and its central directory is read when it is opened. Reading an entry
+ needs no file handle or cursor, so that several threads can read entries of the same package at once.
+ The stored entries are returned as read only slices of the mapping, without a copy, the deflated ones are inflated.
+ Zip64 archives and encrypted entries aren't supported.
+
+ FileUtils::mountPackage() opens the packages whose entries are found and read as files.
+ @since v3.9
+ */
+class CC_DLL FilePackage : public std::enable_shared_from_this<FilePackage>
+{
+public:
+    /**
+     * Opens and indexes a zip archive.
+     *
+     * @param path The full path of the archive, on the file system.
+     * @return The package, or nullptr if the archive can't be read.
+     */
+    static std::shared_ptr<FilePackage> open(const std::string& path);
+
+    ~FilePackage();
+
+    /** The full path of the archive. */
+    const std::string& getPath() const { return _path; }
+
+    /** Number of files in the archive, the directories aren't counted. */
+    size_t getEntryCount() const { return _entries.size(); }
+
+    /** Whether the archive has a file of this name, relative to the root of the archive. */
+    bool hasEntry(const std::string& name) const { return _entries.find(name) != _entries.end(); }
+
+    /** The uncompressed size of the entry, -1 if there is no such entry. */
+    ssize_t getEntrySize(const std::string& name) const;
+
+    /** Whether the entry is stored as is, so that getData() returns a slice of the mapping. */
+    bool isEntryStored(const std::string& name) const;
+
+    /**
+     * Reads an entry, may be called by several threads at once.
+     *
+     * @param name The name of the entry.
+     * @param nullTerminated Whether a '\0' is added after the bytes, which copies a stored entry.
+     * @return The bytes of the entry, Data::Null if it can't be read. A slice of the mapping keeps the package
+     * open until it is cleared. It is shared by every reader of the entry and mapped read only: copy it to modify it.
+     */
+    Data getData(const std::string& name, bool nullTerminated = false);
+
+protected:
+    struct Entry
+    {
+        size_t localHeaderOffset;
+        size_t compressedSize;
+        size_t uncompressedSize;
+        int method;
+    };
+
+    FilePackage();
+    bool init(const std::string& path);
+    bool map();
+    void unmap();
+    bool readCentralDirectory();
+    const unsigned char* getEntryBytes(const Entry& entry) const;
+
+    std::string _path;
+    unsigned char* _bytes;
+    size_t _size;
+    // the handles of the mapping on windows
+    void* _file;
+    void* _mapping;
+    std::unordered_map<std::string, Entry> _entries;
+};
+
+/** @} */
+
+NS_CC_END
+
+#endif // __CC_FILE_PACKAGE_H__
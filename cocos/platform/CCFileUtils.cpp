@@ -26,11 +26,13 @@ THE SOFTWARE.
 #include "CCFileUtils.h"
 
 #include <stack>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "platform/CCSAXParser.h"
+#include "platform/CCFilePackage.h"
 #include "base/ccUtils.h"
 
 #include "tinyxml2.h"
@@ -628,8 +630,12 @@ static Data getData(const std::string& filename, bool forString)
     auto fileutils = FileUtils::getInstance();
     do
     {
-        // Read the file from hardware
         std::string fullPath = fileutils->fullPathForFilename(filename);
+        Data packaged = fileutils->getDataFromPackage(fullPath, forString);
+        if (!packaged.isNull())
+            return packaged;
+
+        // Read the file from hardware
         FILE *fp = fopen(fileutils->getSuitableFOpen(fullPath).c_str(), mode);
         CC_BREAK_IF(!fp);
         fseek(fp,0,SEEK_END);
@@ -689,8 +695,18 @@ unsigned char* FileUtils::getFileData(const std::string& filename, const char* m
     *size = 0;
     do
     {
-        // read the file from hardware
         const std::string fullPath = fullPathForFilename(filename);
+        if (isFileInPackage(fullPath))
+        {
+            // null terminated data is always a buffer of its own, which the caller frees
+            Data packaged = getDataFromPackage(fullPath, true);
+            buffer = packaged.getBytes();
+            *size = packaged.getSize();
+            packaged.fastSet(nullptr, 0);
+            break;
+        }
+
+        // read the file from hardware
         FILE *fp = fopen(getSuitableFOpen(fullPath).c_str(), mode);
         CC_BREAK_IF(!fp);
 
@@ -722,6 +738,25 @@ unsigned char* FileUtils::getFileDataFromZip(const std::string& zipFilePath, con
     {
         CC_BREAK_IF(zipFilePath.empty());
 
+        std::shared_ptr<FilePackage> package;
+        {
+            std::lock_guard<std::mutex> lock(_packageMutex);
+            for (const auto& mounted : _packages)
+            {
+                if (mounted.packagePath == zipFilePath)
+                    package = mounted.package;
+            }
+        }
+        if (package)
+        {
+            // a mounted archive is already indexed, no need to open and scan it again
+            Data data = package->getData(filename, true);
+            buffer = data.getBytes();
+            *size = data.getSize();
+            data.fastSet(nullptr, 0);
+            break;
+        }
+
         file = unzOpen(zipFilePath.c_str());
         CC_BREAK_IF(!file);
 
@@ -757,6 +792,72 @@ unsigned char* FileUtils::getFileDataFromZip(const std::string& zipFilePath, con
     return buffer;
 }
 
+bool FileUtils::mountPackage(const std::string& packagePath, const std::string& mountPath)
+{
+    std::string fullPath = isAbsolutePath(packagePath) ? packagePath : fullPathForFilename(packagePath);
+    auto package = FilePackage::open(fullPath);
+    if (!package)
+        return false;
+
+    std::string prefix = isAbsolutePath(mountPath) ? mountPath : _defaultResRootPath + mountPath;
+    if (!prefix.empty() && prefix.back() != '/')
+        prefix += '/';
+
+    {
+        std::lock_guard<std::mutex> lock(_packageMutex);
+        _packages.push_back({ fullPath, prefix, package });
+    }
+    _fullPathCache.clear();
+    return true;
+}
+
+void FileUtils::unmountPackage(const std::string& packagePath)
+{
+    std::string fullPath = isAbsolutePath(packagePath) ? packagePath : fullPathForFilename(packagePath);
+    {
+        std::lock_guard<std::mutex> lock(_packageMutex);
+        _packages.erase(std::remove_if(_packages.begin(), _packages.end(), [&](const MountedPackage& mounted) {
+            return mounted.packagePath == fullPath;
+        }), _packages.end());
+    }
+    _fullPathCache.clear();
+}
+
+std::shared_ptr<FilePackage> FileUtils::findPackage(const std::string& fullPath, std::string& entryName) const
+{
+    std::lock_guard<std::mutex> lock(_packageMutex);
+    for (auto iter = _packages.rbegin(); iter != _packages.rend(); ++iter)
+    {
+        const std::string& prefix = iter->mountPath;
+        if (fullPath.size() <= prefix.size() || fullPath.compare(0, prefix.size(), prefix) != 0)
+            continue;
+
+        // the package outlives the lock, so that it may be unmounted while it is read
+        std::string name = fullPath.substr(prefix.size());
+        if (iter->package->hasEntry(name))
+        {
+            entryName = std::move(name);
+            return iter->package;
+        }
+    }
+    return nullptr;
+}
+
+Data FileUtils::getDataFromPackage(const std::string& fullPath, bool nullTerminated) const
+{
+    std::string entryName;
+    auto package = findPackage(fullPath, entryName);
+    if (!package)
+        return Data::Null;
+    return package->getData(entryName, nullTerminated);
+}
+
+bool FileUtils::isFileInPackage(const std::string& fullPath) const
+{
+    std::string entryName;
+    return findPackage(fullPath, entryName) != nullptr;
+}
+
 std::string FileUtils::getNewFilename(const std::string &filename) const
 {
     std::string newFileName;
@@ -998,7 +1099,7 @@ std::string FileUtils::getFullPathForDirectoryAndFilename(const std::string& dir
     ret += filename;
 
     // if the file doesn't exist, return an empty string
-    if (!isFileExistInternal(ret)) {
+    if (!isFileInPackage(ret) && !isFileExistInternal(ret)) {
         ret = "";
     }
     return ret;
@@ -1008,7 +1109,7 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        return isFileInPackage(filename) || isFileExistInternal(filename);
     }
     else
     {
@@ -1250,6 +1351,11 @@ long FileUtils::getFileSize(const std::string &filepath)
             return 0;
     }
 
+    std::string entryName;
+    auto package = findPackage(fullpath, entryName);
+    if (package)
+        return (long)package->getEntrySize(entryName);
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat( fullpath.c_str(), &info );
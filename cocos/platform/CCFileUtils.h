@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
@@ -36,6 +38,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class FilePackage;
+
 /**
  * @addtogroup platform
  * @{
@@ -120,6 +124,41 @@ public:
      */
     virtual unsigned char* getFileDataFromZip(const std::string& zipFilePath, const std::string& filename, ssize_t *size);
 
+    /**
+     *  Mounts a zip archive, so that its files are found and read as if they were extracted in a directory.
+     *  The archive is opened and indexed once, its files are read from memory by any thread, and the stored
+     *  (uncompressed) ones are returned by getDataFromFile() without a copy, read only.
+     *  The packages mounted last are looked up first, before the file system.
+     *
+     *  @param packagePath The path of the archive. It must be a file of the file system, not an Android asset.
+     *  @param mountPath The directory the files of the archive appear in, relative to the default resource root path unless absolute.
+     *  @return True if the archive is mounted, false if it can't be read.
+     *  @since v3.9
+     */
+    virtual bool mountPackage(const std::string& packagePath, const std::string& mountPath = "");
+
+    /**
+     *  Unmounts a zip archive mounted by mountPackage(). The data already read from it stays valid.
+     *  @since v3.9
+     */
+    virtual void unmountPackage(const std::string& packagePath);
+
+    /**
+     *  Reads a file of a mounted package, can be called by any thread.
+     *
+     *  @param fullPath The full path of the file, as returned by fullPathForFilename().
+     *  @param nullTerminated Whether a '\0' is added after the bytes.
+     *  @return The content of the file, Data::Null if no mounted package has it.
+     *  @since v3.9
+     */
+    Data getDataFromPackage(const std::string& fullPath, bool nullTerminated = false) const;
+
+    /**
+     *  Checks whether a full path is a file of a mounted package.
+     *  @since v3.9
+     */
+    bool isFileInPackage(const std::string& fullPath) const;
+
 
     /** Returns the fullpath for a given filename.
 
@@ -538,6 +577,15 @@ protected:
      */
     virtual std::string getFullPathForDirectoryAndFilename(const std::string& directory, const std::string& filename) const;
 
+    /**
+     *  Finds the mounted package which has a full path, the last mounted first.
+     *
+     *  @param fullPath The full path of the file.
+     *  @param entryName Set to the name of the file in the package.
+     *  @return The package, or nullptr if none has the file.
+     */
+    std::shared_ptr<FilePackage> findPackage(const std::string& fullPath, std::string& entryName) const;
+
     /** Dictionary used to lookup filenames based on a key.
      *  It is used internally by the following methods:
      *
@@ -579,6 +627,20 @@ protected:
      */
     std::string _writablePath;
 
+    struct MountedPackage
+    {
+        std::string packagePath;
+        std::string mountPath;
+        std::shared_ptr<FilePackage> package;
+    };
+
+    /**
+     *  The mounted packages, in the order they were mounted.
+     *  They are read by the loading threads, so _packageMutex guards them.
+     */
+    std::vector<MountedPackage> _packages;
+    mutable std::mutex _packageMutex;
+
     /**
      *  The singleton pointer of FileUtils.
      */
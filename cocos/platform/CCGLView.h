@@ -122,6 +122,14 @@ public:
     /** Exchanges the front and back buffers, subclass must implement this method. */
     virtual void swapBuffers() = 0;
 
+    /** Makes the GL context current on the calling thread, or releases it from the calling thread.
+     * Used by the pipelined rendering, see Director::setPipelinedRendering().
+     *
+     * @param current True to make the context current, false to release it.
+     * @return False if the context can not move to another thread, the default.
+     */
+    virtual bool makeContextCurrent(bool current);
+
     /** Open or close IME keyboard , subclass must implement this method. 
      *
      * @param open Open or close IME keyboard.
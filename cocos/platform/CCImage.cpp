@@ -89,6 +89,12 @@ extern "C"
 #include "android/CCFileUtils-android.h"
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #define CC_GL_ATC_RGB_AMD                                          0x8C92
 #define CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD                          0x8C93
 #define CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD                      0x87EE
@@ -2447,16 +2453,62 @@ bool Image::saveImageToJPG(const std::string& filePath)
 #endif // CC_USE_JPEG
 }
 
-void Image::premultipliedAlpha()
+// pixels premultiplied by one thread at least, the smaller images are premultiplied by the calling thread alone
+static const size_t PREMULTIPLY_CHUNK = 32 * 1024;
+
+// same as CC_RGB_PREMULTIPLY_ALPHA, c * (a + 1) >> 8
+static void premultiplyPixels(unsigned char* data, size_t count)
 {
-    CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
-    
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i one = _mm_set1_epi16(1);
+    __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+        __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+        __m128i alphaLo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        __m128i alphaHi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alphaLo), 8);
+        hi = _mm_srli_epi16(_mm_mullo_epi16(hi, alphaHi), 8);
+        __m128i result = _mm_packus_epi16(lo, hi);
+        result = _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, pixels));
+        _mm_storeu_si128((__m128i*)(data + i * 4), result);
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t rgba = vld4q_u8(data + i * 4);
+        uint8x8_t alphaLo = vget_low_u8(rgba.val[3]);
+        uint8x8_t alphaHi = vget_high_u8(rgba.val[3]);
+        for (int c = 0; c < 3; ++c)
+        {
+            uint8x8_t lo = vget_low_u8(rgba.val[c]);
+            uint8x8_t hi = vget_high_u8(rgba.val[c]);
+            rgba.val[c] = vcombine_u8(vshrn_n_u16(vaddw_u8(vmull_u8(lo, alphaLo), lo), 8),
+                                      vshrn_n_u16(vaddw_u8(vmull_u8(hi, alphaHi), hi), 8));
+        }
+        vst4q_u8(data + i * 4, rgba);
+    }
+#endif
+    unsigned int* fourBytes = (unsigned int*)data;
+    for (; i < count; ++i)
     {
-        unsigned char* p = _data + i * 4;
+        unsigned char* p = data + i * 4;
         fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
     }
+}
+
+void Image::premultipliedAlpha()
+{
+    CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
+    
+    unsigned char* data = _data;
+    utils::parallelFor((size_t)_width * _height, PREMULTIPLY_CHUNK, [data](size_t begin, size_t end) {
+        premultiplyPixels(data + begin * 4, end - begin);
+    });
     
     _hasPremultipliedAlpha = true;
 }
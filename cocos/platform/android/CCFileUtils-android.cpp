@@ -239,6 +239,10 @@ Data FileUtilsAndroid::getData(const std::string& filename, bool forString)
     ssize_t size = 0;
     string fullPath = fullPathForFilename(filename);
 
+    Data packaged = getDataFromPackage(fullPath, forString);
+    if (!packaged.isNull())
+        return packaged;
+
     if (fullPath[0] != '/')
     {
         string relativePath = string();
@@ -360,7 +364,18 @@ unsigned char* FileUtilsAndroid::getFileData(const std::string& filename, const
 
     string fullPath = fullPathForFilename(filename);
 
-    if (fullPath[0] != '/')
+    if (isFileInPackage(fullPath))
+    {
+        // null terminated data is always a buffer of its own, which the caller frees
+        Data packaged = getDataFromPackage(fullPath, true);
+        data = packaged.getBytes();
+        if (size)
+        {
+            *size = packaged.getSize();
+        }
+        packaged.fastSet(nullptr, 0);
+    }
+    else if (fullPath[0] != '/')
     {
         string relativePath = string();
 
@@ -421,6 +421,12 @@ bool FileUtilsApple::removeDirectory(const std::string& path)
 
 std::string FileUtilsApple::getFullPathForDirectoryAndFilename(const std::string& directory, const std::string& filename) const
 {
+    std::string packagedPath = directory + filename;
+    if (isFileInPackage(packagedPath))
+    {
+        return packagedPath;
+    }
+
     if (directory[0] != '/')
     {
         NSString* fullpath = [getBundle() pathForResource:[NSString stringWithUTF8String:filename.c_str()]
@@ -463,6 +463,15 @@ void GLViewImpl::swapBuffers()
         glfwSwapBuffers(_mainWindow);
 }
 
+bool GLViewImpl::makeContextCurrent(bool current)
+{
+    if(_mainWindow == nullptr)
+        return false;
+
+    glfwMakeContextCurrent(current ? _mainWindow : nullptr);
+    return true;
+}
+
 bool GLViewImpl::windowShouldClose()
 {
     if(_mainWindow)
@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/linux/CCGLViewHeadless-linux.h"
+#include "platform/linux/CCNullGL-linux.h"
+
+NS_CC_BEGIN
+
+GLViewHeadless::GLViewHeadless()
+: _ready(false)
+, _swappedFrames(0)
+{
+    _viewName = "cocos2dx";
+}
+
+GLViewHeadless::~GLViewHeadless()
+{
+    CCLOGINFO("deallocing GLViewHeadless: %p", this);
+}
+
+GLViewHeadless* GLViewHeadless::create(const std::string& viewName)
+{
+    return createWithRect(viewName, Rect(0, 0, 960, 640));
+}
+
+GLViewHeadless* GLViewHeadless::createWithRect(const std::string& viewName, Rect rect)
+{
+    auto ret = new (std::nothrow) GLViewHeadless;
+    if (ret && ret->initWithRect(viewName, rect))
+    {
+        ret->autorelease();
+        return ret;
+    }
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+bool GLViewHeadless::initWithRect(const std::string& viewName, Rect rect)
+{
+    if (!NullGL::isInstalled())
+    {
+        NullGL::install();
+    }
+
+    setViewName(viewName);
+    setFrameSize(rect.size.width, rect.size.height);
+    _ready = true;
+    return true;
+}
+
+bool GLViewHeadless::isOpenGLReady()
+{
+    return _ready;
+}
+
+void GLViewHeadless::end()
+{
+    _ready = false;
+    // Release self, same as GLViewImpl.
+    release();
+}
+
+void GLViewHeadless::swapBuffers()
+{
+    NullGL::endFrame();
+    ++_swappedFrames;
+}
+
+bool GLViewHeadless::windowShouldClose()
+{
+    return !_ready;
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
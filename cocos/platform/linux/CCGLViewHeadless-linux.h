@@ -0,0 +1,76 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_GLVIEW_HEADLESS_LINUX_H__
+#define __CC_GLVIEW_HEADLESS_LINUX_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/CCGLView.h"
+
+NS_CC_BEGIN
+
+/**
+ * A GLView without window and GL context, rendering through NullGL.
+ *
+ * Meant for benchmarks and tests on machines without a GPU or a display.
+ * It is built into the cocos2d_headless library, link it before cocos2d.
+ */
+class CC_DLL GLViewHeadless : public GLView
+{
+public:
+    static GLViewHeadless* create(const std::string& viewName);
+    static GLViewHeadless* createWithRect(const std::string& viewName, Rect rect);
+
+    /* override functions */
+    virtual bool isOpenGLReady() override;
+    virtual void end() override;
+    virtual void swapBuffers() override;
+    virtual bool windowShouldClose() override;
+    virtual void setIMEKeyboardState(bool open) override {}
+    /** NullGL has no context, any thread may call it. */
+    virtual bool makeContextCurrent(bool current) override { return true; }
+
+    /** How many times swapBuffers() was called, each call closes a NullGL frame. */
+    unsigned int getSwappedFrames() const { return _swappedFrames; }
+
+protected:
+    GLViewHeadless();
+    virtual ~GLViewHeadless();
+
+    bool initWithRect(const std::string& viewName, Rect rect);
+
+    bool _ready;
+    unsigned int _swappedFrames;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(GLViewHeadless);
+};
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CC_GLVIEW_HEADLESS_LINUX_H__
@@ -0,0 +1,1225 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/linux/CCNullGL-linux.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "platform/CCGL.h"
+
+NS_CC_BEGIN
+
+namespace NullGL {
+
+namespace {
+
+struct Variable
+{
+    std::string name;
+    GLenum type;
+    GLint size;
+    GLint location;
+};
+
+struct ShaderObject
+{
+    GLenum type;
+    std::string source;
+};
+
+struct ProgramObject
+{
+    std::vector<GLuint> shaders;
+    std::unordered_map<std::string, GLint> boundAttribs;
+    std::vector<Variable> attributes;
+    std::vector<Variable> uniforms;
+};
+
+struct StateValue
+{
+    double v[4];
+    int count;
+};
+
+bool s_installed = false;
+Stats s_frameStats;
+Stats s_currentStats;
+Stats s_totalStats;
+
+GLuint s_nextName = 1;
+GLenum s_error = GL_NO_ERROR;
+std::unordered_set<GLenum> s_enabled;
+std::unordered_map<GLenum, StateValue> s_state;
+std::unordered_map<GLuint, GLsizeiptr> s_bufferSizes;
+std::unordered_map<GLenum, GLuint> s_boundBuffers;
+std::unordered_map<GLuint, std::vector<char>> s_mappedBuffers;
+std::unordered_map<GLuint, ShaderObject> s_shaders;
+std::unordered_map<GLuint, ProgramObject> s_programs;
+
+// Every counter is bumped through this so that frame and total stay in sync.
+#define NULLGL_COUNT(__field__, __n__) do { s_currentStats.__field__ += (__n__); s_totalStats.__field__ += (__n__); } while (0)
+
+void setState(GLenum pname, double a, double b = 0, double c = 0, double d = 0, int count = 1)
+{
+    StateValue& value = s_state[pname];
+    value.v[0] = a;
+    value.v[1] = b;
+    value.v[2] = c;
+    value.v[3] = d;
+    value.count = count;
+}
+
+bool getState(GLenum pname, StateValue* value)
+{
+    auto iter = s_state.find(pname);
+    if (iter == s_state.end())
+        return false;
+    *value = iter->second;
+    return true;
+}
+
+GLuint genName()
+{
+    return s_nextName++;
+}
+
+void genNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+        names[i] = genName();
+}
+
+void resetState()
+{
+    s_nextName = 1;
+    s_error = GL_NO_ERROR;
+    s_enabled.clear();
+    s_state.clear();
+    s_bufferSizes.clear();
+    s_boundBuffers.clear();
+    s_mappedBuffers.clear();
+    s_shaders.clear();
+    s_programs.clear();
+
+    // implementation limits, chosen to match a common desktop GL 2.1 driver
+    setState(GL_MAX_TEXTURE_SIZE, 8192);
+    setState(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, 16);
+    setState(GL_MAX_TEXTURE_IMAGE_UNITS, 16);
+    setState(GL_MAX_VERTEX_ATTRIBS, 16);
+    setState(GL_MAX_RENDERBUFFER_SIZE, 8192);
+    setState(GL_MAX_VIEWPORT_DIMS, 8192, 8192, 0, 0, 2);
+    setState(GL_MAX_SAMPLES, 4);
+    setState(GL_STENCIL_BITS, 8);
+    setState(GL_DEPTH_BITS, 24);
+
+    // initial values of the GL state machine
+    setState(GL_DEPTH_WRITEMASK, GL_TRUE);
+    setState(GL_COLOR_WRITEMASK, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE, 4);
+    setState(GL_DEPTH_FUNC, GL_LESS);
+    setState(GL_DEPTH_CLEAR_VALUE, 1);
+    setState(GL_COLOR_CLEAR_VALUE, 0, 0, 0, 0, 4);
+    setState(GL_STENCIL_CLEAR_VALUE, 0);
+    setState(GL_STENCIL_FUNC, GL_ALWAYS);
+    setState(GL_STENCIL_REF, 0);
+    setState(GL_STENCIL_VALUE_MASK, 0xffffffff);
+    setState(GL_STENCIL_WRITEMASK, 0xffffffff);
+    setState(GL_STENCIL_FAIL, GL_KEEP);
+    setState(GL_STENCIL_PASS_DEPTH_FAIL, GL_KEEP);
+    setState(GL_STENCIL_PASS_DEPTH_PASS, GL_KEEP);
+    setState(GL_BLEND_SRC, GL_ONE);
+    setState(GL_BLEND_DST, GL_ZERO);
+    setState(GL_CULL_FACE_MODE, GL_BACK);
+    setState(GL_FRONT_FACE, GL_CCW);
+    setState(GL_ALPHA_TEST_FUNC, GL_ALWAYS);
+    setState(GL_ALPHA_TEST_REF, 0);
+    setState(GL_LINE_WIDTH, 1);
+    setState(GL_ACTIVE_TEXTURE, GL_TEXTURE0);
+    setState(GL_TEXTURE_BINDING_2D, 0);
+    setState(GL_CURRENT_PROGRAM, 0);
+    setState(GL_ARRAY_BUFFER_BINDING, 0);
+    setState(GL_ELEMENT_ARRAY_BUFFER_BINDING, 0);
+    setState(GL_VERTEX_ARRAY_BINDING, 0);
+    setState(GL_FRAMEBUFFER_BINDING, 0);
+    setState(GL_RENDERBUFFER_BINDING, 0);
+}
+
+size_t bytesPerPixel(GLenum format, GLenum type)
+{
+    switch (type)
+    {
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+        case GL_UNSIGNED_SHORT_5_6_5:
+            return 2;
+        case GL_FLOAT:
+            return 4 * (format == GL_RGBA ? 4 : format == GL_RGB ? 3 : 1);
+        default:
+            break;
+    }
+
+    switch (format)
+    {
+        case GL_RGBA:
+        case GL_BGRA:
+            return 4;
+        case GL_RGB:
+            return 3;
+        case GL_LUMINANCE_ALPHA:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+GLenum glslType(const std::string& name)
+{
+    static const std::unordered_map<std::string, GLenum> types = {
+        { "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+        { "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+        { "bool", GL_BOOL }, { "bvec2", GL_BOOL_VEC2 }, { "bvec3", GL_BOOL_VEC3 }, { "bvec4", GL_BOOL_VEC4 },
+        { "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+        { "sampler2D", GL_SAMPLER_2D }, { "samplerCube", GL_SAMPLER_CUBE },
+    };
+    auto iter = types.find(name);
+    return iter != types.end() ? iter->second : 0;
+}
+
+// Splits GLSL into identifier/number tokens and single punctuation characters,
+// dropping comments and preprocessor lines.
+std::vector<std::string> tokenize(const std::string& source)
+{
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    const size_t len = source.length();
+    bool lineStart = true;
+    while (i < len)
+    {
+        char c = source[i];
+        if (c == '\n')
+        {
+            lineStart = true;
+            ++i;
+        }
+        else if (isspace(c))
+        {
+            ++i;
+        }
+        else if (lineStart && c == '#')
+        {
+            while (i < len && source[i] != '\n')
+                ++i;
+        }
+        else if (c == '/' && i + 1 < len && source[i + 1] == '/')
+        {
+            while (i < len && source[i] != '\n')
+                ++i;
+        }
+        else if (c == '/' && i + 1 < len && source[i + 1] == '*')
+        {
+            size_t end = source.find("*/", i + 2);
+            i = (end == std::string::npos) ? len : end + 2;
+        }
+        else if (isalnum(c) || c == '_')
+        {
+            size_t start = i;
+            while (i < len && (isalnum(source[i]) || source[i] == '_'))
+                ++i;
+            tokens.push_back(source.substr(start, i - start));
+            lineStart = false;
+        }
+        else
+        {
+            tokens.push_back(std::string(1, c));
+            lineStart = false;
+            ++i;
+        }
+    }
+    return tokens;
+}
+
+void collectVariables(const std::string& source, const char* qualifier, std::vector<Variable>* variables)
+{
+    auto tokens = tokenize(source);
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        if (tokens[i] != qualifier)
+            continue;
+
+        size_t t = i + 1;
+        if (t < tokens.size() && (tokens[t] == "lowp" || tokens[t] == "mediump" || tokens[t] == "highp"))
+            ++t;
+        if (t + 1 >= tokens.size())
+            break;
+
+        GLenum type = glslType(tokens[t]);
+        const std::string& name = tokens[t + 1];
+        if (type == 0)
+            continue;
+
+        GLint size = 1;
+        if (t + 4 < tokens.size() && tokens[t + 2] == "[" && tokens[t + 4] == "]")
+            size = atoi(tokens[t + 3].c_str());
+
+        bool duplicated = false;
+        for (const auto& variable : *variables)
+        {
+            if (variable.name == name)
+            {
+                duplicated = true;
+                break;
+            }
+        }
+        if (!duplicated)
+            variables->push_back({ name, type, size, -1 });
+    }
+}
+
+void copyString(const std::string& str, GLsizei bufSize, GLsizei* length, GLchar* buffer)
+{
+    if (bufSize <= 0 || buffer == nullptr)
+        return;
+    GLsizei count = std::min<GLsizei>(bufSize - 1, (GLsizei)str.length());
+    memcpy(buffer, str.c_str(), count);
+    buffer[count] = '\0';
+    if (length)
+        *length = count;
+}
+
+ProgramObject* findProgram(GLuint program)
+{
+    auto iter = s_programs.find(program);
+    if (iter == s_programs.end())
+    {
+        s_error = GL_INVALID_VALUE;
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+GLenum bindingForTarget(GLenum target)
+{
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER: return GL_ARRAY_BUFFER_BINDING;
+        case GL_ELEMENT_ARRAY_BUFFER: return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+        case GL_PIXEL_PACK_BUFFER: return GL_PIXEL_PACK_BUFFER_BINDING;
+        case GL_PIXEL_UNPACK_BUFFER: return GL_PIXEL_UNPACK_BUFFER_BINDING;
+        default: return 0;
+    }
+}
+
+//
+// GL 1.2+ entry points, installed into the GLEW function pointers
+//
+
+void GLAPIENTRY nullActiveTexture(GLenum texture)
+{
+    setState(GL_ACTIVE_TEXTURE, texture);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullBlendEquation(GLenum mode)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    setState(GL_BLEND_SRC, srcRGB);
+    setState(GL_BLEND_DST, dstRGB);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullBlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullStencilMaskSeparate(GLenum face, GLuint mask)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY nullCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
+{
+    NULLGL_COUNT(textureUploads, 1);
+    NULLGL_COUNT(textureUploadBytes, imageSize);
+}
+
+void GLAPIENTRY nullGenBuffers(GLsizei n, GLuint* buffers)
+{
+    genNames(n, buffers);
+}
+
+void GLAPIENTRY nullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        s_bufferSizes.erase(buffers[i]);
+        s_mappedBuffers.erase(buffers[i]);
+        for (auto& bound : s_boundBuffers)
+        {
+            if (bound.second == buffers[i])
+            {
+                bound.second = 0;
+                setState(bindingForTarget(bound.first), 0);
+            }
+        }
+    }
+}
+
+GLboolean GLAPIENTRY nullIsBuffer(GLuint buffer)
+{
+    return s_bufferSizes.find(buffer) != s_bufferSizes.end() ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+{
+    s_boundBuffers[target] = buffer;
+    GLenum binding = bindingForTarget(target);
+    if (binding)
+        setState(binding, buffer);
+    if (buffer && s_bufferSizes.find(buffer) == s_bufferSizes.end())
+        s_bufferSizes[buffer] = 0;
+    NULLGL_COUNT(bufferBinds, 1);
+}
+
+void GLAPIENTRY nullBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    s_bufferSizes[s_boundBuffers[target]] = size;
+    NULLGL_COUNT(bufferUploads, 1);
+    NULLGL_COUNT(bufferUploadBytes, data ? size : 0);
+}
+
+void GLAPIENTRY nullBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    NULLGL_COUNT(bufferUploads, 1);
+    NULLGL_COUNT(bufferUploadBytes, size);
+}
+
+void* GLAPIENTRY nullMapBuffer(GLenum target, GLenum access)
+{
+    // every buffer has its own block while mapped, pixel pack buffers may stay mapped across frames
+    GLuint buffer = s_boundBuffers[target];
+    auto& mapped = s_mappedBuffers[buffer];
+    mapped.resize(s_bufferSizes[buffer]);
+    return mapped.data();
+}
+
+GLboolean GLAPIENTRY nullUnmapBuffer(GLenum target)
+{
+    GLuint buffer = s_boundBuffers[target];
+    if (s_mappedBuffers.erase(buffer) == 0)
+    {
+        s_error = GL_INVALID_OPERATION;
+        return GL_FALSE;
+    }
+    // a pixel pack buffer is read by the mapping, the others are written
+    if (target != GL_PIXEL_PACK_BUFFER)
+    {
+        NULLGL_COUNT(bufferUploads, 1);
+        NULLGL_COUNT(bufferUploadBytes, s_bufferSizes[buffer]);
+    }
+    return GL_TRUE;
+}
+
+void GLAPIENTRY nullGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    genNames(n, arrays);
+}
+
+void GLAPIENTRY nullDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+}
+
+void GLAPIENTRY nullBindVertexArray(GLuint array)
+{
+    setState(GL_VERTEX_ARRAY_BINDING, array);
+    NULLGL_COUNT(bufferBinds, 1);
+}
+
+GLuint GLAPIENTRY nullCreateShader(GLenum type)
+{
+    GLuint name = genName();
+    s_shaders[name].type = type;
+    return name;
+}
+
+void GLAPIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    auto& source = s_shaders[shader].source;
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (length && length[i] >= 0)
+            source.append(string[i], length[i]);
+        else
+            source.append(string[i]);
+    }
+}
+
+void GLAPIENTRY nullCompileShader(GLuint shader)
+{
+}
+
+void GLAPIENTRY nullGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    auto iter = s_shaders.find(shader);
+    if (iter == s_shaders.end())
+    {
+        s_error = GL_INVALID_VALUE;
+        return;
+    }
+
+    switch (pname)
+    {
+        case GL_SHADER_TYPE: *params = iter->second.type; break;
+        case GL_COMPILE_STATUS: *params = GL_TRUE; break;
+        case GL_DELETE_STATUS: *params = GL_FALSE; break;
+        case GL_SHADER_SOURCE_LENGTH: *params = (GLint)iter->second.source.length() + 1; break;
+        default: *params = 0; break;
+    }
+}
+
+void GLAPIENTRY nullGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    copyString("", bufSize, length, infoLog);
+}
+
+void GLAPIENTRY nullGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* source)
+{
+    copyString(s_shaders[shader].source, bufSize, length, source);
+}
+
+void GLAPIENTRY nullDeleteShader(GLuint shader)
+{
+    s_shaders.erase(shader);
+}
+
+GLuint GLAPIENTRY nullCreateProgram()
+{
+    GLuint name = genName();
+    s_programs[name];
+    return name;
+}
+
+void GLAPIENTRY nullAttachShader(GLuint program, GLuint shader)
+{
+    if (auto p = findProgram(program))
+        p->shaders.push_back(shader);
+}
+
+void GLAPIENTRY nullDetachShader(GLuint program, GLuint shader)
+{
+    if (auto p = findProgram(program))
+        p->shaders.erase(std::remove(p->shaders.begin(), p->shaders.end(), shader), p->shaders.end());
+}
+
+void GLAPIENTRY nullBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    if (auto p = findProgram(program))
+        p->boundAttribs[name] = index;
+}
+
+void GLAPIENTRY nullLinkProgram(GLuint program)
+{
+    auto p = findProgram(program);
+    if (p == nullptr)
+        return;
+
+    p->attributes.clear();
+    p->uniforms.clear();
+    for (auto shader : p->shaders)
+    {
+        const auto& object = s_shaders[shader];
+        if (object.type == GL_VERTEX_SHADER)
+            collectVariables(object.source, "attribute", &p->attributes);
+        collectVariables(object.source, "uniform", &p->uniforms);
+    }
+
+    // explicitly bound attributes keep their index, the others take the free ones
+    std::unordered_set<GLint> used;
+    for (auto& attribute : p->attributes)
+    {
+        auto iter = p->boundAttribs.find(attribute.name);
+        if (iter != p->boundAttribs.end())
+        {
+            attribute.location = iter->second;
+            used.insert(iter->second);
+        }
+    }
+    GLint next = 0;
+    for (auto& attribute : p->attributes)
+    {
+        if (attribute.location >= 0)
+            continue;
+        while (used.count(next))
+            ++next;
+        attribute.location = next;
+        used.insert(next);
+    }
+
+    GLint location = 0;
+    for (auto& uniform : p->uniforms)
+    {
+        uniform.location = location;
+        location += uniform.size;
+    }
+}
+
+void GLAPIENTRY nullGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    auto p = findProgram(program);
+    if (p == nullptr)
+        return;
+
+    auto maxLength = [](const std::vector<Variable>& variables, size_t suffix) {
+        GLint length = 0;
+        for (const auto& variable : variables)
+            length = std::max(length, (GLint)(variable.name.length() + suffix + 1));
+        return length;
+    };
+
+    switch (pname)
+    {
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+            *params = GL_TRUE;
+            break;
+        case GL_ACTIVE_ATTRIBUTES: *params = (GLint)p->attributes.size(); break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH: *params = maxLength(p->attributes, 0); break;
+        case GL_ACTIVE_UNIFORMS: *params = (GLint)p->uniforms.size(); break;
+        // arrays are reported as "name[0]"
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH: *params = maxLength(p->uniforms, 3); break;
+        case GL_ATTACHED_SHADERS: *params = (GLint)p->shaders.size(); break;
+        default: *params = 0; break;
+    }
+}
+
+void GLAPIENTRY nullGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    copyString("", bufSize, length, infoLog);
+}
+
+void GLAPIENTRY nullDeleteProgram(GLuint program)
+{
+    s_programs.erase(program);
+}
+
+void GLAPIENTRY nullUseProgram(GLuint program)
+{
+    setState(GL_CURRENT_PROGRAM, program);
+    NULLGL_COUNT(programBinds, 1);
+}
+
+void getActiveVariable(const std::vector<Variable>& variables, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    if (index >= variables.size())
+    {
+        s_error = GL_INVALID_VALUE;
+        return;
+    }
+    const auto& variable = variables[index];
+    *size = variable.size;
+    *type = variable.type;
+    copyString(variable.size > 1 ? variable.name + "[0]" : variable.name, bufSize, length, name);
+}
+
+void GLAPIENTRY nullGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    if (auto p = findProgram(program))
+        getActiveVariable(p->attributes, index, bufSize, length, size, type, name);
+}
+
+void GLAPIENTRY nullGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    if (auto p = findProgram(program))
+        getActiveVariable(p->uniforms, index, bufSize, length, size, type, name);
+}
+
+GLint GLAPIENTRY nullGetAttribLocation(GLuint program, const GLchar* name)
+{
+    if (auto p = findProgram(program))
+    {
+        for (const auto& attribute : p->attributes)
+        {
+            if (attribute.name == name)
+                return attribute.location;
+        }
+    }
+    return -1;
+}
+
+GLint GLAPIENTRY nullGetUniformLocation(GLuint program, const GLchar* name)
+{
+    if (auto p = findProgram(program))
+    {
+        std::string key(name);
+        auto bracket = key.find('[');
+        GLint element = 0;
+        if (bracket != std::string::npos)
+        {
+            element = atoi(key.c_str() + bracket + 1);
+            key.resize(bracket);
+        }
+        for (const auto& uniform : p->uniforms)
+        {
+            if (uniform.name == key)
+                return element < uniform.size ? uniform.location + element : -1;
+        }
+    }
+    return -1;
+}
+
+void GLAPIENTRY nullUniform1i(GLint, GLint) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniform2i(GLint, GLint, GLint) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniform3i(GLint, GLint, GLint, GLint) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniform4i(GLint, GLint, GLint, GLint, GLint) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniform1f(GLint, GLfloat) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniform2f(GLint, GLfloat, GLfloat) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniform3f(GLint, GLfloat, GLfloat, GLfloat) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniformiv(GLint, GLsizei, const GLint*) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniformfv(GLint, GLsizei, const GLfloat*) { NULLGL_COUNT(uniformUpdates, 1); }
+void GLAPIENTRY nullUniformMatrixfv(GLint, GLsizei, GLboolean, const GLfloat*) { NULLGL_COUNT(uniformUpdates, 1); }
+
+void GLAPIENTRY nullVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+{
+    NULLGL_COUNT(vertexAttribCalls, 1);
+}
+
+void GLAPIENTRY nullEnableVertexAttribArray(GLuint index)
+{
+    NULLGL_COUNT(vertexAttribCalls, 1);
+}
+
+void GLAPIENTRY nullDisableVertexAttribArray(GLuint index)
+{
+    NULLGL_COUNT(vertexAttribCalls, 1);
+}
+
+void GLAPIENTRY nullGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    genNames(n, framebuffers);
+}
+
+void GLAPIENTRY nullDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+}
+
+void GLAPIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    setState(GL_FRAMEBUFFER_BINDING, framebuffer);
+    NULLGL_COUNT(framebufferBinds, 1);
+}
+
+void GLAPIENTRY nullFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+}
+
+void GLAPIENTRY nullFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+}
+
+GLenum GLAPIENTRY nullCheckFramebufferStatus(GLenum target)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void GLAPIENTRY nullGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    genNames(n, renderbuffers);
+}
+
+void GLAPIENTRY nullDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+}
+
+void GLAPIENTRY nullBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    setState(GL_RENDERBUFFER_BINDING, renderbuffer);
+}
+
+GLboolean GLAPIENTRY nullIsRenderbuffer(GLuint renderbuffer)
+{
+    return renderbuffer != 0 ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY nullRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+}
+
+void GLAPIENTRY nullGenerateMipmap(GLenum target)
+{
+}
+
+} // namespace
+
+void install()
+{
+    // GLEW entry points are plain function pointers, the casts only paper over
+    // const qualifiers which differ between GLEW releases
+#define NULLGL_BIND(__name__, __impl__) __name__ = reinterpret_cast<decltype(__name__)>(&__impl__)
+    NULLGL_BIND(glActiveTexture, nullActiveTexture);
+    NULLGL_BIND(glBlendEquation, nullBlendEquation);
+    NULLGL_BIND(glBlendEquationSeparate, nullBlendEquationSeparate);
+    NULLGL_BIND(glBlendFuncSeparate, nullBlendFuncSeparate);
+    NULLGL_BIND(glBlendColor, nullBlendColor);
+    NULLGL_BIND(glStencilFuncSeparate, nullStencilFuncSeparate);
+    NULLGL_BIND(glStencilOpSeparate, nullStencilOpSeparate);
+    NULLGL_BIND(glStencilMaskSeparate, nullStencilMaskSeparate);
+    NULLGL_BIND(glCompressedTexImage2D, nullCompressedTexImage2D);
+
+    NULLGL_BIND(glGenBuffers, nullGenBuffers);
+    NULLGL_BIND(glDeleteBuffers, nullDeleteBuffers);
+    NULLGL_BIND(glIsBuffer, nullIsBuffer);
+    NULLGL_BIND(glBindBuffer, nullBindBuffer);
+    NULLGL_BIND(glBufferData, nullBufferData);
+    NULLGL_BIND(glBufferSubData, nullBufferSubData);
+    NULLGL_BIND(glMapBuffer, nullMapBuffer);
+    NULLGL_BIND(glUnmapBuffer, nullUnmapBuffer);
+    NULLGL_BIND(glGenVertexArrays, nullGenVertexArrays);
+    NULLGL_BIND(glDeleteVertexArrays, nullDeleteVertexArrays);
+    NULLGL_BIND(glBindVertexArray, nullBindVertexArray);
+
+    NULLGL_BIND(glCreateShader, nullCreateShader);
+    NULLGL_BIND(glShaderSource, nullShaderSource);
+    NULLGL_BIND(glCompileShader, nullCompileShader);
+    NULLGL_BIND(glGetShaderiv, nullGetShaderiv);
+    NULLGL_BIND(glGetShaderInfoLog, nullGetShaderInfoLog);
+    NULLGL_BIND(glGetShaderSource, nullGetShaderSource);
+    NULLGL_BIND(glDeleteShader, nullDeleteShader);
+    NULLGL_BIND(glCreateProgram, nullCreateProgram);
+    NULLGL_BIND(glAttachShader, nullAttachShader);
+    NULLGL_BIND(glDetachShader, nullDetachShader);
+    NULLGL_BIND(glBindAttribLocation, nullBindAttribLocation);
+    NULLGL_BIND(glLinkProgram, nullLinkProgram);
+    NULLGL_BIND(glGetProgramiv, nullGetProgramiv);
+    NULLGL_BIND(glGetProgramInfoLog, nullGetProgramInfoLog);
+    NULLGL_BIND(glDeleteProgram, nullDeleteProgram);
+    NULLGL_BIND(glUseProgram, nullUseProgram);
+    NULLGL_BIND(glGetActiveAttrib, nullGetActiveAttrib);
+    NULLGL_BIND(glGetActiveUniform, nullGetActiveUniform);
+    NULLGL_BIND(glGetAttribLocation, nullGetAttribLocation);
+    NULLGL_BIND(glGetUniformLocation, nullGetUniformLocation);
+
+    NULLGL_BIND(glUniform1i, nullUniform1i);
+    NULLGL_BIND(glUniform2i, nullUniform2i);
+    NULLGL_BIND(glUniform3i, nullUniform3i);
+    NULLGL_BIND(glUniform4i, nullUniform4i);
+    NULLGL_BIND(glUniform1f, nullUniform1f);
+    NULLGL_BIND(glUniform2f, nullUniform2f);
+    NULLGL_BIND(glUniform3f, nullUniform3f);
+    NULLGL_BIND(glUniform4f, nullUniform4f);
+    NULLGL_BIND(glUniform1iv, nullUniformiv);
+    NULLGL_BIND(glUniform2iv, nullUniformiv);
+    NULLGL_BIND(glUniform3iv, nullUniformiv);
+    NULLGL_BIND(glUniform4iv, nullUniformiv);
+    NULLGL_BIND(glUniform1fv, nullUniformfv);
+    NULLGL_BIND(glUniform2fv, nullUniformfv);
+    NULLGL_BIND(glUniform3fv, nullUniformfv);
+    NULLGL_BIND(glUniform4fv, nullUniformfv);
+    NULLGL_BIND(glUniformMatrix2fv, nullUniformMatrixfv);
+    NULLGL_BIND(glUniformMatrix3fv, nullUniformMatrixfv);
+    NULLGL_BIND(glUniformMatrix4fv, nullUniformMatrixfv);
+
+    NULLGL_BIND(glVertexAttribPointer, nullVertexAttribPointer);
+    NULLGL_BIND(glEnableVertexAttribArray, nullEnableVertexAttribArray);
+    NULLGL_BIND(glDisableVertexAttribArray, nullDisableVertexAttribArray);
+
+    NULLGL_BIND(glGenFramebuffers, nullGenFramebuffers);
+    NULLGL_BIND(glDeleteFramebuffers, nullDeleteFramebuffers);
+    NULLGL_BIND(glBindFramebuffer, nullBindFramebuffer);
+    NULLGL_BIND(glFramebufferTexture2D, nullFramebufferTexture2D);
+    NULLGL_BIND(glFramebufferRenderbuffer, nullFramebufferRenderbuffer);
+    NULLGL_BIND(glCheckFramebufferStatus, nullCheckFramebufferStatus);
+    NULLGL_BIND(glGenRenderbuffers, nullGenRenderbuffers);
+    NULLGL_BIND(glDeleteRenderbuffers, nullDeleteRenderbuffers);
+    NULLGL_BIND(glBindRenderbuffer, nullBindRenderbuffer);
+    NULLGL_BIND(glIsRenderbuffer, nullIsRenderbuffer);
+    NULLGL_BIND(glRenderbufferStorage, nullRenderbufferStorage);
+    NULLGL_BIND(glGenerateMipmap, nullGenerateMipmap);
+#undef NULLGL_BIND
+
+    resetState();
+    resetStats();
+    s_installed = true;
+}
+
+bool isInstalled()
+{
+    return s_installed;
+}
+
+void endFrame()
+{
+    s_frameStats = s_currentStats;
+    memset(&s_currentStats, 0, sizeof(s_currentStats));
+}
+
+const Stats& getFrameStats()
+{
+    return s_frameStats;
+}
+
+const Stats& getTotalStats()
+{
+    return s_totalStats;
+}
+
+void resetStats()
+{
+    memset(&s_frameStats, 0, sizeof(s_frameStats));
+    memset(&s_currentStats, 0, sizeof(s_currentStats));
+    memset(&s_totalStats, 0, sizeof(s_totalStats));
+}
+
+} // namespace NullGL
+
+NS_CC_END
+
+//
+// GL 1.1 entry points. They are exported by libGL rather than loaded by GLEW,
+// so they are defined here with C linkage and override libGL at link time.
+//
+
+USING_NS_CC;
+using namespace cocos2d::NullGL;
+
+void GLAPIENTRY glClear(GLbitfield mask)
+{
+    NULLGL_COUNT(clears, 1);
+}
+
+void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    setState(GL_COLOR_CLEAR_VALUE, red, green, blue, alpha, 4);
+}
+
+void GLAPIENTRY glClearDepth(GLclampd depth)
+{
+    setState(GL_DEPTH_CLEAR_VALUE, depth);
+}
+
+void GLAPIENTRY glClearStencil(GLint s)
+{
+    setState(GL_STENCIL_CLEAR_VALUE, s);
+}
+
+void GLAPIENTRY glEnable(GLenum cap)
+{
+    s_enabled.insert(cap);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glDisable(GLenum cap)
+{
+    s_enabled.erase(cap);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+GLboolean GLAPIENTRY glIsEnabled(GLenum cap)
+{
+    return s_enabled.count(cap) ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    setState(GL_BLEND_SRC, sfactor);
+    setState(GL_BLEND_DST, dfactor);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glDepthFunc(GLenum func)
+{
+    setState(GL_DEPTH_FUNC, func);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glDepthMask(GLboolean flag)
+{
+    setState(GL_DEPTH_WRITEMASK, flag);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glDepthRange(GLclampd zNear, GLclampd zFar)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glCullFace(GLenum mode)
+{
+    setState(GL_CULL_FACE_MODE, mode);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glFrontFace(GLenum mode)
+{
+    setState(GL_FRONT_FACE, mode);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    setState(GL_COLOR_WRITEMASK, red, green, blue, alpha, 4);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    setState(GL_STENCIL_FUNC, func);
+    setState(GL_STENCIL_REF, ref);
+    setState(GL_STENCIL_VALUE_MASK, mask);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    setState(GL_STENCIL_FAIL, fail);
+    setState(GL_STENCIL_PASS_DEPTH_FAIL, zfail);
+    setState(GL_STENCIL_PASS_DEPTH_PASS, zpass);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glStencilMask(GLuint mask)
+{
+    setState(GL_STENCIL_WRITEMASK, mask);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glAlphaFunc(GLenum func, GLclampf ref)
+{
+    setState(GL_ALPHA_TEST_FUNC, func);
+    setState(GL_ALPHA_TEST_REF, ref);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    setState(GL_VIEWPORT, x, y, width, height, 4);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    setState(GL_SCISSOR_BOX, x, y, width, height, 4);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glLineWidth(GLfloat width)
+{
+    setState(GL_LINE_WIDTH, width);
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glPointSize(GLfloat size)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glPolygonMode(GLenum face, GLenum mode)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glPolygonOffset(GLfloat factor, GLfloat units)
+{
+    NULLGL_COUNT(stateChanges, 1);
+}
+
+void GLAPIENTRY glHint(GLenum target, GLenum mode)
+{
+}
+
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param)
+{
+    setState(pname, param);
+}
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params)
+{
+    StateValue value;
+    if (!getState(pname, &value))
+    {
+        params[0] = 0;
+        return;
+    }
+    for (int i = 0; i < value.count; ++i)
+        params[i] = (GLint)(long long)value.v[i];
+}
+
+void GLAPIENTRY glGetFloatv(GLenum pname, GLfloat* params)
+{
+    StateValue value;
+    if (!getState(pname, &value))
+    {
+        params[0] = 0;
+        return;
+    }
+    for (int i = 0; i < value.count; ++i)
+        params[i] = (GLfloat)value.v[i];
+}
+
+void GLAPIENTRY glGetBooleanv(GLenum pname, GLboolean* params)
+{
+    StateValue value;
+    if (!getState(pname, &value))
+    {
+        params[0] = GL_FALSE;
+        return;
+    }
+    for (int i = 0; i < value.count; ++i)
+        params[i] = value.v[i] != 0 ? GL_TRUE : GL_FALSE;
+}
+
+const GLubyte* GLAPIENTRY glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VENDOR: return (const GLubyte*)"cocos2d-x";
+        case GL_RENDERER: return (const GLubyte*)"Null GL";
+        case GL_VERSION: return (const GLubyte*)"2.1 Null GL";
+        case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"1.20";
+        case GL_EXTENSIONS:
+            return (const GLubyte*)"GL_ARB_vertex_buffer_object GL_ARB_vertex_array_object "
+                                   "GL_ARB_framebuffer_object GL_ARB_texture_non_power_of_two "
+                                   "GL_EXT_packed_depth_stencil GL_EXT_texture_compression_s3tc "
+                                   "GL_ARB_pixel_buffer_object";
+        default:
+            s_error = GL_INVALID_ENUM;
+            return nullptr;
+    }
+}
+
+GLenum GLAPIENTRY glGetError()
+{
+    GLenum error = s_error;
+    s_error = GL_NO_ERROR;
+    return error;
+}
+
+void GLAPIENTRY glFlush()
+{
+}
+
+void GLAPIENTRY glFinish()
+{
+}
+
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    NULLGL_COUNT(drawCalls, 1);
+    NULLGL_COUNT(drawnVertices, count);
+}
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    NULLGL_COUNT(drawCalls, 1);
+    NULLGL_COUNT(drawnVertices, count);
+}
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+    genNames(n, textures);
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+}
+
+GLboolean GLAPIENTRY glIsTexture(GLuint texture)
+{
+    return texture != 0 ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+    if (target == GL_TEXTURE_2D)
+        setState(GL_TEXTURE_BINDING_2D, texture);
+    NULLGL_COUNT(textureBinds, 1);
+}
+
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    NULLGL_COUNT(textureUploads, 1);
+    NULLGL_COUNT(textureUploadBytes, pixels ? width * height * bytesPerPixel(format, type) : 0);
+}
+
+void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    NULLGL_COUNT(textureUploads, 1);
+    NULLGL_COUNT(textureUploadBytes, width * height * bytesPerPixel(format, type));
+}
+
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+}
+
+void GLAPIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+}
+
+void GLAPIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
+{
+    // reads back a cleared framebuffer, unless a pixel pack buffer receives the data
+    StateValue pack;
+    if (pixels && !(getState(GL_PIXEL_PACK_BUFFER_BINDING, &pack) && pack.v[0] != 0))
+        memset(pixels, 0, width * height * bytesPerPixel(format, type));
+    NULLGL_COUNT(readPixels, 1);
+}
+
+void GLAPIENTRY glEnableClientState(GLenum array)
+{
+}
+
+void GLAPIENTRY glDisableClientState(GLenum array)
+{
+}
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
@@ -0,0 +1,112 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_NULLGL_LINUX_H__
+#define __CC_NULLGL_LINUX_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include <cstddef>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * A GL implementation which records calls instead of executing them.
+ *
+ * It lives in the cocos2d_headless library, never in cocos2d itself: the GL 1.1 entry
+ * points are defined with their real names so they take precedence over libGL for the
+ * executable linking it, and the GLEW function pointers are filled by install().
+ * Object names, shader sources, uniform locations and the queried state are emulated
+ * well enough for the engine to initialize and run without a GPU or a display.
+ */
+namespace NullGL {
+
+/** Counters of the GL work submitted by the engine. */
+struct CC_DLL Stats
+{
+    /** glDrawArrays/glDrawElements calls. */
+    unsigned int drawCalls;
+    /** Vertices (or indices for indexed draws) submitted by the draw calls. */
+    unsigned int drawnVertices;
+    /** glBufferData/glBufferSubData calls and the bytes they uploaded. */
+    unsigned int bufferUploads;
+    size_t bufferUploadBytes;
+    /** glTexImage2D/glTexSubImage2D/glCompressedTexImage2D calls and their bytes. */
+    unsigned int textureUploads;
+    size_t textureUploadBytes;
+    /** Capabilities, blend, depth, stencil, cull, viewport, scissor and mask changes. */
+    unsigned int stateChanges;
+    /** glUseProgram calls. */
+    unsigned int programBinds;
+    /** glBindTexture calls. */
+    unsigned int textureBinds;
+    /** glBindBuffer and glBindVertexArray calls. */
+    unsigned int bufferBinds;
+    /** glUniform* calls. */
+    unsigned int uniformUpdates;
+    /** glVertexAttribPointer and glEnable/DisableVertexAttribArray calls. */
+    unsigned int vertexAttribCalls;
+    /** glClear calls. */
+    unsigned int clears;
+    /** glBindFramebuffer calls. */
+    unsigned int framebufferBinds;
+    /** glReadPixels calls. */
+    unsigned int readPixels;
+};
+
+/** Points the GLEW entry points at the null implementation and resets the emulated state. */
+void CC_DLL install();
+
+/** Whether install() was called. */
+bool CC_DLL isInstalled();
+
+/** Closes the current frame: its counters become getFrameStats() and a new frame starts. */
+void CC_DLL endFrame();
+
+/** Counters of the last frame closed by endFrame(). */
+const Stats& CC_DLL getFrameStats();
+
+/** Counters accumulated since install() or the last resetStats(). */
+const Stats& CC_DLL getTotalStats();
+
+/** Clears the frame and the total counters. */
+void CC_DLL resetStats();
+
+} // namespace NullGL
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CC_NULLGL_LINUX_H__
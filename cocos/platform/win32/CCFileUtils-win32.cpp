@@ -277,12 +277,15 @@ static Data getData(const std::string& filename, bool forString)
     size_t size = 0;
     do
     {
-        // read the file from hardware
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+        Data packaged = FileUtils::getInstance()->getDataFromPackage(fullPath, forString);
+        if (!packaged.isNull())
+            return packaged;
 
         // check if the filename uses correct case characters
         checkFileName(fullPath, filename);
 
+        // read the file from hardware
         HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
         CC_BREAK_IF(fileHandle == INVALID_HANDLE_VALUE);
 
@@ -359,12 +362,21 @@ unsigned char* FileUtilsWin32::getFileData(const std::string& filename, const ch
     *size = 0;
     do
     {
-        // read the file from hardware
         std::string fullPath = fullPathForFilename(filename);
+        if (isFileInPackage(fullPath))
+        {
+            // null terminated data is always a buffer of its own, which the caller frees
+            Data packaged = getDataFromPackage(fullPath, true);
+            pBuffer = packaged.getBytes();
+            *size = packaged.getSize();
+            packaged.fastSet(nullptr, 0);
+            break;
+        }
 
          // check if the filename uses correct case characters
         checkFileName(fullPath, filename);
 
+        // read the file from hardware
         HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
         CC_BREAK_IF(fileHandle == INVALID_HANDLE_VALUE);
 
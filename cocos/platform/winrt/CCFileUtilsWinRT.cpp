@@ -368,8 +368,12 @@ static Data getData(const std::string& filename, bool forString)
 
     do
     {
-        // Read the file from hardware
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+        Data packaged = FileUtils::getInstance()->getDataFromPackage(fullPath, forString);
+        if (!packaged.isNull())
+            return packaged;
+
+        // Read the file from hardware
         FILE *fp = fopen(fullPath.c_str(), mode);
         CC_BREAK_IF(!fp);
         fseek(fp,0,SEEK_END);
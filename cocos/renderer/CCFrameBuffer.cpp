@@ -28,6 +28,7 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "renderer/CCRenderThread.h"
 
 NS_CC_BEGIN
 namespace experimental{
@@ -150,6 +151,7 @@ RenderTargetRenderBuffer::RenderTargetRenderBuffer()
 
 RenderTargetRenderBuffer::~RenderTargetRenderBuffer()
 {
+    ScopedGLContext context;
     if(glIsRenderbuffer(_colorBuffer))
     {
         glDeleteRenderbuffers(1, &_colorBuffer);
@@ -162,6 +164,7 @@ RenderTargetRenderBuffer::~RenderTargetRenderBuffer()
 
 bool RenderTargetRenderBuffer::init(unsigned int width, unsigned int height)
 {
+    ScopedGLContext context;
     if(!RenderTargetBase::init(width, height)) return false;
     GLint oldRenderBuffer(0);
     glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRenderBuffer);
@@ -221,6 +224,7 @@ RenderTargetDepthStencil::RenderTargetDepthStencil()
 
 RenderTargetDepthStencil::~RenderTargetDepthStencil()
 {
+    ScopedGLContext context;
     if(glIsRenderbuffer(_depthStencilBuffer))
     {
         glDeleteRenderbuffers(1, &_depthStencilBuffer);
@@ -233,6 +237,7 @@ RenderTargetDepthStencil::~RenderTargetDepthStencil()
 
 bool RenderTargetDepthStencil::init(unsigned int width, unsigned int height)
 {
+    ScopedGLContext context;
     if(!RenderTargetBase::init(width, height)) return false;
     GLint oldRenderBuffer(0);
     glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRenderBuffer);
@@ -347,6 +352,7 @@ FrameBuffer* FrameBuffer::create(uint8_t fid, unsigned int width, unsigned int h
 
 bool FrameBuffer::init(uint8_t fid, unsigned int width, unsigned int height)
 {
+    ScopedGLContext context;
     _fid = fid;
     _width = width;
     _height = height;
@@ -397,6 +403,7 @@ FrameBuffer::FrameBuffer()
 
 FrameBuffer::~FrameBuffer()
 {
+    ScopedGLContext context;
     if(!isDefaultFBO())
     {
         CC_SAFE_RELEASE_NULL(_rt);
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/uthash.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/CCRenderThread.h"
 #include "platform/CCFileUtils.h"
 
 #include "deprecated/CCString.h"
@@ -181,6 +182,7 @@ GLProgram::GLProgram()
 , _vertShader(0)
 , _fragShader(0)
 , _flags()
+, _uniformsOwner(0)
 {
     _director = Director::getInstance();
     CCASSERT(nullptr != _director, "Director is null when init a GLProgram");
@@ -189,6 +191,7 @@ GLProgram::GLProgram()
 
 GLProgram::~GLProgram()
 {
+    ScopedGLContext context;
     CCLOGINFO("%s %d deallocing GLProgram: %p", __FUNCTION__, __LINE__, this);
 
     if (_vertShader)
@@ -222,6 +225,7 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
 
 bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray, const std::string& compileTimeDefines)
 {
+    ScopedGLContext context;
     _program = glCreateProgram();
     CHECK_GL_ERROR_DEBUG();
 
@@ -263,6 +267,7 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     }
 
     _hashForUniforms.clear();
+    _uniformsOwner = 0;
 
     CHECK_GL_ERROR_DEBUG();
 
@@ -484,21 +489,25 @@ bool GLProgram::compileShader(GLuint* shader, GLenum type, const GLchar* source,
 
 GLint GLProgram::getAttribLocation(const std::string &attributeName) const
 {
+    ScopedGLContext context;
     return glGetAttribLocation(_program, attributeName.c_str());
 }
 
 GLint GLProgram::getUniformLocation(const std::string &attributeName) const
 {
+    ScopedGLContext context;
     return glGetUniformLocation(_program, attributeName.c_str());
 }
 
 void GLProgram::bindAttribLocation(const std::string &attributeName, GLuint index) const
 {
+    ScopedGLContext context;
     glBindAttribLocation(_program, index, attributeName.c_str());
 }
 
 void GLProgram::updateUniforms()
 {
+    ScopedGLContext context;
     _builtInUniforms[UNIFORM_AMBIENT_COLOR] = glGetUniformLocation(_program, UNIFORM_NAME_AMBIENT_COLOR);
     _builtInUniforms[UNIFORM_P_MATRIX] = glGetUniformLocation(_program, UNIFORM_NAME_P_MATRIX);
     _builtInUniforms[UNIFORM_MV_MATRIX] = glGetUniformLocation(_program, UNIFORM_NAME_MV_MATRIX);
@@ -542,6 +551,7 @@ void GLProgram::updateUniforms()
 
 bool GLProgram::link()
 {
+    ScopedGLContext context;
     CCASSERT(_program != 0, "Cannot link invalid program");
 
     GLint status = GL_TRUE;
@@ -672,11 +682,16 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         }
     }
 
+    if (updated)
+        _uniformsOwner = 0;
+
+    GL::countStateCall(GL::STATE_CALL_UNIFORM, updated);
     return updated;
 }
 
 GLint GLProgram::getUniformLocationForName(const char* name) const
 {
+    ScopedGLContext context;
     CCASSERT(name != nullptr, "Invalid uniform name" );
     CCASSERT(_program != 0, "Invalid operation. Cannot get uniform location when program is not initialized");
 
@@ -876,6 +891,8 @@ void GLProgram::setUniformsForBuiltins()
 
 void GLProgram::setUniformsForBuiltins(const Mat4 &matrixMV)
 {
+    // built-ins never share a location with the user defined uniforms
+    auto uniformsOwner = _uniformsOwner;
     auto& matrixP = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
 
     if (_flags.usesP)
@@ -915,6 +932,8 @@ void GLProgram::setUniformsForBuiltins(const Mat4 &matrixMV)
 
     if (_flags.usesRandom)
         setUniformLocationWith4f(_builtInUniforms[GLProgram::UNIFORM_RANDOM01], CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1());
+
+    _uniformsOwner = uniformsOwner;
 }
 
 void GLProgram::reset()
@@ -933,6 +952,7 @@ void GLProgram::reset()
     }
 
     _hashForUniforms.clear();
+    _uniformsOwner = 0;
 }
 
 NS_CC_END
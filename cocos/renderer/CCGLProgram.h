@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "base/ccMacros.h"
 #include "base/CCRef.h"
@@ -519,6 +520,10 @@ protected:
     std::unordered_map<std::string, VertexAttrib> _vertexAttribs;
     /**Hash value of uniforms for quick access.*/
     std::unordered_map<GLint, std::pair<GLvoid*, unsigned int>> _hashForUniforms;
+    /**Id of the GLProgramState whose values the user defined uniforms still hold, 0 if none.*/
+    unsigned int _uniformsOwner;
+    /**Versions of the values of that GLProgramState the user defined uniforms hold, by slot of the state.*/
+    std::vector<unsigned int> _uniformVersions;
     //cached director pointer for calling
     Director* _director;
 };
@@ -28,6 +28,8 @@ THE SOFTWARE.
 
 #include "renderer/CCGLProgramState.h"
 
+#include <algorithm>
+
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCGLProgramCache.h"
@@ -46,6 +48,8 @@ NS_CC_BEGIN
 // static vector with all the registered custom binding resolvers
 std::vector<GLProgramState::AutoBindingResolver*> GLProgramState::_customAutoBindingResolvers;
 
+unsigned int GLProgramState::s_nextId = 0;
+
 //
 //
 // UniformValue
@@ -56,6 +60,9 @@ UniformValue::UniformValue()
 : _uniform(nullptr)
 , _glprogram(nullptr)
 , _type(Type::VALUE)
+, _version(0)
+// zeroed, the setters compare the new value with it
+, _value()
 {
 }
 
@@ -63,6 +70,8 @@ UniformValue::UniformValue(Uniform *uniform, GLProgram* glprogram)
 : _uniform(uniform)
 , _glprogram(glprogram)
 , _type(Type::VALUE)
+, _version(0)
+, _value()
 {
 }
 
@@ -159,27 +168,40 @@ void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &
 	*_value.callback = callback;
 
     _type = Type::CALLBACK_FN;
+    ++_version;
 }
 
 void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
 {
     //CCASSERT(_uniform->type == GL_SAMPLER_2D, "Wrong type. expecting GL_SAMPLER_2D");
-    _value.tex.textureId = textureId;
-    _value.tex.textureUnit = textureUnit;
-    _type = Type::VALUE;
+    if (_type != Type::VALUE || _value.tex.textureId != textureId || _value.tex.textureUnit != textureUnit)
+    {
+        _value.tex.textureId = textureId;
+        _value.tex.textureUnit = textureUnit;
+        _type = Type::VALUE;
+        ++_version;
+    }
 }
 void UniformValue::setInt(int value)
 {
     CCASSERT(_uniform->type == GL_INT, "Wrong type: expecting GL_INT");
-    _value.intValue = value;
-    _type = Type::VALUE;
+    if (_type != Type::VALUE || _value.intValue != value)
+    {
+        _value.intValue = value;
+        _type = Type::VALUE;
+        ++_version;
+    }
 }
 
 void UniformValue::setFloat(float value)
 {
     CCASSERT(_uniform->type == GL_FLOAT, "Wrong type: expecting GL_FLOAT");
-    _value.floatValue = value;
-    _type = Type::VALUE;
+    if (_type != Type::VALUE || _value.floatValue != value)
+    {
+        _value.floatValue = value;
+        _type = Type::VALUE;
+        ++_version;
+    }
 }
 
 void UniformValue::setFloatv(ssize_t size, const float* pointer)
@@ -188,13 +210,18 @@ void UniformValue::setFloatv(ssize_t size, const float* pointer)
     _value.floatv.pointer = (const float*)pointer;
     _value.floatv.size = (GLsizei)size;
     _type = Type::POINTER;
+    ++_version;
 }
 
 void UniformValue::setVec2(const Vec2& value)
 {
     CCASSERT(_uniform->type == GL_FLOAT_VEC2, "Wrong type: expecting GL_FLOAT_VEC2");
-	memcpy(_value.v2Value, &value, sizeof(_value.v2Value));
-    _type = Type::VALUE;
+    if (_type != Type::VALUE || memcmp(_value.v2Value, &value, sizeof(_value.v2Value)) != 0)
+    {
+        memcpy(_value.v2Value, &value, sizeof(_value.v2Value));
+        _type = Type::VALUE;
+        ++_version;
+    }
 }
 
 void UniformValue::setVec2v(ssize_t size, const Vec2* pointer)
@@ -203,14 +230,18 @@ void UniformValue::setVec2v(ssize_t size, const Vec2* pointer)
     _value.v2f.pointer = (const float*)pointer;
     _value.v2f.size = (GLsizei)size;
     _type = Type::POINTER;
+    ++_version;
 }
 
 void UniformValue::setVec3(const Vec3& value)
 {
     CCASSERT(_uniform->type == GL_FLOAT_VEC3, "Wrong type: expecting GL_FLOAT_VEC3");
-	memcpy(_value.v3Value, &value, sizeof(_value.v3Value));
-    _type = Type::VALUE;
-
+    if (_type != Type::VALUE || memcmp(_value.v3Value, &value, sizeof(_value.v3Value)) != 0)
+    {
+        memcpy(_value.v3Value, &value, sizeof(_value.v3Value));
+        _type = Type::VALUE;
+        ++_version;
+    }
 }
 
 void UniformValue::setVec3v(ssize_t size, const Vec3* pointer)
@@ -219,14 +250,18 @@ void UniformValue::setVec3v(ssize_t size, const Vec3* pointer)
     _value.v3f.pointer = (const float*)pointer;
     _value.v3f.size = (GLsizei)size;
     _type = Type::POINTER;
-
+    ++_version;
 }
 
 void UniformValue::setVec4(const Vec4& value)
 {
     CCASSERT (_uniform->type == GL_FLOAT_VEC4, "Wrong type: expecting GL_FLOAT_VEC4");
-	memcpy(_value.v4Value, &value, sizeof(_value.v4Value));
-    _type = Type::VALUE;
+    if (_type != Type::VALUE || memcmp(_value.v4Value, &value, sizeof(_value.v4Value)) != 0)
+    {
+        memcpy(_value.v4Value, &value, sizeof(_value.v4Value));
+        _type = Type::VALUE;
+        ++_version;
+    }
 }
 
 void UniformValue::setVec4v(ssize_t size, const Vec4* pointer)
@@ -235,13 +270,18 @@ void UniformValue::setVec4v(ssize_t size, const Vec4* pointer)
     _value.v4f.pointer = (const float*)pointer;
     _value.v4f.size = (GLsizei)size;
     _type = Type::POINTER;
+    ++_version;
 }
 
 void UniformValue::setMat4(const Mat4& value)
 {
     CCASSERT(_uniform->type == GL_FLOAT_MAT4, "_uniform's type should be equal GL_FLOAT_MAT4.");
-	memcpy(_value.matrixValue, &value, sizeof(_value.matrixValue));
-    _type = Type::VALUE;
+    if (_type != Type::VALUE || memcmp(_value.matrixValue, &value, sizeof(_value.matrixValue)) != 0)
+    {
+        memcpy(_value.matrixValue, &value, sizeof(_value.matrixValue));
+        _type = Type::VALUE;
+        ++_version;
+    }
 }
 
 //
@@ -363,6 +403,7 @@ GLProgramState::GLProgramState()
 , _vertexAttribsFlags(0)
 , _glprogram(nullptr)
 , _nodeBinding(nullptr)
+, _id(++s_nextId)
 {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     /** listen the event that renderer was recreated on Android/WP8 */
@@ -401,6 +442,7 @@ GLProgramState* GLProgramState::clone() const
     // copy uniforms
     glprogramstate->_uniformsByName = this->_uniformsByName;
     glprogramstate->_uniforms = this->_uniforms;
+    glprogramstate->_uniformLocations = this->_uniformLocations;
     glprogramstate->_uniformAttributeValueDirty = this->_uniformAttributeValueDirty;
 
     // copy textures
@@ -430,10 +472,19 @@ bool GLProgramState::init(GLProgram* glprogram)
         _attributes[attrib.first] = value;
     }
 
-    for(auto &uniform : _glprogram->_userUniforms) {
-        UniformValue value(&uniform.second, _glprogram);
-        _uniforms[uniform.second.location] = value;
-        _uniformsByName[uniform.first] = uniform.second.location;
+    // sorted by location, so that the setters taking a location can binary search it
+    std::vector<Uniform*> uniforms;
+    for(auto &uniform : _glprogram->_userUniforms)
+        uniforms.push_back(&uniform.second);
+    std::sort(uniforms.begin(), uniforms.end(), [](const Uniform* a, const Uniform* b) { return a->location < b->location; });
+
+    // reserved once, the values own their callbacks and must not be moved around
+    _uniforms.reserve(uniforms.size());
+    _uniformLocations.reserve(uniforms.size());
+    for(auto uniform : uniforms) {
+        _uniformsByName[uniform->name] = (int)_uniforms.size();
+        _uniformLocations.push_back(uniform->location);
+        _uniforms.emplace_back(uniform, _glprogram);
     }
 
     return true;
@@ -444,6 +495,8 @@ void GLProgramState::resetGLProgram()
     CC_SAFE_RELEASE(_glprogram);
     _glprogram = nullptr;
     _uniforms.clear();
+    _uniformLocations.clear();
+    _uniformsByName.clear();
     _attributes.clear();
     // first texture is GL_TEXTURE1
     _textureUnitIndex = 1;
@@ -464,9 +517,12 @@ void GLProgramState::updateUniformsAndAttributes()
     CCASSERT(_glprogram, "invalid glprogram");
     if(_uniformAttributeValueDirty)
     {
-        for(auto& uniformLocation : _uniformsByName)
+        // the program was linked again from the same sources, the locations did not move
+        for(auto& uniformSlot : _uniformsByName)
         {
-            _uniforms[uniformLocation.second]._uniform = _glprogram->getUniform(uniformLocation.first);
+            auto& value = _uniforms[uniformSlot.second];
+            value._uniform = _glprogram->getUniform(uniformSlot.first);
+            ++value._version;
         }
         
         _vertexAttribsFlags = 0;
@@ -511,9 +567,47 @@ void GLProgramState::applyUniforms()
 {
     // set uniforms
     updateUniformsAndAttributes();
-    for(auto& uniform : _uniforms) {
-        uniform.second.apply();
+
+    // the program still holds the values this state applied last time, only the changed ones are sent again.
+    // pointers and callbacks are always applied, what they refer to may have changed.
+    bool upToDate = _glprogram->_uniformsOwner == _id;
+    auto& versions = _glprogram->_uniformVersions;
+    versions.resize(_uniforms.size());
+    for(size_t i = 0; i < _uniforms.size(); ++i) {
+        auto& uniform = _uniforms[i];
+        if (upToDate && versions[i] == uniform._version && uniform._type == UniformValue::Type::VALUE)
+        {
+            // texture units are shared by all the programs
+            if (uniform._uniform->type == GL_SAMPLER_2D)
+                GL::bindTexture2DN(uniform._value.tex.textureUnit, uniform._value.tex.textureId);
+            else if (uniform._uniform->type == GL_SAMPLER_CUBE)
+                GL::bindTextureN(uniform._value.tex.textureUnit, uniform._value.tex.textureId, GL_TEXTURE_CUBE_MAP);
+        }
+        else
+        {
+            // taken before the upload, a value set meanwhile has a newer version and is sent next time
+            versions[i] = uniform._version;
+            uniform.apply();
+        }
+    }
+    _glprogram->_uniformsOwner = _id;
+}
+
+bool GLProgramState::copyUniformValuesTo(GLProgramState* copy) const
+{
+    for(const auto& uniform : _uniforms) {
+        if (uniform._type != UniformValue::Type::VALUE)
+            return false;
+    }
+
+    copy->setGLProgram(_glprogram);
+    // the copy stands for this state, so that the program does not upload again the values it already holds
+    copy->_id = _id;
+    for(size_t i = 0; i < _uniforms.size(); ++i) {
+        copy->_uniforms[i]._value = _uniforms[i]._value;
+        copy->_uniforms[i]._version = _uniforms[i]._version;
     }
+    return true;
 }
 
 void GLProgramState::setGLProgram(GLProgram *glprogram)
@@ -536,12 +630,20 @@ ssize_t GLProgramState::getVertexAttribCount() const
     return _attributes.size();
 }
 
+GLint GLProgramState::getUniformLocation(const std::string& uniformName) const
+{
+    const auto itr = _uniformsByName.find(uniformName);
+    if (itr != _uniformsByName.end())
+        return _uniformLocations[itr->second];
+    return -1;
+}
+
 UniformValue* GLProgramState::getUniformValue(GLint uniformLocation)
 {
     updateUniformsAndAttributes();
-    const auto itr = _uniforms.find(uniformLocation);
-    if (itr != _uniforms.end())
-        return &itr->second;
+    const auto itr = std::lower_bound(_uniformLocations.begin(), _uniformLocations.end(), uniformLocation);
+    if (itr != _uniformLocations.end() && *itr == uniformLocation)
+        return &_uniforms[itr - _uniformLocations.begin()];
     return nullptr;
 }
 
@@ -121,6 +121,8 @@ protected:
     GLProgram* _glprogram;
     /** What kind of type is the Uniform */
     Type _type;
+    /** Incremented every time the value changes, compared with the version the GLProgram uploaded last. */
+    unsigned int _version;
 
     /**
      @name Uniform Value Uniform
@@ -240,6 +242,7 @@ protected:
 class CC_DLL GLProgramState : public Ref
 {
     friend class GLProgramStateCache;
+    friend class Renderer;
 public:
 
     /** returns a new instance of GLProgramState for a given GLProgram */
@@ -298,6 +301,14 @@ public:
     
     /**Get the number of user defined uniform count.*/
     ssize_t getUniformCount() const { return _uniforms.size(); }
+
+    /**
+     Get the location of a user defined uniform without querying OpenGL.
+     The location can be kept and passed to the setters below instead of the name, which skips the name lookup.
+     @param uniformName The uniform string name in the shader.
+     @return The location, or -1 if the shader has no such uniform.
+     */
+    GLint getUniformLocation(const std::string& uniformName) const;
     
     /** @{
      Setting user defined uniforms by uniform string name in the shader.
@@ -319,6 +330,7 @@ public:
     
     /** @{
      Setting user defined uniforms by uniform location in the shader.
+     These are the ones to use in code running every frame, @see getUniformLocation().
      */
     void setUniformInt(GLint uniformLocation, int value);
     void setUniformFloat(GLint uniformLocation, float value);
@@ -444,11 +456,16 @@ protected:
     VertexAttribValue* getVertexAttribValue(const std::string& attributeName);
     UniformValue* getUniformValue(const std::string& uniformName);
     UniformValue* getUniformValue(GLint uniformLocation);
+    // copies the values of the user defined uniforms for a frame recorded by the Renderer,
+    // false if some of them are pointers or callbacks
+    bool copyUniformValuesTo(GLProgramState* copy) const;
 
 
     bool _uniformAttributeValueDirty;
-    std::unordered_map<std::string, GLint> _uniformsByName;
-    std::unordered_map<GLint, UniformValue> _uniforms;
+    // one slot per user defined uniform, sorted by location
+    std::vector<UniformValue> _uniforms;
+    std::vector<GLint> _uniformLocations;
+    std::unordered_map<std::string, int> _uniformsByName;
     std::unordered_map<std::string, VertexAttribValue> _attributes;
     std::unordered_map<std::string, int> _boundTextureUnits;
 
@@ -458,6 +475,10 @@ protected:
 
     Node* _nodeBinding; // weak ref
 
+    // identifies the state in GLProgram::_uniformsOwner, never reused
+    unsigned int _id;
+    static unsigned int s_nextId;
+
     // contains uniform name and variable
     std::unordered_map<std::string, std::string> _autoBindings;
 
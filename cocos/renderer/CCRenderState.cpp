@@ -230,9 +230,9 @@ void RenderState::StateBlock::bindNoRestore()
     if ((_bits & RS_BLEND) && (_blendEnabled != _defaultState->_blendEnabled))
     {
         if (_blendEnabled)
-            glEnable(GL_BLEND);
+            GL::enable(GL_BLEND);
         else
-            glDisable(GL_BLEND);
+            GL::disable(GL_BLEND);
         _defaultState->_blendEnabled = _blendEnabled;
     }
     if ((_bits & RS_BLEND_FUNC) && (_blendSrc != _defaultState->_blendSrc || _blendDst != _defaultState->_blendDst))
@@ -244,45 +244,45 @@ void RenderState::StateBlock::bindNoRestore()
     if ((_bits & RS_CULL_FACE) && (_cullFaceEnabled != _defaultState->_cullFaceEnabled))
     {
         if (_cullFaceEnabled)
-            glEnable(GL_CULL_FACE);
+            GL::enable(GL_CULL_FACE);
         else
-            glDisable(GL_CULL_FACE);
+            GL::disable(GL_CULL_FACE);
         _defaultState->_cullFaceEnabled = _cullFaceEnabled;
     }
     if ((_bits & RS_CULL_FACE_SIDE) && (_cullFaceSide != _defaultState->_cullFaceSide))
     {
-        glCullFace((GLenum)_cullFaceSide);
+        GL::cullFace((GLenum)_cullFaceSide);
         _defaultState->_cullFaceSide = _cullFaceSide;
     }
     if ((_bits & RS_FRONT_FACE) && (_frontFace != _defaultState->_frontFace))
     {
-        glFrontFace((GLenum)_frontFace);
+        GL::frontFace((GLenum)_frontFace);
         _defaultState->_frontFace = _frontFace;
     }
     if ((_bits & RS_DEPTH_TEST) && (_depthTestEnabled != _defaultState->_depthTestEnabled))
     {
         if (_depthTestEnabled)
-            glEnable(GL_DEPTH_TEST);
+            GL::enable(GL_DEPTH_TEST);
         else
-            glDisable(GL_DEPTH_TEST);
+            GL::disable(GL_DEPTH_TEST);
         _defaultState->_depthTestEnabled = _depthTestEnabled;
     }
     if ((_bits & RS_DEPTH_WRITE) && (_depthWriteEnabled != _defaultState->_depthWriteEnabled))
     {
-        glDepthMask(_depthWriteEnabled ? GL_TRUE : GL_FALSE);
+        GL::depthMask(_depthWriteEnabled ? GL_TRUE : GL_FALSE);
         _defaultState->_depthWriteEnabled = _depthWriteEnabled;
     }
     if ((_bits & RS_DEPTH_FUNC) && (_depthFunction != _defaultState->_depthFunction))
     {
-        glDepthFunc((GLenum)_depthFunction);
+        GL::depthFunc((GLenum)_depthFunction);
         _defaultState->_depthFunction = _depthFunction;
     }
 //    if ((_bits & RS_STENCIL_TEST) && (_stencilTestEnabled != _defaultState->_stencilTestEnabled))
 //    {
 //        if (_stencilTestEnabled)
-//            glEnable(GL_STENCIL_TEST);
+//            GL::enable(GL_STENCIL_TEST);
 //        else
-//            glDisable(GL_STENCIL_TEST);
+//            GL::disable(GL_STENCIL_TEST);
 //        _defaultState->_stencilTestEnabled = _stencilTestEnabled;
 //    }
 //    if ((_bits & RS_STENCIL_WRITE) && (_stencilWrite != _defaultState->_stencilWrite))
@@ -326,7 +326,7 @@ void RenderState::StateBlock::restore(long stateOverrideBits)
     // Restore any state that is not overridden and is not default
     if (!(stateOverrideBits & RS_BLEND) && (_defaultState->_bits & RS_BLEND))
     {
-        glEnable(GL_BLEND);
+        GL::enable(GL_BLEND);
         _defaultState->_bits &= ~RS_BLEND;
         _defaultState->_blendEnabled = true;
     }
@@ -339,43 +339,43 @@ void RenderState::StateBlock::restore(long stateOverrideBits)
     }
     if (!(stateOverrideBits & RS_CULL_FACE) && (_defaultState->_bits & RS_CULL_FACE))
     {
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         _defaultState->_bits &= ~RS_CULL_FACE;
         _defaultState->_cullFaceEnabled = false;
     }
     if (!(stateOverrideBits & RS_CULL_FACE_SIDE) && (_defaultState->_bits & RS_CULL_FACE_SIDE))
     {
-        glCullFace((GLenum)GL_BACK);
+        GL::cullFace((GLenum)GL_BACK);
         _defaultState->_bits &= ~RS_CULL_FACE_SIDE;
         _defaultState->_cullFaceSide = RenderState::CULL_FACE_SIDE_BACK;
     }
     if (!(stateOverrideBits & RS_FRONT_FACE) && (_defaultState->_bits & RS_FRONT_FACE))
     {
-        glFrontFace((GLenum)GL_CCW);
+        GL::frontFace((GLenum)GL_CCW);
         _defaultState->_bits &= ~RS_FRONT_FACE;
         _defaultState->_frontFace = RenderState::FRONT_FACE_CCW;
     }
     if (!(stateOverrideBits & RS_DEPTH_TEST) && (_defaultState->_bits & RS_DEPTH_TEST))
     {
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_DEPTH_TEST);
         _defaultState->_bits &= ~RS_DEPTH_TEST;
         _defaultState->_depthTestEnabled = true;
     }
     if (!(stateOverrideBits & RS_DEPTH_WRITE) && (_defaultState->_bits & RS_DEPTH_WRITE))
     {
-        glDepthMask(GL_FALSE);
+        GL::depthMask(GL_FALSE);
         _defaultState->_bits &= ~RS_DEPTH_WRITE;
         _defaultState->_depthWriteEnabled = false;
     }
     if (!(stateOverrideBits & RS_DEPTH_FUNC) && (_defaultState->_bits & RS_DEPTH_FUNC))
     {
-        glDepthFunc((GLenum)GL_LESS);
+        GL::depthFunc((GLenum)GL_LESS);
         _defaultState->_bits &= ~RS_DEPTH_FUNC;
         _defaultState->_depthFunction = RenderState::DEPTH_LESS;
     }
 //    if (!(stateOverrideBits & RS_STENCIL_TEST) && (_defaultState->_bits & RS_STENCIL_TEST))
 //    {
-//        glDisable(GL_STENCIL_TEST);
+//        GL::disable(GL_STENCIL_TEST);
 //        _defaultState->_bits &= ~RS_STENCIL_TEST;
 //        _defaultState->_stencilTestEnabled = false;
 //    }
@@ -412,7 +412,7 @@ void RenderState::StateBlock::enableDepthWrite()
     // next frame leaves depth writing disabled.
     if (!_defaultState->_depthWriteEnabled)
     {
-        glDepthMask(GL_TRUE);
+        GL::depthMask(GL_TRUE);
         _defaultState->_bits &= ~RS_DEPTH_WRITE;
         _defaultState->_depthWriteEnabled = true;
     }
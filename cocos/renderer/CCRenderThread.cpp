@@ -0,0 +1,231 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderThread.h"
+
+#include <algorithm>
+
+#include "platform/CCGLView.h"
+
+NS_CC_BEGIN
+
+static float toSeconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<float>(duration).count();
+}
+
+RenderThread* RenderThread::s_runningInstance = nullptr;
+
+RenderThread::RenderThread(Renderer* renderer, GLView* glview)
+: _renderer(renderer)
+, _glview(glview)
+, _recordingFrame(0)
+, _submittedFrame(nullptr)
+, _contextDepth(0)
+, _quit(false)
+{
+    CCASSERT(s_runningInstance == nullptr, "Only one render thread can run");
+    s_runningInstance = this;
+
+    _glview->retain();
+    resetStats();
+
+    _thread = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+
+    _glview->makeContextCurrent(true);
+    _glview->release();
+
+    s_runningInstance = nullptr;
+}
+
+void RenderThread::beginFrame()
+{
+    // drawn already, submitFrame() waited for it before submitting the other frame
+    auto frame = &_frames[_recordingFrame];
+    frame->reset();
+
+    _recordingStart = Clock::now();
+    _renderer->beginFrame(frame);
+}
+
+void RenderThread::submitFrame()
+{
+    _renderer->endFrame();
+    auto frame = &_frames[_recordingFrame];
+    _recordingFrame = 1 - _recordingFrame;
+
+    auto waitStart = Clock::now();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return _submittedFrame == nullptr; });
+
+    _submittedFrame = frame;
+    _submittedStart = _recordingStart;
+    _condition.notify_all();
+
+    // the commands of the frame are still read from the nodes
+    if (!frame->isDetached())
+    {
+        _condition.wait(lock, [this]() { return _submittedFrame == nullptr; });
+    }
+
+    _totalWaitTime += Clock::now() - waitStart;
+    ++_submittedFrames;
+}
+
+void RenderThread::finish()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return _submittedFrame == nullptr; });
+}
+
+RenderThread::Stats RenderThread::getStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Stats stats;
+    stats.renderedFrames = _renderedFrames;
+    stats.overlappedFrames = _overlappedFrames;
+    stats.lastLatency = toSeconds(_lastLatency);
+    stats.averageLatency = _renderedFrames ? toSeconds(_totalLatency) / _renderedFrames : 0;
+    stats.maxLatency = toSeconds(_maxLatency);
+    stats.averageRenderTime = _renderedFrames ? toSeconds(_totalRenderTime) / _renderedFrames : 0;
+    stats.averageWaitTime = _submittedFrames ? toSeconds(_totalWaitTime) / _submittedFrames : 0;
+
+    float elapsed = toSeconds(Clock::now() - _statsStart);
+    stats.framesPerSecond = elapsed > 0 ? _renderedFrames / elapsed : 0;
+    return stats;
+}
+
+void RenderThread::resetStats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _statsStart = Clock::now();
+    _renderedFrames = 0;
+    _overlappedFrames = 0;
+    _submittedFrames = 0;
+    _lastLatency = Clock::duration::zero();
+    _totalLatency = Clock::duration::zero();
+    _maxLatency = Clock::duration::zero();
+    _totalRenderTime = Clock::duration::zero();
+    _totalWaitTime = Clock::duration::zero();
+}
+
+void RenderThread::acquireContext()
+{
+    auto self = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_contextOwner == self)
+    {
+        ++_contextDepth;
+        return;
+    }
+
+    // GL objects updated or deleted by the main thread may be used by the submitted frame
+    _condition.wait(lock, [this]() { return _contextOwner == std::thread::id() && _submittedFrame == nullptr; });
+    _contextOwner = self;
+    _contextDepth = 1;
+    lock.unlock();
+
+    _glview->makeContextCurrent(true);
+}
+
+void RenderThread::releaseContext()
+{
+    CCASSERT(_contextOwner == std::this_thread::get_id(), "The context is not owned by this thread");
+    if (--_contextDepth > 0)
+        return;
+
+    _glview->makeContextCurrent(false);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _contextOwner = std::thread::id();
+    }
+    _condition.notify_all();
+}
+
+void RenderThread::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;)
+    {
+        _condition.wait(lock, [this]() {
+            return (_submittedFrame && _contextOwner == std::thread::id()) || (_quit && _submittedFrame == nullptr);
+        });
+        if (_submittedFrame == nullptr)
+            break;
+
+        auto frame = _submittedFrame;
+        _contextOwner = std::this_thread::get_id();
+        _contextDepth = 1;
+        lock.unlock();
+
+        auto renderStart = Clock::now();
+        _glview->makeContextCurrent(true);
+        _renderer->renderFrame(frame);
+        _glview->swapBuffers();
+        _glview->makeContextCurrent(false);
+        auto renderEnd = Clock::now();
+
+        lock.lock();
+        _contextOwner = std::thread::id();
+        _contextDepth = 0;
+
+        ++_renderedFrames;
+        if (frame->isDetached())
+            ++_overlappedFrames;
+        _lastLatency = renderEnd - _submittedStart;
+        _totalLatency += _lastLatency;
+        _maxLatency = std::max(_maxLatency, _lastLatency);
+        _totalRenderTime += renderEnd - renderStart;
+
+        _submittedFrame = nullptr;
+        _condition.notify_all();
+    }
+}
+
+ScopedGLContext::ScopedGLContext()
+: _renderThread(RenderThread::getRunningInstance())
+{
+    if (_renderThread)
+        _renderThread->acquireContext();
+}
+
+ScopedGLContext::~ScopedGLContext()
+{
+    if (_renderThread)
+        _renderThread->releaseContext();
+}
+
+NS_CC_END
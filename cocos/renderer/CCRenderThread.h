@@ -0,0 +1,162 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_RENDER_THREAD_H__
+#define __CC_RENDER_THREAD_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "platform/CCPlatformMacros.h"
+#include "renderer/CCRenderer.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class GLView;
+
+/**
+ Draws the frames recorded by the main thread, one frame behind it, and swaps the buffers.
+ The Director owns it while the rendering is pipelined, @see Director::setPipelinedRendering().
+
+ The GL context belongs to the thread drawing a frame, or to the thread holding a ScopedGLContext.
+ */
+class CC_DLL RenderThread
+{
+public:
+    /** Frame counters, durations are in seconds. */
+    struct Stats
+    {
+        /** Frames drawn and presented. */
+        unsigned int renderedFrames;
+        /** Frames drawn while the main thread was updating the next one. */
+        unsigned int overlappedFrames;
+        /** Time from the beginning of the update of the last frame until its buffers were swapped. */
+        float lastLatency;
+        float averageLatency;
+        float maxLatency;
+        /** Time the render thread spent drawing a frame and swapping the buffers. */
+        float averageRenderTime;
+        /** Time per frame the main thread waited for the render thread. */
+        float averageWaitTime;
+        /** Frames presented per second since the counters were reset. */
+        float framesPerSecond;
+    };
+
+    /** Starts the thread. The context of glview must not be current on any thread. */
+    RenderThread(Renderer* renderer, GLView* glview);
+    /** Draws the submitted frame, stops the thread and makes the context current on the calling thread. */
+    ~RenderThread();
+
+    /** Makes the renderer record the next frame. Called by the main thread. */
+    void beginFrame();
+
+    /** Hands the recorded frame to the render thread. Called by the main thread.
+     Waits until the previous frame is drawn, and until this one is drawn as well if it is not detached.
+     */
+    void submitFrame();
+
+    /** Waits until the submitted frame is drawn. */
+    void finish();
+
+    /** Whether or not the calling thread is the render thread. */
+    inline bool isCurrentThread() const { return std::this_thread::get_id() == _thread.get_id(); }
+
+    Stats getStats() const;
+    void resetStats();
+
+    /** Waits until the context is free, and until the submitted frame is drawn if called by another thread
+     than the render thread, then makes the context current on the calling thread. Calls can be nested.
+     */
+    void acquireContext();
+    /** Releases the context acquired with acquireContext(). */
+    void releaseContext();
+
+    /** Returns the render thread of the Director, nullptr when the rendering is not pipelined. */
+    static RenderThread* getRunningInstance() { return s_runningInstance; }
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    void run();
+
+    static RenderThread* s_runningInstance;
+
+    Renderer* _renderer;
+    GLView* _glview;
+
+    RenderFrame _frames[2];
+    int _recordingFrame;
+    Clock::time_point _recordingStart;
+
+    RenderFrame* _submittedFrame;
+    Clock::time_point _submittedStart;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread::id _contextOwner;
+    int _contextDepth;
+    bool _quit;
+
+    // counters, guarded by _mutex
+    Clock::time_point _statsStart;
+    unsigned int _renderedFrames;
+    unsigned int _overlappedFrames;
+    unsigned int _submittedFrames;
+    Clock::duration _lastLatency;
+    Clock::duration _totalLatency;
+    Clock::duration _maxLatency;
+    Clock::duration _totalRenderTime;
+    Clock::duration _totalWaitTime;
+
+    std::thread _thread;
+};
+
+/**
+ Makes the GL context current on the calling thread while the object lives, when the rendering is pipelined.
+ Does nothing otherwise. GL calls made by the main thread outside of the frame commands must be enclosed in one.
+ */
+class CC_DLL ScopedGLContext
+{
+public:
+    ScopedGLContext();
+    ~ScopedGLContext();
+
+protected:
+    RenderThread* _renderThread;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif // __CC_RENDER_THREAD_H__
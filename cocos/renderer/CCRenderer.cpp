@@ -154,9 +154,9 @@ void RenderQueue::realloc(size_t reserveSize)
 
 void RenderQueue::saveRenderState()
 {
-    _isDepthEnabled = glIsEnabled(GL_DEPTH_TEST) != GL_FALSE;
-    _isCullEnabled = glIsEnabled(GL_CULL_FACE) != GL_FALSE;
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_isDepthWrite);
+    _isDepthEnabled = GL::isEnabled(GL_DEPTH_TEST);
+    _isCullEnabled = GL::isEnabled(GL_CULL_FACE);
+    _isDepthWrite = GL::getDepthMask();
     
     CHECK_GL_ERROR_DEBUG();
 }
@@ -165,33 +165,102 @@ void RenderQueue::restoreRenderState()
 {
     if (_isCullEnabled)
     {
-        glEnable(GL_CULL_FACE);
+        GL::enable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(true);
     }
     else
     {
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
     }
     
     
     if (_isDepthEnabled)
     {
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(false);
     }
     
-    glDepthMask(_isDepthWrite);
-    RenderState::StateBlock::_defaultState->setDepthWrite(_isDepthEnabled);
+    GL::depthMask(_isDepthWrite);
+    RenderState::StateBlock::_defaultState->setDepthWrite(_isDepthWrite);
 
     CHECK_GL_ERROR_DEBUG();
 }
 
+// frame
+static const size_t FRAME_BLOCK_SIZE = 256 * 1024;
+
+RenderFrame::RenderFrame()
+: _passCount(0)
+, _trianglesCommandCount(0)
+, _quadCommandCount(0)
+, _glProgramStateCopyCount(0)
+, _blockIndex(0)
+, _blockOffset(0)
+, _detached(true)
+{
+}
+
+RenderFrame::~RenderFrame()
+{
+    reset();
+
+    for (auto glProgramState : _glProgramStateCopies)
+    {
+        glProgramState->release();
+    }
+}
+
+void RenderFrame::reset()
+{
+    for (auto& pass : _passes)
+    {
+        pass.callbacks.clear();
+        for (auto& renderqueue : pass.renderGroups)
+        {
+            renderqueue.clear();
+        }
+    }
+    _passCount = 0;
+
+    for (auto glProgramState : _glProgramStates)
+    {
+        glProgramState->release();
+    }
+    _glProgramStates.clear();
+    _glProgramStateCopyCount = 0;
+
+    _trianglesCommandCount = 0;
+    _quadCommandCount = 0;
+    _blockIndex = 0;
+    _blockOffset = 0;
+    _detached = true;
+}
+
+void* RenderFrame::allocate(size_t size)
+{
+    // blocks are never reallocated, so the vertices don't move once copied
+    size = (size + 15) & ~static_cast<size_t>(15);
+    while (_blockIndex < _blocks.size() && _blockOffset + size > _blocks[_blockIndex].size())
+    {
+        ++_blockIndex;
+        _blockOffset = 0;
+    }
+    if (_blockIndex == _blocks.size())
+    {
+        _blocks.push_back(std::vector<char>(std::max(size, FRAME_BLOCK_SIZE)));
+    }
+
+    void* data = _blocks[_blockIndex].data() + _blockOffset;
+    _blockOffset += size;
+    return data;
+}
+
 //
 //
 //
@@ -207,8 +276,12 @@ Renderer::Renderer()
 ,_filledIndex(0)
 ,_numberQuads(0)
 ,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_recordingFrame(nullptr)
+,_visitedRenderGroups(&_renderGroups)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -230,8 +303,8 @@ Renderer::~Renderer()
     _renderGroups.clear();
     _groupCommandManager->release();
     
-    glDeleteBuffers(2, _buffersVBO);
-    glDeleteBuffers(2, _quadbuffersVBO);
+    GL::deleteBuffers(2, _buffersVBO);
+    GL::deleteBuffers(2, _quadbuffersVBO);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -292,7 +365,7 @@ void Renderer::setupVBOAndVAO()
 
     glGenBuffers(2, &_buffersVBO[0]);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
 
     // vertices
@@ -307,13 +380,13 @@ void Renderer::setupVBOAndVAO()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     //generate vbo and vao for quadCommand
     glGenVertexArrays(1, &_quadVAO);
@@ -321,7 +394,7 @@ void Renderer::setupVBOAndVAO()
     
     glGenBuffers(2, &_quadbuffersVBO[0]);
     
-    glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
     
     // vertices
@@ -336,13 +409,13 @@ void Renderer::setupVBOAndVAO()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_quadIndices[0]) * INDEX_VBO_SIZE, _quadIndices, GL_STATIC_DRAW);
     
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     CHECK_GL_ERROR_DEBUG();
 }
@@ -359,21 +432,21 @@ void Renderer::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
     
-    glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_quadIndices[0]) * INDEX_VBO_SIZE, _quadIndices, GL_STATIC_DRAW);
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -390,9 +463,95 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (_recordingFrame)
+    {
+        command = recordCommand(command);
+    }
     _renderGroups[renderQueue].push_back(command);
 }
 
+RenderCommand* Renderer::recordCommand(RenderCommand* command)
+{
+    auto frame = _recordingFrame;
+    auto commandType = command->getType();
+    if (RenderCommand::Type::TRIANGLES_COMMAND == commandType)
+    {
+        auto cmd = static_cast<TrianglesCommand*>(command);
+
+        // the node updates its vertices while the frame is rendered
+        TrianglesCommand::Triangles triangles = cmd->getTriangles();
+        auto verts = static_cast<V3F_C4B_T2F*>(frame->allocate(sizeof(V3F_C4B_T2F) * triangles.vertCount));
+        memcpy(verts, triangles.verts, sizeof(V3F_C4B_T2F) * triangles.vertCount);
+        triangles.verts = verts;
+        auto indices = static_cast<unsigned short*>(frame->allocate(sizeof(unsigned short) * triangles.indexCount));
+        memcpy(indices, triangles.indices, sizeof(unsigned short) * triangles.indexCount);
+        triangles.indices = indices;
+
+        if (frame->_trianglesCommandCount == frame->_trianglesCommands.size())
+            frame->_trianglesCommands.push_back(*cmd);
+        else
+            frame->_trianglesCommands[frame->_trianglesCommandCount] = *cmd;
+        auto copy = &frame->_trianglesCommands[frame->_trianglesCommandCount++];
+        copy->init(cmd->getGlobalOrder(), cmd->getTextureID(), recordGLProgramState(cmd->getGLProgramState()), cmd->getBlendType(), triangles, cmd->getModelView(), cmd->is3D() ? Node::FLAGS_RENDER_AS_3D : 0);
+        command = copy;
+    }
+    else if (RenderCommand::Type::QUAD_COMMAND == commandType)
+    {
+        auto cmd = static_cast<QuadCommand*>(command);
+
+        auto quads = static_cast<V3F_C4B_T2F_Quad*>(frame->allocate(sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount()));
+        memcpy(quads, cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
+
+        if (frame->_quadCommandCount == frame->_quadCommands.size())
+            frame->_quadCommands.push_back(*cmd);
+        else
+            frame->_quadCommands[frame->_quadCommandCount] = *cmd;
+        auto copy = &frame->_quadCommands[frame->_quadCommandCount++];
+        copy->init(cmd->getGlobalOrder(), cmd->getTextureID(), recordGLProgramState(cmd->getGLProgramState()), cmd->getBlendType(), quads, cmd->getQuadCount(), cmd->getModelView(), cmd->is3D() ? Node::FLAGS_RENDER_AS_3D : 0);
+        command = copy;
+    }
+    else
+    {
+        // the other commands read the state of their node when they are executed
+        frame->_detached = false;
+    }
+    return command;
+}
+
+GLProgramState* Renderer::recordGLProgramState(GLProgramState* glProgramState)
+{
+    auto frame = _recordingFrame;
+
+    // the node sets the uniforms of the next frame while this one is rendered, the frame applies a copy of their values
+    if (glProgramState->getUniformCount() > 0)
+    {
+        if (frame->_glProgramStateCopyCount == frame->_glProgramStateCopies.size())
+        {
+            auto copy = GLProgramState::create(glProgramState->getGLProgram());
+            copy->retain();
+            frame->_glProgramStateCopies.push_back(copy);
+        }
+
+        auto copy = frame->_glProgramStateCopies[frame->_glProgramStateCopyCount];
+        if (glProgramState->copyUniformValuesTo(copy))
+        {
+            ++frame->_glProgramStateCopyCount;
+            return copy;
+        }
+
+        // pointers and callbacks are read when the state is applied
+        frame->_detached = false;
+    }
+
+    // consecutive commands usually share their program state
+    if (frame->_glProgramStates.empty() || frame->_glProgramStates.back() != glProgramState)
+    {
+        glProgramState->retain();
+        frame->_glProgramStates.push_back(glProgramState);
+    }
+    return glProgramState;
+}
+
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
@@ -503,7 +662,7 @@ void Renderer::processRenderCommand(RenderCommand* command)
     {
         flush();
         int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
-        visitRenderQueue(_renderGroups[renderQueueID]);
+        visitRenderQueue((*_visitedRenderGroups)[renderQueueID]);
     }
     else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
     {
@@ -541,18 +700,18 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     {
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
             RenderState::StateBlock::_defaultState->setBlend(true);
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
             RenderState::StateBlock::_defaultState->setBlend(true);
@@ -571,9 +730,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     if (opaqueQueue.size() > 0)
     {
         //Clear depth to achieve layered rendering
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(true);
-        glDisable(GL_BLEND);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthMask(true);
+        GL::disable(GL_BLEND);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(true);
         RenderState::StateBlock::_defaultState->setBlend(false);
@@ -592,9 +751,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     const auto& transQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::TRANSPARENT_3D);
     if (transQueue.size() > 0)
     {
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(false);
-        glEnable(GL_BLEND);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthMask(false);
+        GL::enable(GL_BLEND);
 
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(false);
@@ -616,9 +775,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     {
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
 
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
@@ -627,9 +786,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
 
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
@@ -651,9 +810,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     {
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
             
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
@@ -662,9 +821,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
             
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
@@ -684,6 +843,12 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
 
 void Renderer::render()
 {
+    if (_recordingFrame)
+    {
+        closePass();
+        return;
+    }
+
     //Uncomment this once everything is rendered by new renderer
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -717,6 +882,11 @@ void Renderer::clean()
         _renderGroups[j].clear();
     }
 
+    cleanBatches();
+}
+
+void Renderer::cleanBatches()
+{
     // Clear batch commands
     _batchedCommands.clear();
     _batchQuadCommands.clear();
@@ -727,13 +897,98 @@ void Renderer::clean()
     _lastBatchedMeshCommand = nullptr;
 }
 
+void Renderer::beginFrame(RenderFrame* frame)
+{
+    CCASSERT(_recordingFrame == nullptr, "A frame is already being recorded");
+    _recordingFrame = frame;
+    if (frame->_passes.empty())
+    {
+        frame->_passes.resize(1);
+    }
+}
+
+void Renderer::endFrame()
+{
+    CCASSERT(_recordingFrame, "No frame is being recorded");
+    const auto& pass = _recordingFrame->_passes[_recordingFrame->_passCount];
+    if (!pass.callbacks.empty() || _renderGroups[DEFAULT_RENDER_QUEUE].size() > 0)
+    {
+        closePass();
+    }
+    _recordingFrame = nullptr;
+}
+
+void Renderer::closePass()
+{
+    auto frame = _recordingFrame;
+    auto& pass = frame->_passes[frame->_passCount];
+    pass.projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+
+    // the queues go to the frame, and empty ones take their place so that the group IDs stay valid
+    pass.renderGroups.swap(_renderGroups);
+    if (_renderGroups.size() < pass.renderGroups.size())
+    {
+        _renderGroups.resize(pass.renderGroups.size());
+    }
+
+    ++frame->_passCount;
+    if (frame->_passCount == frame->_passes.size())
+    {
+        frame->_passes.push_back(RenderFrame::Pass());
+    }
+}
+
+void Renderer::renderFrame(RenderFrame* frame)
+{
+    auto director = Director::getInstance();
+    for (size_t i = 0; i < frame->_passCount; ++i)
+    {
+        auto& pass = frame->_passes[i];
+
+        // the matrix stacks of the render thread are not the ones of the main thread, see Director
+        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, pass.projection);
+
+        for (const auto& callback : pass.callbacks)
+        {
+            callback();
+        }
+
+        if (_glViewAssigned)
+        {
+            for (auto& renderqueue : pass.renderGroups)
+            {
+                renderqueue.sort();
+            }
+            _visitedRenderGroups = &pass.renderGroups;
+            visitRenderQueue(pass.renderGroups[DEFAULT_RENDER_QUEUE]);
+            _visitedRenderGroups = &_renderGroups;
+        }
+        cleanBatches();
+
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    }
+}
+
+void Renderer::addCallback(const std::function<void()>& callback)
+{
+    if (_recordingFrame)
+    {
+        _recordingFrame->_passes[_recordingFrame->_passCount].callbacks.push_back(callback);
+    }
+    else
+    {
+        callback();
+    }
+}
+
 void Renderer::clear()
 {
     //Enable Depth mask to make sure glClear clear the depth buffer correctly
-    glDepthMask(true);
+    GL::depthMask(true);
     glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glDepthMask(false);
+    GL::depthMask(false);
 
     RenderState::StateBlock::_defaultState->setDepthWrite(false);
 }
@@ -743,8 +998,8 @@ void Renderer::setDepthTest(bool enable)
     if (enable)
     {
         glClearDepth(1.0f);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LEQUAL);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthFunc(GL_LEQUAL);
 
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthFunction(RenderState::DEPTH_LEQUAL);
@@ -753,7 +1008,7 @@ void Renderer::setDepthTest(bool enable)
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
 
         RenderState::StateBlock::_defaultState->setDepthTest(false);
     }
@@ -816,7 +1071,7 @@ void Renderer::drawBatchedTriangles()
         //Bind VAO
         GL::bindVAO(_buffersVAO);
         //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
         // option 1: subdata
 //        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
@@ -830,15 +1085,15 @@ void Renderer::drawBatchedTriangles()
         memcpy(buf, _verts, sizeof(_verts[0])* _filledVertex);
         glUnmapBuffer(GL_ARRAY_BUFFER);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
     else
     {
 #define kQuadSize sizeof(_verts[0])
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
         glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts, GL_DYNAMIC_DRAW);
 
@@ -853,7 +1108,7 @@ void Renderer::drawBatchedTriangles()
         // tex coords
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
 
@@ -897,8 +1152,8 @@ void Renderer::drawBatchedTriangles()
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
     _batchedCommands.clear();
@@ -924,7 +1179,7 @@ void Renderer::drawBatchedQuads()
         //Bind VAO
         GL::bindVAO(_quadVAO);
         //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
         
         // option 1: subdata
         //  glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
@@ -938,14 +1193,14 @@ void Renderer::drawBatchedQuads()
         memcpy(buf, _quadVerts, sizeof(_quadVerts[0])* _numberQuads * 4);
         glUnmapBuffer(GL_ARRAY_BUFFER);
         
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     }
     else
     {
 #define kQuadSize sizeof(_verts[0])
-        glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
         
         glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4 , _quadVerts, GL_DYNAMIC_DRAW);
         
@@ -960,7 +1215,7 @@ void Renderer::drawBatchedQuads()
         // tex coords
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     }
 
 
@@ -1012,8 +1267,8 @@ void Renderer::drawBatchedQuads()
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
     
     _batchQuadCommands.clear();
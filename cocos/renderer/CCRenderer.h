@@ -26,12 +26,18 @@
 #ifndef __CC_RENDERER_H_
 #define __CC_RENDERER_H_
 
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <vector>
 #include <stack>
 
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
+#include "renderer/ccGLStateCache.h"
 #include "platform/CCGL.h"
 
 /**
@@ -42,8 +48,6 @@
 NS_CC_BEGIN
 
 class EventListenerCustom;
-class QuadCommand;
-class TrianglesCommand;
 class MeshCommand;
 
 /** Class that knows how to sort `RenderCommand` objects.
@@ -108,6 +112,60 @@ protected:
     GLboolean _isDepthWrite;
 };
 
+/** The commands of one frame, recorded by the Renderer on the main thread and rendered later on the render thread.
+ Triangles and quads commands are copied into the frame together with their vertices and the values of their uniforms,
+ other commands are kept as they are.
+ Only used when the rendering is pipelined, @see Director::setPipelinedRendering().
+ */
+class CC_DLL RenderFrame
+{
+public:
+    /**Constructor.*/
+    RenderFrame();
+    /**Destructor.*/
+    ~RenderFrame();
+
+    /** Whether every command of the frame was copied into the frame.
+     If not, the frame refers to commands owned by nodes, and it must be rendered before the nodes are visited again.
+     */
+    inline bool isDetached() const { return _detached; }
+
+    /** Releases the commands and the callbacks of the frame. Must be called on the thread recording the frames. */
+    void reset();
+
+protected:
+    friend class Renderer;
+
+    /** What is recorded between two calls to Renderer::render(). */
+    struct Pass
+    {
+        std::vector<std::function<void()>> callbacks;
+        std::vector<RenderQueue> renderGroups;
+        Mat4 projection;
+    };
+
+    /** Returns storage valid until the frame is reset. */
+    void* allocate(size_t size);
+
+    std::vector<Pass> _passes;
+    size_t _passCount;
+
+    std::deque<TrianglesCommand> _trianglesCommands;
+    size_t _trianglesCommandCount;
+    std::deque<QuadCommand> _quadCommands;
+    size_t _quadCommandCount;
+    std::vector<GLProgramState*> _glProgramStates;
+    // copies of the states having user defined uniforms, kept from frame to frame
+    std::vector<GLProgramState*> _glProgramStateCopies;
+    size_t _glProgramStateCopyCount;
+
+    std::vector<std::vector<char>> _blocks;
+    size_t _blockIndex;
+    size_t _blockOffset;
+
+    bool _detached;
+};
+
 //the struct is not used outside.
 struct RenderStackElement
 {
@@ -164,6 +222,25 @@ public:
     /** Clear GL buffer and screen */
     void clear();
 
+    /** Records the commands into frame instead of rendering them, until endFrame() is called.
+     render() then closes a pass of the frame, which keeps the projection matrix of the Director.
+     */
+    void beginFrame(RenderFrame* frame);
+
+    /** Stops recording the commands. */
+    void endFrame();
+
+    /** Whether the commands are recorded into a frame instead of being rendered. */
+    inline bool isRecording() const { return _recordingFrame != nullptr; }
+
+    /** Renders a frame recorded with beginFrame(), on the thread owning the GL context. */
+    void renderFrame(RenderFrame* frame);
+
+    /** Calls callback before the commands added since the last call to render() are rendered.
+     The callback is called right away, unless the commands are recorded into a frame.
+     */
+    void addCallback(const std::function<void()>& callback);
+
     /** set color for clear screen */
     void setClearColor(const Color4F& clearColor);
     /* returns the number of drawn batches in the last frame */
@@ -174,8 +251,8 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) QuadCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
-    /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    /* clear draw stats, and the state change counts of the GL state cache */
+    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; GL::resetStateCacheStats(); }
 
     /**
      * Enable/Disable depth test
@@ -216,6 +293,12 @@ protected:
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
     void fillQuads(const QuadCommand* cmd);
 
+    void cleanBatches();
+
+    RenderCommand* recordCommand(RenderCommand* command);
+    GLProgramState* recordGLProgramState(GLProgramState* glProgramState);
+    void closePass();
+
     /* clear color set outside be used in setGLDefaultValues() */
     Color4F _clearColor;
 
@@ -247,15 +330,19 @@ protected:
     
     bool _glViewAssigned;
 
-    // stats
-    ssize_t _drawnBatches;
-    ssize_t _drawnVertices;
+    // stats, counted by the render thread and read by the main thread when the rendering is pipelined
+    std::atomic<ssize_t> _drawnBatches;
+    std::atomic<ssize_t> _drawnVertices;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     bool _isDepthTestFor2D;
     
     GroupCommandManager* _groupCommandManager;
+
+    RenderFrame* _recordingFrame;
+    // the groups GroupCommand refers to while visiting, the ones of a recorded frame when rendering it
+    std::vector<RenderQueue>* _visitedRenderGroups;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
@@ -45,9 +45,16 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCRenderThread.h"
 #include "base/CCNinePatchImageParser.h"
 #include "deprecated/CCString.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include "renderer/CCTextureCache.h"
@@ -124,302 +131,893 @@ static Texture2D::PixelFormat g_defaultAlphaPixelFormat = Texture2D::PixelFormat
 //////////////////////////////////////////////////////////////////////////
 //conventer function
 
-// IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBB
-void Texture2D::convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
-{
-    for (ssize_t i=0; i < dataLen; ++i)
+// The conversions are split in stripes converted by several threads, and vectorized with SSE2 or NEON.
+// SSE2 has no byte shuffle, the 24 bits formats are converted by the scalar loops there.
+namespace {
+    // pixels converted by one thread at least, the smaller images are converted by the calling thread alone
+    const size_t CONVERSION_CHUNK = 32 * 1024;
+
+    typedef void (*PixelConverter)(const unsigned char* in, unsigned char* out, size_t count);
+
+    void convertPixels(const unsigned char* data, ssize_t dataLen, size_t inBytes, unsigned char* outData, size_t outBytes, PixelConverter converter)
+    {
+        size_t count = dataLen > 0 ? (size_t)dataLen / inBytes : 0;
+        utils::parallelFor(count, CONVERSION_CHUNK, [=](size_t begin, size_t end) {
+            converter(data + begin * inBytes, outData + begin * outBytes, end - begin);
+        });
+    }
+
+    // I = (R*299 + G*587 + B*114 + 500) / 1000
+    inline unsigned char luminance(unsigned r, unsigned g, unsigned b)
+    {
+        return (unsigned char)((r * 299 + g * 587 + b * 114 + 500) / 1000);
+    }
+
+#if defined(__SSE2__)
+    // 16 bits lanes holding 0..255, as in the scalar loops
+    inline __m128i packRGB565(__m128i r, __m128i g, __m128i b)
+    {
+        return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r, _mm_set1_epi16(0xF8)), 8),
+                                         _mm_slli_epi16(_mm_and_si128(g, _mm_set1_epi16(0xFC)), 3)),
+                            _mm_srli_epi16(_mm_and_si128(b, _mm_set1_epi16(0xF8)), 3));
+    }
+
+    inline __m128i packRGBA4444(__m128i r, __m128i g, __m128i b, __m128i a)
+    {
+        __m128i mask = _mm_set1_epi16(0xF0);
+        return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r, mask), 8), _mm_slli_epi16(_mm_and_si128(g, mask), 4)),
+                            _mm_or_si128(_mm_and_si128(b, mask), _mm_srli_epi16(_mm_and_si128(a, mask), 4)));
+    }
+
+    inline __m128i packRGB5A1(__m128i r, __m128i g, __m128i b, __m128i a)
+    {
+        __m128i mask = _mm_set1_epi16(0xF8);
+        return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r, mask), 8), _mm_slli_epi16(_mm_and_si128(g, mask), 3)),
+                            _mm_or_si128(_mm_srli_epi16(_mm_and_si128(b, mask), 2), _mm_srli_epi16(a, 7)));
+    }
+
+    // packs the low 16 bits of the 32 bits lanes, without the signed saturation of _mm_packs_epi32
+    inline __m128i pack32To16(__m128i lo, __m128i hi)
+    {
+        return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+    }
+
+    // the channels of 8 RGBA8888 pixels, in 16 bits lanes
+    inline void unpackRGBA8888(const unsigned char* in, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i*)in);
+        __m128i hi = _mm_loadu_si128((const __m128i*)(in + 16));
+        __m128i mask = _mm_set1_epi32(0xFF);
+        r = pack32To16(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+        g = pack32To16(_mm_and_si128(_mm_srli_epi32(lo, 8), mask), _mm_and_si128(_mm_srli_epi32(hi, 8), mask));
+        b = pack32To16(_mm_and_si128(_mm_srli_epi32(lo, 16), mask), _mm_and_si128(_mm_srli_epi32(hi, 16), mask));
+        a = pack32To16(_mm_srli_epi32(lo, 24), _mm_srli_epi32(hi, 24));
+    }
+
+    // the luminance of 4 RGBA8888 pixels, in 32 bits lanes. The sums are exact in floats, and the division
+    // is rounded correctly, so that the truncation gives the integer division of the scalar loops
+    inline __m128i luminanceRGBA8888(__m128i pixels)
+    {
+        __m128i mask = _mm_set1_epi32(0xFF);
+        __m128 r = _mm_cvtepi32_ps(_mm_and_si128(pixels, mask));
+        __m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), mask));
+        __m128 b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask));
+        __m128 n = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(299.0f)), _mm_mul_ps(g, _mm_set1_ps(587.0f))),
+                              _mm_add_ps(_mm_mul_ps(b, _mm_set1_ps(114.0f)), _mm_set1_ps(500.0f)));
+        return _mm_cvttps_epi32(_mm_div_ps(n, _mm_set1_ps(1000.0f)));
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    inline uint16x8_t packRGB565(uint16x8_t r, uint16x8_t g, uint16x8_t b)
+    {
+        return vorrq_u16(vorrq_u16(vshlq_n_u16(vandq_u16(r, vdupq_n_u16(0xF8)), 8), vshlq_n_u16(vandq_u16(g, vdupq_n_u16(0xFC)), 3)),
+                         vshrq_n_u16(b, 3));
+    }
+
+    inline uint16x8_t packRGBA4444(uint16x8_t r, uint16x8_t g, uint16x8_t b, uint16x8_t a)
+    {
+        uint16x8_t mask = vdupq_n_u16(0xF0);
+        return vorrq_u16(vorrq_u16(vshlq_n_u16(vandq_u16(r, mask), 8), vshlq_n_u16(vandq_u16(g, mask), 4)),
+                         vorrq_u16(vandq_u16(b, mask), vshrq_n_u16(a, 4)));
+    }
+
+    inline uint16x8_t packRGB5A1(uint16x8_t r, uint16x8_t g, uint16x8_t b, uint16x8_t a)
+    {
+        uint16x8_t mask = vdupq_n_u16(0xF8);
+        return vorrq_u16(vorrq_u16(vshlq_n_u16(vandq_u16(r, mask), 8), vshlq_n_u16(vandq_u16(g, mask), 3)),
+                         vorrq_u16(vshrq_n_u16(vandq_u16(b, mask), 2), vshrq_n_u16(a, 7)));
+    }
+
+    // n / 1000 as (n * ceil(2^38 / 1000)) >> 38, exact far beyond the largest sum
+    inline uint32x4_t luminance4(uint32x4_t r, uint32x4_t g, uint32x4_t b)
+    {
+        uint32x4_t n = vmlaq_n_u32(vmlaq_n_u32(vmlaq_n_u32(vdupq_n_u32(500), r, 299), g, 587), b, 114);
+        uint64x2_t lo = vmull_n_u32(vget_low_u32(n), 274877907);
+        uint64x2_t hi = vmull_n_u32(vget_high_u32(n), 274877907);
+        return vshrq_n_u32(vcombine_u32(vshrn_n_u64(lo, 32), vshrn_n_u64(hi, 32)), 6);
+    }
+
+    inline uint8x16_t luminance16(uint8x16_t r, uint8x16_t g, uint8x16_t b)
+    {
+        uint16x8_t r16[2] = { vmovl_u8(vget_low_u8(r)), vmovl_u8(vget_high_u8(r)) };
+        uint16x8_t g16[2] = { vmovl_u8(vget_low_u8(g)), vmovl_u8(vget_high_u8(g)) };
+        uint16x8_t b16[2] = { vmovl_u8(vget_low_u8(b)), vmovl_u8(vget_high_u8(b)) };
+        uint8x8_t half[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            uint32x4_t lo = luminance4(vmovl_u16(vget_low_u16(r16[i])), vmovl_u16(vget_low_u16(g16[i])), vmovl_u16(vget_low_u16(b16[i])));
+            uint32x4_t hi = luminance4(vmovl_u16(vget_high_u16(r16[i])), vmovl_u16(vget_high_u16(g16[i])), vmovl_u16(vget_high_u16(b16[i])));
+            half[i] = vmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+        }
+        return vcombine_u8(half[0], half[1]);
+    }
+
+    // stores 16 pixels of 16 bits, computed from the 8 bits channels by pack(r, g, b, a)
+    template <typename Pack>
+    inline void store16(unsigned char* out, uint8x16_t r, uint8x16_t g, uint8x16_t b, uint8x16_t a, Pack pack)
+    {
+        vst1q_u16((uint16_t*)out, pack(vmovl_u8(vget_low_u8(r)), vmovl_u8(vget_low_u8(g)), vmovl_u8(vget_low_u8(b)), vmovl_u8(vget_low_u8(a))));
+        vst1q_u16((uint16_t*)(out + 16), pack(vmovl_u8(vget_high_u8(r)), vmovl_u8(vget_high_u8(g)), vmovl_u8(vget_high_u8(b)), vmovl_u8(vget_high_u8(a))));
+    }
+
+    inline uint16x8_t packRGB565A(uint16x8_t r, uint16x8_t g, uint16x8_t b, uint16x8_t) { return packRGB565(r, g, b); }
+#endif
+
+    // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBB
+    void i8ToRGB888(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16_t v = vld1q_u8(in + i);
+            uint8x16x3_t rgb = {{ v, v, v }};
+            vst3q_u8(out + i * 3, rgb);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * 3] = out[i * 3 + 1] = out[i * 3 + 2] = in[i];
+        }
+    }
+
+    // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
+    void ai88ToRGB888(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t ia = vld2q_u8(in + i * 2);
+            uint8x16x3_t rgb = {{ ia.val[0], ia.val[0], ia.val[0] }};
+            vst3q_u8(out + i * 3, rgb);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * 3] = out[i * 3 + 1] = out[i * 3 + 2] = in[i * 2];
+        }
+    }
+
+    // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
+    void i8ToRGBA8888(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i lo = _mm_unpacklo_epi8(v, v);
+            __m128i hi = _mm_unpackhi_epi8(v, v);
+            _mm_storeu_si128((__m128i*)(out + i * 4), _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha));
+            _mm_storeu_si128((__m128i*)(out + i * 4 + 16), _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha));
+            _mm_storeu_si128((__m128i*)(out + i * 4 + 32), _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha));
+            _mm_storeu_si128((__m128i*)(out + i * 4 + 48), _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16_t v = vld1q_u8(in + i);
+            uint8x16x4_t rgba = {{ v, v, v, vdupq_n_u8(0xFF) }};
+            vst4q_u8(out + i * 4, rgba);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * 4] = out[i * 4 + 1] = out[i * 4 + 2] = in[i];
+            out[i * 4 + 3] = 0xFF;
+        }
+    }
+
+    // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+    void ai88ToRGBA8888(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        // IAIA -> IIIA
+        __m128i keep = _mm_set1_epi32((int)0xFFFF00FF);
+        __m128i intensity = _mm_set1_epi32(0xFF);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i * 2));
+            __m128i lo = _mm_unpacklo_epi16(v, v);
+            __m128i hi = _mm_unpackhi_epi16(v, v);
+            lo = _mm_or_si128(_mm_and_si128(lo, keep), _mm_slli_epi32(_mm_and_si128(lo, intensity), 8));
+            hi = _mm_or_si128(_mm_and_si128(hi, keep), _mm_slli_epi32(_mm_and_si128(hi, intensity), 8));
+            _mm_storeu_si128((__m128i*)(out + i * 4), lo);
+            _mm_storeu_si128((__m128i*)(out + i * 4 + 16), hi);
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t ia = vld2q_u8(in + i * 2);
+            uint8x16x4_t rgba = {{ ia.val[0], ia.val[0], ia.val[0], ia.val[1] }};
+            vst4q_u8(out + i * 4, rgba);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * 4] = out[i * 4 + 1] = out[i * 4 + 2] = in[i * 2];
+            out[i * 4 + 3] = in[i * 2 + 1];
+        }
+    }
+
+    // IIIIIIII -> RRRRRGGGGGGBBBBB
+    void i8ToRGB565(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGB565(lo, lo, lo));
+            _mm_storeu_si128((__m128i*)(out + i * 2 + 16), packRGB565(hi, hi, hi));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16_t v = vld1q_u8(in + i);
+            store16(out + i * 2, v, v, v, v, packRGB565A);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i] & 0x00F8) << 8    //R
+                | (in[i] & 0x00FC) << 3         //G
+                | (in[i] & 0x00F8) >> 3;        //B
+        }
+    }
+
+    // IIIIIIIIAAAAAAAA -> RRRRRGGGGGGBBBBB
+    void ai88ToRGB565(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i mask = _mm_set1_epi16(0xFF);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(in + i * 2)), mask);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGB565(v, v, v));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t ia = vld2q_u8(in + i * 2);
+            store16(out + i * 2, ia.val[0], ia.val[0], ia.val[0], ia.val[1], packRGB565A);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 2] & 0x00F8) << 8    //R
+                | (in[i * 2] & 0x00FC) << 3         //G
+                | (in[i * 2] & 0x00F8) >> 3;        //B
+        }
+    }
+
+    // IIIIIIII -> RRRRGGGGBBBBAAAA
+    void i8ToRGBA4444(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i zero = _mm_setzero_si128();
+        __m128i alpha = _mm_set1_epi16(0xFF);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGBA4444(lo, lo, lo, alpha));
+            _mm_storeu_si128((__m128i*)(out + i * 2 + 16), packRGBA4444(hi, hi, hi, alpha));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16_t v = vld1q_u8(in + i);
+            store16(out + i * 2, v, v, v, vdupq_n_u8(0xFF), packRGBA4444);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i] & 0x00F0) << 8    //R
+            | (in[i] & 0x00F0) << 4             //G
+            | (in[i] & 0x00F0)                  //B
+            | 0x000F;                           //A
+        }
+    }
+
+    // IIIIIIIIAAAAAAAA -> RRRRGGGGBBBBAAAA
+    void ai88ToRGBA4444(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i mask = _mm_set1_epi16(0xFF);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i * 2));
+            __m128i intensity = _mm_and_si128(v, mask);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGBA4444(intensity, intensity, intensity, _mm_srli_epi16(v, 8)));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t ia = vld2q_u8(in + i * 2);
+            store16(out + i * 2, ia.val[0], ia.val[0], ia.val[0], ia.val[1], packRGBA4444);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 2] & 0x00F0) << 8    //R
+            | (in[i * 2] & 0x00F0) << 4             //G
+            | (in[i * 2] & 0x00F0)                  //B
+            | (in[i * 2 + 1] & 0x00F0) >> 4;        //A
+        }
+    }
+
+    // IIIIIIII -> RRRRRGGGGGBBBBBA
+    void i8ToRGB5A1(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i zero = _mm_setzero_si128();
+        __m128i alpha = _mm_set1_epi16(0xFF);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGB5A1(lo, lo, lo, alpha));
+            _mm_storeu_si128((__m128i*)(out + i * 2 + 16), packRGB5A1(hi, hi, hi, alpha));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16_t v = vld1q_u8(in + i);
+            store16(out + i * 2, v, v, v, vdupq_n_u8(0xFF), packRGB5A1);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i] & 0x00F8) << 8    //R
+                | (in[i] & 0x00F8) << 3         //G
+                | (in[i] & 0x00F8) >> 2         //B
+                | 0x0001;                       //A
+        }
+    }
+
+    // IIIIIIIIAAAAAAAA -> RRRRRGGGGGBBBBBA
+    void ai88ToRGB5A1(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i mask = _mm_set1_epi16(0xFF);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i * 2));
+            __m128i intensity = _mm_and_si128(v, mask);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGB5A1(intensity, intensity, intensity, _mm_srli_epi16(v, 8)));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t ia = vld2q_u8(in + i * 2);
+            store16(out + i * 2, ia.val[0], ia.val[0], ia.val[0], ia.val[1], packRGB5A1);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 2] & 0x00F8) << 8    //R
+                | (in[i * 2] & 0x00F8) << 3         //G
+                | (in[i * 2] & 0x00F8) >> 2         //B
+                | (in[i * 2 + 1] & 0x0080) >> 7;    //A
+        }
+    }
+
+    // IIIIIIII -> IIIIIIIIAAAAAAAA
+    void i8ToAI88(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i alpha = _mm_set1_epi8((char)0xFF);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+            _mm_storeu_si128((__m128i*)(out + i * 2), _mm_unpacklo_epi8(v, alpha));
+            _mm_storeu_si128((__m128i*)(out + i * 2 + 16), _mm_unpackhi_epi8(v, alpha));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t ia = {{ vld1q_u8(in + i), vdupq_n_u8(0xFF) }};
+            vst2q_u8(out + i * 2, ia);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * 2] = in[i];
+            out[i * 2 + 1] = 0xFF;
+        }
+    }
+
+    // IIIIIIIIAAAAAAAA -> AAAAAAAA or IIIIIIII
+    template <int channel>
+    void ai88ToChannel(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i mask = _mm_set1_epi16(0xFF);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i lo = _mm_loadu_si128((const __m128i*)(in + i * 2));
+            __m128i hi = _mm_loadu_si128((const __m128i*)(in + i * 2 + 16));
+            if (channel == 0)
+                _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask)));
+            else
+                _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            vst1q_u8(out + i, vld2q_u8(in + i * 2).val[channel]);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i] = in[i * 2 + channel];
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+    void rgb888ToRGBA8888(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x3_t rgb = vld3q_u8(in + i * 3);
+            uint8x16x4_t rgba = {{ rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFF) }};
+            vst4q_u8(out + i * 4, rgba);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * 4] = in[i * 3];             //R
+            out[i * 4 + 1] = in[i * 3 + 1];     //G
+            out[i * 4 + 2] = in[i * 3 + 2];     //B
+            out[i * 4 + 3] = 0xFF;              //A
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
+    void rgba8888ToRGB888(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x4_t rgba = vld4q_u8(in + i * 4);
+            uint8x16x3_t rgb = {{ rgba.val[0], rgba.val[1], rgba.val[2] }};
+            vst3q_u8(out + i * 3, rgb);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * 3] = in[i * 4];             //R
+            out[i * 3 + 1] = in[i * 4 + 1];     //G
+            out[i * 3 + 2] = in[i * 4 + 2];     //B
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
+    void rgb888ToRGB565(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x3_t rgb = vld3q_u8(in + i * 3);
+            store16(out + i * 2, rgb.val[0], rgb.val[1], rgb.val[2], rgb.val[2], packRGB565A);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 3] & 0x00F8) << 8    //R
+                | (in[i * 3 + 1] & 0x00FC) << 3     //G
+                | (in[i * 3 + 2] & 0x00F8) >> 3;    //B
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+    void rgba8888ToRGB565(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i r, g, b, a;
+            unpackRGBA8888(in + i * 4, r, g, b, a);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGB565(r, g, b));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x4_t rgba = vld4q_u8(in + i * 4);
+            store16(out + i * 2, rgba.val[0], rgba.val[1], rgba.val[2], rgba.val[3], packRGB565A);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 4] & 0x00F8) << 8    //R
+                | (in[i * 4 + 1] & 0x00FC) << 3     //G
+                | (in[i * 4 + 2] & 0x00F8) >> 3;    //B
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIII, or IIIIIIIIAAAAAAAA with an opaque alpha
+    template <int outBytes>
+    void rgb888ToLuminance(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x3_t rgb = vld3q_u8(in + i * 3);
+            uint8x16_t intensity = luminance16(rgb.val[0], rgb.val[1], rgb.val[2]);
+            if (outBytes == 1)
+            {
+                vst1q_u8(out + i, intensity);
+            }
+            else
+            {
+                uint8x16x2_t ia = {{ intensity, vdupq_n_u8(0xFF) }};
+                vst2q_u8(out + i * 2, ia);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * outBytes] = luminance(in[i * 3], in[i * 3 + 1], in[i * 3 + 2]);
+            if (outBytes == 2)
+                out[i * 2 + 1] = 0xFF;
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIII, or IIIIIIIIAAAAAAAA
+    template <int outBytes>
+    void rgba8888ToLuminance(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i pixels[4];
+            __m128i intensity[4];
+            for (int j = 0; j < 4; ++j)
+            {
+                pixels[j] = _mm_loadu_si128((const __m128i*)(in + i * 4 + j * 16));
+                intensity[j] = luminanceRGBA8888(pixels[j]);
+            }
+            if (outBytes == 1)
+            {
+                __m128i lo = _mm_packs_epi32(intensity[0], intensity[1]);
+                __m128i hi = _mm_packs_epi32(intensity[2], intensity[3]);
+                _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(lo, hi));
+            }
+            else
+            {
+                for (int j = 0; j < 4; j += 2)
+                {
+                    __m128i lo = _mm_or_si128(intensity[j], _mm_slli_epi32(_mm_srli_epi32(pixels[j], 24), 8));
+                    __m128i hi = _mm_or_si128(intensity[j + 1], _mm_slli_epi32(_mm_srli_epi32(pixels[j + 1], 24), 8));
+                    _mm_storeu_si128((__m128i*)(out + i * 2 + j * 8), pack32To16(lo, hi));
+                }
+            }
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x4_t rgba = vld4q_u8(in + i * 4);
+            uint8x16_t intensity = luminance16(rgba.val[0], rgba.val[1], rgba.val[2]);
+            if (outBytes == 1)
+            {
+                vst1q_u8(out + i, intensity);
+            }
+            else
+            {
+                uint8x16x2_t ia = {{ intensity, rgba.val[3] }};
+                vst2q_u8(out + i * 2, ia);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i * outBytes] = luminance(in[i * 4], in[i * 4 + 1], in[i * 4 + 2]);
+            if (outBytes == 2)
+                out[i * 2 + 1] = in[i * 4 + 3];
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
+    void rgba8888ToA8(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i a[4];
+            for (int j = 0; j < 4; ++j)
+                a[j] = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(in + i * 4 + j * 16)), 24);
+            _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(_mm_packs_epi32(a[0], a[1]), _mm_packs_epi32(a[2], a[3])));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            vst1q_u8(out + i, vld4q_u8(in + i * 4).val[3]);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i] = in[i * 4 + 3];
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
+    void rgb888ToRGBA4444(const unsigned char* in, unsigned char* out, size_t count)
     {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x3_t rgb = vld3q_u8(in + i * 3);
+            store16(out + i * 2, rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFF), packRGBA4444);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = ((in[i * 3] & 0x00F0) << 8           //R
+                        | (in[i * 3 + 1] & 0x00F0) << 4     //G
+                        | (in[i * 3 + 2] & 0xF0)            //B
+                        |  0x0F);                           //A
+        }
     }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+    void rgba8888ToRGBA4444(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i r, g, b, a;
+            unpackRGBA8888(in + i * 4, r, g, b, a);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGBA4444(r, g, b, a));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x4_t rgba = vld4q_u8(in + i * 4);
+            store16(out + i * 2, rgba.val[0], rgba.val[1], rgba.val[2], rgba.val[3], packRGBA4444);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 4] & 0x00F0) << 8    //R
+            | (in[i * 4 + 1] & 0x00F0) << 4         //G
+            | (in[i * 4 + 2] & 0xF0)                //B
+            |  (in[i * 4 + 3] & 0xF0) >> 4;         //A
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
+    void rgb888ToRGB5A1(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x3_t rgb = vld3q_u8(in + i * 3);
+            store16(out + i * 2, rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFF), packRGB5A1);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 3] & 0x00F8) << 8    //R
+                | (in[i * 3 + 1] & 0x00F8) << 3     //G
+                | (in[i * 3 + 2] & 0x00F8) >> 2     //B
+                |  0x01;                            //A
+        }
+    }
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA
+    void rgba8888ToRGB5A1(const unsigned char* in, unsigned char* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i r, g, b, a;
+            unpackRGBA8888(in + i * 4, r, g, b, a);
+            _mm_storeu_si128((__m128i*)(out + i * 2), packRGB5A1(r, g, b, a));
+        }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x4_t rgba = vld4q_u8(in + i * 4);
+            store16(out + i * 2, rgba.val[0], rgba.val[1], rgba.val[2], rgba.val[3], packRGB5A1);
+        }
+#endif
+        unsigned short* out16 = (unsigned short*)out;
+        for (; i < count; ++i)
+        {
+            out16[i] = (in[i * 4] & 0x00F8) << 8    //R
+                | (in[i * 4 + 1] & 0x00F8) << 3     //G
+                | (in[i * 4 + 2] & 0x00F8) >> 2     //B
+                |  (in[i * 4 + 3] & 0x0080) >> 7;   //A
+        }
+    }
+}
+
+void Texture2D::convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertPixels(data, dataLen, 1, outData, 3, i8ToRGB888);
 }
 
-// IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-    }
+    convertPixels(data, dataLen, 2, outData, 3, ai88ToRGB888);
 }
 
-// IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0; i < dataLen; ++i)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-        *outData++ = 0xFF;        //A
-    }
+    convertPixels(data, dataLen, 1, outData, 4, i8ToRGBA8888);
 }
 
-// IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-        *outData++ = data[i + 1]; //A
-    }
+    convertPixels(data, dataLen, 2, outData, 4, ai88ToRGBA8888);
 }
 
-// IIIIIIII -> RRRRRGGGGGGBBBBB
 void Texture2D::convertI8ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00FC) << 3         //G
-            | (data[i] & 0x00F8) >> 3;        //B
-    }
+    convertPixels(data, dataLen, 1, outData, 2, i8ToRGB565);
 }
 
-// IIIIIIIIAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertAI88ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00FC) << 3         //G
-            | (data[i] & 0x00F8) >> 3;        //B
-    }
+    convertPixels(data, dataLen, 2, outData, 2, ai88ToRGB565);
 }
 
-// IIIIIIII -> RRRRGGGGBBBBAAAA
 void Texture2D::convertI8ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0; i < dataLen; ++i)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i] & 0x00F0) << 4             //G
-        | (data[i] & 0x00F0)                  //B
-        | 0x000F;                             //A
-    }
+    convertPixels(data, dataLen, 1, outData, 2, i8ToRGBA4444);
 }
 
-// IIIIIIIIAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertAI88ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i] & 0x00F0) << 4             //G
-        | (data[i] & 0x00F0)                  //B
-        | (data[i+1] & 0x00F0) >> 4;          //A
-    }
+    convertPixels(data, dataLen, 2, outData, 2, ai88ToRGBA4444);
 }
 
-// IIIIIIII -> RRRRRGGGGGBBBBBA
 void Texture2D::convertI8ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00F8) << 3         //G
-            | (data[i] & 0x00F8) >> 2         //B
-            | 0x0001;                         //A
-    }
+    convertPixels(data, dataLen, 1, outData, 2, i8ToRGB5A1);
 }
 
-// IIIIIIIIAAAAAAAA -> RRRRRGGGGGBBBBBA
 void Texture2D::convertAI88ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00F8) << 3         //G
-            | (data[i] & 0x00F8) >> 2         //B
-            | (data[i + 1] & 0x0080) >> 7;    //A
-    }
+    convertPixels(data, dataLen, 2, outData, 2, ai88ToRGB5A1);
 }
 
-// IIIIIIII -> IIIIIIIIAAAAAAAA
 void Texture2D::convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0; i < dataLen; ++i)
-    {
-        *out16++ = 0xFF00     //A
-        | data[i];            //I
-    }
+    convertPixels(data, dataLen, 1, outData, 2, i8ToAI88);
 }
 
-// IIIIIIIIAAAAAAAA -> AAAAAAAA
 void Texture2D::convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 1; i < dataLen; i += 2)
-    {
-        *outData++ = data[i]; //A
-    }
+    convertPixels(data, dataLen, 2, outData, 1, ai88ToChannel<1>);
 }
 
-// IIIIIIIIAAAAAAAA -> IIIIIIII
 void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *outData++ = data[i]; //R
-    }
+    convertPixels(data, dataLen, 2, outData, 1, ai88ToChannel<0>);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = data[i];         //R
-        *outData++ = data[i + 1];     //G
-        *outData++ = data[i + 2];     //B
-        *outData++ = 0xFF;            //A
-    }
+    convertPixels(data, dataLen, 3, outData, 4, rgb888ToRGBA8888);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = data[i];         //R
-        *outData++ = data[i + 1];     //G
-        *outData++ = data[i + 2];     //B
-    }
+    convertPixels(data, dataLen, 4, outData, 3, rgba8888ToRGB888);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
+    convertPixels(data, dataLen, 3, outData, 2, rgb888ToRGB565);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
+    convertPixels(data, dataLen, 4, outData, 2, rgba8888ToRGB565);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIII
 void Texture2D::convertRGB888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
+    convertPixels(data, dataLen, 3, outData, 1, rgb888ToLuminance<1>);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIII
 void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
+    convertPixels(data, dataLen, 4, outData, 1, rgba8888ToLuminance<1>);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
-    {
-        *outData++ = data[i + 3]; //A
-    }
+    convertPixels(data, dataLen, 4, outData, 1, rgba8888ToA8);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIIIAAAAAAAA
 void Texture2D::convertRGB888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *outData++ = 0xFF;
-    }
+    convertPixels(data, dataLen, 3, outData, 2, rgb888ToLuminance<2>);
 }
 
-
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA
 void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *outData++ = data[i + 3];
-    }
+    convertPixels(data, dataLen, 4, outData, 2, rgba8888ToLuminance<2>);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = ((data[i] & 0x00F0) << 8           //R
-                    | (data[i + 1] & 0x00F0) << 4     //G
-                    | (data[i + 2] & 0xF0)            //B
-                    |  0x0F);                         //A
-    }
+    convertPixels(data, dataLen, 3, outData, 2, rgb888ToRGBA4444);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i + 1] & 0x00F0) << 4         //G
-        | (data[i + 2] & 0xF0)                //B
-        |  (data[i + 3] & 0xF0) >> 4;         //A
-    }
+    convertPixels(data, dataLen, 4, outData, 2, rgba8888ToRGBA4444);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  0x01;                          //A
-    }
+    convertPixels(data, dataLen, 3, outData, 2, rgb888ToRGB5A1);
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  (data[i + 3] & 0x0080) >> 7;   //A
-    }
+    convertPixels(data, dataLen, 4, outData, 2, rgba8888ToRGB5A1);
 }
 // conventer function end
 //////////////////////////////////////////////////////////////////////////
@@ -441,6 +1039,7 @@ Texture2D::Texture2D()
 
 Texture2D::~Texture2D()
 {
+    ScopedGLContext context;
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     VolatileTextureMgr::removeTexture(this);
 #endif
@@ -458,6 +1057,7 @@ Texture2D::~Texture2D()
 
 void Texture2D::releaseGLTexture()
 {
+    ScopedGLContext context;
     if(_name)
     {
         GL::deleteTexture(_name);
@@ -550,6 +1150,7 @@ bool Texture2D::initWithData(const void *data, ssize_t dataLen, Texture2D::Pixel
 
 bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat pixelFormat, int pixelsWide, int pixelsHigh)
 {
+    ScopedGLContext context;
 
 
     //the pixelFormat must be a certain value 
@@ -698,6 +1299,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
 
 bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int width,int height)
 {
+    ScopedGLContext context;
     if (_name)
     {
         GL::bindTexture2D(_name);
@@ -1207,6 +1809,7 @@ void Texture2D::PVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied)
 
 void Texture2D::generateMipmap()
 {
+    ScopedGLContext context;
     CCASSERT(_pixelsWide == ccNextPOT(_pixelsWide) && _pixelsHigh == ccNextPOT(_pixelsHigh), "Mipmap texture only works in POT textures");
     GL::bindTexture2D( _name );
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -1223,6 +1826,7 @@ bool Texture2D::hasMipmaps() const
 
 void Texture2D::setTexParameters(const TexParams &texParams)
 {
+    ScopedGLContext context;
     CCASSERT((_pixelsWide == ccNextPOT(_pixelsWide) || texParams.wrapS == GL_CLAMP_TO_EDGE) &&
         (_pixelsHigh == ccNextPOT(_pixelsHigh) || texParams.wrapT == GL_CLAMP_TO_EDGE),
         "GL_CLAMP_TO_EDGE should be used in NPOT dimensions");
@@ -1240,6 +1844,7 @@ void Texture2D::setTexParameters(const TexParams &texParams)
 
 void Texture2D::setAliasTexParameters()
 {
+    ScopedGLContext context;
     if (! _antialiasEnabled)
     {
         return;
@@ -1272,6 +1877,7 @@ void Texture2D::setAliasTexParameters()
 
 void Texture2D::setAntiAliasTexParameters()
 {
+    ScopedGLContext context;
     if ( _antialiasEnabled )
     {
         return;
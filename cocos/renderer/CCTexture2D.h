@@ -538,6 +538,7 @@ protected:
     bool _antialiasEnabled;
     NinePatchInfo* _ninePatchInfo;
     friend class SpriteFrameCache;
+    friend class SpriteFrameIndex;
     friend class TextureCache;
     friend class ui::Scale9Sprite;
 };
@@ -27,6 +27,7 @@
 #include "platform/CCFileUtils.h"
 
 #include "renderer/ccGLStateCache.h"
+#include "renderer/CCRenderThread.h"
 
 NS_CC_BEGIN
 
@@ -189,6 +190,7 @@ bool TextureCube::init(const std::string& positive_x, const std::string& negativ
     images[4] = createImage(positive_z);
     images[5] = createImage(negative_z);
 
+    ScopedGLContext context;
     GLuint handle;
     glGenTextures(1, &handle);
 
@@ -250,6 +252,7 @@ void TextureCube::setTexParameters(const TexParams& texParams)
 {
     CCASSERT(_name != 0, __FUNCTION__);
 
+    ScopedGLContext context;
     GL::bindTextureN(0, _name, GL_TEXTURE_CUBE_MAP);
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, texParams.minFilter);
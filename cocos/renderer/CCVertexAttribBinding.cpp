@@ -22,6 +22,7 @@
 #include "CCVertexAttribBinding.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/CCRenderThread.h"
 #include "platform/CCGL.h"
 #include "base/CCConfiguration.h"
 #include "3d/CCMeshVertexIndexData.h"
@@ -63,6 +64,7 @@ VertexAttribBinding::~VertexAttribBinding()
 
     if (_handle)
     {
+        ScopedGLContext context;
         glDeleteVertexArrays(1, &_handle);
         _handle = 0;
     }
@@ -99,6 +101,7 @@ bool VertexAttribBinding::init(MeshIndexData* meshIndexData, GLProgramState* glP
 {
     CCASSERT(meshIndexData && glProgramState, "Invalid arguments");
 
+    ScopedGLContext context;
     // One-time initialization.
     if (__maxVertexAttribs == 0)
     {
@@ -141,12 +144,12 @@ bool VertexAttribBinding::init(MeshIndexData* meshIndexData, GLProgramState* glP
     // VAO hardware
     if (Configuration::getInstance()->supportsShareableVAO())
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
         glGenVertexArrays(1, &_handle);
         GL::bindVAO(_handle);
-        glBindBuffer(GL_ARRAY_BUFFER, meshVertexData->getVertexBuffer()->getVBO());
+        GL::bindBuffer(GL_ARRAY_BUFFER, meshVertexData->getVertexBuffer()->getVBO());
 
         auto flags = _vertexAttribsFlags;
         for (int i = 0; flags > 0; i++) {
@@ -156,7 +159,7 @@ bool VertexAttribBinding::init(MeshIndexData* meshIndexData, GLProgramState* glP
             flags &= ~flag;
         }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshIndexData->getIndexBuffer()->getVBO());
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshIndexData->getIndexBuffer()->getVBO());
 
         for(auto &attribute : _attributes)
         {
@@ -181,8 +184,8 @@ void VertexAttribBinding::bind()
     {
         // software
         auto meshVertexData = _meshIndexData->getMeshVertexData();
-        glBindBuffer(GL_ARRAY_BUFFER, meshVertexData->getVertexBuffer()->getVBO());
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _meshIndexData->getIndexBuffer()->getVBO());
+        GL::bindBuffer(GL_ARRAY_BUFFER, meshVertexData->getVertexBuffer()->getVBO());
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _meshIndexData->getIndexBuffer()->getVBO());
 
         // Software mode
         GL::enableVertexAttribs(_vertexAttribsFlags);
@@ -205,8 +208,8 @@ void VertexAttribBinding::unbind()
     else
     {
         // Software
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 }
 
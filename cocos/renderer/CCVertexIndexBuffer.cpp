@@ -27,6 +27,7 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCDirector.h"
+#include "renderer/CCRenderThread.h"
 
 NS_CC_BEGIN
 
@@ -75,9 +76,10 @@ VertexBuffer::VertexBuffer()
 
 VertexBuffer::~VertexBuffer()
 {
+    ScopedGLContext context;
     if(glIsBuffer(_vbo))
     {
-        glDeleteBuffers(1, &_vbo);
+        GL::deleteBuffers(1, &_vbo);
         _vbo = 0;
     }
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -87,6 +89,7 @@ VertexBuffer::~VertexBuffer()
 
 bool VertexBuffer::init(int sizePerVertex, int vertexNumber, GLenum usage/* = GL_STATIC_DRAW*/)
 {
+    ScopedGLContext context;
     if(0 == sizePerVertex || 0 == vertexNumber)
         return false;
     _sizePerVertex = sizePerVertex;
@@ -99,9 +102,9 @@ bool VertexBuffer::init(int sizePerVertex, int vertexNumber, GLenum usage/* = GL
     }
     
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ARRAY_BUFFER, getSize(), nullptr, _usage);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     return true;
 }
 
@@ -117,6 +120,7 @@ int VertexBuffer::getVertexNumber() const
 
 bool VertexBuffer::updateVertices(const void* verts, int count, int begin)
 {
+    ScopedGLContext context;
     if(count <= 0 || nullptr == verts) return false;
     
     if(begin < 0)
@@ -136,9 +140,9 @@ bool VertexBuffer::updateVertices(const void* verts, int count, int begin)
         memcpy(&_shadowCopy[begin * _sizePerVertex], verts, count * _sizePerVertex);
     }
     
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferSubData(GL_ARRAY_BUFFER, begin * _sizePerVertex, count * _sizePerVertex, verts);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     return true;
 }
@@ -152,7 +156,7 @@ void VertexBuffer::recreateVBO() const
 {
     CCLOG("come to foreground of VertexBuffer");
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     const void* buffer = nullptr;
     if(isShadowCopyEnabled())
     {
@@ -160,7 +164,7 @@ void VertexBuffer::recreateVBO() const
     }
     CCLOG("recreate IndexBuffer with size %d %d", getSizePerVertex(), _vertexNumber);
     glBufferData(GL_ARRAY_BUFFER, _sizePerVertex * _vertexNumber, buffer, _usage);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     if(!glIsBuffer(_vbo))
     {
         CCLOGERROR("recreate VertexBuffer Error");
@@ -202,9 +206,10 @@ IndexBuffer::IndexBuffer()
 
 IndexBuffer::~IndexBuffer()
 {
+    ScopedGLContext context;
     if(glIsBuffer(_vbo))
     {
-        glDeleteBuffers(1, &_vbo);
+        GL::deleteBuffers(1, &_vbo);
         _vbo = 0;
     }
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -214,6 +219,7 @@ IndexBuffer::~IndexBuffer()
 
 bool IndexBuffer::init(IndexBuffer::IndexType type, int number, GLenum usage/* = GL_STATIC_DRAW*/)
 {
+    ScopedGLContext context;
     if(number <=0 ) return false;
     
     _type = type;
@@ -221,9 +227,9 @@ bool IndexBuffer::init(IndexBuffer::IndexType type, int number, GLenum usage/* =
     _usage = usage;
     
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, getSize(), nullptr, _usage);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     
     if(isShadowCopyEnabled())
     {
@@ -250,6 +256,7 @@ int IndexBuffer::getIndexNumber() const
 
 bool IndexBuffer::updateIndices(const void* indices, int count, int begin)
 {
+    ScopedGLContext context;
     if(count <= 0 || nullptr == indices) return false;
     
     if(begin < 0)
@@ -264,9 +271,9 @@ bool IndexBuffer::updateIndices(const void* indices, int count, int begin)
         count = _indexNumber - begin;
     }
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _vbo);
     glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, begin * getSizePerIndex(), count * getSizePerIndex(), indices);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     
     if(isShadowCopyEnabled())
     {
@@ -290,7 +297,7 @@ void IndexBuffer::recreateVBO() const
 {
     CCLOG("come to foreground of IndexBuffer");
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     const void* buffer = nullptr;
     if(isShadowCopyEnabled())
     {
@@ -298,7 +305,7 @@ void IndexBuffer::recreateVBO() const
     }
     CCLOG("recreate IndexBuffer with size %d %d ", getSizePerIndex(), _indexNumber);
     glBufferData(GL_ARRAY_BUFFER, getSize(), buffer, _usage);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     if(!glIsBuffer(_vbo))
     {
         CCLOGERROR("recreate IndexBuffer Error");
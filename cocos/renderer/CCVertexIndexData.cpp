@@ -126,7 +126,7 @@ void VertexData::use()
     for(auto& element : _vertexStreams)
     {
         //glEnableVertexAttribArray((GLint)element.second._stream._semantic);
-        glBindBuffer(GL_ARRAY_BUFFER, element.second._buffer->getVBO());
+        GL::bindBuffer(GL_ARRAY_BUFFER, element.second._buffer->getVBO());
         size_t offet = element.second._stream._offset;
         glVertexAttribPointer(GLint(element.second._stream._semantic),element.second._stream._size,
                               element.second._stream._type,element.second._stream._normalize, element.second._buffer->getSizePerVertex(), (GLvoid*)offet);
@@ -37,11 +37,13 @@ NS_CC_BEGIN
 
 static const int MAX_ATTRIBUTES = 16;
 static const int MAX_ACTIVE_TEXTURE = 16;
+static const int MAX_CACHED_CAPABILITIES = 6;
 
 namespace
 {
     static GLuint s_currentProjectionMatrix = -1;
     static uint32_t s_attributeFlags = 0;  // 32 attributes max
+    static GL::StateCacheStats s_stats;
 
 #if CC_ENABLE_GL_STATE_CACHE
 
@@ -53,7 +55,38 @@ namespace
     static GLuint    s_VAO = 0;
     static GLenum    s_activeTexture = -1;
 
+    // -1 while unknown
+    static int       s_capabilities[MAX_CACHED_CAPABILITIES] = { -1, -1, -1, -1, -1, -1 };
+    static int       s_depthMask = -1;
+    static GLenum    s_depthFunc = -1;
+    static GLenum    s_cullFace = -1;
+    static GLenum    s_frontFace = -1;
+    static GLuint    s_arrayBuffer = -1;
+    static GLuint    s_elementArrayBuffer = -1;
+
+    static int capabilityIndex(GLenum capability)
+    {
+        switch (capability)
+        {
+            case GL_BLEND: return 0;
+            case GL_CULL_FACE: return 1;
+            case GL_DEPTH_TEST: return 2;
+            case GL_SCISSOR_TEST: return 3;
+            case GL_STENCIL_TEST: return 4;
+            case GL_POLYGON_OFFSET_FILL: return 5;
+            default: return -1;
+        }
+    }
+
 #endif // CC_ENABLE_GL_STATE_CACHE
+
+    inline void countCall(GL::StateCall call, bool issued)
+    {
+        if (issued)
+            ++s_stats.issued[call];
+        else
+            ++s_stats.filtered[call];
+    }
 }
 
 // GL State Cache functions
@@ -77,7 +110,19 @@ void invalidateStateCache( void )
     s_blendingDest = -1;
     s_GLServerState = 0;
     s_VAO = 0;
-    
+    s_activeTexture = -1;
+
+    for (int i = 0; i < MAX_CACHED_CAPABILITIES; i++)
+    {
+        s_capabilities[i] = -1;
+    }
+    s_depthMask = -1;
+    s_depthFunc = -1;
+    s_cullFace = -1;
+    s_frontFace = -1;
+    s_arrayBuffer = -1;
+    s_elementArrayBuffer = -1;
+
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
 
@@ -98,9 +143,13 @@ void useProgram( GLuint program )
 #if CC_ENABLE_GL_STATE_CACHE
     if( program != s_currentShaderProgram ) {
         s_currentShaderProgram = program;
+        countCall(STATE_CALL_PROGRAM, true);
         glUseProgram(program);
     }
+    else
+        countCall(STATE_CALL_PROGRAM, false);
 #else
+    countCall(STATE_CALL_PROGRAM, true);
     glUseProgram(program);
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -109,12 +158,13 @@ static void SetBlending(GLenum sfactor, GLenum dfactor)
 {
 	if (sfactor == GL_ONE && dfactor == GL_ZERO)
     {
-		glDisable(GL_BLEND);
+		GL::disable(GL_BLEND);
         RenderState::StateBlock::_defaultState->setBlend(false);
 	}
     else
     {
-		glEnable(GL_BLEND);
+		GL::enable(GL_BLEND);
+        countCall(STATE_CALL_BLEND_FUNC, true);
 		glBlendFunc(sfactor, dfactor);
 
         RenderState::StateBlock::_defaultState->setBlend(true);
@@ -132,6 +182,8 @@ void blendFunc(GLenum sfactor, GLenum dfactor)
         s_blendingDest = dfactor;
         SetBlending(sfactor, dfactor);
     }
+    else
+        countCall(STATE_CALL_BLEND_FUNC, false);
 #else
     SetBlending( sfactor, dfactor );
 #endif // CC_ENABLE_GL_STATE_CACHE
@@ -160,10 +212,14 @@ void bindTexture2DN(GLuint textureUnit, GLuint textureId)
 	{
 		s_currentBoundTexture[textureUnit] = textureId;
 		activeTexture(GL_TEXTURE0 + textureUnit);
+		countCall(STATE_CALL_TEXTURE, true);
 		glBindTexture(GL_TEXTURE_2D, textureId);
 	}
+	else
+		countCall(STATE_CALL_TEXTURE, false);
 #else
-	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	activeTexture(GL_TEXTURE0 + textureUnit);
+	countCall(STATE_CALL_TEXTURE, true);
 	glBindTexture(GL_TEXTURE_2D, textureId);
 #endif
 }
@@ -176,10 +232,14 @@ void bindTextureN(GLuint textureUnit, GLuint textureId, GLuint textureType/* = G
     {
         s_currentBoundTexture[textureUnit] = textureId;
         activeTexture(GL_TEXTURE0 + textureUnit);
+        countCall(STATE_CALL_TEXTURE, true);
         glBindTexture(textureType, textureId);
     }
+    else
+        countCall(STATE_CALL_TEXTURE, false);
 #else
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    activeTexture(GL_TEXTURE0 + textureUnit);
+    countCall(STATE_CALL_TEXTURE, true);
     glBindTexture(textureType, textureId);
 #endif
 }
@@ -210,9 +270,13 @@ void activeTexture(GLenum texture)
 #if CC_ENABLE_GL_STATE_CACHE
     if(s_activeTexture != texture) {
         s_activeTexture = texture;
+        countCall(STATE_CALL_TEXTURE, true);
         glActiveTexture(s_activeTexture);
     }
+    else
+        countCall(STATE_CALL_TEXTURE, false);
 #else
+    countCall(STATE_CALL_TEXTURE, true);
     glActiveTexture(texture);
 #endif
 }
@@ -226,9 +290,15 @@ void bindVAO(GLuint vaoId)
         if (s_VAO != vaoId)
         {
             s_VAO = vaoId;
+            // the element array buffer binding belongs to the VAO
+            s_elementArrayBuffer = -1;
+            countCall(STATE_CALL_VAO, true);
             glBindVertexArray(vaoId);
         }
+        else
+            countCall(STATE_CALL_VAO, false);
 #else
+        countCall(STATE_CALL_VAO, true);
         glBindVertexArray(vaoId);
 #endif // CC_ENABLE_GL_STATE_CACHE
     
@@ -249,6 +319,7 @@ void enableVertexAttribs(uint32_t flags)
         bool enabledBefore = (s_attributeFlags & bit) != 0;
         if(enabled != enabledBefore) 
         {
+            countCall(STATE_CALL_VERTEX_ATTRIB, true);
             if( enabled )
                 glEnableVertexAttribArray(i);
             else
@@ -265,6 +336,192 @@ void setProjectionMatrixDirty( void )
     s_currentProjectionMatrix = -1;
 }
 
+// GL server side state functions
+
+static void setCapability(GLenum capability, bool enabled)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = capabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilities[index] == (int)enabled)
+        {
+            countCall(STATE_CALL_CAPABILITY, false);
+            return;
+        }
+        s_capabilities[index] = enabled;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    countCall(STATE_CALL_CAPABILITY, true);
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+void enable(GLenum capability)
+{
+    setCapability(capability, true);
+}
+
+void disable(GLenum capability)
+{
+    setCapability(capability, false);
+}
+
+bool isEnabled(GLenum capability)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = capabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilities[index] < 0)
+            s_capabilities[index] = glIsEnabled(capability) != GL_FALSE;
+        return s_capabilities[index] != 0;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    return glIsEnabled(capability) != GL_FALSE;
+}
+
+void depthMask(GLboolean flag)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int value = flag ? 1 : 0;
+    if (s_depthMask == value)
+    {
+        countCall(STATE_CALL_DEPTH_MASK, false);
+        return;
+    }
+    s_depthMask = value;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    countCall(STATE_CALL_DEPTH_MASK, true);
+    glDepthMask(flag);
+}
+
+GLboolean getDepthMask()
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthMask < 0)
+    {
+        GLboolean flag = GL_TRUE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+        s_depthMask = flag ? 1 : 0;
+    }
+    return s_depthMask ? GL_TRUE : GL_FALSE;
+#else
+    GLboolean flag = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+    return flag;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void depthFunc(GLenum func)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthFunc == func)
+    {
+        countCall(STATE_CALL_DEPTH_FUNC, false);
+        return;
+    }
+    s_depthFunc = func;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    countCall(STATE_CALL_DEPTH_FUNC, true);
+    glDepthFunc(func);
+}
+
+void cullFace(GLenum mode)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_cullFace == mode)
+    {
+        countCall(STATE_CALL_FACE, false);
+        return;
+    }
+    s_cullFace = mode;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    countCall(STATE_CALL_FACE, true);
+    glCullFace(mode);
+}
+
+void frontFace(GLenum mode)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_frontFace == mode)
+    {
+        countCall(STATE_CALL_FACE, false);
+        return;
+    }
+    s_frontFace = mode;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    countCall(STATE_CALL_FACE, true);
+    glFrontFace(mode);
+}
+
+// GL buffer functions
+
+void bindBuffer(GLenum target, GLuint buffer)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    GLuint* boundBuffer = nullptr;
+    if (target == GL_ARRAY_BUFFER)
+        boundBuffer = &s_arrayBuffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+        boundBuffer = &s_elementArrayBuffer;
+
+    if (boundBuffer)
+    {
+        if (*boundBuffer == buffer)
+        {
+            countCall(STATE_CALL_BUFFER, false);
+            return;
+        }
+        *boundBuffer = buffer;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    countCall(STATE_CALL_BUFFER, true);
+    glBindBuffer(target, buffer);
+}
+
+void deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    // GL unbinds deleted buffers, and the names may be generated again
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (s_arrayBuffer == buffers[i])
+            s_arrayBuffer = -1;
+        if (s_elementArrayBuffer == buffers[i])
+            s_elementArrayBuffer = -1;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glDeleteBuffers(n, buffers);
+}
+
+// Statistics
+
+void countStateCall(StateCall call, bool issued)
+{
+    countCall(call, issued);
+}
+
+const StateCacheStats& getStateCacheStats()
+{
+    return s_stats;
+}
+
+void resetStateCacheStats()
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
 } // Namespace GL
 
 NS_CC_END
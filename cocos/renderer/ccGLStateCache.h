@@ -58,6 +58,35 @@ enum {
     VERTEX_ATTRIB_FLAG_POS_COLOR_TEX = (VERTEX_ATTRIB_FLAG_POSITION | VERTEX_ATTRIB_FLAG_COLOR | VERTEX_ATTRIB_FLAG_TEX_COORD),
 };
 
+/** Kinds of state changes counted by the state cache. */
+enum StateCall {
+    STATE_CALL_PROGRAM,
+    /** glBindTexture() and glActiveTexture(). */
+    STATE_CALL_TEXTURE,
+    STATE_CALL_BLEND_FUNC,
+    /** glEnable() and glDisable(). */
+    STATE_CALL_CAPABILITY,
+    STATE_CALL_DEPTH_MASK,
+    STATE_CALL_DEPTH_FUNC,
+    /** glCullFace() and glFrontFace(). */
+    STATE_CALL_FACE,
+    STATE_CALL_BUFFER,
+    STATE_CALL_VAO,
+    /** glEnableVertexAttribArray() and glDisableVertexAttribArray(). */
+    STATE_CALL_VERTEX_ATTRIB,
+    /** glUniform*() sent by GLProgram. */
+    STATE_CALL_UNIFORM,
+
+    STATE_CALL_MAX
+};
+
+/** Number of state changes sent to GL, and of the ones filtered out because GL already had that state. */
+struct StateCacheStats
+{
+    unsigned int issued[STATE_CALL_MAX];
+    unsigned int filtered[STATE_CALL_MAX];
+};
+
 /** 
  * Invalidates the GL state cache.
  *
@@ -172,6 +201,104 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/**
+ * Enables a server side capability in case it is not already enabled.
+ * GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TEST and GL_POLYGON_OFFSET_FILL are cached,
+ * the other capabilities are always enabled.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable() directly.
+ * @since v3.9
+ */
+void CC_DLL enable(GLenum capability);
+
+/**
+ * Disables a server side capability in case it is not already disabled, @see enable().
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDisable() directly.
+ * @since v3.9
+ */
+void CC_DLL disable(GLenum capability);
+
+/**
+ * Returns whether a capability is enabled. Cached capabilities are only queried once after the cache is invalidated.
+ * @since v3.9
+ */
+bool CC_DLL isEnabled(GLenum capability);
+
+/**
+ * Enables or disables depth writing in case it is not already the case.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthMask() directly.
+ * @since v3.9
+ */
+void CC_DLL depthMask(GLboolean flag);
+
+/**
+ * Returns whether depth writing is enabled. It is only queried once after the cache is invalidated.
+ * @since v3.9
+ */
+GLboolean CC_DLL getDepthMask();
+
+/**
+ * Sets the depth comparison function in case it is not already used.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthFunc() directly.
+ * @since v3.9
+ */
+void CC_DLL depthFunc(GLenum func);
+
+/**
+ * Selects the culled faces in case they are not already selected.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glCullFace() directly.
+ * @since v3.9
+ */
+void CC_DLL cullFace(GLenum mode);
+
+/**
+ * Selects the front facing winding in case it is not already selected.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glFrontFace() directly.
+ * @since v3.9
+ */
+void CC_DLL frontFace(GLenum mode);
+
+/**
+ * If the buffer is not already bound to the target, it binds it.
+ * GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached, the element array buffer until another VAO is bound.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glBindBuffer() directly.
+ * @since v3.9
+ */
+void CC_DLL bindBuffer(GLenum target, GLuint buffer);
+
+/**
+ * Deletes the buffers. If one of them was bound, it invalidates the cached binding.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDeleteBuffers() directly.
+ * @since v3.9
+ */
+void CC_DLL deleteBuffers(GLsizei n, const GLuint* buffers);
+
+/**
+ * Counts a state change made outside of the state cache, such as a uniform update filtered by GLProgram.
+ * @since v3.9
+ */
+void CC_DLL countStateCall(StateCall call, bool issued);
+
+/**
+ * Returns the state changes counted since the last call to resetStateCacheStats().
+ * The Renderer resets them at the beginning of every frame, so these are the counts of the frame being drawn.
+ * @since v3.9
+ */
+const StateCacheStats& CC_DLL getStateCacheStats();
+
+/**
+ * Resets the counts of state changes.
+ * @since v3.9
+ */
+void CC_DLL resetStateCacheStats();
+
 // end of support group
 /// @}
 
@@ -78,7 +78,7 @@ bool JSB_glBindBuffer(JSContext *cx, uint32_t argc, jsval *vp) {
     ok &= jsval_to_uint32( cx, args.get(1), &arg1 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glBindBuffer((GLenum)arg0 , (GLuint)arg1  );
+    cocos2d::GL::bindBuffer((GLenum)arg0 , (GLuint)arg1  );
     args.rval().setUndefined();
     return true;
 }
@@ -514,7 +514,7 @@ bool JSB_glCullFace(JSContext *cx, uint32_t argc, jsval *vp) {
     ok &= jsval_to_uint32( cx, args.get(0), &arg0 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glCullFace((GLenum)arg0  );
+    cocos2d::GL::cullFace((GLenum)arg0  );
     args.rval().setUndefined();
     return true;
 }
@@ -562,7 +562,7 @@ bool JSB_glDepthFunc(JSContext *cx, uint32_t argc, jsval *vp) {
     ok &= jsval_to_uint32( cx, args.get(0), &arg0 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glDepthFunc((GLenum)arg0  );
+    cocos2d::GL::depthFunc((GLenum)arg0  );
     args.rval().setUndefined();
     return true;
 }
@@ -578,7 +578,7 @@ bool JSB_glDepthMask(JSContext *cx, uint32_t argc, jsval *vp) {
     ok &= jsval_to_uint16( cx, args.get(0), &arg0 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glDepthMask((GLboolean)arg0  );
+    cocos2d::GL::depthMask((GLboolean)arg0  );
     args.rval().setUndefined();
     return true;
 }
@@ -628,7 +628,7 @@ bool JSB_glDisable(JSContext *cx, uint32_t argc, jsval *vp) {
     ok &= jsval_to_uint32( cx, args.get(0), &arg0 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glDisable((GLenum)arg0  );
+    cocos2d::GL::disable((GLenum)arg0  );
     args.rval().setUndefined();
     return true;
 }
@@ -698,7 +698,7 @@ bool JSB_glEnable(JSContext *cx, uint32_t argc, jsval *vp) {
     ok &= jsval_to_uint32( cx, args.get(0), &arg0 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glEnable((GLenum)arg0  );
+    cocos2d::GL::enable((GLenum)arg0  );
     args.rval().setUndefined();
     return true;
 }
@@ -789,7 +789,7 @@ bool JSB_glFrontFace(JSContext *cx, uint32_t argc, jsval *vp) {
     ok &= jsval_to_uint32( cx, args.get(0), &arg0 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glFrontFace((GLenum)arg0  );
+    cocos2d::GL::frontFace((GLenum)arg0  );
     args.rval().setUndefined();
     return true;
 }
@@ -97,7 +97,7 @@ bool JSB_glDeleteBuffers(JSContext *cx, uint32_t argc, jsval *vp)
     ok &= jsval_to_uint( cx, args.get(0), &arg0 );
     JSB_PRECONDITION2(ok, cx, false, "Error processing arguments");
 
-    glDeleteBuffers(1, &arg0);
+    cocos2d::GL::deleteBuffers(1, &arg0);
     args.rval().set(JSVAL_VOID);
     return true;
 }
@@ -182,6 +182,7 @@ bool LuaStack::init(void)
     luaL_register(_state, "_G", global_functions);
 
     g_luaType.clear();
+    clearLuaTypeNameCache();
     register_all_cocos2dx(_state);
     tolua_opengl_open(_state);
     register_all_cocos2dx_manual(_state);
@@ -30,6 +30,35 @@
 std::unordered_map<std::string, std::string>  g_luaType;
 std::unordered_map<std::string, std::string>  g_typeCast;
 
+// the names of g_luaType by type_info, nullptr for the classes which aren't registered
+static std::unordered_map<const std::type_info*, const std::string*> s_luaTypeNameCache;
+static size_t s_luaTypeNameCacheTypeCount = 0;
+
+const char* getLuaTypeNameByTypeInfo(const std::type_info& info)
+{
+    // a class registered after a miss was cached must be found, g_luaType only grows while the modules register
+    if (s_luaTypeNameCacheTypeCount != g_luaType.size())
+    {
+        s_luaTypeNameCache.clear();
+        s_luaTypeNameCacheTypeCount = g_luaType.size();
+    }
+
+    auto iter = s_luaTypeNameCache.find(&info);
+    if (s_luaTypeNameCache.end() == iter)
+    {
+        auto typeIter = g_luaType.find(info.name());
+        const std::string* name = (g_luaType.end() != typeIter) ? &typeIter->second : nullptr;
+        iter = s_luaTypeNameCache.insert(std::make_pair(&info, name)).first;
+    }
+    return (nullptr != iter->second) ? iter->second->c_str() : nullptr;
+}
+
+void clearLuaTypeNameCache()
+{
+    s_luaTypeNameCache.clear();
+    s_luaTypeNameCacheTypeCount = 0;
+}
+
 #if COCOS2D_DEBUG >=1
 void luaval_to_native_err(lua_State* L,const char* msg,tolua_Error* err, const char* funcName)
 {
@@ -2332,12 +2361,11 @@ void vec2_array_to_luaval(lua_State* L,const cocos2d::Vec2* points, int count)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);
+    lua_createtable(L, count, 0);
     for (int i = 1; i <= count; ++i)
     {
-        lua_pushnumber(L, i);
         vec2_to_luaval(L, points[i-1]);
-        lua_rawset(L, -3);
+        lua_rawseti(L, -2, i);
     }
 }
 
@@ -2345,7 +2373,7 @@ void vec2_to_luaval(lua_State* L,const cocos2d::Vec2& vec2)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 2);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) vec2.x);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2360,7 +2388,7 @@ void vec3_to_luaval(lua_State* L,const cocos2d::Vec3& vec3)
     if (NULL  == L)
         return;
     
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 3);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) vec3.x);             /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2377,7 +2405,7 @@ void vec4_to_luaval(lua_State* L,const cocos2d::Vec4& vec4)
     if (NULL  == L)
         return;
     
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) vec4.x);             /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2475,7 +2503,7 @@ void size_to_luaval(lua_State* L,const Size& sz)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 2);                           /* L: table */
     lua_pushstring(L, "width");                         /* L: table key */
     lua_pushnumber(L, (lua_Number) sz.width);           /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2488,7 +2516,7 @@ void rect_to_luaval(lua_State* L,const Rect& rt)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) rt.origin.x);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2507,7 +2535,7 @@ void color4b_to_luaval(lua_State* L,const Color4B& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "r");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2526,7 +2554,7 @@ void color4f_to_luaval(lua_State* L,const Color4F& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "r");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2545,7 +2573,7 @@ void color3b_to_luaval(lua_State* L,const Color3B& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 3);                           /* L: table */
     lua_pushstring(L, "r");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -2557,6 +2585,46 @@ void color3b_to_luaval(lua_State* L,const Color3B& cc)
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
 }
 
+static void set_number_field(lua_State* L, int lo, const char* key, lua_Number value)
+{
+    lua_pushstring(L, key);                             /* L: key */
+    lua_pushnumber(L, value);                           /* L: key value */
+    lua_rawset(L, lo);                                  /* table[key] = value */
+}
+
+static int absolute_index(lua_State* L, int lo)
+{
+    return (lo < 0 && lo > LUA_REGISTRYINDEX) ? lua_gettop(L) + lo + 1 : lo;
+}
+
+void vec2_to_luatable(lua_State* L, int lo, const cocos2d::Vec2& vec2)
+{
+    if (nullptr == L)
+        return;
+    lo = absolute_index(L, lo);
+    set_number_field(L, lo, "x", vec2.x);
+    set_number_field(L, lo, "y", vec2.y);
+}
+
+void vec3_to_luatable(lua_State* L, int lo, const cocos2d::Vec3& vec3)
+{
+    if (nullptr == L)
+        return;
+    lo = absolute_index(L, lo);
+    set_number_field(L, lo, "x", vec3.x);
+    set_number_field(L, lo, "y", vec3.y);
+    set_number_field(L, lo, "z", vec3.z);
+}
+
+void size_to_luatable(lua_State* L, int lo, const Size& sz)
+{
+    if (nullptr == L)
+        return;
+    lo = absolute_index(L, lo);
+    set_number_field(L, lo, "width", sz.width);
+    set_number_field(L, lo, "height", sz.height);
+}
+
 void affinetransform_to_luaval(lua_State* L,const AffineTransform& inValue)
 {
     if (NULL  == L)
@@ -2663,11 +2731,10 @@ void array_to_luaval(lua_State* L,__Array* inValue)
         if (nullptr == obj)
             continue;
         
-        std::string typeName = typeid(*obj).name();
-        auto iter = g_luaType.find(typeName);
-        if (g_luaType.end() != iter)
+        const char* typeName = getLuaTypeNameByTypeInfo(typeid(*obj));
+        if (nullptr != typeName)
         {
-            className = iter->second;
+            className = typeName;
             if (nullptr != dynamic_cast<cocos2d::Ref *>(obj))
             {
                 lua_pushnumber(L, (lua_Number)indexTable);                
@@ -2752,12 +2819,10 @@ void dictionary_to_luaval(lua_State* L, __Dictionary* dict)
         if (NULL == element)
             continue;
         
-        std::string typeName = typeid(element->getObject()).name();
-        
-        auto iter = g_luaType.find(typeName);
-        if (g_luaType.end() != iter)
+        const char* typeName = getLuaTypeNameByTypeInfo(typeid(element->getObject()));
+        if (nullptr != typeName)
         {
-            className = iter->second;
+            className = typeName;
             if ( nullptr != dynamic_cast<Ref*>(element->getObject()))
             {
                 lua_pushstring(L, element->getStrKey());
@@ -3064,15 +3129,11 @@ void mat4_to_luaval(lua_State* L, const cocos2d::Mat4& mat)
     if (nullptr  == L)
         return;
     
-    lua_newtable(L);                                    /* L: table */
-    int indexTable = 1;
-    
+    lua_createtable(L, 16, 0);                          /* L: table */
     for (int i = 0; i < 16; i++)
     {
-        lua_pushnumber(L, (lua_Number)indexTable);
         lua_pushnumber(L, (lua_Number)mat.m[i]);
-        lua_rawset(L, -3);
-        ++indexTable;
+        lua_rawseti(L, -2, i + 1);
     }
 }
 
@@ -3278,7 +3339,7 @@ void quaternion_to_luaval(lua_State* L,const cocos2d::Quaternion& inValue)
     if (NULL  == L)
         return;
     
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) inValue.x);             /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
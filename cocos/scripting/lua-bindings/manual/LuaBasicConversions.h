@@ -36,6 +36,22 @@ using namespace cocos2d;
 extern std::unordered_map<std::string, std::string>  g_luaType;
 extern std::unordered_map<std::string, std::string>  g_typeCast;
 
+/**
+ * Get the Lua type name registered in g_luaType for a native class.
+ * The name is looked up once by class, the next calls for the same type_info find it in a cache.
+ *
+ * @param info the type_info of the native class.
+ * @return the Lua type name, or nullptr if the class isn't registered.
+ * @since v3.9
+ */
+extern const char* getLuaTypeNameByTypeInfo(const std::type_info& info);
+
+/**
+ * Forget the names cached by getLuaTypeNameByTypeInfo, to call when g_luaType is cleared.
+ * @since v3.9
+ */
+extern void clearLuaTypeNameCache();
+
 #if COCOS2D_DEBUG >=1
 void luaval_to_native_err(lua_State* L,const char* msg,tolua_Error* err, const char* funcName = "");
 #endif
@@ -1058,14 +1074,13 @@ void ccvector_to_luaval(lua_State* L,const cocos2d::Vector<T>& inValue)
 
         if (nullptr != dynamic_cast<cocos2d::Ref *>(obj))
         {
-            std::string typeName = typeid(*obj).name();
-            auto iter = g_luaType.find(typeName);
-            if (g_luaType.end() != iter)
+            const char* typeName = getLuaTypeNameByTypeInfo(typeid(*obj));
+            if (nullptr != typeName)
             {
                 lua_pushnumber(L, (lua_Number)indexTable);
                 int ID = (obj) ? (int)obj->_ID : -1;
                 int* luaID = (obj) ? &obj->_luaID : NULL;
-                toluafix_pushusertype_ccobject(L, ID, luaID, (void*)obj,iter->second.c_str());
+                toluafix_pushusertype_ccobject(L, ID, luaID, (void*)obj,typeName);
                 lua_rawset(L, -3);
                 ++indexTable;
             }
@@ -1095,14 +1110,13 @@ void ccmap_string_key_to_luaval(lua_State* L, const cocos2d::Map<std::string, T>
         T obj = iter->second;
         if (nullptr != dynamic_cast<cocos2d::Ref *>(obj))
         {
-            std::string name = typeid(*obj).name();
-            auto typeIter = g_luaType.find(name);
-            if (g_luaType.end() != typeIter)
+            const char* typeName = getLuaTypeNameByTypeInfo(typeid(*obj));
+            if (nullptr != typeName)
             {
                 lua_pushstring(L, key.c_str());
                 int ID = (obj) ? (int)obj->_ID : -1;
                 int* luaID = (obj) ? &obj->_luaID : NULL;
-                toluafix_pushusertype_ccobject(L, ID, luaID, (void*)obj,typeIter->second.c_str());
+                toluafix_pushusertype_ccobject(L, ID, luaID, (void*)obj,typeName);
                 lua_rawset(L, -3);
             }
         }
@@ -1154,6 +1168,27 @@ void ccvaluevector_to_luaval(lua_State* L, const cocos2d::ValueVector& inValue);
 
 /**@}**/
 
+/**
+ * @name native_to_luatable
+ * The following functions write native c++ values into a table already on the Lua stack, in the same format as the
+ * corresponding xxx_to_luaval functions. A binding which takes an optional table to fill lets a script reuse one table
+ * every frame, instead of allocating a new one by call.
+ * lo may be a negative index, the stack is left unchanged.
+ * @since v3.9
+ * @{
+ **/
+
+/** Set the fields x and y of the table at lo. */
+extern void vec2_to_luatable(lua_State* L, int lo, const cocos2d::Vec2& vec2);
+
+/** Set the fields x, y and z of the table at lo. */
+extern void vec3_to_luatable(lua_State* L, int lo, const cocos2d::Vec3& vec3);
+
+/** Set the fields width and height of the table at lo. */
+extern void size_to_luatable(lua_State* L, int lo, const Size& sz);
+
+/** @} **/
+
 /**
  * Get the real typename for the specified typename.
  * Because all override functions wouldn't be bound,so we must use `typeid` to get the real class name.
@@ -1167,16 +1202,8 @@ const char* getLuaTypeName(T* ret,const char* type)
 {
     if (nullptr != ret)
     {
-        std::string hashName = typeid(*ret).name();
-        auto iter =  g_luaType.find(hashName);
-        if(g_luaType.end() != iter)
-        {
-            return iter->second.c_str();
-        }
-        else
-        {
-            return type;
-        }
+        const char* name = getLuaTypeNameByTypeInfo(typeid(*ret));
+        return nullptr != name ? name : type;
     }
     
     return nullptr;
@@ -294,7 +294,7 @@ static int tolua_Cocos2d_glBindBuffer00(lua_State* tolua_S)
     {
         unsigned int target   = (unsigned int)tolua_tonumber(tolua_S,1,0);
         unsigned int buffer   = (unsigned int)tolua_tonumber(tolua_S,2,0);
-        glBindBuffer((GLenum)target,(GLuint)buffer);
+        GL::bindBuffer((GLenum)target,(GLuint)buffer);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1075,7 +1075,7 @@ static int tolua_Cocos2d_glCullFace00(lua_State* tolua_S)
 #endif
     {
         unsigned int mode   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glCullFace((GLenum)mode  );
+        GL::cullFace((GLenum)mode  );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1101,7 +1101,7 @@ static int tolua_Cocos2d_glDeleteBuffers00(lua_State* tolua_S)
 #endif
     {
         unsigned int buffers   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glDeleteBuffers(1,&buffers );
+        GL::deleteBuffers(1,&buffers );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1127,7 +1127,7 @@ static int tolua_Cocos2d_glDeleteFramebuffers00(lua_State* tolua_S)
 #endif
     {
         unsigned int framebuffers   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glDeleteBuffers(1,&framebuffers );
+        GL::deleteBuffers(1,&framebuffers );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1257,7 +1257,7 @@ static int tolua_Cocos2d_glDepthFunc00(lua_State* tolua_S)
 #endif
     {
         unsigned int func   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glDepthFunc((GLenum)func);
+        GL::depthFunc((GLenum)func);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1283,7 +1283,7 @@ static int tolua_Cocos2d_glDepthMask00(lua_State* tolua_S)
 #endif
     {
         unsigned char flag   = (unsigned char)tolua_tonumber(tolua_S,1,0);
-        glDepthMask((GLboolean)flag  );
+        GL::depthMask((GLboolean)flag  );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1365,7 +1365,7 @@ static int tolua_Cocos2d_glDisable00(lua_State* tolua_S)
 #endif
     {
         unsigned int cap   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glDisable((GLenum)cap );
+        GL::disable((GLenum)cap );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1548,7 +1548,7 @@ static int tolua_Cocos2d_glEnable00(lua_State* tolua_S)
 #endif
     {
         unsigned int cap   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glEnable((GLenum)cap);
+        GL::enable((GLenum)cap);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1714,7 +1714,7 @@ static int tolua_Cocos2d_glFrontFace00(lua_State* tolua_S)
 #endif
     {
         unsigned int mode = (unsigned int)tolua_tonumber(tolua_S, 1, 0);
-        glFrontFace((GLenum)mode);
+        GL::frontFace((GLenum)mode);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -2218,6 +2218,218 @@ tolua_lerror:
 #endif
 }
 
+// getAnchorPoint(), getContentSize() and getPosition3D() fill the table passed as argument if any, so that
+// a script calling them every frame can reuse one table instead of allocating a new one by call
+static int tolua_cocos2d_Node_getAnchorPoint(lua_State* tolua_S)
+{
+    int argc = 0;
+    cocos2d::Node* cobj = nullptr;
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertype(tolua_S,1,"cc.Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    cobj = (cocos2d::Node*)tolua_tousertype(tolua_S,1,0);
+#if COCOS2D_DEBUG >= 1
+    if (!cobj)
+    {
+        tolua_error(tolua_S,"invalid 'cobj' in function 'tolua_cocos2d_Node_getAnchorPoint'", nullptr);
+        return 0;
+    }
+#endif
+    argc = lua_gettop(tolua_S)-1;
+    if (0 == argc)
+    {
+        vec2_to_luaval(tolua_S, cobj->getAnchorPoint());
+        return 1;
+    }
+    else if (1 == argc)
+    {
+#if COCOS2D_DEBUG >= 1
+        if (!tolua_istable(tolua_S, 2, 0, &tolua_err)) goto tolua_lerror;
+#endif
+        vec2_to_luatable(tolua_S, 2, cobj->getAnchorPoint());
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d \n", "cc.Node:getAnchorPoint",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'tolua_cocos2d_Node_getAnchorPoint'.",&tolua_err);
+#endif
+    return 0;
+}
+
+static int tolua_cocos2d_Node_getContentSize(lua_State* tolua_S)
+{
+    int argc = 0;
+    cocos2d::Node* cobj = nullptr;
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertype(tolua_S,1,"cc.Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    cobj = (cocos2d::Node*)tolua_tousertype(tolua_S,1,0);
+#if COCOS2D_DEBUG >= 1
+    if (!cobj)
+    {
+        tolua_error(tolua_S,"invalid 'cobj' in function 'tolua_cocos2d_Node_getContentSize'", nullptr);
+        return 0;
+    }
+#endif
+    argc = lua_gettop(tolua_S)-1;
+    if (0 == argc)
+    {
+        size_to_luaval(tolua_S, cobj->getContentSize());
+        return 1;
+    }
+    else if (1 == argc)
+    {
+#if COCOS2D_DEBUG >= 1
+        if (!tolua_istable(tolua_S, 2, 0, &tolua_err)) goto tolua_lerror;
+#endif
+        size_to_luatable(tolua_S, 2, cobj->getContentSize());
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d \n", "cc.Node:getContentSize",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'tolua_cocos2d_Node_getContentSize'.",&tolua_err);
+#endif
+    return 0;
+}
+
+static int tolua_cocos2d_Node_getPosition3D(lua_State* tolua_S)
+{
+    int argc = 0;
+    cocos2d::Node* cobj = nullptr;
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertype(tolua_S,1,"cc.Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    cobj = (cocos2d::Node*)tolua_tousertype(tolua_S,1,0);
+#if COCOS2D_DEBUG >= 1
+    if (!cobj)
+    {
+        tolua_error(tolua_S,"invalid 'cobj' in function 'tolua_cocos2d_Node_getPosition3D'", nullptr);
+        return 0;
+    }
+#endif
+    argc = lua_gettop(tolua_S)-1;
+    if (0 == argc)
+    {
+        vec3_to_luaval(tolua_S, cobj->getPosition3D());
+        return 1;
+    }
+    else if (1 == argc)
+    {
+#if COCOS2D_DEBUG >= 1
+        if (!tolua_istable(tolua_S, 2, 0, &tolua_err)) goto tolua_lerror;
+#endif
+        vec3_to_luatable(tolua_S, 2, cobj->getPosition3D());
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d \n", "cc.Node:getPosition3D",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'tolua_cocos2d_Node_getPosition3D'.",&tolua_err);
+#endif
+    return 0;
+}
+
+// cc.Node:setPositions(nodes, positions) sets the position of nodes[i] to positions[2i-1], positions[2i],
+// for as many nodes as there are pairs of numbers: one call for a whole array of nodes
+static int tolua_cocos2d_Node_setPositions(lua_State* tolua_S)
+{
+    int argc = 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertable(tolua_S,1,"cc.Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    argc = lua_gettop(tolua_S)-1;
+    if (2 == argc)
+    {
+#if COCOS2D_DEBUG >= 1
+        if (!tolua_istable(tolua_S, 2, 0, &tolua_err) || !tolua_istable(tolua_S, 3, 0, &tolua_err))
+            goto tolua_lerror;
+#endif
+        int count = std::min((int)lua_objlen(tolua_S, 2), (int)lua_objlen(tolua_S, 3) / 2);
+        for (int i = 1; i <= count; ++i)
+        {
+            lua_rawgeti(tolua_S, 2, i);                         /* L: ... node */
+#if COCOS2D_DEBUG >= 1
+            if (!tolua_isusertype(tolua_S, -1, "cc.Node", 0, &tolua_err))
+                goto tolua_lerror;
+#endif
+            cocos2d::Node* node = (cocos2d::Node*)tolua_tousertype(tolua_S, -1, 0);
+            lua_rawgeti(tolua_S, 3, 2 * i - 1);                 /* L: ... node x */
+            lua_rawgeti(tolua_S, 3, 2 * i);                     /* L: ... node x y */
+            if (node)
+                node->setPosition((float)lua_tonumber(tolua_S, -2), (float)lua_tonumber(tolua_S, -1));
+            lua_pop(tolua_S, 3);
+        }
+        return 0;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d \n", "cc.Node:setPositions",argc, 2);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'tolua_cocos2d_Node_setPositions'.",&tolua_err);
+#endif
+    return 0;
+}
+
+// cc.Node:getPositions(nodes [, positions]) writes the position of nodes[i] to positions[2i-1], positions[2i],
+// and returns positions, a new table if none is passed
+static int tolua_cocos2d_Node_getPositions(lua_State* tolua_S)
+{
+    int argc = 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertable(tolua_S,1,"cc.Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    argc = lua_gettop(tolua_S)-1;
+    if (1 == argc || 2 == argc)
+    {
+#if COCOS2D_DEBUG >= 1
+        if (!tolua_istable(tolua_S, 2, 0, &tolua_err) || !tolua_istable(tolua_S, 3, 1, &tolua_err))
+            goto tolua_lerror;
+#endif
+        int count = (int)lua_objlen(tolua_S, 2);
+        if (!lua_istable(tolua_S, 3))
+        {
+            lua_settop(tolua_S, 2);
+            lua_createtable(tolua_S, 2 * count, 0);            /* L: class nodes positions */
+        }
+        for (int i = 1; i <= count; ++i)
+        {
+            lua_rawgeti(tolua_S, 2, i);                         /* L: ... node */
+#if COCOS2D_DEBUG >= 1
+            if (!tolua_isusertype(tolua_S, -1, "cc.Node", 0, &tolua_err))
+                goto tolua_lerror;
+#endif
+            cocos2d::Node* node = (cocos2d::Node*)tolua_tousertype(tolua_S, -1, 0);
+            lua_pop(tolua_S, 1);
+            float x = 0.0f, y = 0.0f;
+            if (node)
+                node->getPosition(&x, &y);
+            lua_pushnumber(tolua_S, (lua_Number)x);
+            lua_rawseti(tolua_S, 3, 2 * i - 1);
+            lua_pushnumber(tolua_S, (lua_Number)y);
+            lua_rawseti(tolua_S, 3, 2 * i);
+        }
+        lua_settop(tolua_S, 3);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d \n", "cc.Node:getPositions",argc, 1);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'tolua_cocos2d_Node_getPositions'.",&tolua_err);
+#endif
+    return 0;
+}
+
 static int lua_cocos2dx_Node_enumerateChildren(lua_State* tolua_S)
 {
     int argc = 0;
@@ -5068,6 +5280,21 @@ static void extendNode(lua_State* tolua_S)
         lua_pushstring(tolua_S,"getPosition");
         lua_pushcfunction(tolua_S,tolua_cocos2d_Node_getPosition);
         lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S, "getAnchorPoint");
+        lua_pushcfunction(tolua_S, tolua_cocos2d_Node_getAnchorPoint);
+        lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S, "getContentSize");
+        lua_pushcfunction(tolua_S, tolua_cocos2d_Node_getContentSize);
+        lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S, "getPosition3D");
+        lua_pushcfunction(tolua_S, tolua_cocos2d_Node_getPosition3D);
+        lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S, "setPositions");
+        lua_pushcfunction(tolua_S, tolua_cocos2d_Node_setPositions);
+        lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S, "getPositions");
+        lua_pushcfunction(tolua_S, tolua_cocos2d_Node_getPositions);
+        lua_rawset(tolua_S, -3);
         lua_pushstring(tolua_S, "setContentSize");
         lua_pushcfunction(tolua_S, tolua_cocos2d_Node_setContentSize);
         lua_rawset(tolua_S, -3);
@@ -8121,11 +8348,31 @@ static void extendAutoPolygon(lua_State* tolua_S)
     lua_pop(tolua_S, 1);
 }
 
+static int tolua_cocos2d_tolua_getpushcount(lua_State* tolua_S)
+{
+    bool reset = lua_toboolean(tolua_S, 1) != 0;
+    lua_pushnumber(tolua_S, (lua_Number)toluafix_get_pushusertype_count(reset));
+    return 1;
+}
+
+static void extendTolua(lua_State* tolua_S)
+{
+    lua_getglobal(tolua_S, "tolua");
+    if (lua_istable(tolua_S, -1))
+    {
+        lua_pushstring(tolua_S, "getpushcount");
+        lua_pushcfunction(tolua_S, tolua_cocos2d_tolua_getpushcount);
+        lua_rawset(tolua_S, -3);
+    }
+    lua_pop(tolua_S, 1);
+}
+
 int register_all_cocos2dx_manual(lua_State* tolua_S)
 {
     if (NULL == tolua_S)
         return 0;
     
+    extendTolua(tolua_S);
     extendNode(tolua_S);
     extendScene(tolua_S);
     extendLayer(tolua_S);
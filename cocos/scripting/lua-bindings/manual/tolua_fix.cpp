@@ -8,19 +8,28 @@ using namespace cocos2d;
 
 static int s_function_ref_id = 0;
 
-TOLUA_API void toluafix_open(lua_State* L)
-{
-    lua_pushstring(L, TOLUA_REFID_PTR_MAPPING);
-    lua_newtable(L);
-    lua_rawset(L, LUA_REGISTRYINDEX);
+// the mapping tables are also kept at integer keys of the registry, found without hashing their names
+static int s_ptr_mapping_ref = LUA_NOREF;
+static int s_type_mapping_ref = LUA_NOREF;
+static int s_function_mapping_ref = LUA_NOREF;
+
+static unsigned int s_pushusertype_count = 0;
 
-    lua_pushstring(L, TOLUA_REFID_TYPE_MAPPING);
-    lua_newtable(L);
-    lua_rawset(L, LUA_REGISTRYINDEX);
+static int toluafix_new_mapping(lua_State* L, const char* name)
+{
+    lua_pushstring(L, name);                                    /* stack: name */
+    lua_newtable(L);                                            /* stack: name mapping */
+    lua_pushvalue(L, -1);                                       /* stack: name mapping mapping */
+    lua_insert(L, -3);                                          /* stack: mapping name mapping */
+    lua_rawset(L, LUA_REGISTRYINDEX);                           /* stack: mapping */
+    return luaL_ref(L, LUA_REGISTRYINDEX);                      /* stack: - */
+}
 
-    lua_pushstring(L, TOLUA_REFID_FUNCTION_MAPPING);
-    lua_newtable(L);
-    lua_rawset(L, LUA_REGISTRYINDEX);
+TOLUA_API void toluafix_open(lua_State* L)
+{
+    s_ptr_mapping_ref = toluafix_new_mapping(L, TOLUA_REFID_PTR_MAPPING);
+    s_type_mapping_ref = toluafix_new_mapping(L, TOLUA_REFID_TYPE_MAPPING);
+    s_function_mapping_ref = toluafix_new_mapping(L, TOLUA_REFID_FUNCTION_MAPPING);
 }
 
 TOLUA_API int toluafix_pushusertype_ccobject(lua_State* L,
@@ -35,6 +44,8 @@ TOLUA_API int toluafix_pushusertype_ccobject(lua_State* L,
         return -1;
     }
     
+    ++s_pushusertype_count;
+
     Ref* vPtr = static_cast<Ref*>(ptr);
     const char* vType = getLuaTypeName(vPtr, type);
 
@@ -42,16 +53,14 @@ TOLUA_API int toluafix_pushusertype_ccobject(lua_State* L,
     {
         *p_refid = refid;
 
-        lua_pushstring(L, TOLUA_REFID_PTR_MAPPING);
-        lua_rawget(L, LUA_REGISTRYINDEX);                           /* stack: refid_ptr */
+        lua_rawgeti(L, LUA_REGISTRYINDEX, s_ptr_mapping_ref);       /* stack: refid_ptr */
         lua_pushinteger(L, refid);                                  /* stack: refid_ptr refid */
         lua_pushlightuserdata(L, vPtr);                              /* stack: refid_ptr refid ptr */
 
         lua_rawset(L, -3);                  /* refid_ptr[refid] = ptr, stack: refid_ptr */
         lua_pop(L, 1);                                              /* stack: - */
 
-        lua_pushstring(L, TOLUA_REFID_TYPE_MAPPING);
-        lua_rawget(L, LUA_REGISTRYINDEX);                           /* stack: refid_type */
+        lua_rawgeti(L, LUA_REGISTRYINDEX, s_type_mapping_ref);      /* stack: refid_type */
         lua_pushinteger(L, refid);                                  /* stack: refid_type refid */
         lua_pushstring(L, vType);                                    /* stack: refid_type refid type */
         lua_rawset(L, -3);                /* refid_type[refid] = type, stack: refid_type */
@@ -65,6 +74,14 @@ TOLUA_API int toluafix_pushusertype_ccobject(lua_State* L,
     return 0;
 }
 
+TOLUA_API unsigned int toluafix_get_pushusertype_count(bool reset)
+{
+    unsigned int count = s_pushusertype_count;
+    if (reset)
+        s_pushusertype_count = 0;
+    return count;
+}
+
 TOLUA_API int toluafix_remove_ccobject_by_refid(lua_State* L, int refid)
 {
 	void* ptr = NULL;
@@ -73,8 +90,7 @@ TOLUA_API int toluafix_remove_ccobject_by_refid(lua_State* L, int refid)
     if (refid == 0) return -1;
 
     // get ptr from tolua_refid_ptr_mapping
-    lua_pushstring(L, TOLUA_REFID_PTR_MAPPING);
-    lua_rawget(L, LUA_REGISTRYINDEX);                               /* stack: refid_ptr */
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s_ptr_mapping_ref);           /* stack: refid_ptr */
     lua_pushinteger(L, refid);                                      /* stack: refid_ptr refid */
     lua_rawget(L, -2);                                              /* stack: refid_ptr ptr */
     ptr = lua_touserdata(L, -1);
@@ -95,8 +111,7 @@ TOLUA_API int toluafix_remove_ccobject_by_refid(lua_State* L, int refid)
 
 
     // get type from tolua_refid_type_mapping
-    lua_pushstring(L, TOLUA_REFID_TYPE_MAPPING);
-    lua_rawget(L, LUA_REGISTRYINDEX);                               /* stack: refid_type */
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s_type_mapping_ref);          /* stack: refid_type */
     lua_pushinteger(L, refid);                                      /* stack: refid_type refid */
     lua_rawget(L, -2);                                              /* stack: refid_type type */
     if (lua_isnil(L, -1))
@@ -173,8 +188,7 @@ TOLUA_API int toluafix_ref_function(lua_State* L, int lo, int def)
 
     s_function_ref_id++;
 
-    lua_pushstring(L, TOLUA_REFID_FUNCTION_MAPPING);
-    lua_rawget(L, LUA_REGISTRYINDEX);                           /* stack: fun ... refid_fun */
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s_function_mapping_ref); /* stack: fun ... refid_fun */
     lua_pushinteger(L, s_function_ref_id);                      /* stack: fun ... refid_fun refid */
     lua_pushvalue(L, lo);                                       /* stack: fun ... refid_fun refid fun */
 
@@ -189,17 +203,14 @@ TOLUA_API int toluafix_ref_function(lua_State* L, int lo, int def)
 
 TOLUA_API void toluafix_get_function_by_refid(lua_State* L, int refid)
 {
-    lua_pushstring(L, TOLUA_REFID_FUNCTION_MAPPING);
-    lua_rawget(L, LUA_REGISTRYINDEX);                           /* stack: ... refid_fun */
-    lua_pushinteger(L, refid);                                  /* stack: ... refid_fun refid */
-    lua_rawget(L, -2);                                          /* stack: ... refid_fun fun */
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s_function_mapping_ref); /* stack: ... refid_fun */
+    lua_rawgeti(L, -1, refid);                                  /* stack: ... refid_fun fun */
     lua_remove(L, -2);                                          /* stack: ... fun */
 }
 
 TOLUA_API void toluafix_remove_function_by_refid(lua_State* L, int refid)
 {
-    lua_pushstring(L, TOLUA_REFID_FUNCTION_MAPPING);
-    lua_rawget(L, LUA_REGISTRYINDEX);                           /* stack: ... refid_fun */
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s_function_mapping_ref); /* stack: ... refid_fun */
     lua_pushinteger(L, refid);                                  /* stack: ... refid_fun refid */
     lua_pushnil(L);                                             /* stack: ... refid_fun refid nil */
     lua_rawset(L, -3);                  /* refid_fun[refid] = fun, stack: ... refid_ptr */
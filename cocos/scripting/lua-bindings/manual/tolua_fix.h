@@ -39,6 +39,18 @@ TOLUA_API int toluafix_pushusertype_ccobject(lua_State* L,
                                              void* ptr,
                                              const char* type);
 
+/**
+ * Get the number of calls to toluafix_pushusertype_ccobject since the last reset, to profile how many objects
+ * the bindings push by frame. It's also available to the scripts as tolua.getpushcount(reset).
+ *
+ * @param reset whether to start counting again from 0.
+ * @return the number of pushes.
+ * @since v3.9
+ * @lua NA
+ * @js NA
+ */
+TOLUA_API unsigned int toluafix_get_pushusertype_count(bool reset);
+
 /**
  * Find the value of Ref object pointer in the Lua registry by the refid.
  * Then, remove the corresponding refrence in some table in the Lua registry by refid, such as toluafix_refid_type_mapping, toluafix_refid_ptr_mapping,tolua_value_root,and so on.
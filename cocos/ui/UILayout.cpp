@@ -333,7 +333,7 @@ void Layout::onBeforeVisitStencil()
     GLint mask_layer = 0x1 << s_layer;
     GLint mask_layer_l = mask_layer - 1;
     _mask_layer_le = mask_layer | mask_layer_l;
-    _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
+    _currentStencilEnabled = GL::isEnabled(GL_STENCIL_TEST);
     glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&_currentStencilWriteMask);
     glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&_currentStencilFunc);
     glGetIntegerv(GL_STENCIL_REF, &_currentStencilRef);
@@ -342,16 +342,16 @@ void Layout::onBeforeVisitStencil()
     glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&_currentStencilPassDepthFail);
     glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
     
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
 //    RenderState::StateBlock::_defaultState->setStencilTest(true);
 
     CHECK_GL_ERROR_DEBUG();
     glStencilMask(mask_layer);
 //    RenderState::StateBlock::_defaultState->setStencilWrite(mask_layer);
 
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
+    _currentDepthWriteMask = GL::getDepthMask();
 
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
     RenderState::StateBlock::_defaultState->setDepthWrite(false);
 
     glStencilFunc(GL_NEVER, mask_layer, mask_layer);
@@ -416,7 +416,7 @@ void Layout::drawFullScreenQuadClearStencil()
 
 void Layout::onAfterDrawStencil()
 {
-    glDepthMask(_currentDepthWriteMask);
+    GL::depthMask(_currentDepthWriteMask);
     RenderState::StateBlock::_defaultState->setDepthWrite(_currentDepthWriteMask != 0);
 
     glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
@@ -451,7 +451,7 @@ void Layout::onAfterVisitStencil()
     glStencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::disable(GL_STENCIL_TEST);
 //        RenderState::StateBlock::_defaultState->setStencilTest(false);
     }
     s_layer--;
@@ -464,7 +464,7 @@ void Layout::onBeforeVisitScissor()
     _scissorOldState = glview->isScissorEnabled();
     if (false == _scissorOldState)
     {
-        glEnable(GL_SCISSOR_TEST);
+        GL::enable(GL_SCISSOR_TEST);
     }
 
     // apply scissor box
@@ -496,7 +496,7 @@ void Layout::onAfterVisitScissor()
     else
     {
         // revert scissor test
-        glDisable(GL_SCISSOR_TEST);
+        GL::disable(GL_SCISSOR_TEST);
     }
 }
     
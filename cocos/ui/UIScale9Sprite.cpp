@@ -28,6 +28,8 @@
 #include "base/CCVector.h"
 #include "base/CCDirector.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCRenderer.h"
+#include "2d/CCCamera.h"
 #include "renderer/ccShaders.h"
 #include "platform/CCImage.h"
 #include "base/CCNinePatchImageParser.h"
@@ -59,9 +61,15 @@ namespace ui {
         ,_flippedY(false)
         ,_isPatch9(false)
         ,_brightState(State::NORMAL)
+        ,_renderingType(RenderingType::SPRITES)
+        ,_insideBounds(true)
 
     {
         this->setAnchorPoint(Vec2(0.5,0.5));
+        _meshTriangles.verts = _meshVertices;
+        _meshTriangles.indices = _meshIndices;
+        _meshTriangles.vertCount = 0;
+        _meshTriangles.indexCount = 0;
     }
 
     Scale9Sprite::~Scale9Sprite()
@@ -682,6 +690,15 @@ namespace ui {
             //it is error but for legacy turn off clip system
             CCLOG("Scale9Sprite capInsetsInternal > originalSize");
 
+        // the mesh is a grid whose lines are the edges of the clipped columns and rows
+        _meshColumns[0] = Vec2(leftTopBounds.getMinX(), leftTopBounds.getMaxX());
+        _meshColumns[1] = Vec2(centerTopBounds.getMinX(), centerTopBounds.getMaxX());
+        _meshColumns[2] = Vec2(rightTopBounds.getMinX(), rightTopBounds.getMaxX());
+        _meshRows[0] = Vec2(leftTopBounds.getMinY(), leftTopBounds.getMaxY());
+        _meshRows[1] = Vec2(leftCenterBounds.getMinY(), leftCenterBounds.getMaxY());
+        _meshRows[2] = Vec2(leftBottomBounds.getMinY(), leftBottomBounds.getMaxY());
+        _meshFrameRect = originalRect;
+
         Rect rotatedLeftTopBoundsOriginal = leftTopBoundsOriginal;
         Rect rotatedCenterBoundsOriginal = centerBoundsOriginal;
         Rect rotatedRightBottomBoundsOriginal = rightBottomBoundsOriginal;
@@ -855,6 +872,19 @@ namespace ui {
             }
         }
 
+        if (_renderingType == RenderingType::MESH)
+        {
+            // same as the shrinking above: only the outer columns and rows lose the border of a 9-patch
+            if (_isPatch9)
+            {
+                _meshColumns[0].x += 1.0f;
+                _meshColumns[2].y -= 1.0f;
+                _meshRows[0].x += 1.0f;
+                _meshRows[2].y -= 1.0f;
+            }
+            return;
+        }
+
         // Centre
         if(rotatedCenterBounds.size.width > 0 && rotatedCenterBounds.size.height > 0 )
         {
@@ -954,6 +984,12 @@ namespace ui {
 
     void Scale9Sprite::updatePositions()
     {
+        if (_renderingType == RenderingType::MESH)
+        {
+            this->updateMesh();
+            return;
+        }
+
         Size size = this->_contentSize;
 
         float sizableWidth = size.width - _topLeftSize.width - _bottomRightSize.width;
@@ -1035,6 +1071,164 @@ namespace ui {
     }
 
 
+    void Scale9Sprite::updateMesh()
+    {
+        _meshTriangles.vertCount = 0;
+        _meshTriangles.indexCount = 0;
+        if (!_scale9Image || !_scale9Image->getTexture())
+        {
+            return;
+        }
+
+        // the slices are laid out as updatePositions() places the sliced sprites
+        float horizontalScale = (_contentSize.width - _topLeftSize.width - _bottomRightSize.width) / _centerSize.width;
+        float verticalScale = (_contentSize.height - _topLeftSize.height - _bottomRightSize.height) / _centerSize.height;
+        float rescaledWidth = _centerSize.width * horizontalScale;
+        float rescaledHeight = _centerSize.height * verticalScale;
+        float leftWidth = _topLeftSize.width;
+        float bottomHeight = _bottomRightSize.height;
+
+        float columnWidths[3], rowHeights[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            columnWidths[i] = _meshColumns[i].y - _meshColumns[i].x;
+            rowHeights[i] = _meshRows[i].y - _meshRows[i].x;
+        }
+
+        // grid lines from left to right and from bottom to top, and the same lines in the original frame;
+        // a line next to an empty slice is the edge of the slice on its other side
+        float x[4], y[4], frameX[4], frameY[4];
+        if (columnWidths[1] > 0)
+        {
+            x[1] = leftWidth + (_meshColumns[1].x - _capInsetsInternal.origin.x) * horizontalScale;
+            x[2] = leftWidth + (_meshColumns[1].y - _capInsetsInternal.origin.x) * horizontalScale;
+            frameX[1] = _meshColumns[1].x;
+            frameX[2] = _meshColumns[1].y;
+        }
+        else
+        {
+            x[1] = leftWidth;
+            x[2] = leftWidth + rescaledWidth;
+            frameX[1] = _meshColumns[0].y;
+            frameX[2] = _meshColumns[2].x;
+        }
+        x[0] = x[1] - columnWidths[0];
+        x[3] = x[2] + columnWidths[2];
+        frameX[0] = _meshColumns[0].x;
+        frameX[3] = _meshColumns[2].y;
+
+        if (rowHeights[1] > 0)
+        {
+            y[1] = bottomHeight + rescaledHeight - (_meshRows[1].y - _capInsetsInternal.origin.y) * verticalScale;
+            y[2] = bottomHeight + rescaledHeight - (_meshRows[1].x - _capInsetsInternal.origin.y) * verticalScale;
+            frameY[1] = _meshRows[1].y;
+            frameY[2] = _meshRows[1].x;
+        }
+        else
+        {
+            y[1] = bottomHeight;
+            y[2] = bottomHeight + rescaledHeight;
+            frameY[1] = _meshRows[2].x;
+            frameY[2] = _meshRows[0].y;
+        }
+        y[0] = y[1] - rowHeights[2];
+        y[3] = y[2] + rowHeights[0];
+        frameY[0] = _meshRows[2].y;
+        frameY[3] = _meshRows[0].x;
+
+        Texture2D *texture = _scale9Image->getTexture();
+        float pixelsWide = (float)texture->getPixelsWide() / CC_CONTENT_SCALE_FACTOR();
+        float pixelsHigh = (float)texture->getPixelsHigh() / CC_CONTENT_SCALE_FACTOR();
+        const Vec2 &frameOrigin = _meshFrameRect.origin;
+
+        for (int row = 0; row < 4; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                V3F_C4B_T2F &vertex = _meshVertices[row * 4 + column];
+                vertex.vertices.set(x[column], y[row], 0.0f);
+
+                // a rotated frame is stored turned clockwise in the texture
+                Vec2 texturePoint;
+                if (_spriteFrameRotated)
+                    texturePoint.set(frameOrigin.x + _meshFrameRect.size.height - frameY[row], frameOrigin.y + frameX[column]);
+                else
+                    texturePoint.set(frameOrigin.x + frameX[column], frameOrigin.y + frameY[row]);
+                vertex.texCoords.u = texturePoint.x / pixelsWide;
+                vertex.texCoords.v = texturePoint.y / pixelsHigh;
+            }
+        }
+
+        // rows of the grid go up, rows of the slices go down
+        unsigned short *index = _meshIndices;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+            {
+                if (columnWidths[column] <= 0 || rowHeights[2 - row] <= 0)
+                    continue;
+
+                unsigned short bottomLeft = row * 4 + column;
+                unsigned short topLeft = bottomLeft + 4;
+                *index++ = bottomLeft;
+                *index++ = bottomLeft + 1;
+                *index++ = topLeft;
+                *index++ = topLeft;
+                *index++ = bottomLeft + 1;
+                *index++ = topLeft + 1;
+            }
+        }
+        _meshTriangles.vertCount = 16;
+        _meshTriangles.indexCount = index - _meshIndices;
+
+        this->updateColor();
+    }
+
+    void Scale9Sprite::updateColor()
+    {
+        Color4B color4(_displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity);
+
+        // as the sliced sprites do for premultiplied textures
+        if (_scale9Image && _scale9Image->getTexture() && _scale9Image->getTexture()->hasPremultipliedAlpha())
+        {
+            color4.r *= _displayedOpacity/255.0f;
+            color4.g *= _displayedOpacity/255.0f;
+            color4.b *= _displayedOpacity/255.0f;
+        }
+
+        for (auto &vertex : _meshVertices)
+        {
+            vertex.colors = color4;
+        }
+    }
+
+    void Scale9Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
+    {
+        if (_renderingType != RenderingType::MESH || !_scale9Enabled || _meshTriangles.indexCount == 0)
+        {
+            return;
+        }
+
+#if CC_USE_CULLING
+        // Don't do calculate the culling if the transform was not updated
+        auto visitingCamera = Camera::getVisitingCamera();
+        auto defaultCamera = Camera::getDefaultCamera();
+        if (visitingCamera == defaultCamera) {
+            _insideBounds = ((flags & FLAGS_TRANSFORM_DIRTY)|| visitingCamera->isViewProjectionUpdated()) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
+        }
+        else
+        {
+            _insideBounds = renderer->checkVisibility(transform, _contentSize);
+        }
+
+        if(_insideBounds)
+#endif
+        {
+            _trianglesCommand.init(_globalZOrder, _scale9Image->getTexture()->getName(), getGLProgramState(), _blendFunc, _meshTriangles, transform, flags);
+            renderer->addCommand(&_trianglesCommand);
+        }
+    }
+
 
     Scale9Sprite* Scale9Sprite::resizableSpriteWithCapInsets(const Rect& capInsets) const
     {
@@ -1081,6 +1275,9 @@ namespace ui {
             _scale9Image->setGLProgramState(glState);
         }
 
+        // used by the mesh
+        this->setGLProgramState(glState);
+
         if (_scale9Enabled)
         {
             for (auto& sp : _protectedChildren)
@@ -1344,6 +1541,39 @@ namespace ui {
         return _scale9Enabled;
     }
 
+    void Scale9Sprite::setRenderingType(RenderingType type)
+    {
+        if (_renderingType == type)
+        {
+            return;
+        }
+        _renderingType = type;
+
+        this->cleanupSlicedSprites();
+        _protectedChildren.clear();
+        _meshTriangles.vertCount = 0;
+        _meshTriangles.indexCount = 0;
+
+        // the slices are built again, at the same size
+        if (_scale9Enabled && _scale9Image)
+        {
+            Size contentSize = _contentSize;
+            this->updateWithSprite(this->_scale9Image,
+                                   _spriteRect,
+                                   _spriteFrameRotated,
+                                   _offset,
+                                   _originalSize,
+                                   _capInsets);
+            this->setContentSize(contentSize);
+        }
+        _positionsAreDirty = true;
+    }
+
+    Scale9Sprite::RenderingType Scale9Sprite::getRenderingType() const
+    {
+        return _renderingType;
+    }
+
     void Scale9Sprite::addProtectedChild(cocos2d::Node *child)
     {
         _reorderProtectedChildDirty = true;
@@ -28,6 +28,7 @@
 #include "2d/CCNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteBatchNode.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "platform/CCPlatformMacros.h"
 #include "ui/GUIExport.h"
 
@@ -77,6 +78,18 @@ namespace ui {
             GRAY
         };
         
+        /**
+         * How the 9 slices are rendered.
+         * SPRITES builds a Sprite child for every slice, MESH builds a single mesh of 16 vertices
+         * drawn by one TrianglesCommand, which batches with the neighbour panels of the same texture.
+         * @since v3.9
+         */
+        enum class RenderingType
+        {
+            SPRITES,
+            MESH
+        };
+        
     public:
         
         /**
@@ -581,9 +594,26 @@ namespace ui {
          */
         bool isScale9Enabled()const;
         
+        /**
+         * @brief Change how the slices are rendered, the cap insets, the flipping and the state are kept.
+         *
+         * @param type A enum value in RenderingType.
+         * @since v3.9
+         */
+        void setRenderingType(RenderingType type);
+        
+        /**
+         * @brief Query how the slices are rendered.
+         *
+         * @return @see `RenderingType`
+         * @since v3.9
+         */
+        RenderingType getRenderingType()const;
+        
         /// @} end of Children and Parent
         
         virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+        virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
         virtual void cleanup() override;
         
         /**
@@ -682,6 +712,8 @@ namespace ui {
     protected:
         void updateCapInset();
         void updatePositions();
+        void updateMesh();
+        virtual void updateColor() override;
         void createSlicedSprites();
         void cleanupSlicedSprites();
         void adjustScale9ImagePosition();
@@ -751,6 +783,19 @@ namespace ui {
         bool _flippedY;
         bool _isPatch9;
         State _brightState;
+        
+        RenderingType _renderingType;
+        /** Start and end of the 3 columns and rows of the slices in the original frame, top row first. */
+        Vec2 _meshColumns[3];
+        Vec2 _meshRows[3];
+        /** The original frame in the texture, as the rect of the sliced sprites. */
+        Rect _meshFrameRect;
+        /** A 4x4 grid from the bottom left corner, the empty slices have no indices. */
+        V3F_C4B_T2F _meshVertices[16];
+        unsigned short _meshIndices[54];
+        TrianglesCommand::Triangles _meshTriangles;
+        TrianglesCommand _trianglesCommand;
+        bool _insideBounds;
     };
     
 }}  //end of namespace
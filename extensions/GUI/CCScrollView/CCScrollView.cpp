@@ -552,7 +552,7 @@ void ScrollView::onBeforeDraw()
             }
         }
         else {
-            glEnable(GL_SCISSOR_TEST);
+            GL::enable(GL_SCISSOR_TEST);
             glview->setScissorInPoints(frame.origin.x, frame.origin.y, frame.size.width, frame.size.height);
         }
     }
@@ -579,7 +579,7 @@ void ScrollView::onAfterDraw()
             glview->setScissorInPoints(_parentScissorRect.origin.x, _parentScissorRect.origin.y, _parentScissorRect.size.width, _parentScissorRect.size.height);
         }
         else {
-            glDisable(GL_SCISSOR_TEST);
+            GL::disable(GL_SCISSOR_TEST);
         }
     }
 }
@@ -58,65 +58,59 @@ struct CC_DLL Particle3D
     std::map<std::string, void*> userDefs;
 };
 
+/**
+ * The datas of a pool are allocated once, and move between the active and the inactive list.
+ * Both lists are dense arrays: removing an active data moves the last active data to its place, so the
+ * order of the active datas is not kept. getFirst() and getNext() visit every active data once, even if
+ * datas are created, or removed with lockLatestData() or lockData(), during the iteration.
+ */
 template<typename T>
 class CC_DLL DataPool
 {
 public:
-    typedef typename std::list<T*> PoolList;
-    typedef typename std::list<T*>::iterator PoolIterator;
+    typedef typename std::vector<T*> PoolList;
+    typedef typename std::vector<T*>::iterator PoolIterator;
 
-    DataPool(){};
+    DataPool() : _nextIndex(0) {};
     ~DataPool(){};
 
     T* createData(){
         if (_locked.empty()) return nullptr;
-        T* p = _locked.front();
-        //_released.push_back(p);
-        //_locked.erase(_locked.begin());
-        _released.splice(_released.end(), _locked, _locked.begin());
+        T* p = _locked.back();
+        _locked.pop_back();
+        _released.push_back(p);
         return p;
     };
 
+    /** Removes the data last returned by getFirst() or getNext(). */
     void lockLatestData(){
-        _locked.push_back(*_releasedIter);
-        _releasedIter = _released.erase(_releasedIter);
-        if (_releasedIter != _released.begin() && _releasedIter != _released.end())
-        {
-            --_releasedIter;
-        }
+        if (_nextIndex > 0)
+            lockDataAt(_nextIndex - 1);
     };
 
     void lockData(T *data){
-        PoolIterator tempIter = _releasedIter;
-        T *ptr = getFirst();
-        while (ptr)
-        {
-            if (ptr == data) break;
-            ptr = getNext();
+        for (size_t i = 0; i < _released.size(); ++i){
+            if (_released[i] == data){
+                lockDataAt(i);
+                break;
+            }
         }
-        if (ptr)
-            lockLatestData();
-        _releasedIter = tempIter;
     }
 
     void lockAllDatas(){
-        _locked.splice(_locked.end(), _released);
-        //_locked.insert(_locked.end(), _released.begin(), _released.end());
-        //_released.clear();
-        _releasedIter = _released.begin();
+        _locked.insert(_locked.end(), _released.begin(), _released.end());
+        _released.clear();
+        _nextIndex = 0;
     };
 
     T* getFirst(){
-        _releasedIter = _released.begin();
-        if (_releasedIter == _released.end()) return nullptr;
-        return *_releasedIter;
+        _nextIndex = 0;
+        return getNext();
     };
 
     T* getNext(){
-        if (_releasedIter == _released.end()) return nullptr;
-        ++_releasedIter;
-        if (_releasedIter == _released.end()) return nullptr;
-        return *_releasedIter;
+        if (_nextIndex >= _released.size()) return nullptr;
+        return _released[_nextIndex++];
     };
 
     const PoolList& getActiveDataList() const { return _released; };
@@ -138,7 +132,22 @@ public:
 
 private:
 
-    PoolIterator _releasedIter;
+    void lockDataAt(size_t index){
+        _locked.push_back(_released[index]);
+        if (index < _nextIndex){
+            // already visited: the current data takes its place, and the last one, not visited yet, is next
+            --_nextIndex;
+            _released[index] = _released[_nextIndex];
+            _released[_nextIndex] = _released.back();
+        }
+        else{
+            _released[index] = _released.back();
+        }
+        _released.pop_back();
+    };
+
+    // the active datas before it are visited by the iteration
+    size_t _nextIndex;
     PoolList _released;
     PoolList _locked;
 };
@@ -204,6 +213,10 @@ public:
      * set particle render, can set your own particle render
      */
     void setRender(Particle3DRender* render);
+    /**
+     * get particle render
+     */
+    Particle3DRender* getRender() const { return _render; }
     /**
      * add particle affector
      */
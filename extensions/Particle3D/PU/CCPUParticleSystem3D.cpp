@@ -823,16 +823,70 @@ void PUParticleSystem3D::setMaxVelocity( float maxVelocity )
     _maxVelocitySet = true;
 }
 
+static bool s_templateCacheEnabled = false;
+static std::unordered_map<std::string, PUParticleSystem3D*> s_templates;
+
+void PUParticleSystem3D::setTemplateCacheEnabled( bool enabled )
+{
+    s_templateCacheEnabled = enabled;
+    if (!enabled)
+        clearTemplateCache();
+}
+
+bool PUParticleSystem3D::isTemplateCacheEnabled()
+{
+    return s_templateCacheEnabled;
+}
+
+void PUParticleSystem3D::clearTemplateCache()
+{
+    for (auto &iter : s_templates){
+        iter.second->release();
+    }
+    s_templates.clear();
+}
+
 bool PUParticleSystem3D::initSystem( const std::string &filePath )
 {
+    if (s_templateCacheEnabled){
+        auto iter = s_templates.find(filePath);
+        if (iter != s_templates.end()){
+            iter->second->copyTemplateTo(this);
+            return true;
+        }
+    }
+
     bool isFirstCompile = true;
     auto list = PUScriptCompiler::Instance()->compile(filePath, isFirstCompile);
     if (list == nullptr || list->empty()) return false;
     PUTranslateManager::Instance()->translateParticleSystem(this, list);
     //std::string  data = FileUtils::getInstance()->getStringFromFile(filePath);
+
+    if (s_templateCacheEnabled){
+        auto ps = new (std::nothrow) PUParticleSystem3D();
+        copyTemplateTo(ps);
+        s_templates[filePath] = ps;
+    }
     return true;
 }
 
+void PUParticleSystem3D::copyTemplateTo( PUParticleSystem3D* system )
+{
+    copyAttributesTo(system);
+    system->setPosition3D(getPosition3D());
+    system->setScaleX(getScaleX());
+    system->setScaleY(getScaleY());
+    system->setScaleZ(getScaleZ());
+    for (auto &iter : _children){
+        PUParticleSystem3D *child = dynamic_cast<PUParticleSystem3D *>(iter);
+        if (child){
+            auto copy = PUParticleSystem3D::create();
+            child->copyTemplateTo(copy);
+            system->addChild(copy);
+        }
+    }
+}
+
 void PUParticleSystem3D::addEmitter( PUEmitter* emitter )
 {
     if (emitter && std::find(_emitters.begin(), _emitters.end(), emitter) == _emitters.end()){
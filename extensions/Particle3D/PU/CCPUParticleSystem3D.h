@@ -228,6 +228,16 @@ public:
     static PUParticleSystem3D* create();
     static PUParticleSystem3D* create(const std::string &filePath);
     static PUParticleSystem3D* create(const std::string &filePath, const std::string &materialPath);
+
+    /**
+     * Keeps the systems translated from the scripts as templates, off by default. The next systems created
+     * from the same script are copied from its template, instead of translating the script again.
+     * @since v3.9
+     */
+    static void setTemplateCacheEnabled(bool enabled);
+    static bool isTemplateCacheEnabled();
+    /** Releases the templates, e.g., after the materials are reloaded. */
+    static void clearTemplateCache();
     
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
@@ -380,6 +390,8 @@ protected:
     inline bool isExpired(PUParticle3D* particle, float timeElapsed);
 
     bool initSystem(const std::string &filePath);
+    // copyAttributesTo(), with the transform set by the scripts and the techniques
+    void copyTemplateTo(PUParticleSystem3D* system);
     static void convertToUnixStylePath(std::string &path);
 
 protected:
@@ -35,10 +35,20 @@
 #include "renderer/CCVertexIndexBuffer.h"
 #include "renderer/CCVertexAttribBinding.h"
 #include "base/CCDirector.h"
+#include "base/ccUtils.h"
 #include "3d/CCSprite3D.h"
 #include "3d/CCMesh.h"
 #include "2d/CCCamera.h"
 
+#include <string.h>
+#include <algorithm>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 NS_CC_BEGIN
 
 void PURender::copyAttributesTo( PURender *render )
@@ -48,10 +58,44 @@ void PURender::copyAttributesTo( PURender *render )
     render->_renderType = _renderType;
 }
 
-//static bool compareParticle3D(PUParticle3D* left, PUParticle3D* right)
-//{
-//    return left->depthInView > right->depthInView;
-//}
+// the particles of a quad render are filled by several threads above this count
+static const size_t QUAD_FILL_CHUNK = 1024;
+// the indices are 16 bits, the particles past the last vertex they address aren't drawn
+static const size_t MAX_QUADS = 65536 / 4;
+
+#if defined(__SSE__)
+typedef __m128 QuadVec;
+static inline QuadVec quadLoad(const Vec3 &v) { return _mm_setr_ps(v.x, v.y, v.z, 0.0f); }
+static inline QuadVec quadMulAdd(const QuadVec &a, const QuadVec &b, float s) { return _mm_add_ps(a, _mm_mul_ps(b, _mm_set1_ps(s))); }
+static inline void quadStore(const QuadVec &v, Vec3 &dst) { float f[4]; _mm_storeu_ps(f, v); dst.set(f); }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+typedef float32x4_t QuadVec;
+static inline QuadVec quadLoad(const Vec3 &v) { const float f[4] = { v.x, v.y, v.z, 0.0f }; return vld1q_f32(f); }
+static inline QuadVec quadMulAdd(const QuadVec &a, const QuadVec &b, float s) { return vmlaq_n_f32(a, b, s); }
+static inline void quadStore(const QuadVec &v, Vec3 &dst) { float f[4]; vst1q_f32(f, v); dst.set(f); }
+#else
+typedef Vec3 QuadVec;
+static inline QuadVec quadLoad(const Vec3 &v) { return v; }
+static inline QuadVec quadMulAdd(const QuadVec &a, const QuadVec &b, float s) { return a + b * s; }
+static inline void quadStore(const QuadVec &v, Vec3 &dst) { dst = v; }
+#endif
+
+// same as Mat4::createRotation(axis, angle) applied to v, axis is normalized
+static inline Vec3 rotateAroundAxis(const Vec3 &v, const Vec3 &axis, float cosAngle, float sinAngle)
+{
+    Vec3 cross;
+    Vec3::cross(axis, v, &cross);
+    return v * cosAngle + cross * sinAngle + axis * (axis.dot(v) * (1.0f - cosAngle));
+}
+
+// maps the floats to unsigned ints of the same order, reversed so that the farthest comes first
+static inline unsigned int depthSortKey(float depth)
+{
+    unsigned int bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    bits ^= (bits & 0x80000000) ? 0xffffffff : 0x80000000;
+    return ~bits;
+}
 
 PUParticle3DQuadRender* PUParticle3DQuadRender::create(const std::string& texFile)
 {
@@ -95,62 +139,144 @@ void PUParticle3DQuadRender::render(Renderer* renderer, const Mat4 &transform, P
         _indexBuffer->retain();
     }
     const ParticlePool::PoolList &activeParticleList = particlePool.getActiveDataList();
-    if (_vertices.size() < activeParticleList.size() * 4)
-    {
-        _vertices.resize(activeParticleList.size() * 4);
-        _indices.resize(activeParticleList.size() * 6);
-    }
+    size_t particleCount = std::min(activeParticleList.size(), MAX_QUADS);
+    _vertices.resize(particleCount * 4);
+    _indices.resize(particleCount * 6);
 
     auto camera = Camera::getVisitingCamera();
     auto cameraMat = camera->getNodeToWorldTransform();
-    
 
-    //for (auto iter : activeParticleList){
-    //    iter->depthInView = -(viewMat.m[2] * iter->positionInWorld.x + viewMat.m[6] * iter->positionInWorld.y + viewMat.m[10] * iter->positionInWorld.z + viewMat.m[14]);
-    //}
+    QuadFrame frame;
+    frame.particles = &activeParticleList;
+    frame.order = nullptr;
+    if (_depthSort)
+    {
+        sortByDepth(activeParticleList, camera->getViewMatrix() * transform);
+        // the farthest particles are the ones left out
+        frame.order = _sortIndices.data() + (activeParticleList.size() - particleCount);
+    }
 
-    //std::sort(activeParticleList.begin(), activeParticleList.end(), compareParticle3D);
-    Vec3 right(cameraMat.m[0], cameraMat.m[1], cameraMat.m[2]);
-    Vec3 up(cameraMat.m[4], cameraMat.m[5], cameraMat.m[6]);
-    Vec3 backward(cameraMat.m[8], cameraMat.m[9], cameraMat.m[10]);
-    
-    Mat4 pRotMat;
-    Vec3 position; //particle position
-    int vertexindex = 0;
-    int index = 0;
-    int offsetX,offsetY;
-    getOriginOffset(offsetX, offsetY);
+    frame.right.set(cameraMat.m[0], cameraMat.m[1], cameraMat.m[2]);
+    frame.up.set(cameraMat.m[4], cameraMat.m[5], cameraMat.m[6]);
+    frame.backward.set(cameraMat.m[8], cameraMat.m[9], cameraMat.m[10]);
+    getOriginOffset(frame.offsetX, frame.offsetY);
 
     if (_type == PERPENDICULAR_COMMON){
-        up = _commonUp;
-        up.normalize();
-        Vec3::cross(up, _commonDir, &right);
-        right.normalize();
-        backward = _commonDir;
+        frame.up = _commonUp;
+        frame.up.normalize();
+        Vec3::cross(frame.up, _commonDir, &frame.right);
+        frame.right.normalize();
+        frame.backward = _commonDir;
     }else if (_type == ORIENTED_COMMON){
-        up = _commonDir;
-        up.normalize();
-        Vec3::cross(up, backward, &right);
-        right.normalize();
+        frame.up = _commonDir;
+        frame.up.normalize();
+        Vec3::cross(frame.up, frame.backward, &frame.right);
+        frame.right.normalize();
     }
 
-    for (auto iter : activeParticleList)
+    // every particle has its own 4 vertices and 6 indices, so that the ranges are filled independently
+    utils::parallelFor(particleCount, QUAD_FILL_CHUNK, [this, &frame](size_t begin, size_t end){
+        fillQuads(frame, begin, end);
+    });
+
+    int vertexindex = (int)particleCount * 4;
+    int index = (int)particleCount * 6;
+    if (!_vertices.empty() && !_indices.empty()){
+        _vertexBuffer->updateVertices(&_vertices[0], vertexindex/* * sizeof(_posuvcolors[0])*/, 0);
+        _indexBuffer->updateIndices(&_indices[0], index/* * sizeof(unsigned short)*/, 0);
+
+        _stateBlock->setBlendFunc(particleSystem->getBlendFunc());
+        
+        GLuint texId = (_texture ? _texture->getName() : 0);
+        _meshCommand->init(0,
+                           texId,
+                           _glProgramState,
+                           _stateBlock,
+                           _vertexBuffer->getVBO(),
+                           _indexBuffer->getVBO(),
+                           GL_TRIANGLES,
+                           GL_UNSIGNED_SHORT,
+                           index,
+                           transform,
+                           Node::FLAGS_RENDER_AS_3D);
+        _meshCommand->setSkipBatching(true);
+        _meshCommand->setTransparent(true);
+        _glProgramState->setUniformVec4("u_color", Vec4(1,1,1,1));
+        renderer->addCommand(_meshCommand);
+    }
+}
+
+void PUParticle3DQuadRender::sortByDepth(const std::vector<Particle3D*> &particles, const Mat4 &modelView)
+{
+    size_t count = particles.size();
+    _sortKeys.resize(count * 2);
+    _sortIndices.resize(count * 2);
+
+    unsigned int *keys = _sortKeys.data();
+    unsigned int *indices = _sortIndices.data();
+    for (size_t i = 0; i < count; ++i)
     {
-        auto particle = static_cast<PUParticle3D *>(iter);
+        auto particle = static_cast<PUParticle3D *>(particles[i]);
+        const Vec3 &pos = particle->position;
+        particle->depthInView = -(modelView.m[2] * pos.x + modelView.m[6] * pos.y + modelView.m[10] * pos.z + modelView.m[14]);
+        keys[i] = depthSortKey(particle->depthInView);
+        indices[i] = (unsigned int)i;
+    }
+
+    // least significant byte first, a byte shared by all the keys is skipped
+    unsigned int *tmpKeys = keys + count;
+    unsigned int *tmpIndices = indices + count;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        size_t offsets[256] = { 0 };
+        for (size_t i = 0; i < count; ++i)
+            ++offsets[(keys[i] >> shift) & 0xff];
+        if (offsets[(keys[0] >> shift) & 0xff] == count)
+            continue;
+
+        size_t total = 0;
+        for (auto &offset : offsets)
+        {
+            size_t c = offset;
+            offset = total;
+            total += c;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t dst = offsets[(keys[i] >> shift) & 0xff]++;
+            tmpKeys[dst] = keys[i];
+            tmpIndices[dst] = indices[i];
+        }
+        std::swap(keys, tmpKeys);
+        std::swap(indices, tmpIndices);
+    }
+
+    // the order is read from the start of _sortIndices
+    if (indices != _sortIndices.data())
+        memcpy(_sortIndices.data(), indices, count * sizeof(unsigned int));
+}
+
+void PUParticle3DQuadRender::fillQuads(const QuadFrame &frame, size_t begin, size_t end)
+{
+    Vec3 right = frame.right;
+    Vec3 up = frame.up;
+    Vec3 backward = frame.backward;
+    float originX = frame.offsetX - 1.0f;
+    float originY = frame.offsetY - 1.0f;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto particle = static_cast<PUParticle3D *>((*frame.particles)[frame.order ? frame.order[i] : i]);
         determineUVCoords(particle);
         if (_type == ORIENTED_SELF){
             Vec3 direction = particle->direction;
-            //transform.transformVector(particle->direction, &direction);
             up = direction;
             up.normalize();
             Vec3::cross(direction, backward, &right);
             right.normalize();
         }else if (_type == PERPENDICULAR_SELF){
             Vec3 direction = particle->direction;
-            //transform.transformVector(particle->direction, &direction);
             direction.normalize();
-            //up = PUUtil::perpendicular(direction);
-            //up.normalize();
             Vec3::cross(_commonUp, direction, &right);
             right.normalize();
             Vec3::cross(direction, right, &up);
@@ -162,103 +288,62 @@ void PUParticle3DQuadRender::render(Renderer* renderer, const Mat4 &transform, P
             Vec3::cross(up, backward, &right);
             right.normalize();
         }
-        Vec3 halfwidth = particle->width * 0.5f * right;
-        Vec3 halfheight = particle->height * 0.5f * up;
-        Vec3 offset = halfwidth * offsetX + halfheight * offsetY;
-        //transform.transformPoint(particle->position, &position);
-        position = particle->position;
 
+        Vec2 uvs[4];
+        Vec3 quadRight = right;
+        Vec3 quadUp = up;
         if (_rotateType == TEXTURE_COORDS){
             float costheta = cosf(-particle->zRotation);
             float sintheta = sinf(-particle->zRotation);
             Vec2 texOffset = 0.5f * (particle->lb_uv + particle->rt_uv);
-            Vec2 val;
-            val.set((particle->lb_uv.x - texOffset.x), (particle->lb_uv.y - texOffset.y));
-            val.set(val.x * costheta - val.y * sintheta, val.x * sintheta + val.y * costheta);
-            fillVertex(vertexindex, (position + (-halfwidth - halfheight + offset)), particle->color, val + texOffset);
-
-            val.set(particle->rt_uv.x - texOffset.x, particle->lb_uv.y - texOffset.y);
-            val.set(val.x * costheta - val.y * sintheta, val.x * sintheta + val.y * costheta);
-            fillVertex(vertexindex + 1, (position + (halfwidth - halfheight + offset)), particle->color, val + texOffset);
-
-            val.set(particle->lb_uv.x - texOffset.x, particle->rt_uv.y - texOffset.y);
-            val.set(val.x * costheta - val.y * sintheta, val.x * sintheta + val.y * costheta);
-            fillVertex(vertexindex + 2, (position + (-halfwidth + halfheight + offset)), particle->color, val + texOffset);
-
-            val.set(particle->rt_uv.x - texOffset.x, particle->rt_uv.y - texOffset.y);
-            val.set(val.x * costheta - val.y * sintheta, val.x * sintheta + val.y * costheta);
-            fillVertex(vertexindex + 3, (position + (halfwidth + halfheight + offset)), particle->color, val + texOffset);
+            uvs[0].set(particle->lb_uv.x - texOffset.x, particle->lb_uv.y - texOffset.y);
+            uvs[1].set(particle->rt_uv.x - texOffset.x, particle->lb_uv.y - texOffset.y);
+            uvs[2].set(particle->lb_uv.x - texOffset.x, particle->rt_uv.y - texOffset.y);
+            uvs[3].set(particle->rt_uv.x - texOffset.x, particle->rt_uv.y - texOffset.y);
+            for (auto &uv : uvs)
+                uv.set(uv.x * costheta - uv.y * sintheta + texOffset.x, uv.x * sintheta + uv.y * costheta + texOffset.y);
         }else{
-            Mat4::createRotation(backward, -particle->zRotation, &pRotMat);
-            fillVertex(vertexindex    , (position + pRotMat * (- halfwidth - halfheight + offset)), particle->color, particle->lb_uv);
-            fillVertex(vertexindex + 1, (position + pRotMat * (halfwidth - halfheight + offset)), particle->color, Vec2(particle->rt_uv.x, particle->lb_uv.y));
-            fillVertex(vertexindex + 2, (position + pRotMat * (-halfwidth + halfheight + offset)), particle->color, Vec2(particle->lb_uv.x, particle->rt_uv.y));
-            fillVertex(vertexindex + 3, (position + pRotMat * (halfwidth + halfheight + offset)), particle->color, particle->rt_uv);
+            uvs[0] = particle->lb_uv;
+            uvs[1].set(particle->rt_uv.x, particle->lb_uv.y);
+            uvs[2].set(particle->lb_uv.x, particle->rt_uv.y);
+            uvs[3] = particle->rt_uv;
+            if (particle->zRotation != 0.0f){
+                // the corners are made of right and up, rotating both rotates the quad
+                Vec3 axis = backward;
+                axis.normalize();
+                float costheta = cosf(-particle->zRotation);
+                float sintheta = sinf(-particle->zRotation);
+                quadRight = rotateAroundAxis(right, axis, costheta, sintheta);
+                quadUp = rotateAroundAxis(up, axis, costheta, sintheta);
+            }
+        }
+
+        // the corners are position + right * width * (+-0.5 + offsetX / 2) + up * height * (+-0.5 + offsetY / 2)
+        float halfWidth = particle->width * 0.5f;
+        float halfHeight = particle->height * 0.5f;
+        QuadVec r = quadLoad(quadRight);
+        QuadVec u = quadLoad(quadUp);
+        QuadVec corner0 = quadMulAdd(quadMulAdd(quadLoad(particle->position), r, halfWidth * originX), u, halfHeight * originY);
+        QuadVec corner1 = quadMulAdd(corner0, r, particle->width);
+        QuadVec corner2 = quadMulAdd(corner0, u, particle->height);
+        QuadVec corner3 = quadMulAdd(corner1, u, particle->height);
+
+        // i is below MAX_QUADS, only the values of the indices are 16 bits
+        unsigned short vertexindex = (unsigned short)(i * 4);
+        size_t index = i * 6;
+        VertexInfo *vertices = &_vertices[i * 4];
+        quadStore(corner0, vertices[0].position);
+        quadStore(corner1, vertices[1].position);
+        quadStore(corner2, vertices[2].position);
+        quadStore(corner3, vertices[3].position);
+        for (int v = 0; v < 4; ++v)
+        {
+            vertices[v].color = particle->color;
+            vertices[v].uv = uvs[v];
         }
 
         fillTriangle(index, vertexindex, vertexindex + 1, vertexindex + 3);
         fillTriangle(index + 3, vertexindex, vertexindex + 3, vertexindex + 2);
-
-        //_posuvcolors[vertexindex].position = (position + (- halfwidth - halfheight + halfwidth * offsetX + halfheight * offsetY));
-        //_posuvcolors[vertexindex].color = particle->color;
-        //_posuvcolors[vertexindex].uv.set(val.x + texOffset.x, val.y + texOffset.y);
-
-        //val.set(particle->rt_uv.x - texOffset.x, particle->lb_uv.y - texOffset.y);
-        //val.set(val.x * costheta - val.y * sintheta, val.x * sintheta + val.y * costheta);
-        //_posuvcolors[vertexindex + 1].position = (position + (halfwidth - halfheight + halfwidth * offsetX + halfheight * offsetY));
-        //_posuvcolors[vertexindex + 1].color = particle->color;
-        //_posuvcolors[vertexindex + 1].uv.set(val.x + texOffset.x, val.y + texOffset.y);
-        //
-        //val.set(particle->lb_uv.x - texOffset.x, particle->rt_uv.y - texOffset.y);
-        //val.set(val.x * costheta - val.y * sintheta, val.x * sintheta + val.y * costheta);
-        //_posuvcolors[vertexindex + 2].position = (position + (- halfwidth + halfheight + halfwidth * offsetX + halfheight * offsetY));
-        //_posuvcolors[vertexindex + 2].color = particle->color;
-        //_posuvcolors[vertexindex + 2].uv.set(val.x + texOffset.x, val.y + texOffset.y);
-        //
-        //val.set(particle->rt_uv.x - texOffset.x, particle->rt_uv.y - texOffset.y);
-        //val.set(val.x * costheta - val.y * sintheta, val.x * sintheta + val.y * costheta);
-        //_posuvcolors[vertexindex + 3].position = (position + (halfwidth + halfheight + halfwidth * offsetX + halfheight * offsetY));
-        //_posuvcolors[vertexindex + 3].color = particle->color;
-        //_posuvcolors[vertexindex + 3].uv.set(val.x + texOffset.x, val.y + texOffset.y);
-        //
-        //
-        //_indexData[index] = vertexindex;
-        //_indexData[index + 1] = vertexindex + 1;
-        //_indexData[index + 2] = vertexindex + 3;
-        //_indexData[index + 3] = vertexindex;
-        //_indexData[index + 4] = vertexindex + 3;
-        //_indexData[index + 5] = vertexindex + 2;
-        
-        index += 6;
-        vertexindex += 4;
-
-    }
-    
-    _vertices.erase(_vertices.begin() + vertexindex, _vertices.end());
-    _indices.erase(_indices.begin() + index, _indices.end());
-    
-    if (!_vertices.empty() && !_indices.empty()){
-        _vertexBuffer->updateVertices(&_vertices[0], vertexindex/* * sizeof(_posuvcolors[0])*/, 0);
-        _indexBuffer->updateIndices(&_indices[0], index/* * sizeof(unsigned short)*/, 0);
-
-        _stateBlock->setBlendFunc(particleSystem->getBlendFunc());
-        
-        GLuint texId = (_texture ? _texture->getName() : 0);
-        _meshCommand->init(0,
-                           texId,
-                           _glProgramState,
-                           _stateBlock,
-                           _vertexBuffer->getVBO(),
-                           _indexBuffer->getVBO(),
-                           GL_TRIANGLES,
-                           GL_UNSIGNED_SHORT,
-                           index,
-                           transform,
-                           Node::FLAGS_RENDER_AS_3D);
-        _meshCommand->setSkipBatching(true);
-        _meshCommand->setTransparent(true);
-        _glProgramState->setUniformVec4("u_color", Vec4(1,1,1,1));
-        renderer->addCommand(_meshCommand);
     }
 }
 
@@ -272,6 +357,7 @@ PUParticle3DQuadRender::PUParticle3DQuadRender()
     , _textureCoordsColumns(1)
     , _textureCoordsRowStep(1.0f)
     , _textureCoordsColStep(1.0f)
+    , _depthSort(false)
 {
     autoRotate = false;
 }
@@ -395,7 +481,7 @@ void PUParticle3DQuadRender::fillVertex( unsigned short index, const Vec3 &pos,
     _vertices[index].uv = uv;
 }
 
-void PUParticle3DQuadRender::fillTriangle( unsigned short index, unsigned short v0, unsigned short v1, unsigned short v2 )
+void PUParticle3DQuadRender::fillTriangle( size_t index, unsigned short v0, unsigned short v1, unsigned short v2 )
 {
     _indices[index] = v0;
     _indices[index + 1] = v1;
@@ -424,6 +510,7 @@ void PUParticle3DQuadRender::copyAttributesTo(PUParticle3DQuadRender *quadRender
     quadRender->_textureCoordsColumns = _textureCoordsColumns;
     quadRender->_textureCoordsRowStep = _textureCoordsRowStep;
     quadRender->_textureCoordsColStep = _textureCoordsColStep;
+    quadRender->_depthSort = _depthSort;
 }
 
 PUParticle3DQuadRender* PUParticle3DQuadRender::clone()
@@ -473,7 +560,7 @@ void PUParticle3DModelRender::render( Renderer* renderer, const Mat4 &transform,
 
 
     const ParticlePool& particlePool = particleSystem->getParticlePool();
-    ParticlePool::PoolList activeParticleList = particlePool.getActiveDataList();
+    const ParticlePool::PoolList &activeParticleList = particlePool.getActiveDataList();
     Mat4 mat;
     Mat4 rotMat;
     Mat4 sclMat;
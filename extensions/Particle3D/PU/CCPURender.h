@@ -36,6 +36,7 @@
 NS_CC_BEGIN
 
 // particle render for quad
+struct Particle3D;
 struct PUParticle3D;
 
 class CC_DLL PURender : public Particle3DRender
@@ -147,6 +148,10 @@ public:
     void setTextureCoordsColumns(unsigned short textureCoordsColumns);
     unsigned int getNumTextureCoords();
 
+    /** Draws the particles from the farthest to the nearest to the camera, for the alpha blended effects. Off by default. */
+    void setDepthSort(bool depthSort) { _depthSort = depthSort; }
+    bool isDepthSort() const { return _depthSort; }
+
     virtual void render(Renderer* renderer, const Mat4 &transform, ParticleSystem3D* particleSystem) override;
 
     virtual PUParticle3DQuadRender* clone() override;
@@ -158,10 +163,24 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
 
+    // what the quads of a frame share
+    struct QuadFrame
+    {
+        const std::vector<Particle3D*> *particles;
+        const unsigned int *order;
+        Vec3 right;
+        Vec3 up;
+        Vec3 backward;
+        int offsetX;
+        int offsetY;
+    };
+
     void getOriginOffset(int &offsetX, int &offsetY);
     void determineUVCoords(PUParticle3D *particle);
     void fillVertex(unsigned short index, const Vec3 &pos, const Vec4 &color, const Vec2 &uv);
-    void fillTriangle(unsigned short index, unsigned short v0, unsigned short v1, unsigned short v2);
+    void fillTriangle(size_t index, unsigned short v0, unsigned short v1, unsigned short v2);
+    void sortByDepth(const std::vector<Particle3D*> &particles, const Mat4 &modelView);
+    void fillQuads(const QuadFrame &frame, size_t begin, size_t end);
 
 protected:
 
@@ -175,6 +194,11 @@ protected:
     unsigned short _textureCoordsColumns;
     float _textureCoordsRowStep;
     float _textureCoordsColStep;
+
+    bool _depthSort;
+    // radix sort of the particles by view depth, the keys and indices are swapped between both halves
+    std::vector<unsigned int> _sortKeys;
+    std::vector<unsigned int> _sortIndices;
 };
 
 // particle render for Sprite3D
@@ -224,6 +224,18 @@ void PURendererTranslator::translate(PUScriptCompiler* compiler, PUAbstractNode
                             }
                         }
                     }
+                    else if (prop->name == token[TOKEN_RENDERER_SORTING])
+                    {
+                        // Property: sorting
+                        if (passValidateProperty(compiler, prop, token[TOKEN_RENDERER_SORTING], VAL_BOOL))
+                        {
+                            bool val;
+                            if(getBoolean(*prop->values.front(), &val))
+                            {
+                                static_cast<PUParticle3DQuadRender *>(_renderer)->setDepthSort(val);
+                            }
+                        }
+                    }
                     else if (prop->name == token[TOKEN_BILLBOARD_ROTATION_TYPE])
                     {
                         // Property: billboard_rotation_type
@@ -26,6 +26,9 @@
 #include "CCPUScriptCompiler.h"
 #include "extensions/Particle3D/PU/CCPUTranslateManager.h"
 #include "platform/CCFileUtils.h"
+#include "xxhash.h"
+#include <stdint.h>
+#include <thread>
 NS_CC_BEGIN
 
 // ObjectAbstractNode
@@ -183,6 +186,11 @@ PUScriptCompiler::PUScriptCompiler():_current(nullptr),_nodes(nullptr), _PUParti
 {
 }
 PUScriptCompiler::~PUScriptCompiler()
+{
+    clearCompiledScripts();
+}
+
+void PUScriptCompiler::clearCompiledScripts()
 {
     for (auto iter : _compiledScripts){
         for (auto miter : iter.second){
@@ -228,6 +236,17 @@ const PUAbstractNodeList* PUScriptCompiler::compile(const std::string &file, boo
     }
 
     std::string data = FileUtils::getInstance()->getStringFromFile(file);
+    std::string cachePath;
+    if (!_cacheDirectory.empty() && !data.empty()){
+        cachePath = getCachePath(data);
+        PUAbstractNodeList aNodes;
+        if (loadCachedScript(cachePath, data, file, aNodes)){
+            _compiledScripts[file] = aNodes;
+            isFirstCompile = true;
+            return &_compiledScripts[file];
+        }
+    }
+
     PUScriptLexer lexer;
     PUScriptParser parser;
     PUScriptTokenList tokenList;
@@ -246,11 +265,277 @@ const PUAbstractNodeList* PUScriptCompiler::compile(const std::string &file, boo
 
     isFirstCompile = true;
     if (state){
+        if (!cachePath.empty())
+            saveCachedScript(cachePath, data, _compiledScripts[file]);
         return &_compiledScripts[file];
     }
     return nullptr;
 }
 
+// the binary cache of the compiled scripts, files named after the hash of the script
+static const char SCRIPT_CACHE_MAGIC[4] = { 'C', 'C', 'P', 'U' };
+static const uint32_t SCRIPT_CACHE_VERSION = 1;
+
+struct PUScriptCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t scriptSize;
+    uint32_t scriptHash[2];
+};
+
+static void writeUInt(std::string &out, uint32_t value)
+{
+    out.append((const char*)&value, sizeof(value));
+}
+
+static void writeString(std::string &out, const std::string &value)
+{
+    writeUInt(out, (uint32_t)value.size());
+    out.append(value);
+}
+
+static bool writeNodes(std::string &out, const PUAbstractNodeList &nodes);
+
+static bool writeNode(std::string &out, const PUAbstractNode *node)
+{
+    writeUInt(out, node->type);
+    writeUInt(out, node->line);
+    switch (node->type)
+    {
+    case ANT_ATOM:
+        {
+            auto atom = static_cast<const PUAtomAbstractNode*>(node);
+            writeString(out, atom->value);
+            writeUInt(out, atom->id);
+            return true;
+        }
+    case ANT_PROPERTY:
+        {
+            auto prop = static_cast<const PUPropertyAbstractNode*>(node);
+            writeString(out, prop->name);
+            writeUInt(out, prop->id);
+            return writeNodes(out, prop->values);
+        }
+    case ANT_OBJECT:
+        {
+            auto obj = static_cast<const PUObjectAbstractNode*>(node);
+            writeString(out, obj->name);
+            writeString(out, obj->cls);
+            writeUInt(out, obj->id);
+            writeUInt(out, obj->abstract ? 1 : 0);
+            writeUInt(out, (uint32_t)obj->bases.size());
+            for (const auto &base : obj->bases)
+                writeString(out, base);
+            const auto &variables = obj->getVariables();
+            writeUInt(out, (uint32_t)variables.size());
+            for (const auto &variable : variables){
+                writeString(out, variable.first);
+                writeString(out, variable.second);
+            }
+            return writeNodes(out, obj->children) && writeNodes(out, obj->values);
+        }
+    default:
+        // the compiler makes no other node
+        return false;
+    }
+}
+
+static bool writeNodes(std::string &out, const PUAbstractNodeList &nodes)
+{
+    writeUInt(out, (uint32_t)nodes.size());
+    for (auto node : nodes){
+        if (!writeNode(out, node))
+            return false;
+    }
+    return true;
+}
+
+class PUScriptCacheReader
+{
+public:
+    PUScriptCacheReader(const unsigned char *bytes, size_t size, const std::string &file)
+    : _bytes(bytes), _end(bytes + size), _file(file)
+    {
+    }
+
+    bool readNodes(PUAbstractNodeList &nodes, PUAbstractNode *parent)
+    {
+        uint32_t count;
+        if (!readUInt(count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i){
+            PUAbstractNode *node = readNode(parent);
+            if (!node)
+                return false;
+            nodes.push_back(node);
+        }
+        return true;
+    }
+
+    bool isAtEnd() const { return _bytes == _end; }
+
+private:
+    bool readUInt(uint32_t &value)
+    {
+        if ((size_t)(_end - _bytes) < sizeof(value))
+            return false;
+        memcpy(&value, _bytes, sizeof(value));
+        _bytes += sizeof(value);
+        return true;
+    }
+
+    bool readString(std::string &value)
+    {
+        uint32_t size;
+        if (!readUInt(size) || (size_t)(_end - _bytes) < size)
+            return false;
+        value.assign((const char*)_bytes, size);
+        _bytes += size;
+        return true;
+    }
+
+    // the node is deleted on failure, with what was read of its children
+    PUAbstractNode* readNode(PUAbstractNode *parent)
+    {
+        uint32_t type, line;
+        if (!readUInt(type) || !readUInt(line))
+            return nullptr;
+
+        PUAbstractNode *node = nullptr;
+        bool ok = false;
+        switch (type)
+        {
+        case ANT_ATOM:
+            {
+                auto atom = new (std::nothrow) PUAtomAbstractNode(parent);
+                node = atom;
+                ok = readString(atom->value) && readUInt(atom->id);
+                break;
+            }
+        case ANT_PROPERTY:
+            {
+                auto prop = new (std::nothrow) PUPropertyAbstractNode(parent);
+                node = prop;
+                ok = readString(prop->name) && readUInt(prop->id) && readNodes(prop->values, prop);
+                break;
+            }
+        case ANT_OBJECT:
+            {
+                auto obj = new (std::nothrow) PUObjectAbstractNode(parent);
+                node = obj;
+                uint32_t abstract, count;
+                ok = readString(obj->name) && readString(obj->cls) && readUInt(obj->id) && readUInt(abstract) && readUInt(count);
+                obj->abstract = abstract != 0;
+                for (uint32_t i = 0; ok && i < count; ++i){
+                    std::string base;
+                    ok = readString(base);
+                    obj->bases.push_back(base);
+                }
+                ok = ok && readUInt(count);
+                for (uint32_t i = 0; ok && i < count; ++i){
+                    std::string name, value;
+                    ok = readString(name) && readString(value);
+                    obj->setVariable(name, value);
+                }
+                ok = ok && readNodes(obj->children, obj) && readNodes(obj->values, obj);
+                break;
+            }
+        default:
+            return nullptr;
+        }
+
+        if (!ok){
+            delete node;
+            return nullptr;
+        }
+        node->file = _file;
+        node->line = line;
+        return node;
+    }
+
+    const unsigned char *_bytes;
+    const unsigned char *_end;
+    const std::string &_file;
+};
+
+static void fillScriptCacheHeader(PUScriptCacheHeader &header, const std::string &data)
+{
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCRIPT_CACHE_MAGIC, sizeof(header.magic));
+    header.version = SCRIPT_CACHE_VERSION;
+    header.scriptSize = (uint32_t)data.size();
+    header.scriptHash[0] = XXH32(data.data(), data.size(), 0);
+    header.scriptHash[1] = XXH32(data.data(), data.size(), header.scriptHash[0]);
+}
+
+void PUScriptCompiler::setCacheDirectory(const std::string &directory)
+{
+    _cacheDirectory = directory;
+    if (!_cacheDirectory.empty()){
+        if (_cacheDirectory.back() != '/')
+            _cacheDirectory += '/';
+        FileUtils::getInstance()->createDirectory(_cacheDirectory);
+    }
+}
+
+std::string PUScriptCompiler::getCachePath(const std::string &data) const
+{
+    PUScriptCacheHeader header;
+    fillScriptCacheHeader(header, data);
+    char name[32];
+    snprintf(name, sizeof(name), "%08x%08x.pus", XXH32(&header, sizeof(header), 0), XXH32(&header, sizeof(header), 1));
+    return _cacheDirectory + name;
+}
+
+bool PUScriptCompiler::loadCachedScript(const std::string &cachePath, const std::string &data, const std::string &file, PUAbstractNodeList &aNodes)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(cachePath))
+        return false;
+
+    Data cache = fileUtils->getDataFromFile(cachePath);
+    PUScriptCacheHeader header, expected;
+    fillScriptCacheHeader(expected, data);
+    if (cache.getSize() < sizeof(header))
+        return false;
+    memcpy(&header, cache.getBytes(), sizeof(header));
+    if (memcmp(&header, &expected, sizeof(header)) != 0)
+        return false;
+
+    PUScriptCacheReader reader(cache.getBytes() + sizeof(header), cache.getSize() - sizeof(header), file);
+    if (!reader.readNodes(aNodes, nullptr) || !reader.isAtEnd() || aNodes.empty()){
+        CCLOG("PUScriptCompiler: ignoring the corrupted cache %s of %s", cachePath.c_str(), file.c_str());
+        for (auto node : aNodes)
+            delete node;
+        aNodes.clear();
+        return false;
+    }
+    return true;
+}
+
+void PUScriptCompiler::saveCachedScript(const std::string &cachePath, const std::string &data, const PUAbstractNodeList &aNodes)
+{
+    PUScriptCacheHeader header;
+    fillScriptCacheHeader(header, data);
+    std::string bytes((const char*)&header, sizeof(header));
+    if (!writeNodes(bytes, aNodes))
+        return;
+
+    Data cache;
+    cache.copy((const unsigned char*)bytes.data(), bytes.size());
+
+    // written aside and renamed, another process never reads a file half written
+    auto fileUtils = FileUtils::getInstance();
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%x.tmp", (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::string tempPath = cachePath + suffix;
+    if (!fileUtils->writeDataToFile(cache, tempPath) || !fileUtils->renameFile(tempPath, cachePath)){
+        CCLOG("PUScriptCompiler: cannot save %s", cachePath.c_str());
+        fileUtils->removeFile(tempPath);
+    }
+}
+
 
 
 void PUScriptCompiler::convertToAST(const PUConcreteNodeList &nodes,PUAbstractNodeList &aNodes)
@@ -143,6 +143,21 @@ public:
     const PUAbstractNodeList* compile(const std::string &file, bool &isFirstCompile);
     
     void convertToAST(const PUConcreteNodeList &nodes,PUAbstractNodeList &aNodes);
+
+    /**
+     * Enables the binary cache of the compiled scripts, off by default.
+     * The abstract nodes of a script are written there after it is parsed, and read back instead of lexing
+     * and parsing it again the next time the application runs. The files are keyed by the content of the
+     * script and the version of the format, an edited script is parsed again.
+     *
+     * @param directory A full path, e.g., FileUtils::getInstance()->getWritablePath() + "particles/", empty disables the cache.
+     * @since v3.9
+     */
+    void setCacheDirectory(const std::string &directory);
+    const std::string& getCacheDirectory() const { return _cacheDirectory; }
+
+    /** Releases the compiled scripts, the next compile() of a script reads it again. @since v3.9 */
+    void clearCompiledScripts();
     
     std::map<std::string,std::string> env;
     
@@ -152,8 +167,13 @@ private:
 
     void visitList(const PUConcreteNodeList &nodes);
     void visit(PUConcreteNode *node);
+
+    bool loadCachedScript(const std::string &cachePath, const std::string &data, const std::string &file, PUAbstractNodeList &aNodes);
+    void saveCachedScript(const std::string &cachePath, const std::string &data, const PUAbstractNodeList &aNodes);
+    std::string getCachePath(const std::string &data) const;
 private:
     
+    std::string _cacheDirectory;
     std::map<std::string, PUAbstractNodeList> _compiledScripts;
     PUAbstractNode *_current;
     PUAbstractNodeList *_nodes;
@@ -24,9 +24,11 @@
 #include "AssetsManagerEx.h"
 #include "CCEventListenerAssetsManagerEx.h"
 #include "deprecated/CCString.h"
+#include "base/CCAsyncTaskPool.h"
 #include "base/CCDirector.h"
 
 #include <stdio.h>
+#include <memory>
 
 #ifdef MINIZIP_FROM_SYSTEM
 #include <minizip/unzip.h>
@@ -70,6 +72,8 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
 , _percentByFile(0)
 , _totalToDownload(0)
 , _totalWaitToDownload(0)
+, _pendingDecompressions(0)
+, _batchFinished(false)
 , _inited(false)
 {
     // Init variables
@@ -256,6 +260,11 @@ const Manifest* AssetsManagerEx::getRemoteManifest() const
     return _remoteManifest;
 }
 
+void AssetsManagerEx::setMaxParallelDownloads(int count)
+{
+    _downloader->setMaxParallelDownloads(count);
+}
+
 const std::string& AssetsManagerEx::getStoragePath() const
 {
     return _storagePath;
@@ -404,18 +413,34 @@ bool AssetsManagerEx::decompress(const std::string &zip)
     return true;
 }
 
-void AssetsManagerEx::decompressDownloadedZip()
+void AssetsManagerEx::decompressAsync(const std::string &zip)
 {
-    // Decompress all compressed files
-    for (auto it = _compressedFiles.begin(); it != _compressedFiles.end(); ++it) {
-        std::string zipfile = *it;
-        if (!decompress(zipfile))
-        {
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", "Unable to decompress file " + zipfile);
-        }
-        _fileUtils->removeFile(zipfile);
+    // minizip needs the central directory at the end of the file, so a pack is extracted once downloaded,
+    // while the other assets are still downloading. The IO thread of the task pool extracts the packs one at a time.
+    ++_pendingDecompressions;
+    retain();
+    auto succeed = std::make_shared<bool>(false);
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [this, zip, succeed](void*) {
+        onDecompressed(zip, *succeed);
+    }, nullptr, [this, zip, succeed]() {
+        *succeed = decompress(zip);
+        _fileUtils->removeFile(zip);
+    });
+}
+
+void AssetsManagerEx::onDecompressed(const std::string &zip, bool succeed)
+{
+    --_pendingDecompressions;
+    if (!succeed)
+    {
+        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", "Unable to decompress file " + zip);
+    }
+    if (_pendingDecompressions == 0 && _batchFinished)
+    {
+        _batchFinished = false;
+        onBatchFinished();
     }
-    _compressedFiles.clear();
+    release();
 }
 
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId/* = ""*/, const std::string &message/* = ""*/, int curle_code/* = CURLE_OK*/, int curlm_code/* = CURLM_OK*/)
@@ -549,7 +574,6 @@ void AssetsManagerEx::startUpdate()
     // Clean up before update
     _failedUnits.clear();
     _downloadUnits.clear();
-    _compressedFiles.clear();
     _totalWaitToDownload = _totalToDownload = 0;
     _percent = _percentByFile = _sizeCollected = _totalSize = 0;
     _downloadedSize.clear();
@@ -602,6 +626,7 @@ void AssetsManagerEx::startUpdate()
                     unit.customId = it->first;
                     unit.srcUrl = packageUrl + path;
                     unit.storagePath = _storagePath + path;
+                    unit.hash = diff.asset.hash;
                     unit.resumeDownload = false;
                     _downloadUnits.emplace(unit.customId, unit);
                 }
@@ -641,11 +666,9 @@ void AssetsManagerEx::updateSucceed()
     _remoteManifest = nullptr;
     // 3. make local manifest take effect
     prepareLocalManifest();
-    // 4. decompress all compressed files
-    decompressDownloadedZip();
-    // 5. Set update state
+    // 4. Set update state, the compressed files were decompressed once downloaded
     _updateState = State::UP_TO_DATE;
-    // 6. Notify finished event
+    // 5. Notify finished event
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FINISHED);
 }
 
@@ -809,6 +832,8 @@ void AssetsManagerEx::onError(const network::Downloader::Error &error)
         if (unitIt != _downloadUnits.end())
         {
             network::DownloadUnit unit = unitIt->second;
+            // the downloaded part is kept, and resumed by downloadFailedAssets
+            unit.resumeDownload = error.code == network::Downloader::ErrorCode::NETWORK;
             _failedUnits.emplace(unit.customId, unit);
         }
         dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_UPDATING, error.customId, error.message, error.curle_code, error.curlm_code);
@@ -881,21 +906,11 @@ void AssetsManagerEx::onSuccess(const std::string &srcUrl, const std::string &st
     }
     else if (customId == BATCH_UPDATE_ID)
     {
-        // Finished with error check
-        if (_failedUnits.size() > 0 || _totalWaitToDownload > 0)
-        {
-            // Save current download manifest information for resuming
-            _tempManifest->saveToFile(_tempManifestPath);
-            
-            decompressDownloadedZip();
-            
-            _updateState = State::FAIL_TO_UPDATE;
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FAILED);
-        }
+        // The result waits for the packs still decompressed
+        if (_pendingDecompressions > 0)
+            _batchFinished = true;
         else
-        {
-            updateSucceed();
-        }
+            onBatchFinished();
     }
     else
     {
@@ -908,7 +923,7 @@ void AssetsManagerEx::onSuccess(const std::string &srcUrl, const std::string &st
             
             // Add file to need decompress list
             if (assetIt->second.compressed) {
-                _compressedFiles.push_back(storagePath);
+                decompressAsync(storagePath);
             }
         }
         
@@ -935,6 +950,23 @@ void AssetsManagerEx::onSuccess(const std::string &srcUrl, const std::string &st
     }
 }
 
+void AssetsManagerEx::onBatchFinished()
+{
+    // Finished with error check
+    if (_failedUnits.size() > 0 || _totalWaitToDownload > 0)
+    {
+        // Save current download manifest information for resuming
+        _tempManifest->saveToFile(_tempManifestPath);
+        
+        _updateState = State::FAIL_TO_UPDATE;
+        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FAILED);
+    }
+    else
+    {
+        updateSucceed();
+    }
+}
+
 void AssetsManagerEx::destroyDownloadedVersion()
 {
     _fileUtils->removeFile(_cacheVersionPath);
@@ -108,6 +108,11 @@ public:
      */
     const Manifest* getRemoteManifest() const;
     
+    /** @brief Sets the number of assets downloaded at once, 6 by default.
+     * @since v3.9
+     */
+    void setMaxParallelDownloads(int count);
+    
 CC_CONSTRUCTOR_ACCESS:
     
     AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath);
@@ -139,7 +144,9 @@ protected:
     void startUpdate();
     void updateSucceed();
     bool decompress(const std::string &filename);
-    void decompressDownloadedZip();
+    void decompressAsync(const std::string &zip);
+    void onDecompressed(const std::string &zip, bool succeed);
+    void onBatchFinished();
     
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
@@ -236,8 +243,11 @@ private:
     //! All failed units
     network::DownloadUnits _failedUnits;
     
-    //! All files to be decompressed
-    std::vector<std::string> _compressedFiles;
+    //! Number of compressed files being decompressed on other threads
+    int _pendingDecompressions;
+    
+    //! Whether the batch download ended while files were still decompressed
+    bool _batchFinished;
     
     //! Download percent
     float _percent;
@@ -41,6 +41,7 @@
 
 #define KEY_PATH                "path"
 #define KEY_MD5                 "md5"
+#define KEY_HASH                "hash"
 #define KEY_GROUP               "group"
 #define KEY_COMPRESSED          "compressed"
 #define KEY_COMPRESSED_FILE     "compressedFile"
@@ -183,7 +184,7 @@ std::unordered_map<std::string, Manifest::AssetDiff> Manifest::genDiff(const Man
         
         // Modified
         valueB = valueIt->second;
-        if (valueA.md5 != valueB.md5) {
+        if (valueA.md5 != valueB.md5 || valueA.hash != valueB.hash) {
             AssetDiff diff;
             diff.asset = valueB;
             diff.type = DiffType::MODIFIED;
@@ -221,6 +222,7 @@ void Manifest::genResumeAssetsList(network::DownloadUnits *units) const
             unit.customId = it->first;
             unit.srcUrl = _packageUrl + asset.path;
             unit.storagePath = _manifestRoot + asset.path;
+            unit.hash = asset.hash;
             if (asset.downloadState == DownloadState::DOWNLOADING)
             {
                 unit.resumeDownload = true;
@@ -378,6 +380,11 @@ Manifest::Asset Manifest::parseAsset(const std::string &path, const rapidjson::V
         asset.md5 = json[KEY_MD5].GetString();
     }
     else asset.md5 = "";
+
+    if ( json.HasMember(KEY_HASH) && json[KEY_HASH].IsString() )
+    {
+        asset.hash = json[KEY_HASH].GetString();
+    }
     
     if ( json.HasMember(KEY_PATH) && json[KEY_PATH].IsString() )
     {
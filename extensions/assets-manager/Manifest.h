@@ -61,6 +61,8 @@ public:
     //! Asset object
     struct Asset {
         std::string md5;
+        //! xxHash32 of the file as 8 hexadecimal digits, checked after the download when present
+        std::string hash;
         std::string path;
         bool compressed;
         DownloadState downloadState;
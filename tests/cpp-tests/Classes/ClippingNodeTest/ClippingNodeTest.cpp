@@ -606,13 +606,13 @@ void RawStencilBufferTest::draw(Renderer *renderer, const Mat4 &transform, uint3
 
 void RawStencilBufferTest::onEnableStencil()
 {
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
 void RawStencilBufferTest::onDisableStencil()
 {
-    glDisable(GL_STENCIL_TEST);
+    GL::disable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -705,12 +705,12 @@ std::string RawStencilBufferTest2::subtitle() const
 void RawStencilBufferTest2::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest2::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -724,14 +724,14 @@ std::string RawStencilBufferTest3::subtitle() const
 void RawStencilBufferTest3::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest3::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
-    //glEnable(GL_DEPTH_TEST);
+    GL::depthMask(GL_TRUE);
+    //GL::enable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -754,10 +754,10 @@ std::string RawStencilBufferTest4::subtitle() const
 void RawStencilBufferTest4::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
-    glEnable(GL_ALPHA_TEST);
+    GL::enable(GL_ALPHA_TEST);
     glAlphaFunc(GL_GREATER, _alphaThreshold);
 #else
     auto program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
@@ -770,9 +770,9 @@ void RawStencilBufferTest4::setupStencilForClippingOnPlane(GLint plane)
 void RawStencilBufferTest4::setupStencilForDrawingOnPlane(GLint plane)
 {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
-    glDisable(GL_ALPHA_TEST);
+    GL::disable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -786,11 +786,11 @@ std::string RawStencilBufferTest5::subtitle() const
 void RawStencilBufferTest5::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
-    glEnable(GL_ALPHA_TEST);
+    GL::enable(GL_ALPHA_TEST);
     glAlphaFunc(GL_GREATER, _alphaThreshold);
 #else
     auto program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
@@ -803,10 +803,10 @@ void RawStencilBufferTest5::setupStencilForClippingOnPlane(GLint plane)
 void RawStencilBufferTest5::setupStencilForDrawingOnPlane(GLint plane)
 {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
-    glDisable(GL_ALPHA_TEST);
+    GL::disable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
-    //glEnable(GL_DEPTH_TEST);
+    GL::depthMask(GL_TRUE);
+    //GL::enable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -879,10 +879,10 @@ void RawStencilBufferTest6::setupStencilForClippingOnPlane(GLint plane)
     
     glStencilFunc(GL_NEVER, planeMask, planeMask);
     glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
-    glEnable(GL_ALPHA_TEST);
+    GL::enable(GL_ALPHA_TEST);
     glAlphaFunc(GL_GREATER, _alphaThreshold);
 #else
     auto program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
@@ -896,10 +896,10 @@ void RawStencilBufferTest6::setupStencilForClippingOnPlane(GLint plane)
 void RawStencilBufferTest6::setupStencilForDrawingOnPlane(GLint plane)
 {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
-    glDisable(GL_ALPHA_TEST);
+    GL::disable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
-    //glEnable(GL_DEPTH_TEST);
+    GL::depthMask(GL_TRUE);
+    //GL::enable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
     glFlush();
 }
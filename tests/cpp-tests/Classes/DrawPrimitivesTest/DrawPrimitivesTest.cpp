@@ -51,7 +51,7 @@ void DrawPrimitivesTest::onDraw(const Mat4 &transform, uint32_t flags)
     // Line Width: 1
     // color: 255,255,255,255 (white, non-transparent)
     // Anti-Aliased
-    //  glEnable(GL_LINE_SMOOTH);
+    //  GL::enable(GL_LINE_SMOOTH);
     DrawPrimitives::drawLine( VisibleRect::leftBottom(), VisibleRect::rightTop() );
     
     CHECK_GL_ERROR_DEBUG();
@@ -59,7 +59,7 @@ void DrawPrimitivesTest::onDraw(const Mat4 &transform, uint32_t flags)
     // line: color, width, aliased
     // glLineWidth > 1 and GL_LINE_SMOOTH are not compatible
     // GL_SMOOTH_LINE_WIDTH_RANGE = (1,1) on iPhone
-    //  glDisable(GL_LINE_SMOOTH);
+    //  GL::disable(GL_LINE_SMOOTH);
     glLineWidth( 5.0f );
     DrawPrimitives::setDrawColor4B(255,0,0,255);
     DrawPrimitives::drawLine( VisibleRect::leftTop(), VisibleRect::rightBottom() );
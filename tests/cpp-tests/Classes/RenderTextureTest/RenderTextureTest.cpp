@@ -471,7 +471,7 @@ void RenderTextureTestDepthStencil::onBeforeClear()
 void RenderTextureTestDepthStencil::onBeforeStencil()
 {
     //! mark sprite quad into stencil buffer
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     glStencilFunc(GL_NEVER, 1, 0xFF);
     glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
 
@@ -493,7 +493,7 @@ void RenderTextureTestDepthStencil::onBeforDraw()
 
 void RenderTextureTestDepthStencil::onAfterDraw()
 {
-    glDisable(GL_STENCIL_TEST);
+    GL::disable(GL_STENCIL_TEST);
 
     // Since cocos2d-x v3.7, users should avoid calling GL directly because it will break the internal GL state
     // But if users must call GL directly, they should update the state manually,
@@ -19,7 +19,7 @@ public:
     
     virtual void drawSkeleton (const cocos2d::Mat4& transform, uint32_t transformFlags) override
     {
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         SkeletonAnimation::drawSkeleton(transform, transformFlags);
         RenderState::StateBlock::invalidate(cocos2d::RenderState::StateBlock::RS_ALL_ONES);
     }
@@ -1045,11 +1045,11 @@ void Effect3DOutline::draw(const Mat4 &transform)
         GLenum cullFace = GL_FRONT;
         if ((_sprite->getScaleX() * _sprite->getScaleY() * _sprite->getScaleZ()) < 0.0f)
             cullFace = GL_BACK;
-        glEnable(GL_CULL_FACE);
-        glCullFace(cullFace);
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_CULL_FACE);
+        GL::cullFace(cullFace);
+        GL::enable(GL_DEPTH_TEST);
         auto mesh = _sprite->getMesh();
-        glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer());
+        GL::bindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer());
         
         auto skin = _sprite->getMesh()->getSkin();
         if(_sprite && skin)
@@ -1060,16 +1060,16 @@ void Effect3DOutline::draw(const Mat4 &transform)
         if(_sprite)
             _glProgramState->apply(transform);
  
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->getIndexBuffer());
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->getIndexBuffer());
         glDrawElements(mesh->getPrimitiveType(), (GLsizei)mesh->getIndexCount(), mesh->getIndexFormat(), 0);
         CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, mesh->getIndexCount());
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
-        glDisable(GL_DEPTH_TEST);
-        glCullFace(GL_BACK);
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_DEPTH_TEST);
+        GL::cullFace(GL_BACK);
+        GL::disable(GL_CULL_FACE);
 
         // Since cocos2d-x v3.7, users should avoid calling GL directly because it will break the internal GL state
         // But if users must call GL directly, they should update the state manually,
@@ -0,0 +1,462 @@
+#include "BenchmarkApp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "platform/linux/CCGLViewHeadless-linux.h"
+#include "platform/linux/CCNullGL-linux.h"
+#include "renderer/CCRenderThread.h"
+#include "json/prettywriter.h"
+#include "json/stringbuffer.h"
+
+#include "BenchmarkScenes.h"
+#include "BenchmarkTasks.h"
+
+USING_NS_CC;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+enum Phase
+{
+    PHASE_UPDATE,
+    PHASE_VISIT,
+    PHASE_RENDER,
+    PHASE_SWAP,
+    PHASE_FRAME,
+    PHASE_COUNT
+};
+
+const char* const kPhaseNames[PHASE_COUNT] = { "update", "visit", "render", "swap", "frame" };
+
+const char* const kStateCallNames[GL::STATE_CALL_MAX] = {
+    "program", "texture", "blendFunc", "capability", "depthMask", "depthFunc", "face", "buffer", "vao", "vertexAttrib", "uniform"
+};
+
+struct FrameMarks
+{
+    Clock::time_point start;
+    Clock::time_point afterUpdate;
+    Clock::time_point afterVisit;
+    Clock::time_point afterDraw;
+    Clock::time_point end;
+};
+
+struct SceneReport
+{
+    std::string name;
+    std::vector<double> phases[PHASE_COUNT];
+    double drawnBatches;
+    double drawnVertices;
+    NullGL::Stats gl;
+    double stateCallsIssued[GL::STATE_CALL_MAX];
+    double stateCallsFiltered[GL::STATE_CALL_MAX];
+    RenderThread::Stats renderThread;
+};
+
+struct TaskReport
+{
+    std::string name;
+    std::vector<double> iterations;
+    // KB, -1 when the kernel can't reset the peak
+    long peakMemoryGrowth;
+};
+
+double toMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void writeSamples(rapidjson::PrettyWriter<rapidjson::StringBuffer>& writer, std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0;
+    for (auto sample : samples)
+        sum += sample;
+
+    auto percentile = [&samples](double p) {
+        return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))];
+    };
+
+    writer.StartObject();
+    writer.String("mean");
+    writer.Double(sum / samples.size());
+    writer.String("min");
+    writer.Double(samples.front());
+    writer.String("p50");
+    writer.Double(percentile(0.5));
+    writer.String("p95");
+    writer.Double(percentile(0.95));
+    writer.String("max");
+    writer.Double(samples.back());
+    writer.EndObject();
+}
+
+// KB of resident memory from /proc/self/status: "VmRSS" now, "VmHWM" the peak since the last resetPeakMemory()
+long readMemoryStatus(const char* field)
+{
+    FILE* file = fopen("/proc/self/status", "r");
+    if (!file)
+        return -1;
+
+    long value = -1;
+    size_t length = strlen(field);
+    char line[256];
+    while (fgets(line, sizeof(line), file))
+    {
+        if (strncmp(line, field, length) == 0 && line[length] == ':')
+        {
+            value = atol(line + length + 1);
+            break;
+        }
+    }
+    fclose(file);
+    return value;
+}
+
+// brings VmHWM down to VmRSS, since Linux 4.0
+bool resetPeakMemory()
+{
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (!file)
+        return false;
+    bool written = fputs("5", file) >= 0;
+    return fclose(file) == 0 && written;
+}
+
+void writeCounter(rapidjson::PrettyWriter<rapidjson::StringBuffer>& writer, const char* name, double total, int frames)
+{
+    writer.String(name);
+    writer.Double(total / frames);
+}
+
+} // namespace
+
+BenchmarkOptions::BenchmarkOptions()
+: frames(600)
+, warmupFrames(30)
+, iterations(20)
+, deltaTime(1.0f / 60)
+, frameSize(960, 640)
+#ifdef BENCHMARK_RESOURCE_ROOT
+, resourceRoot(BENCHMARK_RESOURCE_ROOT)
+#endif
+, pipelined(false)
+{
+}
+
+BenchmarkApp::BenchmarkApp(const BenchmarkOptions& options)
+: _options(options)
+{
+}
+
+BenchmarkApp::~BenchmarkApp()
+{
+}
+
+bool BenchmarkApp::applicationDidFinishLaunching()
+{
+    auto director = Director::getInstance();
+    auto glview = GLViewHeadless::createWithRect("headless-benchmark", Rect(0, 0, _options.frameSize.width, _options.frameSize.height));
+    if (glview == nullptr)
+        return false;
+
+    director->setOpenGLView(glview);
+    director->setAnimationInterval(_options.deltaTime);
+    director->setFixedDeltaTime(_options.deltaTime);
+    director->setPipelinedRendering(_options.pipelined);
+
+    if (!_options.resourceRoot.empty())
+        FileUtils::getInstance()->addSearchPath(_options.resourceRoot);
+
+    return true;
+}
+
+int BenchmarkApp::runBenchmarks()
+{
+    if (!applicationDidFinishLaunching())
+    {
+        fprintf(stderr, "headless-benchmark: unable to create the headless GLView\n");
+        return EXIT_FAILURE;
+    }
+
+    const bool all = _options.scenes.empty() && _options.tasks.empty();
+    std::vector<const BenchmarkScene*> selected;
+    for (const auto& scene : getBenchmarkScenes())
+    {
+        if (all || std::find(_options.scenes.begin(), _options.scenes.end(), scene.name) != _options.scenes.end())
+            selected.push_back(&scene);
+    }
+    std::vector<const BenchmarkTask*> selectedTasks;
+    for (const auto& task : getBenchmarkTasks())
+    {
+        if (all || std::find(_options.tasks.begin(), _options.tasks.end(), task.name) != _options.tasks.end())
+            selectedTasks.push_back(&task);
+    }
+    if (selected.empty() && selectedTasks.empty())
+    {
+        fprintf(stderr, "headless-benchmark: no scene or task matches the selection\n");
+        return EXIT_FAILURE;
+    }
+
+    auto director = Director::getInstance();
+    auto glview = director->getOpenGLView();
+    glview->retain();
+
+    auto dispatcher = director->getEventDispatcher();
+    FrameMarks marks;
+    auto afterUpdate = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [&marks](EventCustom*) { marks.afterUpdate = Clock::now(); });
+    auto afterVisit = dispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [&marks](EventCustom*) { marks.afterVisit = Clock::now(); });
+    auto afterDraw = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [&marks](EventCustom*) { marks.afterDraw = Clock::now(); });
+
+    std::vector<SceneReport> reports;
+    for (auto benchmark : selected)
+    {
+        auto scene = benchmark->create();
+        if (director->getRunningScene())
+            director->replaceScene(scene);
+        else
+            director->runWithScene(scene);
+
+        for (int i = 0; i < _options.warmupFrames; ++i)
+            director->mainLoop();
+
+        SceneReport report;
+        report.name = benchmark->name;
+        report.drawnBatches = report.drawnVertices = 0;
+        memset(&report.gl, 0, sizeof(report.gl));
+        memset(report.stateCallsIssued, 0, sizeof(report.stateCallsIssued));
+        memset(report.stateCallsFiltered, 0, sizeof(report.stateCallsFiltered));
+        memset(&report.renderThread, 0, sizeof(report.renderThread));
+
+        auto renderThread = director->getRenderThread();
+        if (renderThread)
+        {
+            renderThread->finish();
+            renderThread->resetStats();
+        }
+        NullGL::resetStats();
+
+        for (int i = 0; i < _options.frames; ++i)
+        {
+            marks.start = Clock::now();
+            marks.afterUpdate = marks.afterVisit = marks.afterDraw = Clock::time_point();
+            director->mainLoop();
+            marks.end = Clock::now();
+
+            // a phase whose event did not fire takes no time
+            if (marks.afterUpdate == Clock::time_point()) marks.afterUpdate = marks.start;
+            if (marks.afterVisit == Clock::time_point()) marks.afterVisit = marks.afterUpdate;
+            if (marks.afterDraw == Clock::time_point()) marks.afterDraw = marks.afterVisit;
+
+            report.phases[PHASE_UPDATE].push_back(toMilliseconds(marks.afterUpdate - marks.start));
+            report.phases[PHASE_VISIT].push_back(toMilliseconds(marks.afterVisit - marks.afterUpdate));
+            report.phases[PHASE_RENDER].push_back(toMilliseconds(marks.afterDraw - marks.afterVisit));
+            report.phases[PHASE_SWAP].push_back(toMilliseconds(marks.end - marks.afterDraw));
+            report.phases[PHASE_FRAME].push_back(toMilliseconds(marks.end - marks.start));
+
+            auto renderer = director->getRenderer();
+            report.drawnBatches += renderer->getDrawnBatches();
+            report.drawnVertices += renderer->getDrawnVertices();
+
+            // reset by the renderer every frame
+            const auto& stateCalls = GL::getStateCacheStats();
+            for (int call = 0; call < GL::STATE_CALL_MAX; ++call)
+            {
+                report.stateCallsIssued[call] += stateCalls.issued[call];
+                report.stateCallsFiltered[call] += stateCalls.filtered[call];
+            }
+        }
+        if (renderThread)
+        {
+            renderThread->finish();
+            report.renderThread = renderThread->getStats();
+        }
+        report.gl = NullGL::getTotalStats();
+        reports.push_back(report);
+    }
+
+    dispatcher->removeEventListener(afterUpdate);
+    dispatcher->removeEventListener(afterVisit);
+    dispatcher->removeEventListener(afterDraw);
+
+    std::vector<TaskReport> taskReports;
+    for (auto task : selectedTasks)
+    {
+        if (task->prepare)
+            task->prepare();
+
+        TaskReport report;
+        report.name = task->name;
+        bool peakReset = resetPeakMemory();
+        long residentBefore = readMemoryStatus("VmRSS");
+        for (int i = 0; i < _options.iterations; ++i)
+        {
+            auto start = Clock::now();
+            task->run();
+            report.iterations.push_back(toMilliseconds(Clock::now() - start));
+
+            if (task->reset)
+                task->reset();
+        }
+        long peak = readMemoryStatus("VmHWM");
+        report.peakMemoryGrowth = (peakReset && peak >= 0 && residentBefore >= 0) ? peak - residentBefore : -1;
+        taskReports.push_back(report);
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+
+    writer.String("config");
+    writer.StartObject();
+    writer.String("frames");
+    writer.Int(_options.frames);
+    writer.String("warmupFrames");
+    writer.Int(_options.warmupFrames);
+    writer.String("iterations");
+    writer.Int(_options.iterations);
+    writer.String("deltaTime");
+    writer.Double(_options.deltaTime);
+    writer.String("width");
+    writer.Double(_options.frameSize.width);
+    writer.String("height");
+    writer.Double(_options.frameSize.height);
+    writer.String("pipelined");
+    writer.Bool(_options.pipelined);
+    writer.EndObject();
+
+    writer.String("scenes");
+    writer.StartArray();
+    for (const auto& report : reports)
+    {
+        const int frames = _options.frames;
+        writer.StartObject();
+        writer.String("name");
+        writer.String(report.name.c_str());
+
+        // milliseconds
+        writer.String("phases");
+        writer.StartObject();
+        for (int phase = 0; phase < PHASE_COUNT; ++phase)
+        {
+            writer.String(kPhaseNames[phase]);
+            writeSamples(writer, report.phases[phase]);
+        }
+        writer.EndObject();
+
+        // per frame averages
+        writer.String("renderer");
+        writer.StartObject();
+        writeCounter(writer, "drawnBatches", report.drawnBatches, frames);
+        writeCounter(writer, "drawnVertices", report.drawnVertices, frames);
+        writer.EndObject();
+
+        writer.String("gl");
+        writer.StartObject();
+        writeCounter(writer, "drawCalls", report.gl.drawCalls, frames);
+        writeCounter(writer, "drawnVertices", report.gl.drawnVertices, frames);
+        writeCounter(writer, "bufferUploads", report.gl.bufferUploads, frames);
+        writeCounter(writer, "bufferUploadBytes", report.gl.bufferUploadBytes, frames);
+        writeCounter(writer, "textureUploads", report.gl.textureUploads, frames);
+        writeCounter(writer, "textureUploadBytes", report.gl.textureUploadBytes, frames);
+        writeCounter(writer, "stateChanges", report.gl.stateChanges, frames);
+        writeCounter(writer, "programBinds", report.gl.programBinds, frames);
+        writeCounter(writer, "textureBinds", report.gl.textureBinds, frames);
+        writeCounter(writer, "bufferBinds", report.gl.bufferBinds, frames);
+        writeCounter(writer, "uniformUpdates", report.gl.uniformUpdates, frames);
+        writeCounter(writer, "vertexAttribCalls", report.gl.vertexAttribCalls, frames);
+        writeCounter(writer, "clears", report.gl.clears, frames);
+        writeCounter(writer, "framebufferBinds", report.gl.framebufferBinds, frames);
+        writeCounter(writer, "readPixels", report.gl.readPixels, frames);
+        writer.EndObject();
+
+        // state changes sent to GL and filtered by the GL state cache
+        writer.String("stateCache");
+        writer.StartObject();
+        const char* const kinds[2] = { "issued", "filtered" };
+        const double* const counts[2] = { report.stateCallsIssued, report.stateCallsFiltered };
+        for (int kind = 0; kind < 2; ++kind)
+        {
+            writer.String(kinds[kind]);
+            writer.StartObject();
+            double total = 0;
+            for (int call = 0; call < GL::STATE_CALL_MAX; ++call)
+            {
+                writeCounter(writer, kStateCallNames[call], counts[kind][call], frames);
+                total += counts[kind][call];
+            }
+            writeCounter(writer, "total", total, frames);
+            writer.EndObject();
+        }
+        writer.EndObject();
+
+        if (_options.pipelined)
+        {
+            // durations in milliseconds
+            writer.String("renderThread");
+            writer.StartObject();
+            writer.String("renderedFrames");
+            writer.Uint(report.renderThread.renderedFrames);
+            writer.String("overlappedFrames");
+            writer.Uint(report.renderThread.overlappedFrames);
+            writer.String("averageLatency");
+            writer.Double(report.renderThread.averageLatency * 1000);
+            writer.String("maxLatency");
+            writer.Double(report.renderThread.maxLatency * 1000);
+            writer.String("averageRenderTime");
+            writer.Double(report.renderThread.averageRenderTime * 1000);
+            writer.String("averageWaitTime");
+            writer.Double(report.renderThread.averageWaitTime * 1000);
+            writer.String("framesPerSecond");
+            writer.Double(report.renderThread.framesPerSecond);
+            writer.EndObject();
+        }
+
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    // milliseconds per iteration
+    writer.String("tasks");
+    writer.StartArray();
+    for (const auto& report : taskReports)
+    {
+        writer.StartObject();
+        writer.String("name");
+        writer.String(report.name.c_str());
+        writer.String("duration");
+        writeSamples(writer, report.iterations);
+        // MB over the resident memory before the first iteration
+        if (report.peakMemoryGrowth >= 0)
+        {
+            writer.String("peakMemoryGrowth");
+            writer.Double(report.peakMemoryGrowth / 1024.0);
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    int ret = EXIT_SUCCESS;
+    if (_options.outputPath.empty())
+    {
+        printf("%s\n", buffer.GetString());
+    }
+    else if (!FileUtils::getInstance()->writeStringToFile(buffer.GetString(), _options.outputPath))
+    {
+        fprintf(stderr, "headless-benchmark: unable to write %s\n", _options.outputPath.c_str());
+        ret = EXIT_FAILURE;
+    }
+
+    director->end();
+    director->mainLoop();
+    glview->release();
+
+    return ret;
+}
@@ -0,0 +1,64 @@
+#ifndef __BENCHMARK_APP_H__
+#define __BENCHMARK_APP_H__
+
+#include <string>
+#include <vector>
+
+#include "cocos2d.h"
+
+/** Command line options of the runner. */
+struct BenchmarkOptions
+{
+    BenchmarkOptions();
+
+    /** Scenes and tasks to run, all of them if both are empty. */
+    std::vector<std::string> scenes;
+    std::vector<std::string> tasks;
+    /** Measured frames per scene. */
+    int frames;
+    /** Frames run before measuring, so that textures and glyphs are loaded. */
+    int warmupFrames;
+    /** Timed runs per task. */
+    int iterations;
+    /** Delta time fed to the Director every frame, in seconds. */
+    float deltaTime;
+    cocos2d::Size frameSize;
+    std::string resourceRoot;
+    /** File receiving the JSON report, stdout if empty. */
+    std::string outputPath;
+    /** Draws the frames on a render thread, @see Director::setPipelinedRendering(). */
+    bool pipelined;
+};
+
+/**
+ * Runs fixed scenes on a GLViewHeadless for a fixed number of frames with a fixed
+ * delta time, and reports per-phase timings plus renderer and NullGL counters as JSON.
+ *
+ * Phases are delimited by the Director events:
+ * update (delta time, scheduler) -> EVENT_AFTER_UPDATE -> visit (physics, scene visit)
+ * -> EVENT_AFTER_VISIT -> render (Renderer::render) -> EVENT_AFTER_DRAW -> swap (swap
+ * buffers and autorelease pool).
+ *
+ * When the rendering is pipelined, render only records the frame and swap includes the
+ * wait for the render thread, whose own counters are reported under "renderThread".
+ *
+ * Tasks, such as loading resources, run after the scenes and report the duration of each iteration.
+ */
+class BenchmarkApp : private cocos2d::Application
+{
+public:
+    explicit BenchmarkApp(const BenchmarkOptions& options);
+    virtual ~BenchmarkApp();
+
+    /** Runs the benchmarks and writes the report, returns the process exit code. */
+    int runBenchmarks();
+
+    virtual bool applicationDidFinishLaunching() override;
+    virtual void applicationDidEnterBackground() override {}
+    virtual void applicationWillEnterForeground() override {}
+
+private:
+    BenchmarkOptions _options;
+};
+
+#endif // __BENCHMARK_APP_H__
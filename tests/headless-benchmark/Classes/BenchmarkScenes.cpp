@@ -0,0 +1,573 @@
+#include "BenchmarkScenes.h"
+
+#include "ui/UIScale9Sprite.h"
+
+#if BENCHMARK_WITH_EXTENSIONS
+#include "Particle3D/PU/CCPUParticleSystem3D.h"
+#include "Particle3D/PU/CCPURender.h"
+#endif
+
+USING_NS_CC;
+
+// Every scene seeds the random generator so that particles and positions
+// are the same from one run to the next.
+static const unsigned int kRandomSeed = 12345;
+
+static Scene* createSpritesScene()
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+
+    // two textures interleaved, so that batching is broken every other sprite
+    const char* images[] = { "Images/grossini.png", "Images/grossinis_sister1.png" };
+    for (int i = 0; i < 2000; ++i)
+    {
+        auto sprite = Sprite::create(images[i % 2]);
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * size.width, CCRANDOM_0_1() * size.height));
+        sprite->setScale(0.5f);
+        sprite->runAction(RepeatForever::create(RotateBy::create(2.0f, 360.0f)));
+        sprite->runAction(RepeatForever::create(Sequence::create(MoveBy::create(1.0f, Vec2(40, 0)),
+                                                                 MoveBy::create(1.0f, Vec2(-40, 0)),
+                                                                 nullptr)));
+        scene->addChild(sprite);
+    }
+    return scene;
+}
+
+static Scene* createLabelsScene()
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+
+    std::vector<Label*> labels;
+    for (int i = 0; i < 200; ++i)
+    {
+        auto label = Label::createWithTTF("0", "fonts/arial.ttf", 16);
+        label->setPosition(Vec2(CCRANDOM_0_1() * size.width, CCRANDOM_0_1() * size.height));
+        scene->addChild(label);
+        labels.push_back(label);
+    }
+
+    // new strings every frame, so the layout runs each frame as well
+    auto frame = std::make_shared<unsigned int>(0);
+    scene->schedule([labels, frame](float dt) {
+        char str[32];
+        ++(*frame);
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            snprintf(str, sizeof(str), "%u - %u", *frame, (unsigned int)i);
+            labels[i]->setString(str);
+        }
+    }, "labels");
+
+    return scene;
+}
+
+static Scene* createParticlesScene()
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        ParticleSystemQuad* emitter = (i % 2) ? (ParticleSystemQuad*)ParticleGalaxy::create() : (ParticleSystemQuad*)ParticleSun::create();
+        emitter->setPosition(Vec2((i + 0.5f) * size.width / 10, size.height / 2));
+        scene->addChild(emitter);
+    }
+    return scene;
+}
+
+static const char* kProgramStateVertexShader =
+    "attribute vec4 a_position;\n"
+    "uniform mat4 u_transform;\n"
+    "uniform vec4 u_offset;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = CC_MVPMatrix * u_transform * (a_position + u_offset);\n"
+    "}\n";
+
+static const char* kProgramStateFragmentShader =
+    "uniform vec4 u_color;\n"
+    "uniform float u_amount;\n"
+    "uniform sampler2D u_texture;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = texture2D(u_texture, vec2(0.5, 0.5)) * u_color * u_amount;\n"
+    "}\n";
+
+// Applies 10000 GLProgramStates per frame, round robin over states of the same program.
+// Each state changes one uniform per frame, the other ones keep their value.
+// With one state, the program keeps the uniforms of the state from one apply to the next.
+class ProgramStateBenchmark : public Node
+{
+public:
+    static const int APPLY_COUNT = 10000;
+
+    static ProgramStateBenchmark* create(int stateCount)
+    {
+        auto benchmark = new (std::nothrow) ProgramStateBenchmark();
+        if (benchmark && benchmark->init(stateCount))
+        {
+            benchmark->autorelease();
+            return benchmark;
+        }
+        CC_SAFE_DELETE(benchmark);
+        return nullptr;
+    }
+
+    bool init(int stateCount)
+    {
+        if (!Node::init())
+            return false;
+
+        auto program = GLProgram::createWithByteArrays(kProgramStateVertexShader, kProgramStateFragmentShader);
+        auto texture = Director::getInstance()->getTextureCache()->addImage("Images/grossini.png");
+        for (int i = 0; i < stateCount; ++i)
+        {
+            auto state = GLProgramState::create(program);
+            state->setUniformMat4("u_transform", Mat4::IDENTITY);
+            state->setUniformVec4("u_offset", Vec4(i, 0, 0, 0));
+            state->setUniformVec4("u_color", Vec4(CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), 1));
+            if (texture)
+                state->setUniformTexture("u_texture", texture);
+            _states.pushBack(state);
+        }
+        _amountLocation = _states.at(0)->getUniformLocation("u_amount");
+
+        scheduleUpdate();
+        return true;
+    }
+
+    virtual void update(float dt) override
+    {
+        _time += dt;
+        for (ssize_t i = 0; i < _states.size(); ++i)
+            _states.at(i)->setUniformFloat(_amountLocation, sinf(_time + i));
+    }
+
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override
+    {
+        _command.init(_globalZOrder, transform, flags);
+        _command.func = CC_CALLBACK_0(ProgramStateBenchmark::onDraw, this, transform);
+        renderer->addCommand(&_command);
+    }
+
+protected:
+    ProgramStateBenchmark()
+    : _amountLocation(-1)
+    , _time(0)
+    {
+    }
+
+    void onDraw(const Mat4& transform)
+    {
+        for (int i = 0; i < APPLY_COUNT; ++i)
+            _states.at(i % _states.size())->apply(transform);
+    }
+
+    Vector<GLProgramState*> _states;
+    GLint _amountLocation;
+    float _time;
+    CustomCommand _command;
+};
+
+static Scene* createProgramStateScene(int stateCount)
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    scene->addChild(ProgramStateBenchmark::create(stateCount));
+    return scene;
+}
+
+static Scene* createProgramStatesScene()
+{
+    return createProgramStateScene(100);
+}
+
+static Scene* createProgramStateSameScene()
+{
+    return createProgramStateScene(1);
+}
+
+// 400 panels of one texture, resized every frame; as sliced sprites every panel is 10 nodes and 9 quads,
+// as a mesh it is 1 node and 1 command, batched with the others
+static Scene* createScale9Scene(ui::Scale9Sprite::RenderingType renderingType)
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+
+    std::vector<ui::Scale9Sprite*> panels;
+    for (int i = 0; i < 400; ++i)
+    {
+        auto panel = ui::Scale9Sprite::create("Images/blocks9.png", Rect::ZERO, Rect(32, 32, 32, 32));
+        panel->setRenderingType(renderingType);
+        panel->setPosition(Vec2(CCRANDOM_0_1() * size.width, CCRANDOM_0_1() * size.height));
+        panel->setFlippedX(i % 3 == 0);
+        scene->addChild(panel);
+        panels.push_back(panel);
+    }
+
+    auto time = std::make_shared<float>(0.0f);
+    scene->schedule([panels, time](float dt) {
+        *time += dt;
+        for (size_t i = 0; i < panels.size(); ++i)
+        {
+            float phase = *time + i * 0.1f;
+            panels[i]->setContentSize(Size(120 + 60 * sinf(phase), 100 + 40 * cosf(phase)));
+        }
+    }, "panels");
+
+    return scene;
+}
+
+static Scene* createScale9SpritesScene()
+{
+    return createScale9Scene(ui::Scale9Sprite::RenderingType::SPRITES);
+}
+
+static Scene* createScale9MeshScene()
+{
+    return createScale9Scene(ui::Scale9Sprite::RenderingType::MESH);
+}
+
+// 20000 bullets of a batch node, moved, turned and wrapped around the screen every frame;
+// a part of them is outside of the screen
+static const int kBulletCount = 20000;
+
+struct Bullets
+{
+    std::vector<Vec2> positions;
+    std::vector<Vec2> velocities;
+    std::vector<float> rotations;
+
+    void update(float dt, const Size& size)
+    {
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            Vec2& position = positions[i];
+            position += velocities[i] * dt;
+            if (position.x < -100) position.x += size.width + 200;
+            if (position.x > size.width + 100) position.x -= size.width + 200;
+            if (position.y < -100) position.y += size.height + 200;
+            if (position.y > size.height + 100) position.y -= size.height + 200;
+            rotations[i] += 90 * dt;
+        }
+    }
+};
+
+static std::shared_ptr<Bullets> createBullets(const Size& size)
+{
+    auto bullets = std::make_shared<Bullets>();
+    for (int i = 0; i < kBulletCount; ++i)
+    {
+        bullets->positions.push_back(Vec2(CCRANDOM_0_1() * (size.width + 200) - 100, CCRANDOM_0_1() * (size.height + 200) - 100));
+        bullets->velocities.push_back(Vec2(CCRANDOM_MINUS1_1() * 100, CCRANDOM_MINUS1_1() * 100));
+        bullets->rotations.push_back(CCRANDOM_0_1() * 360);
+    }
+    return bullets;
+}
+
+static Rect getBulletFrame(int i)
+{
+    return Rect(85 * (i % 5), 121 * (i / 5 % 3), 85, 121);
+}
+
+static Scene* createBatchSpritesScene()
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+    auto batch = SpriteBatchNode::create("Images/grossini_dance_atlas.png", kBulletCount);
+    scene->addChild(batch);
+
+    auto bullets = createBullets(size);
+    std::vector<Sprite*> sprites;
+    for (int i = 0; i < kBulletCount; ++i)
+    {
+        auto sprite = Sprite::createWithTexture(batch->getTexture(), getBulletFrame(i));
+        sprite->setScale(0.25f);
+        batch->addChild(sprite);
+        sprites.push_back(sprite);
+    }
+
+    scene->schedule([bullets, sprites, size](float dt) {
+        bullets->update(dt, size);
+        for (size_t i = 0; i < sprites.size(); ++i)
+        {
+            sprites[i]->setPosition(bullets->positions[i]);
+            sprites[i]->setRotation(bullets->rotations[i]);
+        }
+    }, "bullets");
+
+    return scene;
+}
+
+// Dense sprites rotated, scaled, colored, some with a frame rotated in the texture, a quarter of them out of the screen.
+// More than one atlas holds their quads.
+static SpriteBatchNode* createDenseCheckBatch(const Size& size, bool parallel)
+{
+    auto batch = SpriteBatchNode::create("Images/grossini_dance_atlas.png");
+    batch->setDenseSpritesParallel(parallel);
+    for (int i = 0; i < 15; ++i)
+        batch->addDenseFrame(getBulletFrame(i));
+    batch->addDenseFrame(SpriteFrame::createWithTexture(batch->getTexture(), Rect(0, 0, 121, 85), true, Vec2(3, -2), Size(127, 89)));
+
+    for (int i = 0; i < 17000; ++i)
+    {
+        // far enough from the sides of the screen that the culling doesn't depend on rounding
+        Vec2 position(150 + CCRANDOM_0_1() * (size.width - 300), 150 + CCRANDOM_0_1() * (size.height - 300));
+        if (i % 4 == 0)
+            position.x = (i % 8 == 0) ? -1000 : size.width + 1000;
+        auto index = batch->addDenseSprite(i % 16, position);
+        batch->setDenseSpriteRotation(index, CCRANDOM_0_1() * 360);
+        batch->setDenseSpriteScale(index, 0.25f + CCRANDOM_0_1() * 0.75f, 0.25f + CCRANDOM_0_1() * 0.75f);
+        batch->setDenseSpriteColor(index, Color4B(std::rand() % 256, std::rand() % 256, std::rand() % 256, std::rand() % 256));
+    }
+    return batch;
+}
+
+static bool isSameQuad(const V3F_C4B_T2F_Quad& a, const V3F_C4B_T2F_Quad& b)
+{
+    const V3F_C4B_T2F* va = &a.tl;
+    const V3F_C4B_T2F* vb = &b.tl;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (va[i].vertices.distanceSquared(vb[i].vertices) > 0.01f * 0.01f
+            || va[i].colors != vb[i].colors
+            || fabsf(va[i].texCoords.u - vb[i].texCoords.u) > 1e-6f
+            || fabsf(va[i].texCoords.v - vb[i].texCoords.v) > 1e-6f)
+            return false;
+    }
+    return true;
+}
+
+// the quads drawn for the dense sprites are the ones of the Sprites createSpriteFromDenseSprite() gives, in batch space,
+// without the Sprites out of the screen
+static void checkDenseQuads(SpriteBatchNode* batch, const char* name)
+{
+    auto director = Director::getInstance();
+    Rect visibleRect(director->getVisibleOrigin(), director->getVisibleSize());
+
+    if (batch->getDenseTextureAtlasCount() != 2)
+    {
+        fprintf(stderr, "headless-benchmark: %s dense sprites use %d atlases instead of 2\n", name, (int)batch->getDenseTextureAtlasCount());
+        abort();
+    }
+
+    ssize_t atlas = 0;
+    ssize_t quad = 0;
+    for (ssize_t i = 0; i < batch->getDenseSpriteCount(); ++i)
+    {
+        auto sprite = batch->createSpriteFromDenseSprite(i);
+        const Mat4& transform = sprite->getNodeToParentTransform();
+        V3F_C4B_T2F_Quad expected = sprite->getQuad();
+        Vec3* corners[4] = { &expected.bl.vertices, &expected.br.vertices, &expected.tl.vertices, &expected.tr.vertices };
+        Rect bounds;
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            transform.transformPoint(corners[corner]);
+            Rect point(corners[corner]->x, corners[corner]->y, 0, 0);
+            bounds = corner ? bounds.unionWithRect(point) : point;
+        }
+        if (!bounds.intersectsRect(visibleRect))
+            continue;
+
+        while (atlas < batch->getDenseTextureAtlasCount() && quad == batch->getDenseTextureAtlas(atlas)->getTotalQuads())
+        {
+            ++atlas;
+            quad = 0;
+        }
+        if (atlas == batch->getDenseTextureAtlasCount() || !isSameQuad(expected, batch->getDenseTextureAtlas(atlas)->getQuads()[quad++]))
+        {
+            fprintf(stderr, "headless-benchmark: %s dense sprite %d differs from its Sprite\n", name, (int)i);
+            abort();
+        }
+    }
+
+    for (; atlas < batch->getDenseTextureAtlasCount(); ++atlas, quad = 0)
+    {
+        if (quad != batch->getDenseTextureAtlas(atlas)->getTotalQuads())
+        {
+            fprintf(stderr, "headless-benchmark: %s dense sprites have more quads than visible Sprites\n", name);
+            abort();
+        }
+    }
+}
+
+static Scene* createBatchDenseScene()
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+    auto batch = SpriteBatchNode::create("Images/grossini_dance_atlas.png");
+    scene->addChild(batch);
+
+    for (int i = 0; i < 15; ++i)
+        batch->addDenseFrame(getBulletFrame(i));
+
+    auto bullets = createBullets(size);
+    for (int i = 0; i < kBulletCount; ++i)
+    {
+        auto index = batch->addDenseSprite(i % 15, bullets->positions[i]);
+        batch->setDenseSpriteScale(index, 0.25f, 0.25f);
+    }
+
+    scene->schedule([bullets, batch, size](float dt) {
+        bullets->update(dt, size);
+        std::copy(bullets->positions.begin(), bullets->positions.end(), batch->getDenseSpritePositions());
+        for (size_t i = 0; i < bullets->rotations.size(); ++i)
+            batch->setDenseSpriteRotation(i, bullets->rotations[i]);
+    }, "bullets");
+
+    // the quads of the check batches are compared once they are drawn, then the batches are removed
+    auto parallelCheck = createDenseCheckBatch(size, true);
+    auto serialCheck = createDenseCheckBatch(size, false);
+    scene->addChild(parallelCheck);
+    scene->addChild(serialCheck);
+    auto frame = std::make_shared<unsigned int>(0);
+    scene->schedule([scene, parallelCheck, serialCheck, frame](float dt) {
+        if (++(*frame) < 2)
+            return;
+        checkDenseQuads(parallelCheck, "parallel");
+        checkDenseQuads(serialCheck, "serial");
+        parallelCheck->removeFromParent();
+        serialCheck->removeFromParent();
+        scene->unschedule("dense-check");
+    }, "dense-check");
+
+    return scene;
+}
+
+// 200 sprites drawn into a 1280x720 render texture every frame, saved as a PNG every 4 frames;
+// synchronously the read back, the flip and the encoding run on the main thread
+static Scene* createCaptureScene(bool async)
+{
+    std::srand(kRandomSeed);
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+    auto renderTexture = RenderTexture::create(1280, 720, Texture2D::PixelFormat::RGBA8888);
+    renderTexture->setPosition(Vec2(size.width / 2, size.height / 2));
+    renderTexture->setAutoDraw(true);
+    renderTexture->setClearFlags(GL_COLOR_BUFFER_BIT);
+    renderTexture->setClearColor(Color4F::BLACK);
+    scene->addChild(renderTexture);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini.png");
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * 1280, CCRANDOM_0_1() * 720));
+        sprite->runAction(RepeatForever::create(RotateBy::create(2.0f, 360.0f)));
+        renderTexture->addChild(sprite);
+    }
+
+    auto frame = std::make_shared<unsigned int>(0);
+    scene->schedule([renderTexture, frame, async](float dt) {
+        if (++(*frame) % 4 != 0)
+            return;
+        if (async)
+            renderTexture->saveToFileAsync("benchmark-capture.png", Image::Format::PNG);
+        else
+            renderTexture->saveToFile("benchmark-capture.png", Image::Format::PNG);
+    }, "capture");
+
+    return scene;
+}
+
+static Scene* createCaptureSyncScene()
+{
+    return createCaptureScene(false);
+}
+
+static Scene* createCaptureAsyncScene()
+{
+    return createCaptureScene(true);
+}
+
+#if BENCHMARK_WITH_EXTENSIONS
+// 8 PU systems of the cpp-tests, up to about 15000 particles once they are all emitting
+static void setPUDepthSort(Node* node)
+{
+    auto system = dynamic_cast<PUParticleSystem3D*>(node);
+    if (system)
+    {
+        auto quadRender = dynamic_cast<PUParticle3DQuadRender*>(system->getRender());
+        if (quadRender)
+            quadRender->setDepthSort(true);
+    }
+    // the techniques are child systems
+    for (auto child : node->getChildren())
+        setPUDepthSort(child);
+}
+
+static Scene* createPUParticlesScene(bool depthSort)
+{
+    std::srand(kRandomSeed);
+
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->addSearchPath("Particle3D/materials");
+    fileUtils->addSearchPath("Particle3D/scripts");
+    fileUtils->addSearchPath("Sprite3DTest");
+
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+
+    // blackHole has 2750 particles, canOfWorms emits emitters, lineStreak expires every particle each second
+    const char* effects[] = { "blackHole.pu", "canOfWorms.pu", "blackHole.pu", "lineStreak.pu",
+                              "blackHole.pu", "canOfWorms.pu", "blackHole.pu", "lineStreak.pu" };
+    for (int i = 0; i < 8; ++i)
+    {
+        auto system = PUParticleSystem3D::create(effects[i], "pu_mediapack_01.material");
+        system->setPosition3D(Vec3((i % 4 + 0.5f) * size.width / 4, (i / 4 + 0.5f) * size.height / 2, 0.0f));
+        system->setScale(10.0f);
+        if (depthSort)
+            setPUDepthSort(system);
+        system->startParticleSystem();
+        scene->addChild(system);
+    }
+    return scene;
+}
+
+static Scene* createPUParticlesUnsortedScene()
+{
+    return createPUParticlesScene(false);
+}
+
+static Scene* createPUParticlesSortedScene()
+{
+    return createPUParticlesScene(true);
+}
+#endif
+
+const std::vector<BenchmarkScene>& getBenchmarkScenes()
+{
+    static const std::vector<BenchmarkScene> scenes = {
+        { "sprites", "2000 animated sprites, two interleaved textures", createSpritesScene },
+        { "labels", "200 TTF labels with a new string every frame", createLabelsScene },
+        { "particles", "10 quad particle systems", createParticlesScene },
+        { "programstate", "10000 GLProgramState applies over 100 states of one program", createProgramStatesScene },
+        { "programstate-same", "10000 applies of the same GLProgramState, whose uniforms stay in the program", createProgramStateSameScene },
+        { "scale9-sprites", "400 Scale9Sprites resized every frame, 9 sliced sprites each (4000 nodes)", createScale9SpritesScene },
+        { "scale9-mesh", "scale9-sprites with a single mesh per panel (400 nodes)", createScale9MeshScene },
+        { "batch-sprites", "20000 moving Sprites of a SpriteBatchNode", createBatchSpritesScene },
+        { "batch-dense", "batch-sprites as dense sprites of the batch node", createBatchDenseScene },
+        { "capture", "1280x720 render texture saved as PNG every 4 frames", createCaptureSyncScene },
+        { "capture-async", "capture with the pixels read back through pixel buffer objects and encoded on a worker thread", createCaptureAsyncScene },
+#if BENCHMARK_WITH_EXTENSIONS
+        { "pu-particles", "8 PU particle systems, up to 15000 particles", createPUParticlesUnsortedScene },
+        { "pu-particles-sorted", "pu-particles with the billboards sorted back to front", createPUParticlesSortedScene },
+#endif
+    };
+    return scenes;
+}
@@ -0,0 +1,21 @@
+#ifndef __BENCHMARK_SCENES_H__
+#define __BENCHMARK_SCENES_H__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cocos2d.h"
+
+/** A fixed scene driven by the benchmark runner. */
+struct BenchmarkScene
+{
+    std::string name;
+    std::string description;
+    std::function<cocos2d::Scene*()> create;
+};
+
+/** All the scenes known to the runner, in the order they run by default. */
+const std::vector<BenchmarkScene>& getBenchmarkScenes();
+
+#endif // __BENCHMARK_SCENES_H__
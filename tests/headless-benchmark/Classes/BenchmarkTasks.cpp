@@ -0,0 +1,1973 @@
+#include "BenchmarkTasks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "cocos2d.h"
+#include "network/CCDownloader.h"
+#include "network/HttpClient.h"
+#include "network/WebSocket.h"
+#include "libwebsockets.h"
+#include "base/atitc.h"
+#include "base/etc1.h"
+#include "base/pvr.h"
+#include "base/s3tc.h"
+#include "navmesh/CCNavMesh.h"
+#include "physics3d/CCPhysics3D.h"
+#include "xxhash.h"
+#include <zlib.h>
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+#include "audio/linux/AudioPcmCache.h"
+#include "audio/linux/NullAudioSink.h"
+#endif
+#if BENCHMARK_WITH_EXTENSIONS
+#include "Particle3D/PU/CCPUParticleSystem3D.h"
+#include "Particle3D/PU/CCPUScriptCompiler.h"
+#endif
+#if BENCHMARK_WITH_COCOSTUDIO
+#include "cocostudio/CCArmatureDataManager.h"
+#include "cocostudio/CCDataReaderHelper.h"
+#endif
+
+USING_NS_CC;
+
+// sprite sheets of the cpp-tests resources, their textures are next to them
+static const char* const kSpriteSheets[] = {
+    "animations/grossini.plist",
+    "animations/grossini_blue.plist",
+    "animations/grossini_gray.plist",
+    "animations/grossini_family.plist",
+    "animations/grossini-aliases.plist",
+    "animations/ghosts.plist",
+    "animations/crystals.plist",
+    "animations/tcc_issue_1.plist",
+    "animations/tcc_issue_2.plist",
+    "zwoptex/grossini.plist",
+    "zwoptex/grossini-generic.plist",
+    "Images/blocks9ss.plist",
+    "Images/ui.plist",
+    "Images/bugs/circle.plist",
+};
+
+struct SpriteSheet
+{
+    std::string plist;
+    std::string index;
+    std::string texture;
+    std::vector<std::string> frames;
+};
+
+static std::string replaceExtension(const std::string& filename, const std::string& extension)
+{
+    return filename.substr(0, filename.find_last_of(".")).append(extension);
+}
+
+// converts the sheets to indexes in the writable path, and loads the textures so that only the sheets are timed
+static const std::vector<SpriteSheet>& prepareSpriteSheets()
+{
+    static std::vector<SpriteSheet> sheets;
+    if (!sheets.empty())
+        return sheets;
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string directory = fileUtils->getWritablePath() + "benchmark-sprite-frames/";
+    fileUtils->createDirectory(directory);
+
+    for (auto plist : kSpriteSheets)
+    {
+        SpriteSheet sheet;
+        sheet.plist = plist;
+        sheet.texture = replaceExtension(plist, ".png");
+
+        std::string name = plist;
+        std::replace(name.begin(), name.end(), '/', '_');
+        sheet.index = directory + replaceExtension(name, SpriteFrameIndex::FILE_EXTENSION);
+
+        if (!SpriteFrameIndex::convertPlist(sheet.plist, sheet.index))
+        {
+            CCLOG("headless-benchmark: can't convert %s", plist);
+            continue;
+        }
+        Director::getInstance()->getTextureCache()->addImage(sheet.texture);
+
+        auto index = SpriteFrameIndex::createWithFile(sheet.index);
+        for (int i = 0; index && i < index->getFrameCount(); ++i)
+            sheet.frames.push_back(index->getFrameName(i));
+        sheets.push_back(sheet);
+    }
+    return sheets;
+}
+
+static void addSpriteSheets(bool indexes)
+{
+    auto cache = SpriteFrameCache::getInstance();
+    for (const auto& sheet : prepareSpriteSheets())
+        cache->addSpriteFramesWithFile(indexes ? sheet.index : sheet.plist, sheet.texture);
+}
+
+static void getSpriteFrames()
+{
+    // every frame of every sheet, as a scene using all of them would
+    auto cache = SpriteFrameCache::getInstance();
+    for (const auto& sheet : prepareSpriteSheets())
+    {
+        for (const auto& name : sheet.frames)
+            cache->getSpriteFrameByName(name);
+    }
+}
+
+static void removeSpriteFrames()
+{
+    SpriteFrameCache::getInstance()->removeSpriteFrames();
+}
+
+// 20 images of the cpp-tests resources, each traced with 10 epsilons, for 200 polygon sprites
+static const char* const kPolygonImages[] = {
+    "Images/grossini.png",
+    "Images/grossinis_sister1.png",
+    "Images/grossinis_sister2.png",
+    "Images/grossini_dance_01.png",
+    "Images/grossini_dance_02.png",
+    "Images/grossini_dance_03.png",
+    "Images/grossini_dance_04.png",
+    "Images/grossini_dance_05.png",
+    "Images/grossini_dance_06.png",
+    "Images/grossini_dance_07.png",
+    "Images/grossini_dance_08.png",
+    "Images/grossini_dance_09.png",
+    "Images/grossini_dance_10.png",
+    "Images/grossini_dance_11.png",
+    "Images/grossini_dance_12.png",
+    "Images/grossini_dance_13.png",
+    "Images/grossini_dance_14.png",
+    "Images/SpookyPeas.png",
+    "Images/CyanTriangle.png",
+    "Images/YellowTriangle.png",
+};
+static const int kPolygonEpsilons = 10;
+
+static float polygonEpsilon(int i)
+{
+    return 1.0f + 0.25f * i;
+}
+
+static void generatePolygons()
+{
+    for (auto image : kPolygonImages)
+    {
+        for (int i = 0; i < kPolygonEpsilons; ++i)
+            AutoPolygon::generatePolygon(image, Rect::ZERO, polygonEpsilon(i));
+    }
+}
+
+static void generatePolygonsAsync()
+{
+    int pending = 0;
+    for (auto image : kPolygonImages)
+    {
+        for (int i = 0; i < kPolygonEpsilons; ++i)
+        {
+            ++pending;
+            AutoPolygon::generatePolygonAsync(image, [&pending](const PolygonInfo&) { --pending; }, Rect::ZERO, polygonEpsilon(i));
+        }
+    }
+
+    // the results are delivered by the scheduler
+    auto scheduler = Director::getInstance()->getScheduler();
+    while (pending > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        scheduler->update(0);
+    }
+}
+
+static std::string polygonCacheDirectory()
+{
+    return FileUtils::getInstance()->getWritablePath() + "benchmark-polygons/";
+}
+
+static void generateCachedPolygons(bool async)
+{
+    AutoPolygon::setCacheDirectory(polygonCacheDirectory());
+    if (async)
+        generatePolygonsAsync();
+    else
+        generatePolygons();
+    AutoPolygon::setCacheDirectory("");
+}
+
+#if CC_USE_NAVMESH
+// the nav mesh of the cpp-tests, created once and kept for all the navmesh tasks
+static NavMesh* getBenchmarkNavMesh()
+{
+    static NavMesh* navMesh = nullptr;
+    if (!navMesh)
+    {
+        navMesh = NavMesh::create("NavMesh/all_tiles_tilecache.bin", "NavMesh/geomset.txt");
+        CC_SAFE_RETAIN(navMesh);
+    }
+    return navMesh;
+}
+
+// an RTS wave: the agents leave 10 spawn points, around which they are scattered, for 4 targets
+static std::vector<std::pair<Vec3, Vec3>> makePathEndpoints(int agents)
+{
+    std::mt19937 random(agents);
+    std::uniform_real_distribution<float> map(-45.0f, 45.0f);
+    std::uniform_real_distribution<float> scatter(-3.0f, 3.0f);
+
+    Vec3 spawns[10], targets[4];
+    for (auto& spawn : spawns)
+        spawn.set(map(random), 0.0f, map(random));
+    for (auto& target : targets)
+        target.set(map(random), 0.0f, map(random));
+
+    std::vector<std::pair<Vec3, Vec3>> endpoints;
+    for (int i = 0; i < agents; ++i)
+    {
+        Vec3 start = spawns[i % 10] + Vec3(scatter(random), 0.0f, scatter(random));
+        Vec3 end = targets[i % 4] + Vec3(scatter(random), 0.0f, scatter(random));
+        endpoints.push_back(std::make_pair(start, end));
+    }
+    return endpoints;
+}
+
+static void findPaths(const std::vector<std::pair<Vec3, Vec3>>& endpoints)
+{
+    auto navMesh = getBenchmarkNavMesh();
+    std::vector<Vec3> pathPoints;
+    for (const auto& endpoint : endpoints)
+    {
+        pathPoints.clear();
+        navMesh->findPath(endpoint.first, endpoint.second, pathPoints);
+    }
+}
+
+static void findPathsAsync(const std::vector<std::pair<Vec3, Vec3>>& endpoints)
+{
+    auto navMesh = getBenchmarkNavMesh();
+    int pending = (int)endpoints.size();
+    for (const auto& endpoint : endpoints)
+        navMesh->findPathAsync(endpoint.first, endpoint.second, [&pending](const std::vector<Vec3>&) { --pending; });
+
+    // the paths are delivered by the updates of the nav mesh
+    while (pending > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        navMesh->update(0);
+    }
+}
+
+static BenchmarkTask makeNavMeshPathTask(int agents, bool async)
+{
+    auto endpoints = std::make_shared<std::vector<std::pair<Vec3, Vec3>>>();
+    auto name = StringUtils::format("navmesh-paths-%s-%d", async ? "async" : "sync", agents);
+    auto description = StringUtils::format("find the paths of %d agents%s, paths/s is %d / duration",
+        agents, async ? " on the path workers" : "", agents);
+
+    return { name, description,
+        [=] { getBenchmarkNavMesh(); *endpoints = makePathEndpoints(agents); },
+        [=] { if (async) findPathsAsync(*endpoints); else findPaths(*endpoints); },
+        [] { getBenchmarkNavMesh()->clearPathCache(); } };
+}
+#endif
+
+// the content of /asset/<id>/<size>, different for every id
+static std::string makeAssetContent(int id, size_t size)
+{
+    std::string content(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+        content[i] = (char)((i * 31 + id) & 0xff);
+    return content;
+}
+
+// answers a GET of /asset/<id>/<size> with its content, from the offset of a "Range: bytes=<offset>-" header,
+// and any other request with 1KB
+static std::string makeHttpResponse(const std::string& request)
+{
+    static const std::string defaultResponse = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 1024\r\n\r\n"
+        + std::string(1024, 'x');
+
+    int id = 0;
+    long size = 0;
+    if (sscanf(request.c_str(), "GET /asset/%d/%ld", &id, &size) != 2 || size <= 0)
+        return defaultResponse;
+
+    long offset = 0;
+    size_t range = request.find("Range: bytes=");
+    if (range != std::string::npos)
+        offset = std::min(atol(request.c_str() + range + 13), size);
+
+    std::string content = makeAssetContent(id, size);
+    if (offset > 0)
+    {
+        return StringUtils::format("HTTP/1.1 206 Partial Content\r\nContent-Length: %ld\r\nContent-Range: bytes %ld-%ld/%ld\r\n\r\n",
+            size - offset, offset, size - 1, size) + content.substr(offset);
+    }
+    return StringUtils::format("HTTP/1.1 200 OK\r\nContent-Length: %ld\r\n\r\n", size) + content;
+}
+
+// a keep-alive HTTP/1.1 server on the loopback, answering every request after 2ms, a thread per connection
+static void serveHttpConnection(int fd)
+{
+    std::string received;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    {
+        received.append(buffer, size);
+        size_t end;
+        while ((end = received.find("\r\n\r\n")) != std::string::npos)
+        {
+            std::string response = makeHttpResponse(received.substr(0, end));
+            received.erase(0, end + 4);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+    }
+    close(fd);
+}
+
+static int getHttpServerPort()
+{
+    static int port = 0;
+    if (port == 0)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (bind(fd, (sockaddr*)&address, length) != 0 || listen(fd, 64) != 0
+            || getsockname(fd, (sockaddr*)&address, &length) != 0)
+        {
+            CCLOG("benchmark: cannot start the loopback HTTP server");
+            close(fd);
+            return 0;
+        }
+        port = ntohs(address.sin_port);
+
+        std::thread([fd] {
+            int connection;
+            while ((connection = accept(fd, nullptr, nullptr)) >= 0)
+                std::thread(serveHttpConnection, connection).detach();
+        }).detach();
+    }
+    return port;
+}
+
+static void waitHttpResponses(const int& pending)
+{
+    // the callbacks are called by the scheduler of the cocos thread
+    while (pending > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        Director::getInstance()->getScheduler()->update(0);
+    }
+}
+
+static void sendHttpRequests(int count, int maxConcurrentRequests, bool sequential)
+{
+    auto client = network::HttpClient::getInstance();
+    client->setMaxConcurrentRequests(maxConcurrentRequests);
+    auto url = StringUtils::format("http://127.0.0.1:%d/", getHttpServerPort());
+
+    int pending = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        auto request = new (std::nothrow) network::HttpRequest();
+        request->setUrl(url.c_str());
+        request->setRequestType(network::HttpRequest::Type::GET);
+        request->setResponseCallback([&pending](network::HttpClient*, network::HttpResponse* response) {
+            if (!response->isSucceed())
+                CCLOG("benchmark: HTTP request failed: %s", response->getErrorBuffer());
+            --pending;
+        });
+        ++pending;
+        client->send(request);
+        request->release();
+
+        if (sequential)
+            waitHttpResponses(pending);
+    }
+    waitHttpResponses(pending);
+    client->setMaxConcurrentRequests(6);
+}
+
+// 64 assets of 256KB, downloaded and checked against their hash by the Downloader
+static const int kDownloadAssets = 64;
+static const size_t kDownloadAssetSize = 256 * 1024;
+
+static std::string downloadDirectory()
+{
+    return FileUtils::getInstance()->getWritablePath() + "benchmark-downloads/";
+}
+
+static network::DownloadUnits makeDownloadUnits(bool resume)
+{
+    auto url = StringUtils::format("http://127.0.0.1:%d/asset/", getHttpServerPort());
+    network::DownloadUnits units;
+    for (int i = 0; i < kDownloadAssets; ++i)
+    {
+        std::string content = makeAssetContent(i, kDownloadAssetSize);
+        network::DownloadUnit unit;
+        unit.customId = StringUtils::format("asset%d", i);
+        unit.srcUrl = url + StringUtils::format("%d/%d", i, (int)kDownloadAssetSize);
+        unit.storagePath = downloadDirectory() + unit.customId;
+        unit.hash = StringUtils::format("%08x", XXH32(content.data(), (int)content.size(), 0));
+        unit.resumeDownload = resume;
+        units.emplace(unit.customId, unit);
+    }
+    return units;
+}
+
+// leaves the first half of every asset, as an interrupted download would
+static void prepareDownloadDirectory(bool halfDownloaded)
+{
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->removeDirectory(downloadDirectory());
+    fileUtils->createDirectory(downloadDirectory());
+    if (!halfDownloaded)
+        return;
+
+    for (int i = 0; i < kDownloadAssets; ++i)
+    {
+        std::string content = makeAssetContent(i, kDownloadAssetSize);
+        Data data;
+        data.copy((const unsigned char*)content.data(), kDownloadAssetSize / 2);
+        fileUtils->writeDataToFile(data, downloadDirectory() + StringUtils::format("asset%d.temp", i));
+    }
+}
+
+static void downloadAssets(int maxParallelDownloads, bool resume)
+{
+    auto downloader = std::make_shared<network::Downloader>();
+    downloader->setMaxParallelDownloads(maxParallelDownloads);
+
+    int downloaded = 0;
+    bool finished = false;
+    downloader->setSuccessCallback([&](const std::string&, const std::string&, const std::string& customId) {
+        if (customId == "batch")
+            finished = true;
+        else
+            ++downloaded;
+    });
+    downloader->setErrorCallback([](const network::Downloader::Error& error) {
+        CCLOG("benchmark: download of %s failed: %s", error.customId.c_str(), error.message.c_str());
+    });
+
+    downloader->batchDownloadAsync(makeDownloadUnits(resume), "batch");
+    while (!finished)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        Director::getInstance()->getScheduler()->update(0);
+    }
+    if (downloaded != kDownloadAssets)
+        CCLOG("benchmark: %d assets downloaded out of %d", downloaded, kDownloadAssets);
+}
+
+// a websocket server on the loopback echoing every message, serviced by its own thread
+static const int kWebSocketServerPort = 18964;
+
+static int echoWebSocketMessage(libwebsocket_context* ctx, libwebsocket* wsi, libwebsocket_callback_reasons reason,
+    void* user, void* in, size_t len)
+{
+    if (reason == LWS_CALLBACK_RECEIVE)
+    {
+        // the messages of the benchmark are small enough to come in one piece
+        std::vector<unsigned char> buffer(LWS_SEND_BUFFER_PRE_PADDING + len + LWS_SEND_BUFFER_POST_PADDING);
+        memcpy(&buffer[LWS_SEND_BUFFER_PRE_PADDING], in, len);
+        libwebsocket_write(wsi, &buffer[LWS_SEND_BUFFER_PRE_PADDING], len,
+            lws_frame_is_binary(wsi) ? LWS_WRITE_BINARY : LWS_WRITE_TEXT);
+    }
+    return 0;
+}
+
+static void startWebSocketServer()
+{
+    static bool started = false;
+    if (started)
+        return;
+    started = true;
+
+    static libwebsocket_protocols protocols[] = {
+        { "default-protocol", echoWebSocketMessage, 0, 4096 },
+        { nullptr, nullptr, 0, 0 }
+    };
+    lws_context_creation_info info;
+    memset(&info, 0, sizeof(info));
+    info.port = kWebSocketServerPort;
+    info.iface = "127.0.0.1";
+    info.protocols = protocols;
+    info.gid = -1;
+    info.uid = -1;
+    auto context = libwebsocket_create_context(&info);
+    if (!context)
+    {
+        CCLOG("benchmark: cannot start the loopback websocket server");
+        return;
+    }
+
+    std::thread([context] {
+        while (true)
+            libwebsocket_service(context, 10);
+    }).detach();
+}
+
+class EchoClient : public network::WebSocket::Delegate
+{
+public:
+    EchoClient() : opened(false), failed(false), received(0) {}
+    virtual void onOpen(network::WebSocket* ws) override { opened = true; }
+    virtual void onMessage(network::WebSocket* ws, const network::WebSocket::Data& data) override { ++received; }
+    virtual void onClose(network::WebSocket* ws) override {}
+    virtual void onError(network::WebSocket* ws, const network::WebSocket::ErrorCode& error) override { failed = true; }
+
+    bool opened;
+    bool failed;
+    int received;
+};
+
+struct EchoConnection
+{
+    EchoClient client;
+    network::WebSocket socket;
+};
+
+static std::vector<std::unique_ptr<EchoConnection>> s_echoConnections;
+
+static void pumpWebSocketMessages(const std::function<bool()>& done)
+{
+    // the messages are delivered by the scheduler of the cocos thread
+    while (!done())
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        Director::getInstance()->getScheduler()->update(0);
+    }
+}
+
+static void openEchoConnections(int count)
+{
+    startWebSocketServer();
+    s_echoConnections.clear();
+    auto url = StringUtils::format("ws://127.0.0.1:%d/", kWebSocketServerPort);
+    for (int i = 0; i < count; ++i)
+    {
+        s_echoConnections.emplace_back(new EchoConnection());
+        s_echoConnections.back()->socket.init(s_echoConnections.back()->client, url);
+    }
+
+    pumpWebSocketMessages([] {
+        for (const auto& connection : s_echoConnections)
+        {
+            if (!connection->client.opened && !connection->client.failed)
+                return false;
+        }
+        return true;
+    });
+}
+
+static void echoWebSocketMessages(int messages, int size)
+{
+    std::vector<unsigned char> message(size, 'x');
+    for (auto& connection : s_echoConnections)
+    {
+        connection->client.received = 0;
+        for (int i = 0; i < messages; ++i)
+        {
+            if (connection->client.opened)
+                connection->socket.send(message.data(), size);
+        }
+    }
+
+    pumpWebSocketMessages([messages] {
+        for (const auto& connection : s_echoConnections)
+        {
+            if (connection->client.opened && connection->client.received < messages)
+                return false;
+        }
+        return true;
+    });
+}
+
+static BenchmarkTask makeWebSocketEchoTask(int sockets, int messages, int size)
+{
+    auto name = StringUtils::format("websocket-echo-%dx%d-%db", sockets, messages, size);
+    auto description = StringUtils::format("%d websockets sending %d binary messages of %d bytes each to a loopback echo server",
+        sockets, messages, size);
+    return { name, description,
+        [=] { openEchoConnections(sockets); }, [=] { echoWebSocketMessages(messages, size); }, nullptr };
+}
+
+// a package of 400 assets of 16KB, one in two stored and the others deflated, mounted at the resource root
+static const int kPackageAssets = 400;
+static const size_t kPackageAssetSize = 16 * 1024;
+
+static std::string packagePath()
+{
+    return FileUtils::getInstance()->getWritablePath() + "benchmark-package.zip";
+}
+
+static std::string packageAssetName(int i)
+{
+    return StringUtils::format("benchmark-package/asset%d.bin", i);
+}
+
+static void appendUInt16(std::string& out, uint16_t value)
+{
+    out.append((const char*)&value, sizeof(value));
+}
+
+static void appendUInt32(std::string& out, uint32_t value)
+{
+    out.append((const char*)&value, sizeof(value));
+}
+
+static std::string deflateRaw(const std::string& content)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&stream, (uLong)content.size()), '\0');
+    stream.next_in = (Bytef*)content.data();
+    stream.avail_in = (uInt)content.size();
+    stream.next_out = (Bytef*)&out[0];
+    stream.avail_out = (uInt)out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+struct PackageEntry
+{
+    std::string name;
+    std::string content;
+    bool deflated;
+};
+
+static void writePackage(const std::string& path, const std::vector<PackageEntry>& entries)
+{
+    std::string archive;
+    std::string directory;
+    for (const auto& entry : entries)
+    {
+        uint16_t method = entry.deflated ? 8 : 0;
+        std::string compressed = entry.deflated ? deflateRaw(entry.content) : entry.content;
+        uint32_t crc = (uint32_t)crc32(0, (const Bytef*)entry.content.data(), (uInt)entry.content.size());
+        uint32_t offset = (uint32_t)archive.size();
+
+        appendUInt32(archive, 0x04034b50);
+        appendUInt16(archive, 20);
+        appendUInt16(archive, 0);
+        appendUInt16(archive, method);
+        appendUInt32(archive, 0);
+        appendUInt32(archive, crc);
+        appendUInt32(archive, (uint32_t)compressed.size());
+        appendUInt32(archive, (uint32_t)entry.content.size());
+        appendUInt16(archive, (uint16_t)entry.name.size());
+        appendUInt16(archive, 0);
+        archive += entry.name + compressed;
+
+        appendUInt32(directory, 0x02014b50);
+        appendUInt16(directory, 20);
+        appendUInt16(directory, 20);
+        appendUInt16(directory, 0);
+        appendUInt16(directory, method);
+        appendUInt32(directory, 0);
+        appendUInt32(directory, crc);
+        appendUInt32(directory, (uint32_t)compressed.size());
+        appendUInt32(directory, (uint32_t)entry.content.size());
+        appendUInt16(directory, (uint16_t)entry.name.size());
+        appendUInt32(directory, 0);
+        appendUInt32(directory, 0);
+        appendUInt32(directory, 0);
+        appendUInt32(directory, offset);
+        directory += entry.name;
+    }
+
+    uint32_t directoryOffset = (uint32_t)archive.size();
+    archive += directory;
+    appendUInt32(archive, 0x06054b50);
+    appendUInt32(archive, 0);
+    appendUInt16(archive, (uint16_t)entries.size());
+    appendUInt16(archive, (uint16_t)entries.size());
+    appendUInt32(archive, (uint32_t)directory.size());
+    appendUInt32(archive, directoryOffset);
+    appendUInt16(archive, 0);
+
+    Data data;
+    data.copy((const unsigned char*)archive.data(), archive.size());
+    FileUtils::getInstance()->writeDataToFile(data, path);
+}
+
+static void preparePackage()
+{
+    if (FileUtils::getInstance()->isFileExist(packagePath()))
+        return;
+
+    std::vector<PackageEntry> entries;
+    for (int i = 0; i < kPackageAssets; ++i)
+        entries.push_back({ packageAssetName(i), makeAssetContent(i, kPackageAssetSize), i % 2 != 0 });
+    writePackage(packagePath(), entries);
+}
+
+// every asset is looked up and read again from the archive by minizip
+static void readZipAssets()
+{
+    auto fileUtils = FileUtils::getInstance();
+    for (int i = 0; i < kPackageAssets; ++i)
+    {
+        ssize_t size = 0;
+        unsigned char* bytes = fileUtils->getFileDataFromZip(packagePath(), packageAssetName(i), &size);
+        CCASSERT(size == (ssize_t)kPackageAssetSize, "the asset size is wrong");
+        free(bytes);
+    }
+}
+
+static void mountPackage()
+{
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->unmountPackage(packagePath());
+    fileUtils->mountPackage(packagePath());
+}
+
+static void unmountPackage()
+{
+    FileUtils::getInstance()->unmountPackage(packagePath());
+}
+
+// the assets are found through the search paths and read from the mounted package, on one thread or all of them
+static void readPackageAssets(bool parallel)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::vector<std::string> fullPaths;
+    for (int i = 0; i < kPackageAssets; ++i)
+        fullPaths.push_back(fileUtils->fullPathForFilename(packageAssetName(i)));
+
+    utils::parallelFor(fullPaths.size(), parallel ? 8 : fullPaths.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Data data = fileUtils->getDataFromFile(fullPaths[i]);
+            CCASSERT(data.getSize() == (ssize_t)kPackageAssetSize, "the asset size is wrong");
+        }
+    });
+}
+
+// the encrypted atlas of cpp-tests, stored in a package mounted under its own directory
+static const char* kEncryptedAtlas = "Images/encryptedAtlas.pvr.ccz";
+
+static std::string encryptedPackagePath()
+{
+    return FileUtils::getInstance()->getWritablePath() + "benchmark-encrypted.zip";
+}
+
+static std::string encryptedPackageAtlas()
+{
+    return FileUtils::getInstance()->getWritablePath() + "benchmark-encrypted/encryptedAtlas.pvr.ccz";
+}
+
+static void setAtlasEncryptionKey()
+{
+    ZipUtils::setPvrEncryptionKeyPart(0, 0xaaaaaaaa);
+    ZipUtils::setPvrEncryptionKeyPart(1, 0xbbbbbbbb);
+    ZipUtils::setPvrEncryptionKeyPart(2, 0xcccccccc);
+    ZipUtils::setPvrEncryptionKeyPart(3, 0xdddddddd);
+}
+
+static std::vector<unsigned char> decodeImage(const Data& data)
+{
+    Image image;
+    if (data.isNull() || !image.initWithImageData(data.getBytes(), data.getSize()))
+        return std::vector<unsigned char>();
+    return std::vector<unsigned char>(image.getData(), image.getData() + image.getDataLen());
+}
+
+// the stored atlas is a read only slice of the package: every load must decrypt the original bytes again
+static void prepareEncryptedPackage()
+{
+    setAtlasEncryptionKey();
+    auto fileUtils = FileUtils::getInstance();
+    Data atlas = fileUtils->getDataFromFile(kEncryptedAtlas);
+    fileUtils->unmountPackage(encryptedPackagePath());
+    writePackage(encryptedPackagePath(), { { "encryptedAtlas.pvr.ccz",
+        std::string((const char*)atlas.getBytes(), atlas.getSize()), false } });
+    fileUtils->mountPackage(encryptedPackagePath(), fileUtils->getWritablePath() + "benchmark-encrypted");
+
+    auto expected = decodeImage(atlas);
+    auto first = decodeImage(fileUtils->getDataFromFile(encryptedPackageAtlas()));
+    auto second = decodeImage(fileUtils->getDataFromFile(encryptedPackageAtlas()));
+    if (expected.empty() || first != expected || second != expected)
+    {
+        fprintf(stderr, "headless-benchmark: the encrypted atlas read twice from a package differs from the file\n");
+        abort();
+    }
+}
+
+static void loadEncryptedPackageAtlas()
+{
+    auto fileUtils = FileUtils::getInstance();
+    auto fullPath = encryptedPackageAtlas();
+    utils::parallelFor(16, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Image image;
+            Data data = fileUtils->getDataFromFile(fullPath);
+            if (!image.initWithImageData(data.getBytes(), data.getSize()))
+            {
+                fprintf(stderr, "headless-benchmark: the encrypted atlas can't be loaded from the package\n");
+                abort();
+            }
+        }
+    });
+}
+
+// a 4096x4096 RGBA8888 atlas premultiplied and converted to RGBA4444, and a 1024x1024 image converted to every format
+static const int kAtlasSize = 4096;
+static const int kConvertedSize = 1024;
+
+class BenchmarkImage : public Image
+{
+public:
+    using Image::premultipliedAlpha;
+};
+
+static std::vector<unsigned char> makeRandomPixels(size_t size, unsigned int seed)
+{
+    std::vector<unsigned char> pixels(size);
+    std::mt19937 random(seed);
+    for (auto& byte : pixels)
+        byte = (unsigned char)random();
+    return pixels;
+}
+
+typedef void (*TextureConversion)(const unsigned char*, ssize_t, unsigned char*);
+
+// the scalar loops the conversions replaced
+
+// IIIIIIII -> RRRRRRRRGGGGGGGGBBBBBBBB
+static void referenceI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i=0; i < dataLen; ++i)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
+static void referenceAI88ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+    }
+}
+
+// IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
+static void referenceI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < dataLen; ++i)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+        *outData++ = 0xFF;        //A
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+static void referenceAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+        *outData++ = data[i + 1]; //A
+    }
+}
+
+// IIIIIIII -> RRRRRGGGGGGBBBBB
+static void referenceI8ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (int i = 0; i < dataLen; ++i)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i] & 0x00FC) << 3         //G
+            | (data[i] & 0x00F8) >> 3;        //B
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> RRRRRGGGGGGBBBBB
+static void referenceAI88ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i] & 0x00FC) << 3         //G
+            | (data[i] & 0x00F8) >> 3;        //B
+    }
+}
+
+// IIIIIIII -> RRRRGGGGBBBBAAAA
+static void referenceI8ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < dataLen; ++i)
+    {
+        *out16++ = (data[i] & 0x00F0) << 8    //R
+        | (data[i] & 0x00F0) << 4             //G
+        | (data[i] & 0x00F0)                  //B
+        | 0x000F;                             //A
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> RRRRGGGGBBBBAAAA
+static void referenceAI88ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    {
+        *out16++ = (data[i] & 0x00F0) << 8    //R
+        | (data[i] & 0x00F0) << 4             //G
+        | (data[i] & 0x00F0)                  //B
+        | (data[i+1] & 0x00F0) >> 4;          //A
+    }
+}
+
+// IIIIIIII -> RRRRRGGGGGBBBBBA
+static void referenceI8ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (int i = 0; i < dataLen; ++i)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i] & 0x00F8) << 3         //G
+            | (data[i] & 0x00F8) >> 2         //B
+            | 0x0001;                         //A
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> RRRRRGGGGGBBBBBA
+static void referenceAI88ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i] & 0x00F8) << 3         //G
+            | (data[i] & 0x00F8) >> 2         //B
+            | (data[i + 1] & 0x0080) >> 7;    //A
+    }
+}
+
+// IIIIIIII -> IIIIIIIIAAAAAAAA
+static void referenceI8ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < dataLen; ++i)
+    {
+        *out16++ = 0xFF00     //A
+        | data[i];            //I
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> AAAAAAAA
+static void referenceAI88ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 1; i < dataLen; i += 2)
+    {
+        *outData++ = data[i]; //A
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> IIIIIIII
+static void referenceAI88ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    {
+        *outData++ = data[i]; //R
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+static void referenceRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *outData++ = data[i];         //R
+        *outData++ = data[i + 1];     //G
+        *outData++ = data[i + 2];     //B
+        *outData++ = 0xFF;            //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
+static void referenceRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    {
+        *outData++ = data[i];         //R
+        *outData++ = data[i + 1];     //G
+        *outData++ = data[i + 2];     //B
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
+static void referenceRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00FC) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 3;    //B
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+static void referenceRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00FC) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 3;    //B
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIII
+static void referenceRGB888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIII
+static void referenceRGBA8888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    {
+        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
+static void referenceRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
+    {
+        *outData++ = data[i + 3]; //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIIIAAAAAAAA
+static void referenceRGB888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
+        *outData++ = 0xFF;
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA
+static void referenceRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    {
+        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
+        *outData++ = data[i + 3];
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
+static void referenceRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *out16++ = ((data[i] & 0x00F0) << 8           //R
+                    | (data[i + 1] & 0x00F0) << 4     //G
+                    | (data[i + 2] & 0xF0)            //B
+                    |  0x0F);                         //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+static void referenceRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F0) << 8    //R
+        | (data[i + 1] & 0x00F0) << 4         //G
+        | (data[i + 2] & 0xF0)                //B
+        |  (data[i + 3] & 0xF0) >> 4;         //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
+static void referenceRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00F8) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 2     //B
+            |  0x01;                          //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
+static void referenceRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00F8) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 2     //B
+            |  (data[i + 3] & 0x0080) >> 7;   //A
+    }
+}
+
+static void checkConversion(const char* name, TextureConversion conversion, TextureConversion reference, int inBytes, int outBytes)
+{
+    // an odd count, so that the vector loops leave a tail and the stripes are uneven
+    const int pixels = 100003;
+    auto in = makeRandomPixels(pixels * inBytes, pixels);
+    std::vector<unsigned char> out(pixels * outBytes), expected(pixels * outBytes);
+    conversion(in.data(), in.size(), out.data());
+    reference(in.data(), in.size(), expected.data());
+    if (out != expected)
+    {
+        fprintf(stderr, "headless-benchmark: %s differs from the scalar conversion\n", name);
+        abort();
+    }
+}
+
+static void store16(unsigned char* out, unsigned int value)
+{
+    unsigned short value16 = (unsigned short)value;
+    memcpy(out, &value16, sizeof(value16));
+}
+
+static void checkTextureConversions()
+{
+    static bool checked = false;
+    if (checked)
+        return;
+    checked = true;
+
+    checkConversion("I8 to RGB888", Texture2D::convertI8ToRGB888, referenceI8ToRGB888, 1, 3);
+    checkConversion("AI88 to RGB888", Texture2D::convertAI88ToRGB888, referenceAI88ToRGB888, 2, 3);
+    checkConversion("I8 to RGBA8888", Texture2D::convertI8ToRGBA8888, referenceI8ToRGBA8888, 1, 4);
+    checkConversion("AI88 to RGBA8888", Texture2D::convertAI88ToRGBA8888, referenceAI88ToRGBA8888, 2, 4);
+    checkConversion("I8 to RGB565", Texture2D::convertI8ToRGB565, referenceI8ToRGB565, 1, 2);
+    checkConversion("AI88 to RGB565", Texture2D::convertAI88ToRGB565, referenceAI88ToRGB565, 2, 2);
+    checkConversion("I8 to RGBA4444", Texture2D::convertI8ToRGBA4444, referenceI8ToRGBA4444, 1, 2);
+    checkConversion("AI88 to RGBA4444", Texture2D::convertAI88ToRGBA4444, referenceAI88ToRGBA4444, 2, 2);
+    checkConversion("I8 to RGB5A1", Texture2D::convertI8ToRGB5A1, referenceI8ToRGB5A1, 1, 2);
+    checkConversion("AI88 to RGB5A1", Texture2D::convertAI88ToRGB5A1, referenceAI88ToRGB5A1, 2, 2);
+    checkConversion("I8 to AI88", Texture2D::convertI8ToAI88, referenceI8ToAI88, 1, 2);
+    checkConversion("AI88 to A8", Texture2D::convertAI88ToA8, referenceAI88ToA8, 2, 1);
+    checkConversion("AI88 to I8", Texture2D::convertAI88ToI8, referenceAI88ToI8, 2, 1);
+    checkConversion("RGB888 to RGBA8888", Texture2D::convertRGB888ToRGBA8888, referenceRGB888ToRGBA8888, 3, 4);
+    checkConversion("RGBA8888 to RGB888", Texture2D::convertRGBA8888ToRGB888, referenceRGBA8888ToRGB888, 4, 3);
+    checkConversion("RGB888 to RGB565", Texture2D::convertRGB888ToRGB565, referenceRGB888ToRGB565, 3, 2);
+    checkConversion("RGBA8888 to RGB565", Texture2D::convertRGBA8888ToRGB565, referenceRGBA8888ToRGB565, 4, 2);
+    checkConversion("RGB888 to I8", Texture2D::convertRGB888ToI8, referenceRGB888ToI8, 3, 1);
+    checkConversion("RGBA8888 to I8", Texture2D::convertRGBA8888ToI8, referenceRGBA8888ToI8, 4, 1);
+    checkConversion("RGBA8888 to A8", Texture2D::convertRGBA8888ToA8, referenceRGBA8888ToA8, 4, 1);
+    checkConversion("RGB888 to AI88", Texture2D::convertRGB888ToAI88, referenceRGB888ToAI88, 3, 2);
+    checkConversion("RGBA8888 to AI88", Texture2D::convertRGBA8888ToAI88, referenceRGBA8888ToAI88, 4, 2);
+    checkConversion("RGB888 to RGBA4444", Texture2D::convertRGB888ToRGBA4444, referenceRGB888ToRGBA4444, 3, 2);
+    checkConversion("RGBA8888 to RGBA4444", Texture2D::convertRGBA8888ToRGBA4444, referenceRGBA8888ToRGBA4444, 4, 2);
+    checkConversion("RGB888 to RGB5A1", Texture2D::convertRGB888ToRGB5A1, referenceRGB888ToRGB5A1, 3, 2);
+    checkConversion("RGBA8888 to RGB5A1", Texture2D::convertRGBA8888ToRGB5A1, referenceRGBA8888ToRGB5A1, 4, 2);
+
+    const int size = 317;
+    auto pixels = makeRandomPixels(size * size * 4, size);
+    BenchmarkImage image;
+    image.initWithRawData(pixels.data(), pixels.size(), size, size, 8);
+    image.premultipliedAlpha();
+    for (int i = 0; i < size * size; ++i)
+    {
+        const unsigned char* p = &pixels[i * 4];
+        unsigned int expected = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+        if (memcmp(image.getData() + i * 4, &expected, 4) != 0)
+        {
+            fprintf(stderr, "headless-benchmark: premultiplied alpha differs from the scalar loop\n");
+            abort();
+        }
+    }
+}
+
+static void premultiplyAndConvertAtlas()
+{
+    static const auto pixels = makeRandomPixels(kAtlasSize * kAtlasSize * 4, 1);
+    BenchmarkImage image;
+    image.initWithRawData(pixels.data(), pixels.size(), kAtlasSize, kAtlasSize, 8);
+    image.premultipliedAlpha();
+    std::vector<unsigned char> converted(kAtlasSize * kAtlasSize * 2);
+    Texture2D::convertRGBA8888ToRGBA4444(image.getData(), image.getDataLen(), converted.data());
+}
+
+static void convertToEveryFormat()
+{
+    const ssize_t count = kConvertedSize * kConvertedSize;
+    static const auto rgba = makeRandomPixels(count * 4, 2);
+    static const auto rgb = makeRandomPixels(count * 3, 3);
+    static const auto ai = makeRandomPixels(count * 2, 4);
+    static const auto intensity = makeRandomPixels(count, 5);
+    std::vector<unsigned char> out(count * 4);
+
+    const TextureConversion fromRGBA[] = { Texture2D::convertRGBA8888ToRGB888, Texture2D::convertRGBA8888ToRGB565,
+        Texture2D::convertRGBA8888ToI8, Texture2D::convertRGBA8888ToA8, Texture2D::convertRGBA8888ToAI88,
+        Texture2D::convertRGBA8888ToRGBA4444, Texture2D::convertRGBA8888ToRGB5A1 };
+    const TextureConversion fromRGB[] = { Texture2D::convertRGB888ToRGBA8888, Texture2D::convertRGB888ToRGB565,
+        Texture2D::convertRGB888ToI8, Texture2D::convertRGB888ToAI88, Texture2D::convertRGB888ToRGBA4444,
+        Texture2D::convertRGB888ToRGB5A1 };
+    const TextureConversion fromAI[] = { Texture2D::convertAI88ToRGB888, Texture2D::convertAI88ToRGBA8888,
+        Texture2D::convertAI88ToRGB565, Texture2D::convertAI88ToRGBA4444, Texture2D::convertAI88ToRGB5A1,
+        Texture2D::convertAI88ToA8, Texture2D::convertAI88ToI8 };
+    const TextureConversion fromI[] = { Texture2D::convertI8ToRGB888, Texture2D::convertI8ToRGBA8888,
+        Texture2D::convertI8ToRGB565, Texture2D::convertI8ToRGBA4444, Texture2D::convertI8ToRGB5A1,
+        Texture2D::convertI8ToAI88 };
+
+    for (auto conversion : fromRGBA)
+        conversion(rgba.data(), rgba.size(), out.data());
+    for (auto conversion : fromRGB)
+        conversion(rgb.data(), rgb.size(), out.data());
+    for (auto conversion : fromAI)
+        conversion(ai.data(), ai.size(), out.data());
+    for (auto conversion : fromI)
+        conversion(intensity.data(), intensity.size(), out.data());
+}
+
+// 2048x2048 textures of random blocks, 262144 blocks of 4x4 pixels (PVRTC 4bpp: 4x4, 2bpp: 8x4), decoded in software
+static const int kCompressedSize = 2048;
+
+static void checkDecodedImage(const char* name, const std::vector<unsigned char>& decoded,
+    const std::vector<unsigned char>& expected)
+{
+    if (decoded != expected)
+    {
+        fprintf(stderr, "headless-benchmark: %s decoding differs from the block decoder\n", name);
+        abort();
+    }
+}
+
+// every image is decoded at once and by rows of blocks, each row alone on the calling thread, or by the scalar
+// block decoder for ETC1, so that neither the split between the threads nor the vector decoder change a pixel
+static void checkTextureDecoders()
+{
+    static bool checked = false;
+    if (checked)
+        return;
+    checked = true;
+
+    // not a multiple of the rows taken by a thread, and ETC1 is cropped inside its last blocks
+    const int width = 260, height = 332;
+    auto blocks = makeRandomPixels(width * height, 6);
+    std::vector<unsigned char> decoded(width * height * 4), expected(width * height * 4);
+    const int rowBytes = width * 4 * 4;
+
+    const S3TCDecodeFlag s3tcFlags[] = { S3TCDecodeFlag::DXT1, S3TCDecodeFlag::DXT3, S3TCDecodeFlag::DXT5 };
+    for (auto flag : s3tcFlags)
+    {
+        const int blockRowBytes = width / 4 * (flag == S3TCDecodeFlag::DXT1 ? 8 : 16);
+        s3tc_decode(blocks.data(), decoded.data(), width, height, flag);
+        for (int row = 0; row < height / 4; ++row)
+            s3tc_decode(blocks.data() + row * blockRowBytes, expected.data() + row * rowBytes, width, 4, flag);
+        checkDecodedImage("S3TC", decoded, expected);
+    }
+
+    const ATITCDecodeFlag atitcFlags[] = { ATITCDecodeFlag::ATC_RGB, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA,
+        ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA };
+    for (auto flag : atitcFlags)
+    {
+        const int blockRowBytes = width / 4 * (flag == ATITCDecodeFlag::ATC_RGB ? 8 : 16);
+        atitc_decode(blocks.data(), decoded.data(), width, height, flag);
+        for (int row = 0; row < height / 4; ++row)
+            atitc_decode(blocks.data() + row * blockRowBytes, expected.data() + row * rowBytes, width, 4, flag);
+        checkDecodedImage("ATITC", decoded, expected);
+    }
+
+    const int etc1Width = width - 3, etc1Height = height - 2;
+    for (int pixelSize = 2; pixelSize <= 3; ++pixelSize)
+    {
+        const int stride = etc1Width * pixelSize;
+        std::fill(decoded.begin(), decoded.end(), 0);
+        std::fill(expected.begin(), expected.end(), 0);
+        etc1_decode_image(blocks.data(), decoded.data(), etc1Width, etc1Height, pixelSize, stride);
+
+        const unsigned char* block = blocks.data();
+        etc1_byte pixels[ETC1_DECODED_BLOCK_SIZE];
+        for (int y = 0; y < height; y += 4)
+        {
+            for (int x = 0; x < width; x += 4, block += ETC1_ENCODED_BLOCK_SIZE)
+            {
+                etc1_decode_block(block, pixels);
+                for (int cy = 0; cy < 4 && y + cy < etc1Height; ++cy)
+                {
+                    for (int cx = 0; cx < 4 && x + cx < etc1Width; ++cx)
+                    {
+                        const etc1_byte* q = pixels + (cy * 4 + cx) * 3;
+                        unsigned char* p = expected.data() + (y + cy) * stride + (x + cx) * pixelSize;
+                        if (pixelSize == 3)
+                            memcpy(p, q, 3);
+                        else
+                            store16(p, (q[0] >> 3) << 11 | (q[1] >> 2) << 5 | q[2] >> 3);
+                    }
+                }
+            }
+        }
+        checkDecodedImage("ETC1", decoded, expected);
+    }
+}
+
+static void decodeS3TC(S3TCDecodeFlag flag)
+{
+    static const auto blocks = makeRandomPixels(kCompressedSize * kCompressedSize, 7);
+    std::vector<unsigned char> decoded(kCompressedSize * kCompressedSize * 4);
+    s3tc_decode(const_cast<unsigned char*>(blocks.data()), decoded.data(), kCompressedSize, kCompressedSize, flag);
+}
+
+static void decodeATITC(ATITCDecodeFlag flag)
+{
+    static const auto blocks = makeRandomPixels(kCompressedSize * kCompressedSize, 8);
+    std::vector<unsigned char> decoded(kCompressedSize * kCompressedSize * 4);
+    atitc_decode(const_cast<unsigned char*>(blocks.data()), decoded.data(), kCompressedSize, kCompressedSize, flag);
+}
+
+static void decodeETC1()
+{
+    static const auto blocks = makeRandomPixels(kCompressedSize * kCompressedSize / 2, 9);
+    std::vector<unsigned char> decoded(kCompressedSize * kCompressedSize * 3);
+    etc1_decode_image(blocks.data(), decoded.data(), kCompressedSize, kCompressedSize, 3, kCompressedSize * 3);
+}
+
+static void decodePVRTC(bool twoBits)
+{
+    static const auto blocks = makeRandomPixels(kCompressedSize * kCompressedSize / 2, 10);
+    std::vector<unsigned char> decoded(kCompressedSize * kCompressedSize * 4);
+    PVRTDecompressPVRTC(blocks.data(), kCompressedSize, kCompressedSize, decoded.data(), twoBits);
+}
+
+// 6 read backs of a 1280x720 render texture requested at once, half as images and half saved as PNG files:
+// the first 4 take the pixel buffer objects of its pool, the last 2 find them busy and read the pixels at once
+static const int kReadbackWidth = 1280;
+static const int kReadbackHeight = 720;
+static const int kReadbackCount = 6;
+static const int kReadbackBuffers = 4;
+
+static void checkReadbackImage(Image* image, int readback)
+{
+    if (!image || image->getWidth() != kReadbackWidth || image->getHeight() != kReadbackHeight)
+    {
+        fprintf(stderr, "headless-benchmark: read back %d, through %s, did not deliver a %dx%d image\n", readback,
+            readback < kReadbackBuffers ? "a pixel buffer object" : "glReadPixels", kReadbackWidth, kReadbackHeight);
+        abort();
+    }
+}
+
+static void readBackRenderTexture()
+{
+    if (!Configuration::getInstance()->supportsPixelBufferObject())
+    {
+        fprintf(stderr, "headless-benchmark: pixel buffer objects are not supported, the read backs can't use them\n");
+        abort();
+    }
+
+    // a new render texture each time, its pool of buffers is empty
+    auto renderTexture = RenderTexture::create(kReadbackWidth, kReadbackHeight, Texture2D::PixelFormat::RGBA8888);
+    renderTexture->retain();
+
+    int pending = kReadbackCount;
+    for (int i = 0; i < kReadbackCount; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            renderTexture->newImageAsync([&pending, i](RenderTexture*, Image* image) {
+                checkReadbackImage(image, i);
+                --pending;
+            });
+        }
+        else
+        {
+            renderTexture->saveToFileAsync(StringUtils::format("benchmark-readback-%d.png", i), Image::Format::PNG, true,
+                [&pending, i](RenderTexture*, const std::string& fullPath) {
+                    Image image;
+                    checkReadbackImage(image.initWithImageFile(fullPath) ? &image : nullptr, i);
+                    --pending;
+                });
+        }
+    }
+
+    // the pixels are read and mapped by the renderer, the images are delivered by the scheduler
+    auto director = Director::getInstance();
+    while (pending > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        director->mainLoop();
+    }
+    renderTexture->release();
+}
+
+// a 4096x4096 map of 4 layers, its tile data deflated with a zlib or gzip header, or only base64 encoded for 2 layers
+static const int kMapSize = 4096;
+
+enum class TileDataEncoding
+{
+    ZLIB,
+    GZIP,
+    BASE64
+};
+
+// a ground of large patches on the first layer, sparser decorations on the others
+static uint32_t mapTileGid(int layer, int x, int y)
+{
+    if (layer > 0 && (x / 32 + y / 32 + layer) % 4 != 0)
+        return 0;
+    uint32_t gid = 1 + (uint32_t)((x / 16 + y / 16 * 7 + layer * 3) % 12);
+    return ((x * 31 + y * 17) % 97 == 0) ? gid + 12 : gid;
+}
+
+static int mapLayerCount(TileDataEncoding encoding)
+{
+    return encoding == TileDataEncoding::BASE64 ? 2 : 4;
+}
+
+static std::string deflateTileData(const std::string& content, bool gzip)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzip ? MAX_WBITS + 16 : MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&stream, (uLong)content.size()), '\0');
+    stream.next_in = (Bytef*)content.data();
+    stream.avail_in = (uInt)content.size();
+    stream.next_out = (Bytef*)&out[0];
+    stream.avail_out = (uInt)out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+static std::string makeMapXML(TileDataEncoding encoding)
+{
+    char header[512];
+    snprintf(header, sizeof(header),
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<map version=\"1.0\" orientation=\"orthogonal\" width=\"%d\" height=\"%d\" tilewidth=\"32\" tileheight=\"32\">\n"
+        " <tileset firstgid=\"1\" name=\"tiles\" tilewidth=\"32\" tileheight=\"32\">\n"
+        "  <image source=\"tiles.png\" width=\"256\" height=\"128\"/>\n"
+        " </tileset>\n", kMapSize, kMapSize);
+    std::string xml = header;
+
+    const char* compression = encoding == TileDataEncoding::ZLIB ? " compression=\"zlib\"" :
+        encoding == TileDataEncoding::GZIP ? " compression=\"gzip\"" : "";
+    std::string tiles(kMapSize * kMapSize * sizeof(uint32_t), '\0');
+    for (int layer = 0; layer < mapLayerCount(encoding); ++layer)
+    {
+        uint32_t* gids = (uint32_t*)&tiles[0];
+        for (int y = 0; y < kMapSize; ++y)
+            for (int x = 0; x < kMapSize; ++x)
+                gids[y * kMapSize + x] = mapTileGid(layer, x, y);
+
+        std::string data = encoding == TileDataEncoding::BASE64 ? tiles : deflateTileData(tiles, encoding == TileDataEncoding::GZIP);
+        char* encoded = nullptr;
+        int length = base64Encode((const unsigned char*)data.data(), (unsigned int)data.size(), &encoded);
+
+        snprintf(header, sizeof(header), " <layer name=\"layer%d\" width=\"%d\" height=\"%d\">\n  <data encoding=\"base64\"%s>\n   ",
+            layer, kMapSize, kMapSize, compression);
+        xml += header;
+        xml.append(encoded, length);
+        xml += "\n  </data>\n </layer>\n";
+        free(encoded);
+    }
+    xml += "</map>\n";
+    return xml;
+}
+
+// one map is kept at a time, the last one prepared
+static std::string s_mapXML;
+
+static void loadMap()
+{
+    auto mapInfo = new (std::nothrow) TMXMapInfo();
+    mapInfo->initWithXML(s_mapXML, "");
+    mapInfo->release();
+}
+
+static void prepareMap(TileDataEncoding encoding)
+{
+    std::string().swap(s_mapXML);
+    s_mapXML = makeMapXML(encoding);
+
+    auto mapInfo = new (std::nothrow) TMXMapInfo();
+    mapInfo->initWithXML(s_mapXML, "");
+    const auto& layers = mapInfo->getLayers();
+    bool same = (int)layers.size() == mapLayerCount(encoding);
+    for (int layer = 0; same && layer < (int)layers.size(); ++layer)
+    {
+        const uint32_t* tiles = layers.at(layer)->_tiles;
+        same = tiles != nullptr;
+        for (int i = 0; same && i < kMapSize * kMapSize; ++i)
+            same = tiles[i] == mapTileGid(layer, i % kMapSize, i / kMapSize);
+    }
+    mapInfo->release();
+
+    if (!same)
+    {
+        fprintf(stderr, "headless-benchmark: the tiles of the TMX map differ from the generated ones\n");
+        abort();
+    }
+}
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+// 24 sound effects of half a second and a minute of music, as 16 bits stereo wav files, mixed by a sink without output
+static const int kAudioEffects = 24;
+static const int kAudioEffectRounds = 8;
+static const int kAudioSampleRate = 44100;
+static const size_t kAudioRenderFrames = 1024;
+
+static std::string audioDirectory()
+{
+    return FileUtils::getInstance()->getWritablePath() + "benchmark-audio/";
+}
+
+static std::string audioEffectPath(int i)
+{
+    return audioDirectory() + StringUtils::format("effect%d.wav", i);
+}
+
+static std::string audioMusicPath()
+{
+    return audioDirectory() + "music.wav";
+}
+
+static void writeWav(const std::string& path, int frames, int seed)
+{
+    std::vector<int16_t> samples(frames * 2);
+    for (int i = 0; i < frames; ++i)
+    {
+        samples[i * 2] = (int16_t)(((i * (seed + 3)) % 512 - 256) * 64);
+        samples[i * 2 + 1] = (int16_t)(((i * (seed + 5)) % 768 - 384) * 42);
+    }
+
+    uint32_t dataSize = (uint32_t)(samples.size() * sizeof(int16_t));
+    uint32_t header[] = { 0x46464952, 36 + dataSize, 0x45564157, 0x20746d66, 16,
+        (2u << 16) | 1, (uint32_t)kAudioSampleRate, (uint32_t)kAudioSampleRate * 4, (16u << 16) | 4, 0x61746164, dataSize };
+    std::string content((const char*)header, sizeof(header));
+    content.append((const char*)samples.data(), dataSize);
+    Data data;
+    data.copy((const unsigned char*)content.data(), content.size());
+    FileUtils::getInstance()->writeDataToFile(data, path);
+}
+
+static void prepareAudioFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isFileExist(audioMusicPath()))
+        return;
+
+    fileUtils->createDirectory(audioDirectory());
+    for (int i = 0; i < kAudioEffects; ++i)
+        writeWav(audioEffectPath(i), kAudioSampleRate / 2, i);
+    writeWav(audioMusicPath(), kAudioSampleRate * 60, kAudioEffects);
+}
+
+static void renderUntilSilent(CocosDenshion::NullAudioSink& sink)
+{
+    while (sink.render(kAudioRenderFrames) > 0)
+        ;
+}
+
+// every round plays all the effects at once, decoded again or taken from the cache
+static void playAudioEffects(bool cached)
+{
+    auto cache = CocosDenshion::AudioPcmCache::getInstance();
+    CocosDenshion::NullAudioSink sink;
+    for (int round = 0; round < kAudioEffectRounds; ++round)
+    {
+        for (int i = 0; i < kAudioEffects; ++i)
+        {
+            if (cached)
+            {
+                sink.play(cache->get(audioEffectPath(i)));
+            }
+            else
+            {
+                auto pcm = std::make_shared<CocosDenshion::AudioPcm>();
+                CocosDenshion::AudioDecoder::decodeAll(audioEffectPath(i), *pcm);
+                sink.play(pcm);
+            }
+        }
+        renderUntilSilent(sink);
+    }
+}
+
+static void playAudioMusic(bool streamed)
+{
+    CocosDenshion::NullAudioSink sink;
+    if (streamed)
+    {
+        auto stream = CocosDenshion::AudioStream::create(audioMusicPath());
+        sink.play(stream);
+        renderUntilSilent(sink);
+    }
+    else
+    {
+        auto pcm = std::make_shared<CocosDenshion::AudioPcm>();
+        CocosDenshion::AudioDecoder::decodeAll(audioMusicPath(), *pcm);
+        sink.play(pcm);
+        renderUntilSilent(sink);
+    }
+}
+#endif
+
+#if CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION
+// 2000 boxes dropped in a pile on a static ground, with a callback receiving every contact
+static Physics3DWorld* s_pileWorld = nullptr;
+static int s_pileContacts = 0;
+
+enum class PileContacts
+{
+    OBJECT_CALLBACKS,
+    BATCH_CALLBACK,
+};
+
+static void createPile(PileContacts contacts)
+{
+    CC_SAFE_RELEASE_NULL(s_pileWorld);
+    Physics3DWorldDes worldDes;
+    s_pileWorld = Physics3DWorld::create(&worldDes);
+    s_pileWorld->retain();
+
+    Physics3DRigidBodyDes groundDes;
+    groundDes.shape = Physics3DShape::createBox(Vec3(200.0f, 1.0f, 200.0f));
+    groundDes.originalTransform.translate(0.0f, -0.5f, 0.0f);
+    s_pileWorld->addPhysics3DObject(Physics3DRigidBody::create(&groundDes));
+
+    auto onContact = [](const Physics3DCollisionInfo& ci) { s_pileContacts += (int)ci.collisionPointList.size(); };
+    Physics3DRigidBodyDes boxDes;
+    boxDes.mass = 1.0f;
+    boxDes.shape = Physics3DShape::createBox(Vec3(1.0f, 1.0f, 1.0f));
+    for (int i = 0; i < 2000; ++i)
+    {
+        // a 10 x 10 column, 20 layers high, slightly shifted so that it collapses
+        boxDes.originalTransform = Mat4::IDENTITY;
+        boxDes.originalTransform.translate((i % 10) * 1.05f + (i / 100) * 0.1f, 0.5f + (i / 100) * 1.05f, ((i / 10) % 10) * 1.05f);
+        auto body = Physics3DRigidBody::create(&boxDes);
+        if (contacts == PileContacts::OBJECT_CALLBACKS)
+            body->setCollisionCallback(onContact);
+        s_pileWorld->addPhysics3DObject(body);
+    }
+
+    if (contacts == PileContacts::BATCH_CALLBACK)
+        s_pileWorld->setContactBatchCallback([](const Physics3DContactBatch& batch) { s_pileContacts += (int)batch.points.size(); });
+}
+
+static void stepPile()
+{
+    // two seconds of simulation
+    s_pileContacts = 0;
+    for (int i = 0; i < 120; ++i)
+        s_pileWorld->stepSimulate(1.0f / 60.0f);
+}
+
+static void rayCastPile()
+{
+    Physics3DWorld::HitResult result;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Vec3 start((i % 40) * 0.3f - 1.0f, 40.0f, (i / 40) * 0.5f - 1.0f);
+        s_pileWorld->rayCast(start, start - Vec3(0.0f, 50.0f, 0.0f), &result);
+    }
+}
+#endif
+
+#if BENCHMARK_WITH_COCOSTUDIO
+// a pack of 50 characters exported as json, 24 bones and 6 movements of 16 frames each, without sprite sheets
+static const int kArmatureCharacters = 50;
+static const int kArmatureBones = 24;
+static const int kArmatureMovements = 6;
+static const int kArmatureFrames = 16;
+
+static std::string armaturePath(int character)
+{
+    return FileUtils::getInstance()->getWritablePath() + StringUtils::format("benchmark-armatures/hero%d.ExportJson", character);
+}
+
+static std::string makeArmatureJson(int character)
+{
+    std::string bones;
+    for (int bone = 0; bone < kArmatureBones; ++bone)
+    {
+        bones += StringUtils::format("%s{\"name\":\"bone%d\",\"parent\":\"%s\",\"dI\":0,\"x\":%d.5,\"y\":%d.25,\"z\":%d,"
+            "\"cX\":1.0,\"cY\":1.0,\"kX\":0.0,\"kY\":0.0,\"display_data\":[{\"displayType\":0,\"name\":\"hero%d_bone%d.png\","
+            "\"skin_data\":[{\"x\":1.5,\"y\":-2.5,\"cX\":1.0,\"cY\":1.0,\"kX\":0.0,\"kY\":0.0}]}]}",
+            bone ? "," : "", bone, bone ? StringUtils::format("bone%d", (bone - 1) / 2).c_str() : "", bone * 3, bone * 5, bone,
+            character, bone);
+    }
+
+    std::string movements;
+    for (int movement = 0; movement < kArmatureMovements; ++movement)
+    {
+        std::string movementBones;
+        for (int bone = 0; bone < kArmatureBones; ++bone)
+        {
+            std::string frames;
+            for (int frame = 0; frame < kArmatureFrames; ++frame)
+            {
+                frames += StringUtils::format("%s{\"fi\":%d,\"dI\":0,\"x\":%d.125,\"y\":%d.75,\"kX\":0.%d,\"kY\":0.%d,"
+                    "\"cX\":1.0,\"cY\":1.0,\"z\":%d,\"twE\":0,\"tweenFrame\":true}",
+                    frame ? "," : "", frame * 2, frame - bone, movement + frame, frame, bone, bone);
+            }
+            movementBones += StringUtils::format("%s{\"name\":\"bone%d\",\"dl\":0.0,\"frame_data\":[",
+                bone ? "," : "", bone) + frames + "]}";
+        }
+        movements += StringUtils::format("%s{\"name\":\"move%d\",\"dr\":%d,\"lp\":true,\"to\":6,\"drTW\":%d,\"twE\":0,\"sc\":1.0,"
+            "\"mov_bone_data\":[", movement ? "," : "", movement, kArmatureFrames * 2, kArmatureFrames * 2) + movementBones + "]}";
+    }
+
+    // StringUtils::format() is limited to 100KB, the animations are larger
+    return StringUtils::format("{\"content_scale\":1.0,\"armature_data\":[{\"name\":\"hero%d\",\"version\":1.6,\"bone_data\":[", character)
+        + bones + StringUtils::format("]}],\"animation_data\":[{\"name\":\"hero%d\",\"mov_data\":[", character)
+        + movements + "]}],\"texture_data\":[],\"config_file_path\":[]}";
+}
+
+static void prepareArmatureFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isFileExist(armaturePath(kArmatureCharacters - 1)))
+        return;
+
+    fileUtils->createDirectory(FileUtils::getInstance()->getWritablePath() + "benchmark-armatures/");
+    for (int i = 0; i < kArmatureCharacters; ++i)
+        fileUtils->writeStringToFile(makeArmatureJson(i), armaturePath(i));
+}
+
+class ArmatureLoadCounter : public Ref
+{
+public:
+    int loaded = 0;
+    void onLoaded(float) { ++loaded; }
+};
+
+// the pack is loaded one file after another, or queued at once for the loading threads
+static void loadArmaturePack(int loadingThreads)
+{
+    auto manager = cocostudio::ArmatureDataManager::getInstance();
+    if (loadingThreads == 0)
+    {
+        for (int i = 0; i < kArmatureCharacters; ++i)
+            manager->addArmatureFileInfo(armaturePath(i));
+        return;
+    }
+
+    cocostudio::DataReaderHelper::getInstance()->setLoadingThreadCount(loadingThreads);
+    auto counter = new ArmatureLoadCounter();
+    for (int i = 0; i < kArmatureCharacters; ++i)
+        manager->addArmatureFileInfoAsync(armaturePath(i), counter, CC_SCHEDULE_SELECTOR(ArmatureLoadCounter::onLoaded));
+    while (counter->loaded < kArmatureCharacters)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        Director::getInstance()->getScheduler()->update(0);
+    }
+    counter->release();
+}
+
+// the loading threads are started again by the next load
+static void forgetArmaturePack()
+{
+    cocostudio::ArmatureDataManager::destroyInstance();
+}
+#endif
+
+#if BENCHMARK_WITH_EXTENSIONS
+// the 4 PU effects of the pu-particles scene, 20 systems of each
+enum class PULoading
+{
+    PARSE,
+    BINARY_CACHE,
+    TEMPLATES,
+};
+
+static void preparePUSearchPaths()
+{
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->addSearchPath("Particle3D/materials");
+    fileUtils->addSearchPath("Particle3D/scripts");
+    fileUtils->addSearchPath("Sprite3DTest");
+}
+
+static std::string puCacheDirectory()
+{
+    return FileUtils::getInstance()->getWritablePath() + "benchmark-pu/";
+}
+
+static void createPUSystems(PULoading loading)
+{
+    auto compiler = PUScriptCompiler::Instance();
+    compiler->setCacheDirectory(loading == PULoading::PARSE ? "" : puCacheDirectory());
+    PUParticleSystem3D::setTemplateCacheEnabled(loading == PULoading::TEMPLATES);
+
+    const char* effects[] = { "blackHole.pu", "canOfWorms.pu", "lineStreak.pu", "flareShield.pu" };
+    Vector<PUParticleSystem3D*> systems;
+    for (int i = 0; i < 20; ++i)
+    {
+        for (auto effect : effects)
+            systems.pushBack(PUParticleSystem3D::create(effect, "pu_mediapack_01.material"));
+    }
+
+    compiler->setCacheDirectory("");
+    PUParticleSystem3D::setTemplateCacheEnabled(false);
+}
+
+static void forgetPUScripts()
+{
+    PUScriptCompiler::Instance()->clearCompiledScripts();
+    PUParticleSystem3D::clearTemplateCache();
+}
+
+static BenchmarkTask makePULoadingTask(const char* name, const char* description, PULoading loading)
+{
+    return { name, description,
+        [=] { preparePUSearchPaths(); forgetPUScripts(); createPUSystems(loading); forgetPUScripts(); },
+        [=] { createPUSystems(loading); },
+        forgetPUScripts };
+}
+#endif
+
+const std::vector<BenchmarkTask>& getBenchmarkTasks()
+{
+    static const std::vector<BenchmarkTask> tasks = {
+        { "spriteframes-plist", "load 14 sprite sheets from their plists",
+            [] { prepareSpriteSheets(); }, [] { addSpriteSheets(false); }, removeSpriteFrames },
+        { "spriteframes-index", "load 14 sprite sheets from their binary indexes",
+            [] { prepareSpriteSheets(); }, [] { addSpriteSheets(true); }, removeSpriteFrames },
+        { "spriteframes-plist-all", "load 14 sprite sheets from their plists and get all their frames",
+            [] { prepareSpriteSheets(); }, [] { addSpriteSheets(false); getSpriteFrames(); }, removeSpriteFrames },
+        { "spriteframes-index-all", "load 14 sprite sheets from their binary indexes and get all their frames",
+            [] { prepareSpriteSheets(); }, [] { addSpriteSheets(true); getSpriteFrames(); }, removeSpriteFrames },
+        { "autopolygon", "generate 200 polygons from 20 images",
+            nullptr, generatePolygons, nullptr },
+        { "autopolygon-async", "generate 200 polygons from 20 images on a worker",
+            nullptr, generatePolygonsAsync, nullptr },
+        { "autopolygon-cached", "load 200 polygons of 20 images from the polygon cache",
+            [] { generateCachedPolygons(false); }, [] { generateCachedPolygons(false); }, nullptr },
+        { "autopolygon-cached-async", "load 200 polygons of 20 images from the polygon cache on a worker",
+            [] { generateCachedPolygons(false); }, [] { generateCachedPolygons(true); }, nullptr },
+        { "http-serial-200", "200 GET requests to a loopback server answering in 2ms, one at a time",
+            [] { getHttpServerPort(); }, [] { sendHttpRequests(200, 1, false); }, nullptr },
+        { "http-concurrent-200", "200 GET requests to a loopback server answering in 2ms, 8 at once",
+            [] { getHttpServerPort(); }, [] { sendHttpRequests(200, 8, false); }, nullptr },
+        { "http-latency-50", "50 GET requests to a loopback server answering in 2ms, each sent after the previous response",
+            [] { getHttpServerPort(); }, [] { sendHttpRequests(50, 8, true); }, nullptr },
+        { "download-batch-serial", "download and check 64 assets of 256KB from a loopback server, one at a time",
+            [] { getHttpServerPort(); prepareDownloadDirectory(false); }, [] { downloadAssets(1, false); },
+            [] { prepareDownloadDirectory(false); } },
+        { "download-batch-parallel", "download and check 64 assets of 256KB from a loopback server, 8 at once",
+            [] { getHttpServerPort(); prepareDownloadDirectory(false); }, [] { downloadAssets(8, false); },
+            [] { prepareDownloadDirectory(false); } },
+        { "download-batch-resume", "resume and check 64 half downloaded assets of 256KB from a loopback server, 8 at once",
+            [] { getHttpServerPort(); prepareDownloadDirectory(true); }, [] { downloadAssets(8, true); },
+            [] { prepareDownloadDirectory(true); } },
+        makeWebSocketEchoTask(1, 2000, 16),
+        makeWebSocketEchoTask(8, 500, 1024),
+        { "package-zip", "read 400 assets of 16KB from a zip archive, opened and searched for each asset",
+            [] { preparePackage(); unmountPackage(); }, readZipAssets, nullptr },
+        { "package-mounted", "read 400 assets of 16KB from a mounted zip package, half of them without a copy",
+            [] { preparePackage(); mountPackage(); }, [] { readPackageAssets(false); }, nullptr },
+        { "package-mounted-parallel", "read 400 assets of 16KB from a mounted zip package, on all the threads at once",
+            [] { preparePackage(); mountPackage(); }, [] { readPackageAssets(true); }, nullptr },
+        { "package-mounted-ccz", "load an encrypted pvr.ccz atlas 16 times from a mounted package, on all the threads at once",
+            prepareEncryptedPackage, loadEncryptedPackageAtlas, nullptr },
+        { "texture-premultiply-4444", "premultiply a 4096x4096 RGBA8888 atlas and convert it to RGBA4444",
+            checkTextureConversions, premultiplyAndConvertAtlas, nullptr },
+        { "texture-convert-formats", "convert 1024x1024 images between the 26 pairs of pixel formats",
+            checkTextureConversions, convertToEveryFormat, nullptr },
+        { "texture-decode-dxt1", "decode a 2048x2048 DXT1 texture in software, 262144 blocks",
+            checkTextureDecoders, [] { decodeS3TC(S3TCDecodeFlag::DXT1); }, nullptr },
+        { "texture-decode-dxt5", "decode a 2048x2048 DXT5 texture in software, 262144 blocks",
+            checkTextureDecoders, [] { decodeS3TC(S3TCDecodeFlag::DXT5); }, nullptr },
+        { "texture-decode-atc", "decode a 2048x2048 ATC interpolated alpha texture in software, 262144 blocks",
+            checkTextureDecoders, [] { decodeATITC(ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA); }, nullptr },
+        { "texture-decode-etc1", "decode a 2048x2048 ETC1 texture in software, 262144 blocks",
+            checkTextureDecoders, decodeETC1, nullptr },
+        { "texture-decode-pvrtc4", "decode a 2048x2048 PVRTC 4bpp texture in software, 262144 blocks",
+            checkTextureDecoders, [] { decodePVRTC(false); }, nullptr },
+        { "rendertexture-readback-async", "read a 1280x720 render texture back 6 times at once, 4 through pixel buffer objects",
+            nullptr, readBackRenderTexture, nullptr },
+        { "tmx-load-zlib", "parse a 4096x4096 TMX map of 4 layers, base64 and zlib tile data",
+            [] { prepareMap(TileDataEncoding::ZLIB); }, loadMap, nullptr },
+        { "tmx-load-gzip", "parse a 4096x4096 TMX map of 4 layers, base64 and gzip tile data",
+            [] { prepareMap(TileDataEncoding::GZIP); }, loadMap, nullptr },
+        { "tmx-load-base64", "parse a 4096x4096 TMX map of 2 layers, uncompressed base64 tile data",
+            [] { prepareMap(TileDataEncoding::BASE64); }, loadMap, nullptr },
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+        { "audio-effects-decode", "play 24 sound effects of 0.5s 8 times on a null sink, decoding them at every play",
+            prepareAudioFiles, [] { playAudioEffects(false); }, nullptr },
+        { "audio-effects-cached", "play 24 sound effects of 0.5s 8 times on a null sink, from the decoded clip cache",
+            [] { prepareAudioFiles(); playAudioEffects(true); }, [] { playAudioEffects(true); }, nullptr },
+        { "audio-music-decode", "play a minute of music on a null sink, decoded whole before playing",
+            prepareAudioFiles, [] { playAudioMusic(false); }, nullptr },
+        { "audio-music-stream", "play a minute of music on a null sink, streamed by chunks",
+            prepareAudioFiles, [] { playAudioMusic(true); }, nullptr },
+#endif
+#if BENCHMARK_WITH_COCOSTUDIO
+        { "armature-pack-sync", "load a pack of 50 armatures of 24 bones and 6 movements, one file after another",
+            [] { prepareArmatureFiles(); forgetArmaturePack(); }, [] { loadArmaturePack(0); }, forgetArmaturePack },
+        { "armature-pack-async-1", "load a pack of 50 armatures of 24 bones and 6 movements, on a single loading thread",
+            [] { prepareArmatureFiles(); forgetArmaturePack(); }, [] { loadArmaturePack(1); }, forgetArmaturePack },
+        { "armature-pack-async", "load a pack of 50 armatures of 24 bones and 6 movements, on 4 loading threads",
+            [] { prepareArmatureFiles(); forgetArmaturePack(); }, [] { loadArmaturePack(4); }, forgetArmaturePack },
+#endif
+#if CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION
+        { "physics3d-pile", "120 steps of a pile of 2000 boxes, each with a collision callback",
+            [] { createPile(PileContacts::OBJECT_CALLBACKS); }, stepPile, [] { createPile(PileContacts::OBJECT_CALLBACKS); } },
+        { "physics3d-pile-batch", "120 steps of a pile of 2000 boxes, with a contact batch callback",
+            [] { createPile(PileContacts::BATCH_CALLBACK); }, stepPile, [] { createPile(PileContacts::BATCH_CALLBACK); } },
+        { "physics3d-raycast", "1000 ray casts on a pile of 2000 boxes",
+            [] { createPile(PileContacts::BATCH_CALLBACK); stepPile(); }, rayCastPile, nullptr },
+#endif
+#if BENCHMARK_WITH_EXTENSIONS
+        makePULoadingTask("pu-load-parse", "create 80 systems of 4 PU effects, the scripts are parsed",
+            PULoading::PARSE),
+        makePULoadingTask("pu-load-binary", "create 80 systems of 4 PU effects, the scripts are read from the binary cache",
+            PULoading::BINARY_CACHE),
+        makePULoadingTask("pu-load-templates", "create 80 systems of 4 PU effects, copied from a template of each effect",
+            PULoading::TEMPLATES),
+#endif
+#if CC_USE_NAVMESH
+        makeNavMeshPathTask(50, false),
+        makeNavMeshPathTask(50, true),
+        makeNavMeshPathTask(200, false),
+        makeNavMeshPathTask(200, true),
+        makeNavMeshPathTask(500, false),
+        makeNavMeshPathTask(500, true),
+#endif
+    };
+    return tasks;
+}
@@ -0,0 +1,25 @@
+#ifndef __BENCHMARK_TASKS_H__
+#define __BENCHMARK_TASKS_H__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * A piece of work timed on its own, outside of the frames, such as loading resources.
+ * prepare runs once before the iterations, run is timed, and reset runs after every
+ * iteration so that the next one starts from the same state. prepare and reset may be empty.
+ */
+struct BenchmarkTask
+{
+    std::string name;
+    std::string description;
+    std::function<void()> prepare;
+    std::function<void()> run;
+    std::function<void()> reset;
+};
+
+/** All the tasks known to the runner, in the order they run by default. */
+const std::vector<BenchmarkTask>& getBenchmarkTasks();
+
+#endif // __BENCHMARK_TASKS_H__
@@ -0,0 +1,98 @@
+#include "../Classes/BenchmarkApp.h"
+#include "../Classes/BenchmarkScenes.h"
+#include "../Classes/BenchmarkTasks.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+USING_NS_CC;
+
+static void printUsage(const char* program)
+{
+    printf("usage: %s [options]\n"
+           "  --scene NAME       run this scene, can be repeated (default: all)\n"
+           "  --task NAME        run this task, can be repeated (default: all)\n"
+           "  --iterations N     timed runs per task (default: 20)\n"
+           "  --frames N         measured frames per scene (default: 600)\n"
+           "  --warmup N         frames run before measuring (default: 30)\n"
+           "  --dt SECONDS       fixed delta time (default: 1/60)\n"
+           "  --size WxH         frame size (default: 960x640)\n"
+           "  --resources DIR    resource root (default: cpp-tests resources)\n"
+           "  --output FILE      write the JSON report to FILE (default: stdout)\n"
+           "  --pipelined        draw the frames on a render thread\n"
+           "  --list             list the scenes and the tasks and exit\n",
+           program);
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--list") == 0)
+        {
+            for (const auto& scene : getBenchmarkScenes())
+                printf("%-24s %s\n", scene.name.c_str(), scene.description.c_str());
+            for (const auto& task : getBenchmarkTasks())
+                printf("%-24s %s\n", task.name.c_str(), task.description.c_str());
+            return EXIT_SUCCESS;
+        }
+        else if (strcmp(arg, "--pipelined") == 0)
+        {
+            options.pipelined = true;
+            continue;
+        }
+        else if (strcmp(arg, "--help") == 0 || value == nullptr)
+        {
+            printUsage(argv[0]);
+            return strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        else if (strcmp(arg, "--scene") == 0)
+            options.scenes.push_back(value);
+        else if (strcmp(arg, "--task") == 0)
+            options.tasks.push_back(value);
+        else if (strcmp(arg, "--iterations") == 0)
+            options.iterations = atoi(value);
+        else if (strcmp(arg, "--frames") == 0)
+            options.frames = atoi(value);
+        else if (strcmp(arg, "--warmup") == 0)
+            options.warmupFrames = atoi(value);
+        else if (strcmp(arg, "--dt") == 0)
+            options.deltaTime = atof(value);
+        else if (strcmp(arg, "--resources") == 0)
+            options.resourceRoot = value;
+        else if (strcmp(arg, "--output") == 0)
+            options.outputPath = value;
+        else if (strcmp(arg, "--size") == 0)
+        {
+            int width = 0, height = 0;
+            if (sscanf(value, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+            {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            options.frameSize = Size(width, height);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        ++i;
+    }
+
+    if (options.frames <= 0 || options.warmupFrames < 0 || options.iterations <= 0 || options.deltaTime <= 0)
+    {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    BenchmarkApp app(options);
+    return app.runBenchmarks();
+}
@@ -125,7 +125,7 @@ DrawNode3D::~DrawNode3D()
     free(_buffer);
     _buffer = nullptr;
     
-    glDeleteBuffers(1, &_vbo);
+    cocos2d::GL::deleteBuffers(1, &_vbo);
     _vbo = 0;
     
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -177,7 +177,7 @@ bool DrawNode3D::init()
     }
     
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
     
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -186,7 +186,7 @@ bool DrawNode3D::init()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B), (GLvoid *)offsetof(V3F_C4B, colors));
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -222,12 +222,12 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     auto glProgram = getGLProgram();
     glProgram->use();
     glProgram->setUniformsForBuiltins(transform);
-    glEnable(GL_DEPTH_TEST);
+    cocos2d::GL::enable(GL_DEPTH_TEST);
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
         _dirty = false;
     }
@@ -239,7 +239,7 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         // vertex
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B), (GLvoid *)offsetof(V3F_C4B, vertices));
 
@@ -248,10 +248,10 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     }
 
     glDrawArrays(GL_LINES, 0, _bufferCount);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCount);
-    glDisable(GL_DEPTH_TEST);
+    cocos2d::GL::disable(GL_DEPTH_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -104,7 +104,7 @@ DrawNode3D::~DrawNode3D()
     free(_buffer);
     _buffer = nullptr;
     
-    glDeleteBuffers(1, &_vbo);
+    GL::deleteBuffers(1, &_vbo);
     _vbo = 0;
     
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -156,7 +156,7 @@ bool DrawNode3D::init()
     }
     
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
     
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -165,7 +165,7 @@ bool DrawNode3D::init()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B), (GLvoid *)offsetof(V3F_C4B, colors));
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -201,12 +201,12 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     auto glProgram = getGLProgram();
     glProgram->use();
     glProgram->setUniformsForBuiltins(transform);
-    glEnable(GL_DEPTH_TEST);
+    GL::enable(GL_DEPTH_TEST);
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
     
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
         _dirty = false;
     }
@@ -218,7 +218,7 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
         
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         // vertex
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B), (GLvoid *)offsetof(V3F_C4B, vertices));
         
@@ -227,10 +227,10 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     }
     
     glDrawArrays(GL_LINES, 0, _bufferCount);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCount);
-	glDisable(GL_DEPTH_TEST);
+	GL::disable(GL_DEPTH_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -1678,6 +1678,7 @@ local function runFuncRelateWithTable()
     local averageTime2 = 0.0
     local totalTime    = 0.0
     local numberOfCalls = 0
+    local pushesPerFrame = 0
 
     local function GetTitle()
         return "Func Releated Table Performance Test"
@@ -1694,6 +1695,7 @@ local function runFuncRelateWithTable()
         averageTime2 = 0.0
         totalTime    = 0.0
         numberOfCalls = 0
+        tolua.getpushcount(true)
     end
 
     --Title
@@ -1754,10 +1756,18 @@ local function runFuncRelateWithTable()
     local getPositionItem = cc.MenuItemFont:create("getPosition")
     local getAnchorPointItem = cc.MenuItemFont:create("getAnchorPoint")
     local pointItem       = cc.MenuItemFont:create("object")
+    local getAnchorPointToTableItem = cc.MenuItemFont:create("getAnchorPoint(table)")
+    local setPositionsItem = cc.MenuItemFont:create("setPositions")
+    local getPositionsItem = cc.MenuItemFont:create("getPositions")
+    local getParentItem = cc.MenuItemFont:create("getParent")
     local funcToggleItem  = cc.MenuItemToggle:create(setPositionItem)
     funcToggleItem:addSubItem(getPositionItem)
     funcToggleItem:addSubItem(getAnchorPointItem)
     funcToggleItem:addSubItem(pointItem)
+    funcToggleItem:addSubItem(getAnchorPointToTableItem)
+    funcToggleItem:addSubItem(setPositionsItem)
+    funcToggleItem:addSubItem(getPositionsItem)
+    funcToggleItem:addSubItem(getParentItem)
     funcToggleItem:setAnchorPoint(cc.p(0.0, 0.5))
     funcToggleItem:setPosition(cc.p(VisibleRect:left()))
     local funcMenu = cc.Menu:create(funcToggleItem)
@@ -1767,8 +1777,26 @@ local function runFuncRelateWithTable()
     local testNode = cc.Node:create()
     layer:addChild(testNode)
 
+    -- the batch calls get quantityOfNodes times the same node, and the positions as {x1, y1, x2, y2, ...}
+    local nodes = {}
+    local positions = {}
+    local anchorPoint = cc.p(0, 0)
+
+    local function prepareBatch()
+        if #nodes == quantityOfNodes then
+            return
+        end
+        nodes = {}
+        positions = {}
+        for i=1,quantityOfNodes do
+            nodes[i] = testNode
+            positions[2 * i - 1] = 1
+            positions[2 * i] = 2
+        end
+    end
+
     local function step(dt)
-        print(string.format("push num: %d, avg1:%f, avg2:%f,min:%f, max:%f, total: %f, calls: %d",quantityOfNodes, averageTime1, averageTime2, minTime, maxTime, totalTime, numberOfCalls))
+        print(string.format("push num: %d, avg1:%f, avg2:%f,min:%f, max:%f, total: %f, calls: %d, objects pushed by frame: %d",quantityOfNodes, averageTime1, averageTime2, minTime, maxTime, totalTime, numberOfCalls, pushesPerFrame))
     end
 
     local function profileEnd(startTime)
@@ -1822,7 +1850,43 @@ local function runFuncRelateWithTable()
         profileEnd(startTime)
     end
 
+    local function callGetAnchorPointToTable()
+        numberOfCalls = numberOfCalls + 1
+        local startTime = socket.gettime()
+        for i=1,quantityOfNodes do
+            testNode:getAnchorPoint(anchorPoint)
+        end
+        profileEnd(startTime)
+    end
+
+    local function callSetPositions()
+        prepareBatch()
+        numberOfCalls = numberOfCalls + 1
+        local startTime = socket.gettime()
+        cc.Node:setPositions(nodes, positions)
+        profileEnd(startTime)
+    end
+
+    local function callGetPositions()
+        prepareBatch()
+        numberOfCalls = numberOfCalls + 1
+        local startTime = socket.gettime()
+        cc.Node:getPositions(nodes, positions)
+        profileEnd(startTime)
+    end
+
+    local function callGetParent()
+        numberOfCalls = numberOfCalls + 1
+        local startTime = socket.gettime()
+        for i=1,quantityOfNodes do
+            local parent = testNode:getParent()
+        end
+        profileEnd(startTime)
+    end
+
     local function update(dt)
+        -- the objects pushed by the last frame, this update included
+        pushesPerFrame = tolua.getpushcount(true)
 
         local funcSelected = funcToggleItem:getSelectedIndex()
         if 0 == funcSelected then
@@ -1833,6 +1897,14 @@ local function runFuncRelateWithTable()
             callGetAnchorPoint()
         elseif 3 == funcSelected then
             callTableObject()
+        elseif 4 == funcSelected then
+            callGetAnchorPointToTable()
+        elseif 5 == funcSelected then
+            callSetPositions()
+        elseif 6 == funcSelected then
+            callGetPositions()
+        elseif 7 == funcSelected then
+            callGetParent()
         end
     end
 